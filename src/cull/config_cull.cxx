@@ -33,6 +33,21 @@ ConfigureFn(config_cull) {
   init_libcull();
 }
 
+ConfigVariableInt max_instances_per_draw
+("max-instances-per-draw", 256,
+ PRC_DESC("This is the largest number of copies of a Geom that a cull bin "
+          "with instancing enabled will collapse into a single instanced "
+          "draw call.  A batch larger than the instance_transforms array "
+          "declared by its shader is still split into several draw calls "
+          "that each fit the array."));
+
+ConfigVariableBool cull_state_delta
+("cull-state-delta", true,
+ PRC_DESC("When this is true, the cull bins work out, in the cull thread, "
+          "which render attributes change from each object to the next, so "
+          "that the draw thread does not have to compare the states itself.  "
+          "This is mainly useful to turn off for comparison."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
@@ -26,6 +26,9 @@ class DSearchPath;
 ConfigureDecl(config_cull, EXPCL_PANDA_CULL, EXPTP_PANDA_CULL);
 NotifyCategoryDecl(cull, EXPCL_PANDA_CULL, EXPTP_PANDA_CULL);
 
+extern ConfigVariableInt max_instances_per_draw;
+extern EXPCL_PANDA_CULL ConfigVariableBool cull_state_delta;
+
 extern EXPCL_PANDA_CULL void init_libcull();
 
 #endif
@@ -21,6 +21,7 @@
 #include "transformState.h"
 #include "renderState.h"
 #include "pointerTo.h"
+#include "radixSort.h"
 
 /**
  * A specific kind of CullBin that sorts geometry in order from furthest to
@@ -29,12 +30,17 @@
  * be sorted from back to front.
  */
 class EXPCL_PANDA_CULL CullBinBackToFront : public CullBin {
+protected:
+  INLINE CullBinBackToFront(const CullBinBackToFront &copy);
+
 public:
   INLINE CullBinBackToFront(const std::string &name,
                             GraphicsStateGuardianBase *gsg,
                             const PStatCollector &draw_region_pcollector);
   virtual ~CullBinBackToFront();
 
+  virtual PT(CullBin) make_next() const;
+
   static CullBin *make_bin(const std::string &name,
                            GraphicsStateGuardianBase *gsg,
                            const PStatCollector &draw_region_pcollector);
@@ -51,10 +57,9 @@ private:
   class ObjectData {
   public:
     INLINE ObjectData(CullableObject *object, PN_stdfloat dist);
-    INLINE bool operator < (const ObjectData &other) const;
 
     CullableObject *_object;
-    PN_stdfloat _dist;
+    uint64_t _sort_key;
   };
 
   typedef pvector<ObjectData> Objects;
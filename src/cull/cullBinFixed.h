@@ -31,12 +31,17 @@
  * in scene-graph order (as with CullBinUnsorted).
  */
 class EXPCL_PANDA_CULL CullBinFixed : public CullBin {
+protected:
+  INLINE CullBinFixed(const CullBinFixed &copy);
+
 public:
   INLINE CullBinFixed(const std::string &name,
                       GraphicsStateGuardianBase *gsg,
                       const PStatCollector &draw_region_pcollector);
   virtual ~CullBinFixed();
 
+  virtual PT(CullBin) make_next() const;
+
   static CullBin *make_bin(const std::string &name,
                            GraphicsStateGuardianBase *gsg,
                            const PStatCollector &draw_region_pcollector);
@@ -17,6 +17,7 @@
 #include "cullableObject.h"
 #include "cullHandler.h"
 #include "pStatTimer.h"
+#include "config_cull.h"
 
 #include <algorithm>
 
@@ -35,6 +36,15 @@ CullBinFrontToBack::
   }
 }
 
+/**
+ * Returns a new, empty bin of the same type for next frame, sized for the
+ * number of objects in this one.
+ */
+PT(CullBin) CullBinFrontToBack::
+make_next() const {
+  return new CullBinFrontToBack(*this);
+}
+
 /**
  * Factory constructor for passing to the CullBinManager.
  */
@@ -75,7 +85,17 @@ add_object(CullableObject *object, Thread *current_thread) {
 void CullBinFrontToBack::
 finish_cull(SceneSetup *, Thread *current_thread) {
   PStatTimer timer(_cull_this_pcollector, current_thread);
-  sort(_objects.begin(), _objects.end());
+  radix_sort(_objects);
+
+  if (cull_state_delta) {
+    // Now that the order is settled, note which attributes change from each
+    // object to the next, so the draw thread doesn't have to.
+    const RenderState *prev_state = nullptr;
+    for (ObjectData &data : _objects) {
+      data._object->set_prev_state(prev_state);
+      prev_state = data._object->_state;
+    }
+  }
 }
 
 /**
@@ -92,7 +112,8 @@ draw(bool force, Thread *current_thread) {
     if (object->_draw_callback == nullptr) {
       nassertd(object->_geom != nullptr) continue;
 
-      _gsg->set_state_and_transform(object->_state, object->_internal_transform);
+      _gsg->set_state_delta_and_transform(object->_state, object->_internal_transform,
+                                          object->_prev_state, object->_changed_slots);
 
       GeomPipelineReader geom_reader(object->_geom, current_thread);
       GeomVertexDataPipelineReader data_reader(object->_munged_data, current_thread);
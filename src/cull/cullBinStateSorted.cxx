@@ -16,6 +16,7 @@
 #include "cullableObject.h"
 #include "cullHandler.h"
 #include "pStatTimer.h"
+#include "config_cull.h"
 
 #include <algorithm>
 
@@ -34,6 +35,15 @@ CullBinStateSorted::
   }
 }
 
+/**
+ * Returns a new, empty bin of the same type for next frame, sized for the
+ * number of objects in this one.
+ */
+PT(CullBin) CullBinStateSorted::
+make_next() const {
+  return new CullBinStateSorted(*this);
+}
+
 /**
  * Factory constructor for passing to the CullBinManager.
  */
@@ -48,7 +58,31 @@ make_bin(const std::string &name, GraphicsStateGuardianBase *gsg,
  */
 void CullBinStateSorted::
 add_object(CullableObject *object, Thread *current_thread) {
-  _objects.push_back(ObjectData(object));
+  const GeomVertexData *data = object->_munged_data;
+  const GeomVertexFormat *format = nullptr;
+  if (data != nullptr) {
+    format = data->get_format();
+  }
+
+  // Group by state changes, in approximate order from heaviest change to
+  // lightest change.  Vertex format changes are also fairly slow, and
+  // grouping by vertex data prevents unnecessary vertex buffer rebinds.
+  uint64_t key =
+    (get_index(_states, object->_state.p(), max_state_index) << SK_state_shift) |
+    (get_index(_formats, format, max_format_index) << SK_format_shift) |
+    (get_index(_datas, data, max_data_index) << SK_data_shift);
+
+  if (_instancing) {
+    key |= get_index(_geoms, object->_geom.p(), max_geom_index) << SK_transform_shift;
+  } else {
+    // Uniform updates are actually pretty fast, so for the transform we only
+    // use some bits of the pointer, which is enough to keep identical
+    // transforms together.
+    uintptr_t transform = (uintptr_t)object->_internal_transform.p();
+    key |= (uint64_t)((transform >> 4) & 0xffff) << SK_transform_shift;
+  }
+
+  _objects.push_back(ObjectData(object, key));
 }
 
 /**
@@ -59,10 +93,101 @@ add_object(CullableObject *object, Thread *current_thread) {
 void CullBinStateSorted::
 finish_cull(SceneSetup *, Thread *current_thread) {
   PStatTimer timer(_cull_this_pcollector, current_thread);
-  sort(_objects.begin(), _objects.end());
+
+  // The states were numbered in the order they were first seen.  Rank them
+  // by compare_sort() instead, which puts states that share their more
+  // expensive attributes next to each other.  There are far fewer distinct
+  // states than objects, so this comparison sort is cheap.
+  size_t num_states = std::min((size_t)_states.get_num_entries(),
+                               (size_t)max_state_index);
+  if (num_states > 1) {
+    pvector<int> order(num_states);
+    for (size_t i = 0; i < num_states; ++i) {
+      order[i] = (int)i;
+    }
+    sort(order.begin(), order.end(), [this](int a, int b) {
+      return _states.get_key(a)->compare_sort(*_states.get_key(b)) < 0;
+    });
+
+    pvector<uint64_t> ranks(num_states + 1, num_states);
+    for (size_t r = 0; r < num_states; ++r) {
+      ranks[order[r]] = r;
+    }
+
+    const uint64_t state_mask = max_state_index << SK_state_shift;
+    Objects::iterator oi;
+    for (oi = _objects.begin(); oi != _objects.end(); ++oi) {
+      uint64_t key = (*oi)._sort_key;
+      uint64_t rank = ranks[key >> SK_state_shift];
+      (*oi)._sort_key = (key & ~state_mask) | (rank << SK_state_shift);
+    }
+  }
+
+  radix_sort(_objects);
+
+  if (_instancing) {
+    collapse_instances();
+  }
+
+  if (cull_state_delta) {
+    // Now that the order is settled, note which attributes change from each
+    // object to the next, so the draw thread doesn't have to.
+    const RenderState *prev_state = nullptr;
+    for (ObjectData &data : _objects) {
+      data._object->set_prev_state(prev_state);
+      prev_state = data._object->_state;
+    }
+  }
 }
 
 
+/**
+ * Replaces each run of sorted objects that draw the same Geom with the same
+ * state and vertex data by a single instanced object.
+ */
+void CullBinStateSorted::
+collapse_instances() {
+  size_t max_instances = (size_t)std::max((int)max_instances_per_draw, 1);
+  size_t num_objects = _objects.size();
+  size_t num_kept = 0;
+
+  size_t i = 0;
+  while (i < num_objects) {
+    CullableObject *object = _objects[i]._object;
+    size_t j = i + 1;
+    if (object->_draw_callback == nullptr && object->_instances == nullptr) {
+      while (j < num_objects && j - i < max_instances) {
+        const CullableObject *next = _objects[j]._object;
+        if (next->_geom != object->_geom ||
+            next->_state != object->_state ||
+            next->_munged_data != object->_munged_data ||
+            next->_draw_callback != nullptr ||
+            next->_instances != nullptr) {
+          break;
+        }
+        ++j;
+      }
+    }
+
+    if (j - i > 1) {
+      object->_instances = new CullableObject::Instances;
+      CullableObject::InstanceTransforms &transforms =
+        object->_instances->_transforms;
+      transforms.reserve(j - i);
+      transforms.push_back(object->_internal_transform);
+      for (size_t k = i + 1; k < j; ++k) {
+        transforms.push_back(_objects[k]._object->_internal_transform);
+        delete _objects[k]._object;
+      }
+    }
+
+    _objects[num_kept++] = _objects[i];
+    i = j;
+  }
+
+  _objects.erase(_objects.begin() + num_kept, _objects.end());
+}
+
 /**
  * Draws all the geoms in the bin, in the appropriate order.
  */
@@ -70,14 +195,20 @@ void CullBinStateSorted::
 draw(bool force, Thread *current_thread) {
   PStatTimer timer(_draw_this_pcollector, current_thread);
 
+  _instance_states->next_frame();
+
   Objects::const_iterator oi;
   for (oi = _objects.begin(); oi != _objects.end(); ++oi) {
     CullableObject *object = (*oi)._object;
 
-    if (object->_draw_callback == nullptr) {
+    if (object->_instances != nullptr) {
+      object->draw_instances(_gsg, force, current_thread, _instance_states);
+
+    } else if (object->_draw_callback == nullptr) {
       nassertd(object->_geom != nullptr) continue;
 
-      _gsg->set_state_and_transform(object->_state, object->_internal_transform);
+      _gsg->set_state_delta_and_transform(object->_state, object->_internal_transform,
+                                          object->_prev_state, object->_changed_slots);
 
       GeomPipelineReader geom_reader(object->_geom, current_thread);
       GeomVertexDataPipelineReader data_reader(object->_munged_data, current_thread);
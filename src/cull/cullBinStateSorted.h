@@ -22,6 +22,9 @@
 #include "transformState.h"
 #include "renderState.h"
 #include "pointerTo.h"
+#include "simpleHashMap.h"
+#include "stl_compares.h"
+#include "radixSort.h"
 
 /**
  * A specific kind of CullBin that sorts geometry to collect items of the same
@@ -31,14 +34,27 @@
  * This also sorts objects front-to-back within a particular state, to take
  * advantage of hierarchical Z-buffer algorithms which can early-out when an
  * object appears behind another one.
+ *
+ * Everything the objects are sorted on is packed into a single 64-bit key
+ * when each object is added, so that finish_cull() can use a radix sort
+ * rather than comparing RenderStates for every pair of objects.
+ *
+ * If instancing is enabled for the bin, consecutive objects that draw the
+ * same Geom with the same state are collapsed into one instanced object after
+ * sorting; see CullBinManager::set_bin_instancing().
  */
 class EXPCL_PANDA_CULL CullBinStateSorted : public CullBin {
+protected:
+  INLINE CullBinStateSorted(const CullBinStateSorted &copy);
+
 public:
   INLINE CullBinStateSorted(const std::string &name,
                             GraphicsStateGuardianBase *gsg,
                             const PStatCollector &draw_region_pcollector);
   virtual ~CullBinStateSorted();
 
+  virtual PT(CullBin) make_next() const;
+
   static CullBin *make_bin(const std::string &name,
                            GraphicsStateGuardianBase *gsg,
                            const PStatCollector &draw_region_pcollector);
@@ -50,19 +66,57 @@ public:
 protected:
   virtual void fill_result_graph(ResultGraphBuilder &builder);
 
+private:
+  void collapse_instances();
+
 private:
   class ObjectData {
   public:
-    INLINE ObjectData(CullableObject *object);
-    INLINE bool operator < (const ObjectData &other) const;
+    INLINE ObjectData(CullableObject *object, uint64_t sort_key);
 
     CullableObject *_object;
-    const GeomVertexFormat *_format;
+    uint64_t _sort_key;
   };
 
   typedef pvector<ObjectData> Objects;
   Objects _objects;
 
+  // Shared with the bins made by make_next(), so that instanced batches can
+  // reuse their states from frame to frame.  Only draw() touches it.
+  PT(CullableObject::InstanceStates) _instance_states;
+
+  // The layout of the sort key, from the most significant bits down.  The
+  // state is stored first as the order in which it was first seen in this
+  // bin, and replaced with its rank in compare_sort() order by finish_cull().
+  // Indices that do not fit are clamped, which only makes the grouping a
+  // little less tight.  The lowest bits hold some bits of the transform
+  // pointer, or, if instancing is enabled, the Geom index, so that copies of
+  // the same Geom end up next to each other.
+  enum SortKeyLayout {
+    SK_state_shift = 48,
+    SK_format_shift = 38,
+    SK_data_shift = 16,
+    SK_transform_shift = 0,
+  };
+  static const uint64_t max_state_index = 0xffff;
+  static const uint64_t max_format_index = 0x3ff;
+  static const uint64_t max_data_index = 0x3fffff;
+  static const uint64_t max_geom_index = 0xffff;
+
+  typedef SimpleHashMap<const RenderState *, std::nullptr_t, pointer_hash> States;
+  typedef SimpleHashMap<const GeomVertexFormat *, std::nullptr_t, pointer_hash> Formats;
+  typedef SimpleHashMap<const GeomVertexData *, std::nullptr_t, pointer_hash> Datas;
+  typedef SimpleHashMap<const Geom *, std::nullptr_t, pointer_hash> Geoms;
+
+  template<class Indices, class Key>
+  INLINE static uint64_t get_index(Indices &indices, Key key,
+                                   uint64_t max_index);
+
+  States _states;
+  Formats _formats;
+  Datas _datas;
+  Geoms _geoms;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
@@ -15,6 +15,7 @@
 #include "cullHandler.h"
 #include "graphicsStateGuardianBase.h"
 #include "pStatTimer.h"
+#include "config_cull.h"
 
 
 TypeHandle CullBinUnsorted::_type_handle;
@@ -31,6 +32,15 @@ CullBinUnsorted::
   }
 }
 
+/**
+ * Returns a new, empty bin of the same type for next frame, sized for the
+ * number of objects in this one.
+ */
+PT(CullBin) CullBinUnsorted::
+make_next() const {
+  return new CullBinUnsorted(*this);
+}
+
 /**
  * Factory constructor for passing to the CullBinManager.
  */
@@ -45,6 +55,11 @@ make_bin(const std::string &name, GraphicsStateGuardianBase *gsg,
  */
 void CullBinUnsorted::
 add_object(CullableObject *object, Thread *current_thread) {
+  // The objects are drawn in the order they are added, so we can already tell
+  // which attributes will change from the previous object to this one.
+  if (cull_state_delta && !_objects.empty()) {
+    object->set_prev_state(_objects.back()->_state);
+  }
   _objects.push_back(object);
 }
 
@@ -62,7 +77,8 @@ draw(bool force, Thread *current_thread) {
     if (object->_draw_callback == nullptr) {
       nassertd(object->_geom != nullptr) continue;
 
-      _gsg->set_state_and_transform(object->_state, object->_internal_transform);
+      _gsg->set_state_delta_and_transform(object->_state, object->_internal_transform,
+                                          object->_prev_state, object->_changed_slots);
 
       GeomPipelineReader geom_reader(object->_geom, current_thread);
       GeomVertexDataPipelineReader data_reader(object->_munged_data, current_thread);
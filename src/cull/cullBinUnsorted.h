@@ -25,12 +25,17 @@
  * will be in scene-graph order.
  */
 class EXPCL_PANDA_CULL CullBinUnsorted : public CullBin {
+protected:
+  INLINE CullBinUnsorted(const CullBinUnsorted &copy);
+
 public:
   INLINE CullBinUnsorted(const std::string &name,
                          GraphicsStateGuardianBase *gsg,
                          const PStatCollector &draw_region_pcollector);
   ~CullBinUnsorted();
 
+  virtual PT(CullBin) make_next() const;
+
   static CullBin *make_bin(const std::string &name,
                            GraphicsStateGuardianBase *gsg,
                            const PStatCollector &draw_region_pcollector);
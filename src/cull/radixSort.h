@@ -0,0 +1,42 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file radixSort.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef RADIXSORT_H
+#define RADIXSORT_H
+
+#include "pandabase.h"
+#include "pvector.h"
+
+#include <algorithm>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Sorts the elements of the vector into ascending order of their 64-bit
+ * _sort_key member, using a least-significant-digit radix sort.  The sort is
+ * stable.  This is used by the sorting CullBins, which pack everything they
+ * sort on into a single integer key when the object is added, so that the
+ * sort itself does not need to look at the objects at all.
+ *
+ * Digits that are the same in every key are skipped, so the cost is
+ * proportional to the number of bytes in which the keys actually differ.
+ */
+template<class Element>
+void radix_sort(pvector<Element> &elements);
+
+INLINE uint32_t radix_sort_float_key(float value);
+
+#include "radixSort.I"
+#include "radixSort.T"
+
+#endif
@@ -0,0 +1,120 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_radix_sort.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "radixSort.h"
+#include "pnotify.h"
+
+#include <algorithm>
+#include <random>
+
+// This checks radix_sort() against std::stable_sort(), on both sides of the
+// size below which it uses an insertion sort instead: random keys, keys with
+// only a few distinct values, which must keep the elements that share a key
+// in their original order, keys that differ only in their top byte, so that
+// all the other digits are skipped, and keys made from floats of both signs
+// by radix_sort_float_key().
+
+static int num_failures = 0;
+
+static void
+check(bool condition, const char *message) {
+  if (!condition) {
+    nout << "FAILED: " << message << "\n";
+    ++num_failures;
+  }
+}
+
+class Element {
+public:
+  uint64_t _sort_key;
+  int _index;
+};
+
+typedef pvector<Element> Elements;
+
+static std::mt19937_64 rng(1);
+
+/**
+ * Returns true if radix_sort() puts the elements in the same order that
+ * std::stable_sort() does.  Each element is numbered by its original
+ * position, so that an unstable sort would be noticed.
+ */
+static bool
+sorts_like_stable_sort(Elements elements) {
+  for (size_t i = 0; i < elements.size(); ++i) {
+    elements[i]._index = (int)i;
+  }
+  Elements expected = elements;
+  std::stable_sort(expected.begin(), expected.end(),
+                   [](const Element &a, const Element &b) {
+    return a._sort_key < b._sort_key;
+  });
+
+  radix_sort(elements);
+  for (size_t i = 0; i < elements.size(); ++i) {
+    if (elements[i]._sort_key != expected[i]._sort_key ||
+        elements[i]._index != expected[i]._index) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void
+test_sizes(size_t size) {
+  Elements random(size), few(size), top(size), floats(size);
+  std::uniform_real_distribution<float> real(-1000.0f, 1000.0f);
+  for (size_t i = 0; i < size; ++i) {
+    random[i]._sort_key = rng();
+    few[i]._sort_key = rng() % 4;
+    top[i]._sort_key = (rng() % 256) << 56;
+    floats[i]._sort_key = radix_sort_float_key(real(rng));
+  }
+
+  check(sorts_like_stable_sort(random), "random keys sort");
+  check(sorts_like_stable_sort(few), "repeated keys keep their order");
+  check(sorts_like_stable_sort(top), "keys differing in the top byte sort");
+  check(sorts_like_stable_sort(floats), "float keys sort");
+}
+
+static void
+test_float_keys() {
+  static const float values[] = {
+    -1.0e30f, -2.5f, -1.0f, -1.0e-30f, 0.0f, 1.0e-30f, 1.0f, 2.5f, 1.0e30f,
+  };
+  static const size_t num_values = sizeof(values) / sizeof(values[0]);
+
+  bool ascending = true;
+  for (size_t i = 1; i < num_values; ++i) {
+    ascending = ascending &&
+      radix_sort_float_key(values[i - 1]) < radix_sort_float_key(values[i]);
+  }
+  check(ascending, "float keys are in the order of the floats");
+}
+
+int
+main(int argc, char *argv[]) {
+  static const size_t sizes[] = { 0, 1, 2, 31, 32, 33, 100, 5000 };
+  for (size_t size : sizes) {
+    test_sizes(size);
+  }
+  test_float_keys();
+
+  if (num_failures != 0) {
+    nout << num_failures << " checks failed.\n";
+    return 1;
+  }
+  nout << "All checks passed.\n";
+  return 0;
+}
@@ -19,6 +19,7 @@
     displayRegionCullCallbackData.I displayRegionCullCallbackData.h \
     displayRegionDrawCallbackData.I displayRegionDrawCallbackData.h \
     frameBufferProperties.I frameBufferProperties.h \
+    frameTimeline.I frameTimeline.h \
     get_x11.h pre_x11_include.h post_x11_include.h \
     graphicsEngine.I graphicsEngine.h \
     graphicsOutput.I graphicsOutput.h \
@@ -60,6 +61,7 @@
     displaySearchParameters.cxx \
     displayInformation.cxx \
     frameBufferProperties.cxx \
+    frameTimeline.cxx \
     graphicsEngine.cxx \
     graphicsOutput.cxx \
     graphicsBuffer.cxx \
@@ -91,6 +93,7 @@
     displayRegionDrawCallbackData.I displayRegionDrawCallbackData.h \
     displaySearchParameters.h \
     frameBufferProperties.I frameBufferProperties.h \
+    frameTimeline.I frameTimeline.h \
     get_x11.h pre_x11_include.h post_x11_include.h \
     graphicsEngine.I graphicsEngine.h \
     graphicsOutput.I graphicsOutput.h \
@@ -130,3 +133,53 @@
     windowProperties_ext.h
 
 #end lib_target
+
+#begin test_bin_target
+  #define TARGET test_threaded_cull
+  #define LOCAL_LIBS \
+    p3display p3cull p3pgraph p3gobj p3putil p3express p3pstatclient
+
+  #define SOURCES \
+    test_threaded_cull.cxx
+
+#end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_frame_timeline
+  #define LOCAL_LIBS \
+    p3display p3putil p3express
+
+  #define SOURCES \
+    test_frame_timeline.cxx
+
+#end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_clustered_geom
+  #define LOCAL_LIBS \
+    p3display p3pgraph p3gobj p3putil p3express
+
+  #define SOURCES \
+    test_clustered_geom.cxx
+
+#end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_instanced_bin
+  #define LOCAL_LIBS \
+    p3display p3cull p3pgraph p3gobj p3putil p3express
+
+  #define SOURCES \
+    test_instanced_bin.cxx
+
+#end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_retained_cull
+  #define LOCAL_LIBS \
+    p3display p3pgraph p3gobj p3putil p3express
+
+  #define SOURCES \
+    test_retained_cull.cxx
+
+#end test_bin_target
@@ -65,7 +65,10 @@ ConfigVariableString threading_model
 ("threading-model", "",
  PRC_DESC("This is the default threading model to use for new windows.  Use "
           "empty string for single-threaded, or something like \"cull/draw\" for "
-          "a 3-stage pipeline.  See GraphicsEngine::set_threading_model(). "
+          "a 3-stage pipeline.  Append a colon and a number, as in "
+          "\"cull/draw:4\", to cull separate display regions in parallel on "
+          "that many additional threads.  See "
+          "GraphicsEngine::set_threading_model().  "
           "EXPERIMENTAL and incomplete, do not use this!"));
 
 ConfigVariableBool allow_nonpipeline_threads
@@ -100,6 +103,19 @@ ConfigVariableBool yield_timeslice
  PRC_DESC("Set this true to yield the timeslice at the end of the frame to be "
           "more polite to other applications that are trying to run."));
 
+ConfigVariableInt frame_timeline_size
+("frame-timeline-size", 120,
+ PRC_DESC("The number of recent frames for which the GraphicsEngine records "
+          "the start and end time of each stage in its FrameTimeline.  Set "
+          "this to 0 to disable the recording."));
+
+ConfigVariableDouble frame_pacing_interval
+("frame-pacing-interval", 0.0,
+ PRC_DESC("If this is greater than zero, render_frame() waits at its end until "
+          "this many seconds have passed since the previous frame, so that "
+          "frames that are rendered faster than this are evenly spaced.  "
+          "See FrameTimeline::set_target_interval()."));
+
 ConfigVariableDouble subprocess_window_max_wait
 ("subprocess-window-max-wait", 0.2,
  PRC_DESC("This is the amount of time, in seconds, that the SubprocessWindow will "
@@ -729,7 +729,8 @@ CData() :
   _stereo_channel(Lens::SC_mono),
   _tex_view_offset(0),
   _target_tex_page(-1),
-  _scissor_enabled(true)
+  _scissor_enabled(true),
+  _retained_cull(false)
 {
   _regions.push_back(Region());
 }
@@ -748,7 +749,9 @@ CData(const DisplayRegion::CData &copy) :
   _stereo_channel(copy._stereo_channel),
   _tex_view_offset(copy._tex_view_offset),
   _target_tex_page(copy._target_tex_page),
-  _scissor_enabled(copy._scissor_enabled)
+  _scissor_enabled(copy._scissor_enabled),
+  _retained_cull(copy._retained_cull),
+  _cull_stale_seq(copy._cull_stale_seq)
 {
 }
 
@@ -768,6 +771,32 @@ make_copy() const {
   return new CDataCull(*this);
 }
 
+/**
+ * Captures the inputs of the cull traversal described by the indicated
+ * SceneSetup.  The scene graph is represented by the bounds sequence number
+ * of its root node, which changes whenever anything below it changes.
+ */
+DisplayRegion::CullVersion::
+CullVersion(const SceneSetup *scene_setup, UpdateSeq stale_seq,
+            Thread *current_thread) :
+  _stale_seq(stale_seq),
+  _camera_transform(scene_setup->get_camera_transform()),
+  _initial_state(scene_setup->get_initial_state()),
+  _camera_node(scene_setup->get_camera_node()),
+  _camera_mask(DrawMask::all_on())
+{
+  PandaNode *scene_root = scene_setup->get_scene_root().node();
+  scene_root->get_bounds(_scene_seq, current_thread);
+
+  const Lens *lens = scene_setup->get_lens();
+  if (lens != nullptr) {
+    _lens_seq = lens->get_last_change();
+  }
+  if (_camera_node != nullptr) {
+    _camera_mask = _camera_node->get_camera_mask();
+  }
+}
+
 /**
  * Returns the GraphicsPipe that this DisplayRegion is ultimately associated
  * with, or NULL if no pipe is associated.
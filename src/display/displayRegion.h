@@ -38,6 +38,7 @@
 #include "callbackObject.h"
 #include "luse.h"
 #include "epvector.h"
+#include "updateSeq.h"
 
 class GraphicsOutput;
 class GraphicsPipe;
@@ -145,6 +146,11 @@ PUBLISHED:
   INLINE CallbackObject *get_draw_callback() const;
   MAKE_PROPERTY(draw_callback, get_draw_callback, set_draw_callback);
 
+  INLINE void set_retained_cull(bool retained_cull);
+  INLINE bool get_retained_cull() const;
+  MAKE_PROPERTY(retained_cull, get_retained_cull, set_retained_cull);
+  INLINE void mark_cull_stale();
+
   INLINE int get_pixel_width(int i = 0) const;
   INLINE int get_pixel_height(int i = 0) const;
   INLINE LVecBase2i get_pixel_size(int i = 0) const;
@@ -176,10 +182,37 @@ public:
 
   virtual bool supports_pixel_zoom() const;
 
+  // Identifies the inputs to a cull traversal: the scene graph, as of its
+  // bounding volume sequence number, and the camera it was viewed from.  A
+  // DisplayRegion with retained_cull set keeps drawing its last cull result
+  // for as long as these stay the same.
+  class EXPCL_PANDA_DISPLAY CullVersion {
+  public:
+    INLINE CullVersion();
+    CullVersion(const SceneSetup *scene_setup, UpdateSeq stale_seq,
+                Thread *current_thread);
+
+    INLINE bool operator == (const CullVersion &other) const;
+    INLINE bool operator != (const CullVersion &other) const;
+
+  private:
+    UpdateSeq _scene_seq;
+    UpdateSeq _lens_seq;
+    UpdateSeq _stale_seq;
+    CPT(TransformState) _camera_transform;
+    CPT(RenderState) _initial_state;
+    // A reference is held so that another camera can't take over the same
+    // address while this version is still around to be compared.
+    CPT(Camera) _camera_node;
+    DrawMask _camera_mask;
+  };
+
   INLINE void set_cull_result(PT(CullResult) cull_result, PT(SceneSetup) scene_setup,
-                              Thread *current_thread);
+                              Thread *current_thread,
+                              const CullVersion &cull_version = CullVersion());
   INLINE CullResult *get_cull_result(Thread *current_thread) const;
   INLINE SceneSetup *get_scene_setup(Thread *current_thread) const;
+  INLINE CullVersion get_cull_version(Thread *current_thread) const;
 
   INLINE PStatCollector &get_cull_region_pcollector();
   INLINE PStatCollector &get_draw_region_pcollector();
@@ -244,6 +277,8 @@ private:
     int _tex_view_offset;
     int _target_tex_page;
     bool _scissor_enabled;
+    bool _retained_cull;
+    UpdateSeq _cull_stale_seq;
 
     PT(CallbackObject) _cull_callback;
     PT(CallbackObject) _draw_callback;
@@ -272,6 +307,7 @@ private:
 
     PT(CullResult) _cull_result;
     PT(SceneSetup) _scene_setup;
+    CullVersion _cull_version;
   };
   PipelineCycler<CDataCull> _cycler_cull;
   typedef CycleDataReader<CDataCull> CDCullReader;
@@ -344,6 +380,8 @@ public:
   INLINE int get_target_tex_page() const;
   INLINE bool get_scissor_enabled() const;
   INLINE CallbackObject *get_draw_callback() const;
+  INLINE bool get_retained_cull() const;
+  INLINE UpdateSeq get_cull_stale_seq() const;
 
   INLINE void get_pixels(int &pl, int &pr, int &pb, int &pt) const;
   INLINE void get_pixels(int i, int &pl, int &pr, int &pb, int &pt) const;
@@ -0,0 +1,243 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file frameTimeline.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "frameTimeline.h"
+#include "lightMutexHolder.h"
+#include "trueClock.h"
+#include "thread.h"
+
+/**
+ *
+ */
+FrameTimeline::
+FrameTimeline(int max_frames) :
+  _newest_frame(-1),
+  _last_flipped_frame(-1),
+  _target_interval(0.0),
+  _last_pace_time(-1.0)
+{
+  _frames.resize(std::max(max_frames, 0));
+}
+
+/**
+ * Changes the number of recent frames that are retained.  This also discards
+ * the frames that have been recorded so far.
+ */
+void FrameTimeline::
+set_max_frames(int max_frames) {
+  LightMutexHolder holder(_lock);
+  _frames.clear();
+  _frames.resize(std::max(max_frames, 0));
+  _newest_frame = -1;
+  _last_flipped_frame = -1;
+}
+
+/**
+ * Discards the frames that have been recorded so far.
+ */
+void FrameTimeline::
+clear() {
+  LightMutexHolder holder(_lock);
+  std::fill(_frames.begin(), _frames.end(), Frame());
+  _newest_frame = -1;
+  _last_flipped_frame = -1;
+}
+
+/**
+ * Returns the number of frames for which at least one stage has been
+ * recorded and which are still retained.
+ */
+int FrameTimeline::
+get_num_frames() const {
+  Frames frames;
+  get_recent_frames(frames);
+  return (int)frames.size();
+}
+
+/**
+ * Returns the nth of the retained frames, counting from the oldest.
+ */
+FrameTimeline::Frame FrameTimeline::
+get_frame(int n) const {
+  Frames frames;
+  get_recent_frames(frames);
+  nassertr(n >= 0 && n < (int)frames.size(), Frame());
+  return frames[n];
+}
+
+/**
+ * Looks up the record of the indicated frame number.  Returns true and fills
+ * in frame if it is still retained, or false if it is not.
+ */
+bool FrameTimeline::
+find_frame(int frame_number, Frame &frame) const {
+  LightMutexHolder holder(_lock);
+  if (_frames.empty() || frame_number < 0) {
+    return false;
+  }
+  const Frame &slot = _frames[frame_number % _frames.size()];
+  if (slot._frame_number != frame_number) {
+    return false;
+  }
+  frame = slot;
+  return true;
+}
+
+/**
+ * Records that the indicated stage of the indicated frame ran from start to
+ * end.  This may be called from any thread, and may be called more than once
+ * for the same stage of the same frame; the stage then spans all of the
+ * recorded intervals.
+ */
+void FrameTimeline::
+record_stage(Stage stage, int frame_number, double start, double end) {
+  nassertv(stage >= 0 && stage < S_num_stages);
+
+  LightMutexHolder holder(_lock);
+  do_record_stage(stage, frame_number, start, end);
+}
+
+/**
+ * Records that a flip ran from start to end.  The flip is attributed to the
+ * most recent frame whose draw stage has been recorded, since that is the
+ * frame that the flip shows; the thread that performs the flip may already be
+ * working on a later frame.
+ *
+ * This is only right for a flip that happens outside of the draw stage, such
+ * as one deferred to the start of the next draw.  A flip performed while the
+ * draw stage of its frame is still open must use the other overload, since
+ * that frame's draw has not been recorded yet.
+ */
+void FrameTimeline::
+record_flip(double start, double end) {
+  LightMutexHolder holder(_lock);
+  int num_slots = (int)_frames.size();
+  int first = std::max(_newest_frame - num_slots + 1, 0);
+  for (int frame_number = _newest_frame; frame_number >= first; --frame_number) {
+    const Frame &frame = _frames[frame_number % num_slots];
+    if (frame._frame_number == frame_number && frame._end[S_draw] >= 0.0) {
+      do_record_stage(S_flip, frame_number, start, end);
+      return;
+    }
+  }
+}
+
+/**
+ * Records that the flip of the indicated frame ran from start to end.
+ */
+void FrameTimeline::
+record_flip(int frame_number, double start, double end) {
+  LightMutexHolder holder(_lock);
+  do_record_stage(S_flip, frame_number, start, end);
+}
+
+/**
+ * Fills in the indicated vector with all of the retained frames, from the
+ * oldest to the newest.
+ */
+void FrameTimeline::
+get_recent_frames(Frames &frames) const {
+  frames.clear();
+
+  LightMutexHolder holder(_lock);
+  int num_slots = (int)_frames.size();
+  if (num_slots == 0 || _newest_frame < 0) {
+    return;
+  }
+
+  frames.reserve(num_slots);
+  int first = std::max(_newest_frame - num_slots + 1, 0);
+  for (int frame_number = first; frame_number <= _newest_frame; ++frame_number) {
+    const Frame &frame = _frames[frame_number % num_slots];
+    if (frame._frame_number == frame_number) {
+      frames.push_back(frame);
+    }
+  }
+}
+
+/**
+ * The implementation of record_stage().  Assumes the lock is held.
+ */
+void FrameTimeline::
+do_record_stage(Stage stage, int frame_number, double start, double end) {
+  if (_frames.empty() || frame_number < 0) {
+    return;
+  }
+
+  Frame &frame = _frames[frame_number % _frames.size()];
+  if (frame._frame_number != frame_number) {
+    if (frame._frame_number > frame_number) {
+      // This frame is too old to be retained.
+      return;
+    }
+    frame = Frame();
+    frame._frame_number = frame_number;
+  }
+
+  if (frame._start[stage] < 0.0 || start < frame._start[stage]) {
+    frame._start[stage] = start;
+  }
+  if (end > frame._end[stage]) {
+    frame._end[stage] = end;
+  }
+  _newest_frame = std::max(_newest_frame, frame_number);
+  if (stage == S_flip) {
+    _last_flipped_frame = std::max(_last_flipped_frame, frame_number);
+  }
+}
+
+/**
+ * Called by the GraphicsEngine at the end of each frame.  If a target
+ * interval has been set, waits until that much time has passed since the
+ * previous frame was paced.  Returns the number of seconds spent waiting.
+ */
+double FrameTimeline::
+pace_frame() {
+  if (_target_interval <= 0.0) {
+    _last_pace_time = -1.0;
+    return 0.0;
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double now = clock->get_short_time();
+  if (_last_pace_time < 0.0) {
+    _last_pace_time = now;
+    return 0.0;
+  }
+
+  double target = _last_pace_time + _target_interval;
+  if (now >= target) {
+    if (now - target > _target_interval) {
+      // We have fallen more than a whole frame behind; don't try to catch
+      // up, just start over from here.
+      _last_pace_time = now;
+    } else {
+      _last_pace_time = target;
+    }
+    return 0.0;
+  }
+
+  // Sleep through most of the remaining time, but the scheduler can't be
+  // trusted to wake us up precisely, so yield for the last bit.
+  double start = now;
+  static const double spin_time = 0.002;
+  if (target - now > spin_time) {
+    Thread::sleep(target - now - spin_time);
+  }
+  while (clock->get_short_time() < target) {
+    Thread::force_yield();
+  }
+
+  _last_pace_time = target;
+  return target - start;
+}
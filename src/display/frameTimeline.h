@@ -0,0 +1,142 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file frameTimeline.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef FRAMETIMELINE_H
+#define FRAMETIMELINE_H
+
+#include "pandabase.h"
+#include "referenceCount.h"
+#include "lightMutex.h"
+#include "pvector.h"
+#include "trueClock.h"
+#include "clockObject.h"
+
+/**
+ * Records, for each of the most recent frames, when each stage of the frame
+ * (app, cull, draw and flip) began and ended, regardless of which thread
+ * performed it.  In a pipelined threading model, the stages of one frame are
+ * processed by different threads in successive calls to render_frame(), so
+ * this is the only place where the full life of a frame, from the start of
+ * app to the flip that shows it, can be seen.
+ *
+ * The GraphicsEngine owns one of these, and fills it in as it renders.  It may
+ * also be asked to pace the frames, by waiting at the end of render_frame()
+ * until a fixed interval has elapsed since the previous frame.
+ *
+ * All times are in seconds, as reported by TrueClock::get_short_time().
+ */
+class EXPCL_PANDA_DISPLAY FrameTimeline : public ReferenceCount {
+PUBLISHED:
+  enum Stage {
+    S_app,
+    S_cull,
+    S_draw,
+    S_flip,
+    S_num_stages
+  };
+
+  class EXPCL_PANDA_DISPLAY Frame {
+  public:
+    INLINE Frame();
+
+  PUBLISHED:
+    INLINE int get_frame_number() const;
+    INLINE bool has_stage(Stage stage) const;
+    INLINE double get_start(Stage stage) const;
+    INLINE double get_end(Stage stage) const;
+    INLINE double get_duration(Stage stage) const;
+    INLINE double get_latency() const;
+
+    MAKE_PROPERTY(frame_number, get_frame_number);
+    MAKE_PROPERTY(latency, get_latency);
+
+  public:
+    int _frame_number;
+    double _start[S_num_stages];
+    double _end[S_num_stages];
+  };
+
+  explicit FrameTimeline(int max_frames = 120);
+
+  void set_max_frames(int max_frames);
+  INLINE int get_max_frames() const;
+  MAKE_PROPERTY(max_frames, get_max_frames, set_max_frames);
+
+  void clear();
+
+  int get_num_frames() const;
+  Frame get_frame(int n) const;
+  bool find_frame(int frame_number, Frame &frame) const;
+
+  INLINE void set_target_interval(double target_interval);
+  INLINE double get_target_interval() const;
+  MAKE_PROPERTY(target_interval, get_target_interval, set_target_interval);
+
+public:
+  typedef pvector<Frame> Frames;
+
+  void record_stage(Stage stage, int frame_number, double start, double end);
+  void record_flip(double start, double end);
+  void record_flip(int frame_number, double start, double end);
+  void get_recent_frames(Frames &frames) const;
+  INLINE int get_last_flipped_frame() const;
+  double pace_frame();
+
+  // Records the time between its construction and destruction as the
+  // indicated stage of the frame that the current thread is processing.
+  class StageTimer {
+  public:
+    INLINE StageTimer(FrameTimeline *timeline, Stage stage,
+                      Thread *current_thread);
+    INLINE ~StageTimer();
+
+    INLINE int get_frame_number() const;
+
+  private:
+    FrameTimeline *_timeline;
+    Stage _stage;
+    int _frame_number;
+    double _start;
+  };
+
+  // Records the time between its construction and destruction as the flip
+  // of the indicated frame, or of the most recently drawn frame if the frame
+  // number is -1.
+  class FlipTimer {
+  public:
+    INLINE FlipTimer(FrameTimeline *timeline, int frame_number = -1);
+    INLINE ~FlipTimer();
+
+  private:
+    FrameTimeline *_timeline;
+    int _frame_number;
+    double _start;
+  };
+
+private:
+  void do_record_stage(Stage stage, int frame_number, double start, double end);
+
+  // A ring buffer, indexed by frame number modulo its size.
+  Frames _frames;
+  int _newest_frame;
+  int _last_flipped_frame;
+
+  double _target_interval;
+  double _last_pace_time;
+
+  mutable LightMutex _lock;
+};
+
+#include "frameTimeline.I"
+
+#endif
@@ -81,6 +81,9 @@ PStatCollector GraphicsEngine::_sync_pcollector("Draw:Sync");
 PStatCollector GraphicsEngine::_flip_pcollector("Wait:Flip");
 PStatCollector GraphicsEngine::_flip_begin_pcollector("Wait:Flip:Begin");
 PStatCollector GraphicsEngine::_flip_end_pcollector("Wait:Flip:End");
+PStatCollector GraphicsEngine::_frame_pacing_pcollector("Wait:Frame pacing");
+PStatCollector GraphicsEngine::_frame_latency_pcollector("Frame latency");
+PStatCollector GraphicsEngine::_pipeline_depth_pcollector("Pipeline depth");
 PStatCollector GraphicsEngine::_transform_states_pcollector("TransformStates");
 PStatCollector GraphicsEngine::_transform_states_unused_pcollector("TransformStates:Unused");
 PStatCollector GraphicsEngine::_render_states_pcollector("RenderStates");
@@ -98,6 +101,9 @@ PStatCollector GraphicsEngine::_vertex_data_resident_pcollector("Vertex Data:Res
 PStatCollector GraphicsEngine::_vertex_data_compressed_pcollector("Vertex Data:Compressed");
 PStatCollector GraphicsEngine::_vertex_data_unused_disk_pcollector("Vertex Data:Disk:Unused");
 PStatCollector GraphicsEngine::_vertex_data_used_disk_pcollector("Vertex Data:Disk:Used");
+PStatCollector GraphicsEngine::_vertex_paging_compress_in_pcollector("Vertex Paging:Compress input");
+PStatCollector GraphicsEngine::_vertex_paging_compress_out_pcollector("Vertex Paging:Compress output");
+PStatCollector GraphicsEngine::_vertex_paging_decompress_pcollector("Vertex Paging:Decompress output");
 
 // These are counted independently by the collision system; we redefine them
 // here so we can reset them at each frame.
@@ -152,6 +158,8 @@ GraphicsEngine::
 GraphicsEngine(Pipeline *pipeline) :
   _pipeline(pipeline),
   _app("app"),
+  _cull_workers_lock("GraphicsEngine::_cull_workers_lock"),
+  _cull_workers_cvar(_cull_workers_lock),
   _lock("GraphicsEngine::_lock"),
   _loaded_textures_lock("GraphicsEngine::_loaded_textures_lock")
 {
@@ -173,6 +181,15 @@ GraphicsEngine(Pipeline *pipeline) :
 
   _singular_warning_last_frame = false;
   _singular_warning_this_frame = false;
+  _cull_workers_shutdown = false;
+
+  _frame_timeline = new FrameTimeline(frame_timeline_size);
+  _frame_timeline->set_target_interval(frame_pacing_interval);
+  _app_start_time = -1.0;
+
+  _last_vertex_compress_input = VertexDataPage::get_total_compress_input();
+  _last_vertex_compress_output = VertexDataPage::get_total_compress_output();
+  _last_vertex_decompress_output = VertexDataPage::get_total_decompress_output();
 }
 
 /**
@@ -728,6 +745,15 @@ render_frame() {
 
   ClockObject *global_clock = ClockObject::get_global_clock();
 
+  // Everything since the last call to render_frame() returned was the App
+  // stage of the current frame.
+  TrueClock *true_clock = TrueClock::get_global_ptr();
+  if (_app_start_time >= 0.0) {
+    _frame_timeline->record_stage(FrameTimeline::S_app,
+                                  global_clock->get_frame_count(current_thread),
+                                  _app_start_time, true_clock->get_short_time());
+  }
+
   if (display_cat.is_spam()) {
     display_cat.spam()
       << "render_frame() - frame " << global_clock->get_frame_count() << "\n";
@@ -851,10 +877,26 @@ render_frame() {
 #ifdef DO_PSTATS
     PStatClient::main_tick();
 
+    // Report how long it took from the start of the most recently shown frame
+    // to the flip that showed it, and how many frames are in flight.
+    int flipped_frame = _frame_timeline->get_last_flipped_frame();
+    if (flipped_frame >= 0) {
+      FrameTimeline::Frame frame;
+      if (_frame_timeline->find_frame(flipped_frame, frame) &&
+          frame.has_stage(FrameTimeline::S_app)) {
+        _frame_latency_pcollector.set_level(frame.get_latency());
+      }
+      _pipeline_depth_pcollector.set_level(
+        global_clock->get_frame_count(current_thread) - flipped_frame);
+    }
+
     // Reset our pcollectors that track data across the frame.
     CullTraverser::_nodes_pcollector.clear_level();
     CullTraverser::_geom_nodes_pcollector.clear_level();
     CullTraverser::_geoms_pcollector.clear_level();
+    CullTraverser::_clusters_pcollector.clear_level();
+    CullTraverser::_clusters_culled_pcollector.clear_level();
+    CullResult::_arena_pcollector.clear_level();
     GeomCacheManager::_geom_cache_active_pcollector.clear_level();
     GeomCacheManager::_geom_cache_record_pcollector.clear_level();
     GeomCacheManager::_geom_cache_erase_pcollector.clear_level();
@@ -914,6 +956,19 @@ render_frame() {
       _vertex_data_compressed_pcollector.set_level(compressed);
       _vertex_data_unused_disk_pcollector.set_level(total_disk - used_disk);
       _vertex_data_used_disk_pcollector.set_level(used_disk);
+
+      // Report the number of bytes the vertex pager has pushed through the
+      // compressor since the last frame.  Divided by the Compress and
+      // Decompress times, this gives the codec throughput.
+      size_t compress_input = VertexDataPage::get_total_compress_input();
+      size_t compress_output = VertexDataPage::get_total_compress_output();
+      size_t decompress_output = VertexDataPage::get_total_decompress_output();
+      _vertex_paging_compress_in_pcollector.set_level(compress_input - _last_vertex_compress_input);
+      _vertex_paging_compress_out_pcollector.set_level(compress_output - _last_vertex_compress_output);
+      _vertex_paging_decompress_pcollector.set_level(decompress_output - _last_vertex_decompress_output);
+      _last_vertex_compress_input = compress_input;
+      _last_vertex_compress_output = compress_output;
+      _last_vertex_decompress_output = decompress_output;
     }
 
 #endif  // DO_PSTATS
@@ -948,6 +1003,14 @@ render_frame() {
     Thread::consider_yield();
   }
 
+  if (_frame_timeline->get_target_interval() > 0.0) {
+    // Hold the frame rate steady, so that the time between the start of App
+    // and the flip doesn't vary from frame to frame.
+    PStatTimer timer(_frame_pacing_pcollector, current_thread);
+    _frame_timeline->pace_frame();
+  }
+  _app_start_time = true_clock->get_short_time();
+
   // Anything that happens outside of GraphicsEngine::render_frame() is deemed
   // to be App.
   _app_pcollector.start();
@@ -1402,12 +1465,15 @@ void GraphicsEngine::
 cull_and_draw_together(GraphicsEngine::Windows wlist,
                        Thread *current_thread) {
   PStatTimer timer(_cull_pcollector, current_thread);
+  FrameTimeline::StageTimer stage_timer(_frame_timeline, FrameTimeline::S_draw,
+                                        current_thread);
 
   size_t wlist_size = wlist.size();
   for (size_t wi = 0; wi < wlist_size; ++wi) {
     GraphicsOutput *win = wlist[wi];
     if (win->is_active() && win->get_gsg()->is_active()) {
       if (win->flip_ready()) {
+        FrameTimeline::FlipTimer flip_timer(_frame_timeline);
         {
           PStatTimer timer(GraphicsEngine::_flip_begin_pcollector, current_thread);
           win->begin_flip();
@@ -1438,6 +1504,9 @@ cull_and_draw_together(GraphicsEngine::Windows wlist,
 
         if (_auto_flip) {
           if (win->flip_ready()) {
+            // The draw stage of this frame is still open, so name the frame.
+            FrameTimeline::FlipTimer flip_timer(_frame_timeline,
+                                                stage_timer.get_frame_number());
             {
               PStatTimer timer(GraphicsEngine::_flip_begin_pcollector, current_thread);
               win->begin_flip();
@@ -1521,15 +1590,22 @@ cull_and_draw_together(GraphicsOutput *win, DisplayRegion *dr,
 void GraphicsEngine::
 cull_to_bins(GraphicsEngine::Windows wlist, Thread *current_thread) {
   PStatTimer timer(_cull_pcollector, current_thread);
+  FrameTimeline::StageTimer stage_timer(_frame_timeline, FrameTimeline::S_cull,
+                                        current_thread);
 
   _singular_warning_last_frame = _singular_warning_this_frame;
   _singular_warning_this_frame = false;
 
   // Keep track of the cameras we have already used in this thread to render
-  // DisplayRegions.
-  typedef pmap<CullKey, DisplayRegion *> AlreadyCulled;
+  // DisplayRegions, by the index of the job that culls them.
+  typedef pmap<CullKey, int> AlreadyCulled;
   AlreadyCulled already_culled;
 
+  // The DisplayRegions to cull, in the order in which their results are to be
+  // saved.
+  CullJobs jobs;
+  int num_threads = 0;
+
   // We cull shadow passes last; whether we cull them depends on whether their
   // respective frusta are in view of a "normal" camera.
   pvector<PT(SceneSetup)> shadow_passes;
@@ -1540,14 +1616,15 @@ cull_to_bins(GraphicsEngine::Windows wlist, Thread *current_thread) {
     GraphicsOutput *win = wlist[wi];
     if (win->is_active() && win->get_gsg()->is_active()) {
       GraphicsStateGuardian *gsg = win->get_gsg();
-      PStatTimer timer(win->get_cull_window_pcollector(), current_thread);
+      num_threads = std::max(num_threads, gsg->get_threading_model().get_num_cull_threads());
       int num_display_regions = win->get_num_active_display_regions();
       for (int i = 0; i < num_display_regions; ++i) {
         PT(DisplayRegion) dr = win->get_active_display_region(i);
         if (dr != nullptr) {
           PT(SceneSetup) scene_setup;
-          PT(CullResult) cull_result;
           CullKey key;
+          bool retained_cull;
+          UpdateSeq cull_stale_seq;
           {
             PStatTimer timer(_cull_setup_pcollector, current_thread);
             DisplayRegionPipelineReader dr_reader(dr, current_thread);
@@ -1559,6 +1636,8 @@ cull_to_bins(GraphicsEngine::Windows wlist, Thread *current_thread) {
             key._gsg = gsg;
             key._camera = dr_reader.get_camera();
             key._lens_index = dr_reader.get_lens_index();
+            retained_cull = dr_reader.get_retained_cull();
+            cull_stale_seq = dr_reader.get_cull_stale_seq();
           }
 
           // If this is a shadow pass, postpone culling it until we've culled
@@ -1582,19 +1661,34 @@ cull_to_bins(GraphicsEngine::Windows wlist, Thread *current_thread) {
             }
           }
 
-          AlreadyCulled::iterator aci = already_culled.insert(AlreadyCulled::value_type(std::move(key), nullptr)).first;
-          if ((*aci).second == nullptr) {
+          CullJob job;
+          job._win = win;
+          job._gsg = gsg;
+          job._dr = dr;
+          job._source_job = -1;
+          job._retained = false;
+          if (retained_cull) {
+            job._cull_version =
+              DisplayRegion::CullVersion(scene_setup, cull_stale_seq, current_thread);
+          }
+          job._scene_setup = std::move(scene_setup);
+
+          AlreadyCulled::iterator aci = already_culled.insert(AlreadyCulled::value_type(std::move(key), -1)).first;
+          if ((*aci).second == -1) {
             // We have not used this camera already in this thread.  Perform
-            // the cull operation.
-            cull_result = dr->get_cull_result(current_thread);
-            if (cull_result != nullptr) {
-              cull_result = cull_result->make_next();
+            // the cull operation, unless the previous result is still good.
+            PT(CullResult) cull_result = dr->get_cull_result(current_thread);
+            if (cull_result != nullptr && retained_cull &&
+                dr->get_cull_version(current_thread) == job._cull_version) {
+              job._cull_result = std::move(cull_result);
+              job._retained = true;
+            } else if (cull_result != nullptr) {
+              job._cull_result = cull_result->make_next();
             } else {
               // This DisplayRegion has no cull results; draw it.
-              cull_result = new CullResult(gsg, dr->get_draw_region_pcollector());
+              job._cull_result = new CullResult(gsg, dr->get_draw_region_pcollector());
             }
-            (*aci).second = dr;
-            cull_to_bins(win, gsg, dr, scene_setup, cull_result, current_thread);
+            (*aci).second = (int)jobs.size();
 
           } else {
             // We have already culled a scene using this camera in this
@@ -1603,12 +1697,10 @@ cull_to_bins(GraphicsEngine::Windows wlist, Thread *current_thread) {
             // DisplayRegions for the left and right channels of a stereo
             // image.)  Of course, the cull result will be the same, so just
             // use the result from the other DisplayRegion.
-            DisplayRegion *other_dr = (*aci).second;
-            cull_result = other_dr->get_cull_result(current_thread);
+            job._source_job = (*aci).second;
           }
 
-          // Save the results for next frame.
-          dr->set_cull_result(std::move(cull_result), std::move(scene_setup), current_thread);
+          jobs.push_back(std::move(job));
         }
       }
     }
@@ -1619,24 +1711,25 @@ cull_to_bins(GraphicsEngine::Windows wlist, Thread *current_thread) {
   // only one output per GSG+light combination.
   for (PT(SceneSetup) &scene_setup : shadow_passes) {
     DisplayRegion *dr = scene_setup->get_display_region();
-    GraphicsOutput *win = dr->get_window();
-    PStatTimer timer(win->get_cull_window_pcollector(), current_thread);
 
-    PT(CullResult) cull_result;
+    CullJob job;
+    job._win = dr->get_window();
+    job._gsg = job._win->get_gsg();
+    job._dr = dr;
+    job._source_job = -1;
+    job._retained = false;
 
     // Are the cull bounds in view of another camera?
     GeometricBoundingVolume *frustum = scene_setup->get_view_frustum();
     if (frustum == nullptr ||
         non_shadow_bounds[scene_setup->get_scene_root()].contains(frustum)) {
-      GraphicsStateGuardian *gsg = win->get_gsg();
-      cull_result = dr->get_cull_result(current_thread);
+      PT(CullResult) cull_result = dr->get_cull_result(current_thread);
       if (cull_result != nullptr) {
-        cull_result = cull_result->make_next();
+        job._cull_result = cull_result->make_next();
       } else {
         // This DisplayRegion has no cull results; draw it.
-        cull_result = new CullResult(gsg, dr->get_draw_region_pcollector());
+        job._cull_result = new CullResult(job._gsg, dr->get_draw_region_pcollector());
       }
-      cull_to_bins(win, gsg, dr, scene_setup, cull_result, current_thread);
     }
     else if (display_cat.is_spam()) {
       display_cat.spam()
@@ -1644,9 +1737,138 @@ cull_to_bins(GraphicsEngine::Windows wlist, Thread *current_thread) {
         << " frustum is not in view, skipping shadow pass\n";
     }
 
-    // Even save the results if null, to tell the draw pass that we don't want
-    // to draw this at all.
-    dr->set_cull_result(std::move(cull_result), std::move(scene_setup), current_thread);
+    job._scene_setup = std::move(scene_setup);
+    jobs.push_back(std::move(job));
+  }
+
+  run_cull_jobs(jobs, num_threads, current_thread);
+
+  // Save the results for next frame, in the original order.  Even save the
+  // results of a skipped shadow pass if null, to tell the draw pass that we
+  // don't want to draw this at all.
+  for (CullJob &job : jobs) {
+    if (job._source_job != -1) {
+      job._cull_result = jobs[job._source_job]._cull_result;
+    }
+    job._dr->set_cull_result(std::move(job._cull_result), std::move(job._scene_setup),
+                             current_thread, job._cull_version);
+  }
+}
+
+/**
+ * Performs the culls collected by cull_to_bins().  If the threading model
+ * allows it, and there is more than one, they are spread over the
+ * CullWorkers, with the calling thread taking its share; this does not
+ * return until all of them are finished.
+ */
+void GraphicsEngine::
+run_cull_jobs(CullJobs &jobs, int num_threads, Thread *current_thread) {
+  CullBatch batch;
+  batch._next_job = 0;
+  batch._pipeline_stage = current_thread->get_pipeline_stage();
+  for (CullJob &job : jobs) {
+    if (job._source_job == -1 && job._cull_result != nullptr && !job._retained) {
+      batch._jobs.push_back(&job);
+    }
+  }
+  batch._jobs_pending = batch._jobs.size();
+
+  if (num_threads <= 0 || batch._jobs.size() < 2 ||
+      !Thread::is_true_threads()) {
+    // Cull them all right here.
+    for (CullJob *job : batch._jobs) {
+      PStatTimer timer(job->_win->get_cull_window_pcollector(), current_thread);
+      cull_to_bins(job->_win, job->_gsg, job->_dr, job->_scene_setup,
+                   job->_cull_result, current_thread);
+    }
+    return;
+  }
+
+  MutexHolder holder(_cull_workers_lock, current_thread);
+  if ((int)_cull_workers.size() < num_threads) {
+    start_cull_workers(num_threads);
+  }
+
+  _cull_batches.push_back(&batch);
+  _cull_workers_cvar.notify_all();
+
+  // Help out with our own jobs until they have all been handed out, then
+  // wait for the workers to finish theirs.
+  while (batch._next_job < batch._jobs.size()) {
+    run_next_cull_job(&batch, current_thread);
+  }
+  while (batch._jobs_pending > 0) {
+    _cull_workers_cvar.wait();
+  }
+}
+
+/**
+ * Takes the next job from the indicated batch and performs it.  Assumes
+ * _cull_workers_lock is held, and that the batch has a job left to hand out;
+ * the lock is released while the job runs.
+ */
+void GraphicsEngine::
+run_next_cull_job(CullBatch *batch, Thread *current_thread) {
+  CullJob *job = batch->_jobs[batch->_next_job++];
+  if (batch->_next_job == batch->_jobs.size()) {
+    // Nothing more to hand out from this batch.
+    pdeque<CullBatch *>::iterator bi =
+      std::find(_cull_batches.begin(), _cull_batches.end(), batch);
+    if (bi != _cull_batches.end()) {
+      _cull_batches.erase(bi);
+    }
+  }
+
+  _cull_workers_lock.release();
+  {
+    PStatTimer timer(job->_win->get_cull_window_pcollector(), current_thread);
+    cull_to_bins(job->_win, job->_gsg, job->_dr, job->_scene_setup,
+                 job->_cull_result, current_thread);
+  }
+  _cull_workers_lock.acquire();
+
+  if (--batch->_jobs_pending == 0) {
+    _cull_workers_cvar.notify_all();
+  }
+}
+
+/**
+ * Starts enough CullWorkers to bring the pool up to the indicated number of
+ * threads.  Assumes _cull_workers_lock is held.
+ */
+void GraphicsEngine::
+start_cull_workers(int num_threads) {
+  _cull_workers_shutdown = false;
+
+  while ((int)_cull_workers.size() < num_threads) {
+    std::ostringstream name_strm;
+    name_strm << "CullWorker" << _cull_workers.size();
+    PT(CullWorker) thread = new CullWorker(name_strm.str(), this);
+    if (!thread->start(TP_normal, true)) {
+      display_cat.error()
+        << "Unable to start " << name_strm.str() << "\n";
+      break;
+    }
+    _cull_workers.push_back(thread);
+  }
+}
+
+/**
+ * Signals all the CullWorkers to stop and waits for them.  Assumes
+ * _cull_workers_lock is *not* held.
+ */
+void GraphicsEngine::
+stop_cull_workers() {
+  CullWorkers threads;
+  {
+    MutexHolder holder(_cull_workers_lock);
+    _cull_workers_shutdown = true;
+    _cull_workers_cvar.notify_all();
+    threads.swap(_cull_workers);
+  }
+
+  for (CullWorker *thread : threads) {
+    thread->join();
   }
 }
 
@@ -1658,6 +1880,10 @@ cull_to_bins(GraphicsOutput *win, GraphicsStateGuardian *gsg,
              DisplayRegion *dr, SceneSetup *scene_setup,
              CullResult *cull_result, Thread *current_thread) {
 
+  // The CullableObjects created during the traversal go into the arena
+  // owned by the CullResult.
+  CullArena::Scope arena_scope(cull_result->get_arena());
+
   BinCullHandler cull_handler(cull_result);
   CallbackObject *cbobj = dr->get_cull_callback();
   if (cbobj != nullptr) {
@@ -1684,6 +1910,8 @@ cull_to_bins(GraphicsOutput *win, GraphicsStateGuardian *gsg,
 void GraphicsEngine::
 draw_bins(const GraphicsEngine::Windows &wlist, Thread *current_thread) {
   nassertv(wlist.verify_list());
+  FrameTimeline::StageTimer stage_timer(_frame_timeline, FrameTimeline::S_draw,
+                                        current_thread);
 
   size_t wlist_size = wlist.size();
   for (size_t wi = 0; wi < wlist_size; ++wi) {
@@ -1694,6 +1922,7 @@ draw_bins(const GraphicsEngine::Windows &wlist, Thread *current_thread) {
 
       GraphicsOutput *host = win->get_host();
       if (host->flip_ready()) {
+        FrameTimeline::FlipTimer flip_timer(_frame_timeline);
         {
           // We can't use a PStatGPUTimer before begin_frame, so when using
           // GPU timing, it is advisable to set auto-flip to #t.
@@ -1741,6 +1970,9 @@ draw_bins(const GraphicsEngine::Windows &wlist, Thread *current_thread) {
 #endif
 
           if (win->flip_ready()) {
+            // The draw stage of this frame is still open, so name the frame.
+            FrameTimeline::FlipTimer flip_timer(_frame_timeline,
+                                                stage_timer.get_frame_number());
             {
               // begin_flip doesn't do anything interesting, let's not waste
               // two timer queries on that.
@@ -1811,6 +2043,7 @@ flip_windows(const GraphicsEngine::Windows &wlist, Thread *current_thread) {
   size_t warray_size = num_windows * sizeof(GraphicsOutput *);
   size_t warray_count = 0;
   GraphicsOutput **warray = (GraphicsOutput **)alloca(warray_size);
+  double flip_start = TrueClock::get_global_ptr()->get_short_time();
 
   size_t i;
   for (i = 0; i < num_windows; ++i) {
@@ -1830,6 +2063,11 @@ flip_windows(const GraphicsEngine::Windows &wlist, Thread *current_thread) {
     PStatTimer timer(GraphicsEngine::_flip_end_pcollector, current_thread);
     win->end_flip();
   }
+
+  if (warray_count != 0) {
+    _frame_timeline->record_flip(flip_start,
+                                 TrueClock::get_global_ptr()->get_short_time());
+  }
 }
 
 /**
@@ -2376,6 +2614,8 @@ terminate_threads(Thread *current_thread) {
   }
 
   _threads.clear();
+
+  stop_cull_workers();
 }
 
 
@@ -2802,3 +3042,43 @@ thread_main() {
     }
   }
 }
+
+/**
+ *
+ */
+GraphicsEngine::CullWorker::
+CullWorker(const string &name, GraphicsEngine *engine) :
+  Thread(name, name),
+  _engine(engine)
+{
+}
+
+/**
+ * The main loop for a cull worker thread.  It takes jobs from any batch that
+ * has some left to hand out, reading from the same pipeline stage as the
+ * thread that submitted the batch.
+ */
+void GraphicsEngine::CullWorker::
+thread_main() {
+  Thread *current_thread = Thread::get_current_thread();
+
+  MutexHolder holder(_engine->_cull_workers_lock);
+  while (true) {
+    while (_engine->_cull_batches.empty()) {
+      if (_engine->_cull_workers_shutdown) {
+        return;
+      }
+      PStatTimer timer(_wait_pcollector, current_thread);
+      _engine->_cull_workers_cvar.wait();
+    }
+    if (_engine->_cull_workers_shutdown) {
+      return;
+    }
+
+    PStatClient::thread_tick(get_sync_name());
+
+    CullBatch *batch = _engine->_cull_batches.front();
+    current_thread->set_pipeline_stage(batch->_pipeline_stage);
+    _engine->run_next_cull_job(batch, current_thread);
+  }
+}
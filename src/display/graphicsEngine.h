@@ -19,6 +19,7 @@
 #include "graphicsBuffer.h"
 #include "frameBufferProperties.h"
 #include "graphicsThreadingModel.h"
+#include "frameTimeline.h"
 #include "sceneSetup.h"
 #include "pointerTo.h"
 #include "thread.h"
@@ -26,8 +27,10 @@
 #include "reMutex.h"
 #include "lightReMutex.h"
 #include "conditionVar.h"
+#include "conditionVarFull.h"
 #include "pStatCollector.h"
 #include "pset.h"
+#include "pdeque.h"
 #include "ordered_vector.h"
 #include "indirectLess.h"
 #include "loader.h"
@@ -74,6 +77,9 @@ PUBLISHED:
   INLINE Loader *get_default_loader() const;
   MAKE_PROPERTY(default_loader, get_default_loader, set_default_loader);
 
+  INLINE FrameTimeline *get_frame_timeline() const;
+  MAKE_PROPERTY(frame_timeline, get_frame_timeline);
+
   GraphicsOutput *make_output(GraphicsPipe *pipe,
                               const std::string &name, int sort,
                               const FrameBufferProperties &fb_prop,
@@ -313,6 +319,52 @@ private:
     bool _result;
   };
 
+  // One DisplayRegion to be culled by cull_to_bins().  The culls are
+  // collected first, so that they may be performed in parallel, and the
+  // results are then handed on in their original order.
+  class CullJob {
+  public:
+    GraphicsOutput *_win;
+    GraphicsStateGuardian *_gsg;
+    PT(DisplayRegion) _dr;
+    PT(SceneSetup) _scene_setup;
+    PT(CullResult) _cull_result;
+    DisplayRegion::CullVersion _cull_version;
+
+    // If this is not -1, this DisplayRegion shares the cull result of the
+    // indicated earlier job instead of being culled itself.
+    int _source_job;
+
+    // True if _cull_result is the previous frame's result, which is still
+    // valid and need not be culled again.
+    bool _retained;
+  };
+  typedef pvector<CullJob> CullJobs;
+
+  // The jobs of one call to cull_to_bins() that are handed out to the
+  // CullWorkers.  Protected by _cull_workers_lock.
+  class CullBatch {
+  public:
+    pvector<CullJob *> _jobs;
+    size_t _next_job;
+    size_t _jobs_pending;
+    int _pipeline_stage;
+  };
+
+  class CullWorker : public Thread {
+  public:
+    CullWorker(const std::string &name, GraphicsEngine *engine);
+    virtual void thread_main();
+
+    GraphicsEngine *_engine;
+  };
+  typedef pvector<PT(CullWorker) > CullWorkers;
+
+  void run_cull_jobs(CullJobs &jobs, int num_threads, Thread *current_thread);
+  void run_next_cull_job(CullBatch *batch, Thread *current_thread);
+  void start_cull_workers(int num_threads);
+  void stop_cull_workers();
+
   WindowRenderer *get_window_renderer(const std::string &name, int pipeline_stage);
 
   Pipeline *_pipeline;
@@ -328,10 +380,23 @@ private:
   typedef pmap<std::string, PT(RenderThread) > Threads;
   Threads _threads;
   GraphicsThreadingModel _threading_model;
+
+  // The pool of threads that cull DisplayRegions in parallel, if the
+  // threading model asks for any.  This lock protects the following members.
+  Mutex _cull_workers_lock;
+  ConditionVarFull _cull_workers_cvar;
+  CullWorkers _cull_workers;
+  pdeque<CullBatch *> _cull_batches;
+  bool _cull_workers_shutdown;
   bool _auto_flip;
   bool _portal_enabled; //toggle to portal culling on/off
   PT(Loader) _default_loader;
 
+  // Records when each stage of the recent frames ran.  _app_start_time is
+  // the time at which the previous call to render_frame() returned.
+  PT(FrameTimeline) _frame_timeline;
+  double _app_start_time;
+
   enum FlipState {
     FS_draw,  // Still drawing.
     FS_sync,  // All windows are done drawing.
@@ -342,6 +407,11 @@ private:
   bool _singular_warning_last_frame;
   bool _singular_warning_this_frame;
 
+  // Used to compute the per-frame vertex paging throughput for PStats.
+  size_t _last_vertex_compress_input;
+  size_t _last_vertex_compress_output;
+  size_t _last_vertex_decompress_output;
+
   ReMutex _lock;
   ReMutex _public_lock;
 
@@ -370,6 +440,9 @@ private:
   static PStatCollector _flip_pcollector;
   static PStatCollector _flip_begin_pcollector;
   static PStatCollector _flip_end_pcollector;
+  static PStatCollector _frame_pacing_pcollector;
+  static PStatCollector _frame_latency_pcollector;
+  static PStatCollector _pipeline_depth_pcollector;
   static PStatCollector _transform_states_pcollector;
   static PStatCollector _transform_states_unused_pcollector;
   static PStatCollector _render_states_pcollector;
@@ -386,6 +459,9 @@ private:
   static PStatCollector _vertex_data_compressed_pcollector;
   static PStatCollector _vertex_data_used_disk_pcollector;
   static PStatCollector _vertex_data_unused_disk_pcollector;
+  static PStatCollector _vertex_paging_compress_in_pcollector;
+  static PStatCollector _vertex_paging_compress_out_pcollector;
+  static PStatCollector _vertex_paging_decompress_pcollector;
 
   static PStatCollector _cnode_volume_pcollector;
   static PStatCollector _gnode_volume_pcollector;
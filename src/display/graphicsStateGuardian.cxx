@@ -58,6 +58,7 @@
 #include "clipPlaneAttrib.h"
 #include "fogAttrib.h"
 #include "config_pstatclient.h"
+#include "lightMutexHolder.h"
 
 #include <limits.h>
 
@@ -304,8 +305,16 @@ GraphicsStateGuardian::
   size_t size = RenderState::_states.get_num_entries();
   for (size_t si = 0; si < size; ++si) {
     const RenderState *state = RenderState::_states.get_key(si);
-    state->_mungers.remove(_id);
-    state->_munged_states.remove(_id);
+    PT(GeomMunger) munger;
+    {
+      LightMutexHolder munger_holder(state->_munger_lock);
+      int mi = state->_mungers.find(_id);
+      if (mi >= 0) {
+        munger = std::move(state->_mungers.modify_data(mi));
+        state->_mungers.remove_element(mi);
+      }
+      state->_munged_states.remove(_id);
+    }
   }
 }
 
@@ -795,44 +804,65 @@ dispatch_compute(int num_groups_x, int num_groups_y, int num_groups_z) {
 /**
  * Looks up or creates a GeomMunger object to munge vertices appropriate to
  * this GSG for the indicated state.
+ *
+ * This may be called from several cull threads at once, even for the same
+ * state, so the state's munger cache is only touched with its
+ * _munger_lock held.
  */
 PT(GeomMunger) GraphicsStateGuardian::
 get_geom_munger(const RenderState *state, Thread *current_thread) {
   RenderState::Mungers &mungers = state->_mungers;
 
-  if (!mungers.is_empty()) {
-    // Before we even look up the map, see if the _last_mi value points to
-    // this GSG.  This is likely because we tend to visit the same state
-    // multiple times during a frame.  Also, this might well be the only GSG
-    // in the world anyway.
-    int mi = state->_last_mi;
-    if (mi >= 0 && (size_t)mi < mungers.get_num_entries() && mungers.get_key(mi) == _id) {
-      PT(GeomMunger) munger = mungers.get_data(mi);
-      if (munger->is_registered()) {
-        return munger;
+  // An unregistered munger that we remove from the map is only released
+  // after the lock has been, since its destruction may release states.
+  PT(GeomMunger) stale_munger;
+  {
+    LightMutexHolder holder(state->_munger_lock);
+    if (!mungers.is_empty()) {
+      // Before we even look up the map, see if the _last_mi value points to
+      // this GSG.  This is likely because we tend to visit the same state
+      // multiple times during a frame.  Also, this might well be the only GSG
+      // in the world anyway.
+      int mi = state->_last_mi;
+      if (mi >= 0 && (size_t)mi < mungers.get_num_entries() && mungers.get_key(mi) == _id) {
+        PT(GeomMunger) munger = mungers.get_data(mi);
+        if (munger->is_registered()) {
+          return munger;
+        }
       }
-    }
 
-    // Nope, we have to look it up in the map.
-    mi = mungers.find(_id);
-    if (mi >= 0) {
-      PT(GeomMunger) munger = mungers.get_data(mi);
-      if (munger->is_registered()) {
-        state->_last_mi = mi;
-        return munger;
-      } else {
-        // This GeomMunger is no longer registered.  Remove it from the map.
-        mungers.remove_element(mi);
+      // Nope, we have to look it up in the map.
+      mi = mungers.find(_id);
+      if (mi >= 0) {
+        PT(GeomMunger) munger = mungers.get_data(mi);
+        if (munger->is_registered()) {
+          state->_last_mi = mi;
+          return munger;
+        } else {
+          // This GeomMunger is no longer registered.  Remove it from the map.
+          stale_munger = std::move(munger);
+          mungers.remove_element(mi);
+        }
       }
     }
   }
 
-  // Nothing in the map; create a new entry.
+  // Nothing in the map; create a new entry.  This is done without the lock,
+  // since making the munger may consult the state.  If another thread does
+  // the same in the meantime, the registry hands us both the same munger.
   PT(GeomMunger) munger = make_geom_munger(state, current_thread);
   nassertr(munger != nullptr && munger->is_registered(), munger);
   nassertr(munger->is_of_type(StateMunger::get_class_type()), munger);
 
-  state->_last_mi = mungers.store(_id, munger);
+  LightMutexHolder holder(state->_munger_lock);
+  int mi = mungers.find(_id);
+  if (mi >= 0) {
+    stale_munger = mungers.get_data(mi);
+    mungers.set_data(mi, munger);
+    state->_last_mi = mi;
+  } else {
+    state->_last_mi = mungers.store(_id, munger);
+  }
   return munger;
 }
 
@@ -2665,6 +2695,20 @@ set_state_and_transform(const RenderState *state,
                         const TransformState *trans) {
 }
 
+/**
+ * Like set_state_and_transform(), but the caller has already determined
+ * which attributes differ between prev_state and state.  GSG's that can make
+ * use of this should override it; the default implementation ignores the
+ * extra information.
+ */
+void GraphicsStateGuardian::
+set_state_delta_and_transform(const RenderState *state,
+                              const TransformState *trans,
+                              const RenderState *prev_state,
+                              const RenderState::SlotMask &changed_slots) {
+  set_state_and_transform(state, trans);
+}
+
 /**
  * Clears the framebuffer within the current DisplayRegion, according to the
  * flags indicated by the given DrawableRegion object.
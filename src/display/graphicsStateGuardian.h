@@ -331,6 +331,10 @@ public:
 
   virtual void set_state_and_transform(const RenderState *state,
                                        const TransformState *transform);
+  virtual void set_state_delta_and_transform(const RenderState *state,
+                                             const TransformState *transform,
+                                             const RenderState *prev_state,
+                                             const RenderState::SlotMask &changed_slots);
 
   PN_stdfloat compute_distance_to(const LPoint3 &point) const;
 
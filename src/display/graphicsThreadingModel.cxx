@@ -12,6 +12,7 @@
  */
 
 #include "graphicsThreadingModel.h"
+#include "string_utils.h"
 
 using std::string;
 
@@ -36,22 +37,35 @@ using std::string;
  * draw are run simultaneously, in the same thread, with no binning or state
  * sorting.  It simplifies the cull process but it forces the scene to render
  * in scene graph order; state sorting and alpha sorting is lost.
+ *
+ * The model may also end with a colon and a number, for instance
+ * "cull/draw:4", to indicate that up to that many additional worker threads
+ * may help the cull thread by culling separate DisplayRegions in parallel.
+ * See set_num_cull_threads().
  */
 GraphicsThreadingModel::
 GraphicsThreadingModel(const string &model) {
   _cull_sorting = true;
+  _num_cull_threads = 0;
   size_t start = 0;
   if (!model.empty() && model[0] == '-') {
     start = 1;
     _cull_sorting = false;
   }
 
+  size_t end = model.size();
+  size_t colon = model.rfind(':');
+  if (colon != string::npos && colon >= start) {
+    _num_cull_threads = std::max(atoi(model.c_str() + colon + 1), 0);
+    end = colon;
+  }
+
   size_t slash = model.find('/', start);
-  if (slash == string::npos) {
-    _cull_name = model.substr(start);
+  if (slash == string::npos || slash > end) {
+    _cull_name = model.substr(start, end - start);
   } else {
     _cull_name = model.substr(start, slash - start);
-    _draw_name = model.substr(slash + 1);
+    _draw_name = model.substr(slash + 1, end - slash - 1);
   }
 
   update_stages();
@@ -63,11 +77,16 @@ GraphicsThreadingModel(const string &model) {
  */
 string GraphicsThreadingModel::
 get_model() const {
+  string model;
   if (get_cull_sorting()) {
-    return get_cull_name() + "/" + get_draw_name();
+    model = get_cull_name() + "/" + get_draw_name();
   } else {
-    return string("-") + get_cull_name();
+    model = string("-") + get_cull_name();
+  }
+  if (_num_cull_threads > 0) {
+    model += ":" + format_string(_num_cull_threads);
   }
+  return model;
 }
 
 /**
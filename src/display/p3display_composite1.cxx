@@ -7,6 +7,7 @@
 #include "displaySearchParameters.cxx"
 #include "drawableRegion.cxx"
 #include "frameBufferProperties.cxx"
+#include "frameTimeline.cxx"
 #include "graphicsBuffer.cxx"
 #include "graphicsDevice.cxx"
 #include "graphicsEngine.cxx"
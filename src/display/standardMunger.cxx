@@ -168,7 +168,7 @@ munge_data_impl(const GeomVertexData *data) {
     return new_data;
   }
 
-  return new_data->convert_to(new_format);
+  return new_data->convert_to(new_format, true);
 }
 
 /**
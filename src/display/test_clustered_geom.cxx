@@ -0,0 +1,225 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_clustered_geom.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "graphicsStateGuardian.h"
+#include "cullTraverser.h"
+#include "cullHandler.h"
+#include "cullableObject.h"
+#include "sceneSetup.h"
+#include "camera.h"
+#include "perspectiveLens.h"
+#include "clusteredGeomNode.h"
+#include "geom.h"
+#include "geomTriangles.h"
+#include "geomVertexData.h"
+#include "geomVertexReader.h"
+#include "geomVertexWriter.h"
+#include "nodePath.h"
+
+// This culls one long strip of triangles in a ClusteredGeomNode with two
+// cameras, each looking at a different end of it, in alternate frames, as two
+// DisplayRegions would.  No window is opened.
+//
+// Each camera must get a partial Geom that holds only the clusters near its
+// own end of the strip.  When each camera culls the unchanged scene again, it
+// must get back the very same Geom it got the first time; the other camera's
+// traversal in between must not have displaced it.
+
+static int num_failures = 0;
+
+static void
+check(bool condition, const char *message) {
+  if (!condition) {
+    nout << "FAILED: " << message << "\n";
+    ++num_failures;
+  }
+}
+
+/**
+ * A GSG that can't draw anything; the traverser only needs one to exist.
+ */
+class TestGSG : public GraphicsStateGuardian {
+public:
+  TestGSG() : GraphicsStateGuardian(CS_default, nullptr, nullptr) {
+  }
+};
+
+/**
+ * Remembers the Geom that was drawn last.
+ */
+class RecordingCullHandler : public CullHandler {
+public:
+  RecordingCullHandler() : _num_objects(0) {
+  }
+
+  virtual void record_object(CullableObject *object,
+                             const CullTraverser *traverser) {
+    _geom = object->_geom;
+    ++_num_objects;
+    delete object;
+  }
+
+  CPT(Geom) _geom;
+  int _num_objects;
+};
+
+static const int num_segments = 400;
+
+/**
+ * Returns a strip of triangles, one unit high, running along the X axis from
+ * -200 to 200, 50 units down the Y axis.
+ */
+static PT(Geom)
+make_strip() {
+  PT(GeomVertexData) vdata = new GeomVertexData
+    ("strip", GeomVertexFormat::get_v3(), Geom::UH_static);
+  GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+  for (int i = 0; i <= num_segments; ++i) {
+    PN_stdfloat x = (PN_stdfloat)(i - num_segments / 2);
+    vertex.add_data3(x, 50.0f, -0.5f);
+    vertex.add_data3(x, 50.0f, 0.5f);
+  }
+
+  PT(GeomTriangles) tris = new GeomTriangles(Geom::UH_static);
+  for (int i = 0; i < num_segments; ++i) {
+    int v = i * 2;
+    tris->add_vertices(v, v + 2, v + 3);
+    tris->add_vertices(v, v + 3, v + 1);
+  }
+
+  PT(Geom) geom = new Geom(vdata);
+  geom->add_primitive(tris);
+  return geom;
+}
+
+/**
+ * Sets up a camera at the indicated X position, looking down the Y axis,
+ * with a frustum that is transformed into the space of render.
+ */
+static PT(SceneSetup)
+make_scene_setup(NodePath &render, PN_stdfloat x) {
+  PT(PerspectiveLens) lens = new PerspectiveLens;
+  lens->set_fov(30.0f);
+  lens->set_near_far(1.0f, 200.0f);
+  PT(Camera) camera_node = new Camera("camera", lens);
+  NodePath camera = render.attach_new_node(camera_node);
+  camera.set_x(x);
+
+  CPT(TransformState) camera_transform = camera.get_transform(render);
+
+  PT(SceneSetup) scene_setup = new SceneSetup;
+  scene_setup->set_viewport_size(800, 600);
+  scene_setup->set_scene_root(render);
+  scene_setup->set_camera_path(camera);
+  scene_setup->set_camera_node(camera_node);
+  scene_setup->set_lens(lens);
+  scene_setup->set_initial_state(RenderState::make_empty());
+  scene_setup->set_camera_transform(camera_transform);
+  scene_setup->set_world_transform(camera_transform->get_inverse());
+  scene_setup->set_cs_transform(TransformState::make_identity());
+  scene_setup->set_cs_world_transform(camera_transform->get_inverse());
+
+  PT(GeometricBoundingVolume) frustum =
+    lens->make_bounds()->as_geometric_bounding_volume();
+  frustum->xform(camera_transform->get_mat());
+  scene_setup->set_view_frustum(frustum);
+  return scene_setup;
+}
+
+/**
+ * Culls the scene with the indicated traverser, and returns the Geom that
+ * was drawn, or NULL if there wasn't exactly one.
+ */
+static CPT(Geom)
+cull(CullTraverser *trav, SceneSetup *scene_setup, GraphicsStateGuardian *gsg,
+     NodePath &render) {
+  RecordingCullHandler cull_handler;
+  trav->set_cull_handler(&cull_handler);
+  trav->set_scene(scene_setup, gsg, false);
+  trav->traverse(render);
+  trav->end_traverse();
+  trav->set_cull_handler(nullptr);
+  return (cull_handler._num_objects == 1) ? cull_handler._geom : nullptr;
+}
+
+/**
+ * Returns true if the Geom has fewer triangles than the whole strip, and all
+ * of the triangles lie between the indicated X coordinates.
+ */
+static bool
+is_partial_within(const Geom *geom, PN_stdfloat min_x, PN_stdfloat max_x) {
+  if (geom == nullptr) {
+    return false;
+  }
+  CPT(GeomPrimitive) prim = geom->get_primitive(0);
+  int num_vertices = prim->get_num_vertices();
+  if (num_vertices == 0 || num_vertices >= num_segments * 6) {
+    return false;
+  }
+
+  GeomVertexReader vertex(geom->get_vertex_data(), InternalName::get_vertex());
+  for (int vi = 0; vi < num_vertices; ++vi) {
+    vertex.set_row(prim->get_vertex(vi));
+    PN_stdfloat x = vertex.get_data3()[0];
+    if (x < min_x || x > max_x) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int
+main(int argc, char *argv[]) {
+  NodePath render("render");
+
+  PT(ClusteredGeomNode) node = new ClusteredGeomNode("strip");
+  node->set_max_cluster_triangles(8);
+  node->add_geom(make_strip());
+  NodePath strip = render.attach_new_node(node);
+  strip.set_two_sided(true);
+  check(node->get_num_clusters(0) > 2, "strip is divided into clusters");
+
+  PT(TestGSG) gsg = new TestGSG;
+  PT(SceneSetup) left_scene = make_scene_setup(render, -100.0f);
+  PT(SceneSetup) right_scene = make_scene_setup(render, 100.0f);
+  PT(CullTraverser) left_trav = new CullTraverser;
+  PT(CullTraverser) right_trav = new CullTraverser;
+
+  CPT(Geom) left1 = cull(left_trav, left_scene, gsg, render);
+  CPT(Geom) right1 = cull(right_trav, right_scene, gsg, render);
+  check(is_partial_within(left1, -130.0f, -70.0f),
+        "left camera draws only the left end");
+  check(is_partial_within(right1, 70.0f, 130.0f),
+        "right camera draws only the right end");
+
+  CPT(Geom) left2 = cull(left_trav, left_scene, gsg, render);
+  CPT(Geom) right2 = cull(right_trav, right_scene, gsg, render);
+  check(left1 != nullptr && left2 == left1,
+        "left camera gets its cached Geom back");
+  check(right1 != nullptr && right2 == right1,
+        "right camera gets its cached Geom back");
+
+  // Once the view changes, the new set of clusters is drawn.
+  left_scene = make_scene_setup(render, -50.0f);
+  CPT(Geom) left3 = cull(left_trav, left_scene, gsg, render);
+  check(left3 != left1 && is_partial_within(left3, -80.0f, -20.0f),
+        "moved camera gets a new Geom");
+
+  if (num_failures != 0) {
+    nout << num_failures << " checks failed.\n";
+    return 1;
+  }
+  nout << "All checks passed.\n";
+  return 0;
+}
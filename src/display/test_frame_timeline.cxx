@@ -0,0 +1,147 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_frame_timeline.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "frameTimeline.h"
+#include "clockObject.h"
+#include "pnotify.h"
+
+// This checks that FrameTimeline attributes each stage to the right frame.
+// Stages recorded for frames that overlap, as they do in a pipelined
+// threading model, must each land in their own frame.  A flip made while the
+// draw stage of its frame is still open, as the auto-flip in draw_bins()
+// does, must be credited to that frame and not to the one drawn before it.
+// A flip deferred to the start of the next draw must still be credited to
+// the frame that was drawn last.
+
+static int num_failures = 0;
+
+static void
+check(bool condition, const char *message) {
+  if (!condition) {
+    nout << "FAILED: " << message << "\n";
+    ++num_failures;
+  }
+}
+
+/**
+ * Records the stages of three frames, overlapping as they would with app,
+ * cull and draw on separate threads, at made-up times.
+ */
+static void
+test_pipelined_stages() {
+  FrameTimeline timeline(8);
+
+  // Frame n runs app at [n, n+1], cull at [n+1, n+2], draw at [n+2, n+3],
+  // and is flipped at [n+3, n+3.5].
+  for (int step = 1; step <= 5; ++step) {
+    double t = (double)step;
+    if (step <= 3) {
+      timeline.record_stage(FrameTimeline::S_app, step, t, t + 1.0);
+    }
+    if (step >= 2 && step - 1 <= 3) {
+      timeline.record_stage(FrameTimeline::S_cull, step - 1, t, t + 1.0);
+    }
+    if (step >= 3 && step - 2 <= 3) {
+      timeline.record_stage(FrameTimeline::S_draw, step - 2, t, t + 1.0);
+      timeline.record_flip(step - 2, t + 1.0, t + 1.5);
+    }
+  }
+
+  for (int n = 1; n <= 3; ++n) {
+    FrameTimeline::Frame frame;
+    check(timeline.find_frame(n, frame), "frame is retained");
+    check(frame.get_start(FrameTimeline::S_app) == (double)n, "app start");
+    check(frame.get_start(FrameTimeline::S_cull) == (double)n + 1.0,
+          "cull start");
+    check(frame.get_start(FrameTimeline::S_draw) == (double)n + 2.0,
+          "draw start");
+    check(frame.get_end(FrameTimeline::S_flip) == (double)n + 3.5, "flip end");
+    check(frame.get_latency() == 3.5, "latency covers app to flip");
+  }
+  check(timeline.get_last_flipped_frame() == 3, "last flipped frame");
+  check(timeline.get_num_frames() == 3, "three frames are retained");
+}
+
+/**
+ * Does what draw_bins() does with auto-flip on: the flip happens while the
+ * draw StageTimer is still in scope.
+ */
+static void
+test_auto_flip() {
+  ClockObject *clock = ClockObject::get_global_clock();
+  Thread *current_thread = Thread::get_current_thread();
+  PT(FrameTimeline) timeline = new FrameTimeline(8);
+
+  clock->tick(current_thread);
+  int previous = clock->get_frame_count(current_thread);
+  timeline->record_stage(FrameTimeline::S_app, previous, 0.0, 1.0);
+  timeline->record_stage(FrameTimeline::S_draw, previous, 1.0, 2.0);
+  timeline->record_flip(previous, 2.0, 2.5);
+
+  clock->tick(current_thread);
+  int current = clock->get_frame_count(current_thread);
+  timeline->record_stage(FrameTimeline::S_app, current, 2.0, 3.0);
+  {
+    FrameTimeline::StageTimer stage_timer(timeline, FrameTimeline::S_draw,
+                                          current_thread);
+    check(stage_timer.get_frame_number() == current,
+          "stage timer records the current frame");
+    FrameTimeline::FlipTimer flip_timer(timeline,
+                                        stage_timer.get_frame_number());
+  }
+
+  FrameTimeline::Frame frame;
+  check(timeline->find_frame(current, frame) &&
+        frame.has_stage(FrameTimeline::S_flip),
+        "auto-flip is credited to the frame being drawn");
+  check(frame.get_latency() >= 0.0, "current frame has a latency");
+
+  check(timeline->find_frame(previous, frame) &&
+        frame.get_end(FrameTimeline::S_flip) == 2.5,
+        "previous frame keeps its own flip");
+  check(frame.get_latency() == 2.5, "previous frame latency is unchanged");
+}
+
+/**
+ * A flip that is deferred until the start of the next draw goes to the frame
+ * that was drawn last, even though a later frame has already begun.
+ */
+static void
+test_deferred_flip() {
+  FrameTimeline timeline(8);
+  timeline.record_stage(FrameTimeline::S_app, 10, 0.0, 1.0);
+  timeline.record_stage(FrameTimeline::S_draw, 10, 1.0, 2.0);
+  timeline.record_stage(FrameTimeline::S_app, 11, 1.0, 2.0);
+  timeline.record_flip(2.0, 2.5);
+
+  FrameTimeline::Frame frame;
+  check(timeline.find_frame(10, frame) && frame.get_end(FrameTimeline::S_flip) == 2.5,
+        "deferred flip goes to the last drawn frame");
+  check(timeline.find_frame(11, frame) && !frame.has_stage(FrameTimeline::S_flip),
+        "deferred flip doesn't go to the undrawn frame");
+}
+
+int
+main(int argc, char *argv[]) {
+  test_pipelined_stages();
+  test_auto_flip();
+  test_deferred_flip();
+
+  if (num_failures != 0) {
+    nout << num_failures << " checks failed.\n";
+    return 1;
+  }
+  nout << "All checks passed.\n";
+  return 0;
+}
@@ -0,0 +1,259 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_instanced_bin.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "graphicsStateGuardian.h"
+#include "cullBinStateSorted.h"
+#include "cullableObject.h"
+#include "shader.h"
+#include "shaderAttrib.h"
+#include "geom.h"
+#include "geomTriangles.h"
+#include "geomVertexData.h"
+#include "geomVertexWriter.h"
+#include "load_prc_file.h"
+#include "pStatCollector.h"
+
+#include <algorithm>
+#include <functional>
+#include <sstream>
+
+// This fills a state-sorted bin that has instancing enabled with copies of
+// two Geoms, each copy with its own transform, and draws it with a GSG that
+// only records what it is asked to draw.  No window is opened.
+//
+// max-instances-per-draw is set to 8, and the shader declares an
+// instance_transforms array of 4, so the 20 copies of the first Geom must be
+// drawn in five calls of 4, and the 3 copies of the second in one call of 3.
+// Every copy must be drawn exactly once, with its own transform.  If the
+// shader declares no such array, or the GSG can't instance, every copy must
+// be drawn by itself.
+//
+// This GSG can't link a shader, so the length of the array, which linking
+// would find, is filled in by hand.
+
+static int num_failures = 0;
+
+static void
+check(bool condition, const char *message) {
+  if (!condition) {
+    nout << "FAILED: " << message << "\n";
+    ++num_failures;
+  }
+}
+
+/**
+ * A GSG that draws nothing, but records the X position of each copy that
+ * each draw call would have drawn.
+ */
+class TestGSG : public GraphicsStateGuardian {
+public:
+  explicit TestGSG(bool instancing) : GraphicsStateGuardian(CS_default, nullptr, nullptr) {
+    _supports_geometry_instancing = instancing;
+  }
+
+  virtual void set_state_and_transform(const RenderState *state,
+                                       const TransformState *transform) {
+    _last_state = state;
+    _last_transform = transform;
+  }
+
+  virtual void set_state_delta_and_transform(const RenderState *state,
+                                             const TransformState *transform,
+                                             const RenderState *prev_state,
+                                             const RenderState::SlotMask &changed_slots) {
+    set_state_and_transform(state, transform);
+  }
+
+  virtual bool begin_draw_primitives(const GeomPipelineReader *geom_reader,
+                                     const GeomVertexDataPipelineReader *data_reader,
+                                     bool force) {
+    pvector<int> xs;
+    const ShaderAttrib *sa;
+    if (_last_state->get_attrib(sa) && sa->get_instance_count() > 0) {
+      const Shader::ShaderPtrData *data =
+        sa->get_shader_input_ptr(InternalName::make("instance_transforms"));
+      nassertr(data != nullptr, false);
+      const LMatrix4 *mats = (const LMatrix4 *)data->_ptr;
+      for (int i = 0; i < sa->get_instance_count(); ++i) {
+        xs.push_back((int)mats[i].get_row3(3)[0]);
+      }
+    } else {
+      xs.push_back((int)_last_transform->get_pos()[0]);
+    }
+    _draws.push_back(xs);
+    return false;
+  }
+
+  CPT(RenderState) _last_state;
+  CPT(TransformState) _last_transform;
+  pvector<pvector<int> > _draws;
+};
+
+/**
+ * Returns a Geom with a single triangle.
+ */
+static PT(Geom)
+make_triangle() {
+  PT(GeomVertexData) vdata = new GeomVertexData
+    ("triangle", GeomVertexFormat::get_v3(), Geom::UH_static);
+  GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+  vertex.add_data3(0.0f, 0.0f, 0.0f);
+  vertex.add_data3(1.0f, 0.0f, 0.0f);
+  vertex.add_data3(0.0f, 0.0f, 1.0f);
+
+  PT(GeomTriangles) tris = new GeomTriangles(Geom::UH_static);
+  tris->add_vertices(0, 1, 2);
+
+  PT(Geom) geom = new Geom(vdata);
+  geom->add_primitive(tris);
+  return geom;
+}
+
+/**
+ * Returns a GLSL shader that, as far as the GSG can tell, declares an
+ * instance_transforms array of the indicated length, or none if it is 0.
+ */
+static PT(Shader)
+make_shader(int array_length) {
+  std::ostringstream vertex;
+  vertex << "#version 330\n";
+  if (array_length > 0) {
+    vertex << "uniform mat4 instance_transforms[" << array_length << "];\n";
+  }
+  vertex << "void main() {}\n";
+  PT(Shader) shader = Shader::make(Shader::SL_GLSL, vertex.str(),
+                                   "#version 330\nvoid main() {}\n");
+  nassertr(shader != nullptr, nullptr);
+
+  if (array_length > 0) {
+    Shader::ShaderPtrSpec spec;
+    spec._id._name = "instance_transforms";
+    spec._id._seqno = 0;
+    spec._dim[0] = array_length;
+    spec._dim[1] = 4;
+    spec._dim[2] = 4;
+    spec._dep[0] = Shader::SSD_general | Shader::SSD_shaderinputs | Shader::SSD_frame;
+    spec._dep[1] = Shader::SSD_NONE;
+    spec._arg = InternalName::make("instance_transforms");
+    spec._type = Shader::SPT_float;
+    shader->_ptr_spec.push_back(spec);
+  }
+  return shader;
+}
+
+/**
+ * Culls 20 copies of one Geom and 3 of another into an instancing bin, with
+ * the X position of each copy set to its index, and draws the bin.  Returns
+ * the draw calls, as recorded by the GSG.
+ */
+static pvector<pvector<int> >
+draw_copies(bool gsg_instancing, Shader *shader) {
+  PT(TestGSG) gsg = new TestGSG(gsg_instancing);
+  PT(CullBinStateSorted) bin =
+    new CullBinStateSorted("instanced", gsg, PStatCollector("test"));
+  bin->set_instancing(true);
+
+  CPT(RenderState) state = RenderState::make(ShaderAttrib::make(shader));
+  PT(Geom) geoms[2] = { make_triangle(), make_triangle() };
+  Thread *current_thread = Thread::get_current_thread();
+  for (int i = 0; i < 23; ++i) {
+    const Geom *geom = geoms[i < 20 ? 0 : 1];
+    CullableObject *object = new CullableObject
+      (geom, state, TransformState::make_pos(LPoint3((PN_stdfloat)i, 0.0f, 0.0f)));
+    object->_munged_data = geom->get_vertex_data();
+    bin->add_object(object, current_thread);
+  }
+  bin->finish_cull(nullptr, current_thread);
+  bin->draw(false, current_thread);
+  return gsg->_draws;
+}
+
+/**
+ * Returns true if every copy was drawn exactly once.
+ */
+static bool
+all_drawn_once(const pvector<pvector<int> > &draws) {
+  pvector<int> xs;
+  for (const pvector<int> &draw : draws) {
+    xs.insert(xs.end(), draw.begin(), draw.end());
+  }
+  std::sort(xs.begin(), xs.end());
+  if (xs.size() != 23) {
+    return false;
+  }
+  for (int i = 0; i < 23; ++i) {
+    if (xs[i] != i) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Returns true if the calls drew the given numbers of copies, which are
+ * listed in descending order, whatever order the calls were made in.
+ */
+static bool
+has_batch_sizes(const pvector<pvector<int> > &draws,
+                std::initializer_list<size_t> expected) {
+  pvector<size_t> sizes;
+  for (const pvector<int> &draw : draws) {
+    sizes.push_back(draw.size());
+  }
+  std::sort(sizes.begin(), sizes.end(), std::greater<size_t>());
+  return sizes.size() == expected.size() &&
+    std::equal(sizes.begin(), sizes.end(), expected.begin());
+}
+
+int
+main(int argc, char *argv[]) {
+  load_prc_file_data("test_instanced_bin", "max-instances-per-draw 8\n");
+
+  PT(Shader) shader = make_shader(4);
+  pvector<pvector<int> > draws = draw_copies(true, shader);
+  check(has_batch_sizes(draws, { 4, 4, 4, 4, 4, 3 }),
+        "copies are drawn in batches that fit the shader's array");
+  check(all_drawn_once(draws), "instanced copies are drawn once each");
+
+  // Each batch holds copies of one Geom only.
+  bool separate = true;
+  for (const pvector<int> &draw : draws) {
+    for (int x : draw) {
+      separate = separate && ((x < 20) == (draw[0] < 20));
+    }
+  }
+  check(separate, "batches don't mix Geoms");
+
+  // A larger array is still limited by max-instances-per-draw.
+  draws = draw_copies(true, make_shader(64));
+  check(has_batch_sizes(draws, { 8, 8, 4, 3 }),
+        "batches are limited by max-instances-per-draw");
+  check(all_drawn_once(draws), "copies in large batches are drawn once each");
+
+  // Without the array, or without GSG support, each copy is drawn alone.
+  draws = draw_copies(true, make_shader(0));
+  check(draws.size() == 23, "undeclared array draws each copy alone");
+  check(all_drawn_once(draws), "undeclared array draws each copy once");
+
+  draws = draw_copies(false, shader);
+  check(draws.size() == 23, "GSG without instancing draws each copy alone");
+  check(all_drawn_once(draws), "GSG without instancing draws each copy once");
+
+  if (num_failures != 0) {
+    nout << num_failures << " checks failed.\n";
+    return 1;
+  }
+  nout << "All checks passed.\n";
+  return 0;
+}
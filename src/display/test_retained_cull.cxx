@@ -0,0 +1,145 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_retained_cull.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "displayRegion.h"
+#include "sceneSetup.h"
+#include "camera.h"
+#include "perspectiveLens.h"
+#include "billboardEffect.h"
+#include "nodePath.h"
+#include "pnotify.h"
+
+// A DisplayRegion with retained_cull set draws its last cull result again
+// for as long as the DisplayRegion::CullVersion of the scene stays the same.
+// This checks that the version stays the same from one frame to the next
+// while nothing changes, and that it changes on every kind of change that
+// could alter the cull result: the transform, state, effects or children of
+// a node anywhere in the scene, the position, lens or camera mask of the
+// camera, and an explicit mark_cull_stale().  No window is opened.
+
+static int num_failures = 0;
+
+static void
+check(bool condition, const char *message) {
+  if (!condition) {
+    nout << "FAILED: " << message << "\n";
+    ++num_failures;
+  }
+}
+
+/**
+ * Holds a small scene and a camera looking at it.
+ */
+class Scene {
+public:
+  Scene() :
+    _render("render"),
+    _stale_seq(UpdateSeq::initial())
+  {
+    _model = _render.attach_new_node("model").attach_new_node("child");
+    _model.set_y(10.0f);
+
+    _lens = new PerspectiveLens;
+    _camera_node = new Camera("camera", _lens);
+    _camera = _render.attach_new_node(_camera_node);
+  }
+
+  /**
+   * Returns the version of the scene as it is now, as the GraphicsEngine
+   * would compute it at the start of a frame.
+   */
+  DisplayRegion::CullVersion get_version() {
+    PT(SceneSetup) scene_setup = new SceneSetup;
+    scene_setup->set_scene_root(_render);
+    scene_setup->set_camera_path(_camera);
+    scene_setup->set_camera_node(_camera_node);
+    scene_setup->set_lens(_lens);
+    scene_setup->set_initial_state(RenderState::make_empty());
+    scene_setup->set_camera_transform(_camera.get_transform(_render));
+    return DisplayRegion::CullVersion(scene_setup, _stale_seq,
+                                      Thread::get_current_thread());
+  }
+
+  NodePath _render;
+  NodePath _model;
+  NodePath _camera;
+  PT(Camera) _camera_node;
+  PT(PerspectiveLens) _lens;
+  UpdateSeq _stale_seq;
+};
+
+/**
+ * Returns true if the version of the scene is the same as it was, then
+ * remembers the new version.
+ */
+static bool
+unchanged(Scene &scene, DisplayRegion::CullVersion &version) {
+  DisplayRegion::CullVersion new_version = scene.get_version();
+  bool same = (new_version == version);
+  version = new_version;
+  return same;
+}
+
+int
+main(int argc, char *argv[]) {
+  Scene scene;
+  DisplayRegion::CullVersion version = scene.get_version();
+
+  check(DisplayRegion::CullVersion() != DisplayRegion::CullVersion(),
+        "an empty version matches nothing");
+  check(version != DisplayRegion::CullVersion(),
+        "an empty version doesn't match a real one");
+
+  check(unchanged(scene, version), "unchanged scene keeps its version");
+  check(unchanged(scene, version), "unchanged scene keeps its version again");
+
+  scene._model.set_x(1.0f);
+  check(!unchanged(scene, version), "moving a node changes the version");
+  check(unchanged(scene, version), "version settles after a move");
+
+  scene._model.set_color(1.0f, 0.0f, 0.0f, 1.0f);
+  check(!unchanged(scene, version), "changing a state changes the version");
+
+  scene._model.set_effect(BillboardEffect::make_point_eye());
+  check(!unchanged(scene, version), "adding an effect changes the version");
+  scene._model.clear_effect(BillboardEffect::get_class_type());
+  check(!unchanged(scene, version), "removing an effect changes the version");
+
+  scene._model.attach_new_node("grandchild");
+  check(!unchanged(scene, version), "adding a child changes the version");
+
+  scene._model.hide();
+  check(!unchanged(scene, version), "hiding a node changes the version");
+
+  scene._camera.set_h(10.0f);
+  check(!unchanged(scene, version), "turning the camera changes the version");
+
+  scene._lens->set_fov(60.0f);
+  check(!unchanged(scene, version), "changing the lens changes the version");
+
+  scene._camera_node->set_camera_mask(BitMask32::bit(3));
+  check(!unchanged(scene, version), "changing the camera mask changes the version");
+
+  // This is what DisplayRegion::mark_cull_stale() does.
+  ++scene._stale_seq;
+  check(!unchanged(scene, version), "marking the cull stale changes the version");
+  check(unchanged(scene, version), "version settles after all the changes");
+
+  if (num_failures != 0) {
+    nout << num_failures << " checks failed.\n";
+    return 1;
+  }
+  nout << "All checks passed.\n";
+  return 0;
+}
@@ -0,0 +1,298 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_threaded_cull.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "graphicsStateGuardian.h"
+#include "stateMunger.h"
+#include "binCullHandler.h"
+#include "cullResult.h"
+#include "cullTraverser.h"
+#include "sceneSetup.h"
+#include "camera.h"
+#include "perspectiveLens.h"
+#include "geomNode.h"
+#include "geom.h"
+#include "geomTriangles.h"
+#include "geomVertexData.h"
+#include "geomVertexWriter.h"
+#include "colorAttrib.h"
+#include "colorScaleAttrib.h"
+#include "nodePath.h"
+#include "nodePathCollection.h"
+#include "cullArena.h"
+#include "thread.h"
+#include "pStatCollector.h"
+#include "panda_getopt.h"
+#include "preprocess_argv.h"
+
+#include <algorithm>
+
+// This culls the same scene into several DisplayRegions' worth of
+// CullResults at once, each on its own thread, as the cull-threads option of
+// GraphicsThreadingModel does, all of them for the one GSG.  Every Geom in
+// the scene has a different state, and the scene is culled many times over,
+// so the threads keep on asking the GSG for mungers and munged states for
+// the same RenderStates at the same time.
+//
+// No window is opened; the GSG is a stand-in that only makes mungers.  The
+// test fails unless every thread culled every Geom, and each state ended up
+// with exactly one munger for the GSG.
+
+static int num_threads = 4;
+static int num_frames = 200;
+static int num_geoms = 256;
+
+/**
+ * A munger for a particular state, which munges the state by adding a color
+ * scale to it, so that the munged-state cache is exercised as well.
+ */
+class TestMunger : public StateMunger {
+public:
+  TestMunger(GraphicsStateGuardianBase *gsg, const RenderState *state) :
+    StateMunger(gsg),
+    _key(state)
+  {
+    _should_munge_state = true;
+  }
+
+protected:
+  virtual CPT(RenderState) munge_state_impl(const RenderState *state) {
+    return state->add_attrib(ColorScaleAttrib::make(LVecBase4(0.5f, 0.5f, 0.5f, 1.0f)));
+  }
+
+  virtual int compare_to_impl(const GeomMunger *other) const {
+    const TestMunger *om = (const TestMunger *)other;
+    if (_key != om->_key) {
+      return _key < om->_key ? -1 : 1;
+    }
+    return StateMunger::compare_to_impl(other);
+  }
+
+private:
+  // Only used to tell the mungers apart; this doesn't hold a reference,
+  // since the state holds one to us.
+  const RenderState *_key;
+};
+
+/**
+ * A GSG that can't draw anything, but hands out mungers.
+ */
+class TestGSG : public GraphicsStateGuardian {
+public:
+  TestGSG() : GraphicsStateGuardian(CS_default, nullptr, nullptr) {
+    _num_mungers_made = 0;
+  }
+
+  virtual PT(GeomMunger) make_geom_munger(const RenderState *state,
+                                          Thread *current_thread) {
+    AtomicAdjust::inc(_num_mungers_made);
+    PT(TestMunger) munger = new TestMunger(this, state);
+    return GeomMunger::register_munger(munger, current_thread);
+  }
+
+  AtomicAdjust::Integer _num_mungers_made;
+};
+
+/**
+ * Bins the objects as usual, but also counts them.
+ */
+class CountingCullHandler : public BinCullHandler {
+public:
+  CountingCullHandler(CullResult *cull_result) :
+    BinCullHandler(cull_result),
+    _num_objects(0)
+  {
+  }
+
+  virtual void record_object(CullableObject *object,
+                             const CullTraverser *traverser) {
+    ++_num_objects;
+    BinCullHandler::record_object(object, traverser);
+  }
+
+  int _num_objects;
+};
+
+/**
+ * Culls the scene over and over, as a cull thread would for its own
+ * DisplayRegion.
+ */
+class CullThread : public Thread {
+public:
+  CullThread(int index, TestGSG *gsg, SceneSetup *scene_setup) :
+    Thread("cull" + std::to_string(index), "cull"),
+    _gsg(gsg),
+    _scene_setup(scene_setup),
+    _pcollector("Draw:Test"),
+    _min_objects(-1),
+    _max_objects(0)
+  {
+  }
+
+  virtual void thread_main() {
+    for (int frame = 0; frame < num_frames; ++frame) {
+      PT(CullResult) cull_result = new CullResult(_gsg, _pcollector);
+      CullArena::Scope arena_scope(cull_result->get_arena());
+
+      CountingCullHandler cull_handler(cull_result);
+      CullTraverser trav;
+      trav.set_cull_handler(&cull_handler);
+      trav.set_scene(_scene_setup, _gsg, false);
+      trav.traverse(_scene_setup->get_scene_root());
+      trav.end_traverse();
+      cull_result->finish_cull(_scene_setup, this);
+
+      int num_objects = cull_handler._num_objects;
+      _min_objects = (_min_objects < 0) ? num_objects : std::min(_min_objects, num_objects);
+      _max_objects = std::max(_max_objects, num_objects);
+    }
+  }
+
+  PT(TestGSG) _gsg;
+  PT(SceneSetup) _scene_setup;
+  PStatCollector _pcollector;
+  int _min_objects;
+  int _max_objects;
+};
+
+static bool
+get_command_line_opts(int &argc, char **&argv) {
+  extern char *optarg;
+  extern int optind;
+  const char *options = "t:f:g:";
+  int flag = getopt(argc, argv, options);
+  while (flag != EOF) {
+    switch (flag) {
+    case 't':
+      num_threads = std::max(atoi(optarg), 1);
+      break;
+
+    case 'f':
+      num_frames = std::max(atoi(optarg), 1);
+      break;
+
+    case 'g':
+      num_geoms = std::max(atoi(optarg), 1);
+      break;
+
+    case '?':
+      nout
+        << "test_threaded_cull [-t threads] [-f frames] [-g geoms]\n";
+      return false;
+    }
+
+    flag = getopt(argc, argv, options);
+  }
+
+  argv += (optind - 1);
+  argc -= (optind - 1);
+
+  return true;
+}
+
+/**
+ * Returns a single triangle in front of the camera.
+ */
+static PT(Geom)
+make_triangle() {
+  PT(GeomVertexData) vdata = new GeomVertexData
+    ("triangle", GeomVertexFormat::get_v3(), Geom::UH_static);
+  GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+  vertex.add_data3(-1.0f, 10.0f, -1.0f);
+  vertex.add_data3(1.0f, 10.0f, -1.0f);
+  vertex.add_data3(0.0f, 10.0f, 1.0f);
+
+  PT(GeomTriangles) tris = new GeomTriangles(Geom::UH_static);
+  tris->add_vertices(0, 1, 2);
+
+  PT(Geom) geom = new Geom(vdata);
+  geom->add_primitive(tris);
+  return geom;
+}
+
+int
+main(int argc, char *argv[]) {
+  preprocess_argv(argc, argv);
+  if (!get_command_line_opts(argc, argv)) {
+    return (1);
+  }
+
+  // Every Geom gets its own state, which all of the threads share.
+  NodePath render("render");
+  PT(Geom) geom = make_triangle();
+  for (int i = 0; i < num_geoms; ++i) {
+    PT(GeomNode) node = new GeomNode("geom" + std::to_string(i));
+    LColor color((i & 7) / 7.0f, ((i >> 3) & 7) / 7.0f, (i >> 6) / 7.0f, 1.0f);
+    node->add_geom(geom, RenderState::make(ColorAttrib::make_flat(color)));
+    render.attach_new_node(node);
+  }
+
+  PT(Camera) camera_node = new Camera("camera", new PerspectiveLens);
+  NodePath camera = render.attach_new_node(camera_node);
+
+  PT(TestGSG) gsg = new TestGSG;
+
+  PT(SceneSetup) scene_setup = new SceneSetup;
+  scene_setup->set_viewport_size(800, 600);
+  scene_setup->set_scene_root(render);
+  scene_setup->set_camera_path(camera);
+  scene_setup->set_camera_node(camera_node);
+  scene_setup->set_lens(camera_node->get_lens());
+  scene_setup->set_initial_state(RenderState::make_empty());
+  scene_setup->set_camera_transform(TransformState::make_identity());
+  scene_setup->set_world_transform(TransformState::make_identity());
+  scene_setup->set_cs_transform(TransformState::make_identity());
+  scene_setup->set_cs_world_transform(TransformState::make_identity());
+
+  pvector<PT(CullThread)> threads;
+  for (int i = 0; i < num_threads; ++i) {
+    PT(CullThread) thread = new CullThread(i, gsg, scene_setup);
+    if (thread->start(TP_normal, true)) {
+      threads.push_back(thread);
+    }
+  }
+  if (threads.empty()) {
+    nout << "Unable to start any threads.\n";
+    return (1);
+  }
+
+  bool okflag = true;
+  for (CullThread *thread : threads) {
+    thread->join();
+    if (thread->_min_objects != num_geoms || thread->_max_objects != num_geoms) {
+      nout << thread->get_name() << " culled between " << thread->_min_objects
+           << " and " << thread->_max_objects << " Geoms, expected "
+           << num_geoms << ".\n";
+      okflag = false;
+    }
+  }
+
+  // Each state should have exactly one munger for this GSG, and it should be
+  // the one that the GSG hands out now.
+  NodePathCollection geom_nodes = render.find_all_matches("**/+GeomNode");
+  for (int i = 0; i < geom_nodes.get_num_paths(); ++i) {
+    GeomNode *node = DCAST(GeomNode, geom_nodes.get_path(i).node());
+    const RenderState *state = node->get_geom_state(0);
+    PT(GeomMunger) munger = gsg->get_geom_munger(state, Thread::get_current_thread());
+    if (munger == nullptr || munger != gsg->get_geom_munger(state, Thread::get_current_thread())) {
+      nout << "Inconsistent munger for " << *state << "\n";
+      okflag = false;
+    }
+  }
+
+  nout << threads.size() << " threads culled " << num_geoms << " Geoms "
+       << num_frames << " times each; " << gsg->_num_mungers_made
+       << " mungers made for " << num_geoms << " states.\n";
+
+  return okflag ? 0 : 1;
+}
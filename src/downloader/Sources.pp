@@ -33,6 +33,7 @@
     multiplexStreamBuf.I multiplexStreamBuf.h \
     patcher.h patcher.I \
     socketStream.h socketStream.I \
+    sslMemoryChannel.h sslMemoryChannel.I \
     urlSpec.I urlSpec.h \
     virtualFileHTTP.I virtualFileHTTP.h \
     virtualFileMountHTTP.I virtualFileMountHTTP.h
@@ -61,6 +62,7 @@
     multiplexStream.cxx multiplexStreamBuf.cxx \
     patcher.cxx \
     socketStream.cxx \
+    sslMemoryChannel.cxx \
     urlSpec.cxx \
     virtualFileHTTP.cxx \
     virtualFileMountHTTP.cxx
@@ -91,6 +93,7 @@
     multiplexStreamBuf.I multiplexStreamBuf.h \
     patcher.h patcher.I \
     socketStream.h socketStream.I \
+    sslMemoryChannel.h sslMemoryChannel.I \
     urlSpec.h urlSpec.I \
     virtualFileHTTP.I virtualFileHTTP.h \
     virtualFileMountHTTP.I virtualFileMountHTTP.h
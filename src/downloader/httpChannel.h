@@ -448,6 +448,7 @@ private:
   friend class ChunkedStreamBuf;
   friend class IdentityStreamBuf;
   friend class HTTPClient;
+  friend class SSLMemoryChannel;
 };
 
 std::ostream &operator << (std::ostream &out, HTTPChannel::State state);
@@ -210,6 +210,7 @@ private:
   static PT(HTTPClient) _global_ptr;
 
   friend class HTTPChannel;
+  friend class SSLMemoryChannel;
 };
 
 #include "httpClient.I"
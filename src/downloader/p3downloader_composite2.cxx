@@ -13,6 +13,7 @@
 #include "multiplexStreamBuf.cxx"
 #include "patcher.cxx"
 #include "socketStream.cxx"
+#include "sslMemoryChannel.cxx"
 #include "urlSpec.cxx"
 #include "virtualFileHTTP.cxx"
 #include "virtualFileMountHTTP.cxx"
@@ -0,0 +1,365 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file sslMemoryChannel.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "sslMemoryChannel.h"
+
+#ifdef HAVE_OPENSSL
+
+#include "httpChannel.h"
+#include "config_downloader.h"
+#include "urlSpec.h"
+#include "openSSLWrapper.h"
+
+#include <algorithm>
+
+using std::string;
+
+// The most we decrypt in one call to SSL_read().
+static const int read_buffer_size = 16384;
+
+/**
+ * Creates the SSL state for a connection to the indicated server, and starts
+ * the handshake.  The first message to the server is available from
+ * get_output() right away.  If client is nullptr, the global HTTPClient is
+ * used.
+ */
+SSLMemoryChannel::
+SSLMemoryChannel(HTTPClient *client, const string &hostname, int port) :
+  _client(client != nullptr ? client : HTTPClient::get_global_ptr()),
+  _hostname(hostname),
+  _port(port),
+  _state(S_handshake)
+{
+  _ssl = SSL_new(_client->get_ssl_ctx());
+  _rbio = BIO_new(BIO_s_mem());
+  _wbio = BIO_new(BIO_s_mem());
+
+  // An empty read buffer means "try again later", not end-of-file.
+  BIO_set_mem_eof_return(_rbio, -1);
+
+  // The SSL object takes ownership of both BIOs.
+  SSL_set_bio(_ssl, _rbio, _wbio);
+  SSL_set_connect_state(_ssl);
+
+  // As in HTTPChannel, only the first word of the cipher list is used.
+  string cipher_list = _client->get_cipher_list();
+  if (!cipher_list.empty()) {
+    size_t space = cipher_list.find(" ");
+    if (space != string::npos) {
+      cipher_list = cipher_list.substr(0, space);
+    }
+    if (SSL_set_cipher_list(_ssl, cipher_list.c_str()) == 0) {
+      downloader_cat.error()
+        << "Invalid cipher list: '" << cipher_list << "'\n";
+      fail("SSL_set_cipher_list");
+      return;
+    }
+  }
+
+  if (SSL_set_tlsext_host_name(_ssl, _hostname.c_str()) == 0) {
+    downloader_cat.error()
+      << "Could not set TLS SNI hostname to '" << _hostname << "'\n";
+  }
+
+  if (_client->load_client_certificate()) {
+    SSL_use_certificate(_ssl, _client->_client_certificate_pub);
+    SSL_use_PrivateKey(_ssl, _client->_client_certificate_priv);
+    if (!SSL_check_private_key(_ssl)) {
+      downloader_cat.warning()
+        << "Client private key does not match public key!\n";
+    }
+  }
+
+  do_handshake();
+}
+
+/**
+ *
+ */
+SSLMemoryChannel::
+~SSLMemoryChannel() {
+  SSL_free(_ssl);
+}
+
+/**
+ * Hands the channel some bytes that were received from the server.  Any
+ * decrypted data may then be retrieved with read(), and any reply should be
+ * collected with get_output() and sent.
+ */
+void SSLMemoryChannel::
+receive(const unsigned char *data, size_t size) {
+  if (_state == S_failure || size == 0) {
+    return;
+  }
+  BIO_write(_rbio, data, (int)size);
+
+  if (_state == S_handshake) {
+    do_handshake();
+  }
+}
+
+/**
+ * Encrypts the indicated data for sending to the server; collect the result
+ * with get_output().  If the handshake has not yet completed, the data is
+ * held until it has.  Returns false if the connection is closed or has
+ * failed.
+ */
+bool SSLMemoryChannel::
+write(const unsigned char *data, size_t size) {
+  if (_state == S_handshake) {
+    _pending.insert(_pending.end(), data, data + size);
+    return true;
+  }
+  if (_state != S_ready) {
+    return false;
+  }
+
+  // The output buffer grows as needed, so SSL_write() never has to wait for
+  // it to drain, and always consumes everything it is given.
+  while (size > 0) {
+    int chunk = (int)std::min(size, (size_t)0x40000000);
+    int result = SSL_write(_ssl, data, chunk);
+    if (result <= 0) {
+      fail("SSL_write");
+      return false;
+    }
+    data += result;
+    size -= result;
+  }
+  return true;
+}
+
+/**
+ * Appends whatever data has been decrypted so far to the end of result.
+ * Returns false if the server has closed the connection or it has failed,
+ * in which case no more data will be coming, although some may still have
+ * been appended by this call.
+ */
+bool SSLMemoryChannel::
+read(vector_uchar &result) {
+  if (_state != S_ready) {
+    return false;
+  }
+
+  unsigned char buffer[read_buffer_size];
+  while (true) {
+    int bytes_read = SSL_read(_ssl, buffer, read_buffer_size);
+    if (bytes_read > 0) {
+      result.insert(result.end(), buffer, buffer + bytes_read);
+      continue;
+    }
+
+    int error = SSL_get_error(_ssl, bytes_read);
+    if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) {
+      // We have everything there is for now.
+      return true;
+    }
+    if (error == SSL_ERROR_ZERO_RETURN) {
+      // The server sent close_notify.
+      _state = S_closed;
+      return false;
+    }
+    fail("SSL_read");
+    return false;
+  }
+}
+
+/**
+ * Begins closing the connection cleanly, by queueing a close_notify alert for
+ * the server.  No more data may be written afterwards.
+ */
+void SSLMemoryChannel::
+shutdown() {
+  if (_state == S_ready) {
+    SSL_shutdown(_ssl);
+    _state = S_closed;
+  }
+}
+
+/**
+ * Returns true if there are bytes waiting to be sent to the server.
+ */
+bool SSLMemoryChannel::
+has_output() const {
+  return BIO_ctrl_pending(_wbio) > 0;
+}
+
+/**
+ * Appends the bytes that should be sent to the server to the end of result,
+ * and removes them from the channel.
+ */
+void SSLMemoryChannel::
+get_output(vector_uchar &result) {
+  size_t pending = BIO_ctrl_pending(_wbio);
+  while (pending > 0) {
+    size_t start = result.size();
+    result.resize(start + pending);
+    int bytes_read = BIO_read(_wbio, &result[start], (int)pending);
+    result.resize(start + std::max(bytes_read, 0));
+    if (bytes_read <= 0) {
+      break;
+    }
+    pending = BIO_ctrl_pending(_wbio);
+  }
+}
+
+/**
+ * Returns the name of the cipher negotiated with the server, or the empty
+ * string if the handshake has not yet completed.
+ */
+string SSLMemoryChannel::
+get_cipher_name() const {
+  const SSL_CIPHER *cipher = SSL_get_current_cipher(_ssl);
+  if (cipher == nullptr) {
+    return string();
+  }
+  return SSL_CIPHER_get_name(cipher);
+}
+
+/**
+ * Takes the handshake as far as it can go with the data received so far.
+ * When it is done, verifies the server and sends any data that was written
+ * in the meantime.
+ */
+void SSLMemoryChannel::
+do_handshake() {
+  int result = SSL_do_handshake(_ssl);
+  if (result <= 0) {
+    int error = SSL_get_error(_ssl, result);
+    if (error != SSL_ERROR_WANT_READ && error != SSL_ERROR_WANT_WRITE) {
+      downloader_cat.info()
+        << "Could not establish SSL handshake with " << _hostname << ":"
+        << _port << "\n";
+      fail("SSL_do_handshake");
+    }
+    return;
+  }
+
+  if (downloader_cat.is_debug()) {
+    downloader_cat.debug()
+      << "Using cipher " << get_cipher_name() << " with " << _hostname
+      << "\n";
+  }
+
+  if (!verify_server_certificate()) {
+    _state = S_failure;
+    return;
+  }
+
+  _state = S_ready;
+  if (!_pending.empty()) {
+    vector_uchar pending;
+    pending.swap(_pending);
+    write(pending.data(), pending.size());
+  }
+}
+
+/**
+ * Checks the certificate presented by the server against the settings of the
+ * HTTPClient.  This follows HTTPChannel::run_ssl_handshake().  Returns true
+ * if the server is acceptable.
+ */
+bool SSLMemoryChannel::
+verify_server_certificate() {
+  X509 *cert = SSL_get_peer_certificate(_ssl);
+  if (cert == nullptr) {
+    downloader_cat.info()
+      << "No certificate was presented by server.\n";
+    return false;
+  }
+
+  URLSpec url;
+  url.set_scheme("https");
+  url.set_server(_hostname);
+  url.set_port(_port);
+
+  bool cert_preapproved = false;
+  bool cert_name_preapproved = false;
+  _client->check_preapproved_server_certificate(url, cert, cert_preapproved,
+                                                cert_name_preapproved);
+
+  HTTPClient::VerifySSL verify_ssl = _client->get_verify_ssl();
+  long verify_result = SSL_get_verify_result(_ssl);
+  bool cert_valid = true;
+
+  if (verify_result == X509_V_ERR_CERT_HAS_EXPIRED ||
+      verify_result == X509_V_ERR_CERT_NOT_YET_VALID) {
+    downloader_cat.info()
+      << "Certificate from " << url.get_server_and_port()
+      << " is not valid at this time\n";
+    if (verify_ssl == HTTPClient::VS_normal && !cert_preapproved) {
+      cert_valid = false;
+    }
+
+  } else if (verify_result != X509_V_OK) {
+    downloader_cat.info()
+      << "Unable to verify identity of " << url.get_server_and_port()
+      << ", verify error code " << verify_result << "\n";
+    if (verify_ssl != HTTPClient::VS_no_verify && !cert_preapproved) {
+      cert_valid = false;
+    }
+  }
+
+  if (cert_valid && verify_ssl != HTTPClient::VS_no_verify &&
+      !cert_name_preapproved) {
+    cert_valid = validate_server_name(cert);
+  }
+
+  X509_free(cert);
+  return cert_valid;
+}
+
+/**
+ * Returns true if the name in the cert matches the hostname of the server,
+ * false otherwise.
+ */
+bool SSLMemoryChannel::
+validate_server_name(X509 *cert) const {
+#if OPENSSL_VERSION_NUMBER >= 0x10002000L
+  // This checks the subjectAltName extension first, and falls back to the
+  // common name, as RFC 2818 asks.
+  if (X509_check_host(cert, _hostname.data(), _hostname.size(), 0, nullptr) == 1) {
+    return true;
+  }
+#else
+  X509_NAME *xname = X509_get_subject_name(cert);
+  if (xname != nullptr) {
+    string common_name =
+      HTTPChannel::get_x509_name_component(xname, NID_commonName);
+    if (HTTPChannel::match_cert_name(common_name, _hostname)) {
+      return true;
+    }
+  }
+#endif
+
+  downloader_cat.info()
+    << "Server certificate from " << _hostname
+    << " does not match the server's name.\n";
+  return false;
+}
+
+/**
+ * Marks the channel as failed, and reports any errors that OpenSSL has
+ * queued up.
+ */
+void SSLMemoryChannel::
+fail(const char *operation) {
+  if (downloader_cat.is_debug()) {
+    downloader_cat.debug()
+      << operation << " failed on connection to " << _hostname << "\n";
+  }
+  OpenSSLWrapper::get_global_ptr()->notify_ssl_errors();
+  _state = S_failure;
+}
+
+#endif  // HAVE_OPENSSL
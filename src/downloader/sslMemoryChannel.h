@@ -0,0 +1,89 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file sslMemoryChannel.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef SSLMEMORYCHANNEL_H
+#define SSLMEMORYCHANNEL_H
+
+#include "pandabase.h"
+
+#ifdef HAVE_OPENSSL
+
+#include "httpClient.h"
+#include "referenceCount.h"
+#include "pointerTo.h"
+#include "vector_uchar.h"
+
+typedef struct ssl_st SSL;
+typedef struct bio_st BIO;
+
+/**
+ * The client end of an SSL connection whose encrypted side is passed through
+ * memory buffers, rather than read from and written to a socket by OpenSSL.
+ * The bytes received from the socket are handed to receive(), and the bytes
+ * that should be sent are collected with get_output().  Since the caller does
+ * all of the socket I/O, nothing here ever blocks, and a single thread may
+ * service any number of channels; see AsyncDatagramConnection::connect_tls().
+ *
+ * The handshake begins as soon as the channel is constructed.  Once it
+ * completes, the server's certificate is checked in the same way that
+ * HTTPChannel checks it, according to the settings of the HTTPClient.
+ */
+class EXPCL_PANDA_DOWNLOADER SSLMemoryChannel : public ReferenceCount {
+public:
+  SSLMemoryChannel(HTTPClient *client, const std::string &hostname, int port);
+  ~SSLMemoryChannel();
+
+  enum State {
+    S_handshake,
+    S_ready,
+    S_closed,
+    S_failure,
+  };
+
+  INLINE State get_state() const;
+  INLINE const std::string &get_hostname() const;
+
+  void receive(const unsigned char *data, size_t size);
+  bool write(const unsigned char *data, size_t size);
+  bool read(vector_uchar &result);
+  void shutdown();
+
+  bool has_output() const;
+  void get_output(vector_uchar &result);
+
+  std::string get_cipher_name() const;
+
+private:
+  void do_handshake();
+  bool verify_server_certificate();
+  bool validate_server_name(X509 *cert) const;
+  void fail(const char *operation);
+
+  PT(HTTPClient) _client;
+  std::string _hostname;
+  int _port;
+
+  SSL *_ssl;
+  BIO *_rbio;
+  BIO *_wbio;
+  State _state;
+
+  // Data passed to write() before the handshake has completed.
+  vector_uchar _pending;
+};
+
+#include "sslMemoryChannel.I"
+
+#endif  // HAVE_OPENSSL
+
+#endif
@@ -1,4 +1,16 @@
 #define LOCAL_LIBS p3putil p3express p3pandabase p3pstatclient p3linmath
+
+// AsyncDatagramConnection and friends are built on the net library, and are
+// left out when it isn't built, as PStatClient's networking is.
+#if $[and $[HAVE_NET],$[WANT_NATIVE_NET]]
+  #define LOCAL_LIBS $[LOCAL_LIBS] p3net p3nativenet
+
+  // AsyncDatagramConnection::connect_tls() uses the downloader's SSL
+  // support, which only exists with OpenSSL.
+  #if $[HAVE_OPENSSL]
+    #define LOCAL_LIBS $[LOCAL_LIBS] p3downloader
+  #endif
+#endif
 #define OTHER_LIBS p3dtoolutil:c p3dtoolbase:c p3dtool:m p3prc
 
 #begin lib_target
@@ -7,6 +19,8 @@
   #define BUILDING_DLL BUILDING_PANDA_EVENT
 
   #define SOURCES \
+    asyncDatagramConnection.h asyncDatagramConnection.I \
+    asyncDatagramListener.h asyncDatagramListener.I \
     asyncFuture.h asyncFuture.I \
     asyncTask.h asyncTask.I \
     asyncTaskChain.h asyncTaskChain.I \
@@ -23,9 +37,12 @@
     event.I event.h eventHandler.h eventHandler.I \
     eventParameter.I eventParameter.h \
     eventQueue.I eventQueue.h eventReceiver.h \
-    pt_Event.h throw_event.I throw_event.h
+    pt_Event.h socketReactor.h socketReactor.I \
+    throw_event.I throw_event.h
 
   #define COMPOSITE_SOURCES \
+    asyncDatagramConnection.cxx \
+    asyncDatagramListener.cxx \
     asyncFuture.cxx \
     asyncTask.cxx \
     asyncTaskChain.cxx \
@@ -40,9 +57,11 @@
     pointerEventList.cxx \
     config_event.cxx event.cxx eventHandler.cxx \
     eventParameter.cxx eventQueue.cxx eventReceiver.cxx \
-    pt_Event.cxx
+    pt_Event.cxx socketReactor.cxx
 
   #define INSTALL_HEADERS \
+    asyncDatagramConnection.h asyncDatagramConnection.I \
+    asyncDatagramListener.h asyncDatagramListener.I \
     asyncFuture.h asyncFuture.I \
     asyncTask.h asyncTask.I \
     asyncTaskChain.h asyncTaskChain.I \
@@ -58,7 +77,8 @@
     event.I event.h eventHandler.h eventHandler.I \
     eventParameter.I eventParameter.h \
     eventQueue.I eventQueue.h eventReceiver.h \
-    pt_Event.h throw_event.I throw_event.h
+    pt_Event.h socketReactor.h socketReactor.I \
+    throw_event.I throw_event.h
 
   #define IGATESCAN all
 
@@ -82,3 +102,29 @@
     test_task.cxx
 
 #end test_bin_target
+
+#if $[and $[HAVE_NET],$[WANT_NATIVE_NET]]
+#begin test_bin_target
+  #define TARGET test_async_echo
+  #define OTHER_LIBS \
+   p3dtoolbase:c p3prc \
+   p3dtoolutil:c p3dtool:m
+
+  #define SOURCES \
+    test_async_echo.cxx
+
+#end test_bin_target
+#endif
+
+#if $[and $[HAVE_NET],$[WANT_NATIVE_NET],$[HAVE_OPENSSL]]
+#begin test_bin_target
+  #define TARGET test_async_tls
+  #define OTHER_LIBS \
+   p3dtoolbase:c p3prc \
+   p3dtoolutil:c p3dtool:m
+
+  #define SOURCES \
+    test_async_tls.cxx
+
+#end test_bin_target
+#endif
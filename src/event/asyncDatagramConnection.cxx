@@ -0,0 +1,636 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file asyncDatagramConnection.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "asyncDatagramConnection.h"
+
+// This file only defines anything if the net library is built.
+#if defined(HAVE_NET) && defined(WANT_NATIVE_NET)
+
+#include "datagramTCPHeader.h"
+#include "config_event.h"
+#include "lightMutexHolder.h"
+#include "socket_address.h"
+
+TypeHandle AsyncDatagramFuture::_type_handle;
+TypeHandle AsyncDatagramConnection::_type_handle;
+
+// The most we read from the socket in one call.
+static const int read_buffer_size = 65536;
+
+/**
+ * Creates a connection that is not yet open; call connect() to open it.  If
+ * reactor is nullptr, the global SocketReactor is used.
+ */
+AsyncDatagramConnection::
+AsyncDatagramConnection(SocketReactor *reactor) :
+  _reactor(reactor != nullptr ? reactor : SocketReactor::get_global_ptr()),
+  _tcp_header_size(tcp_header_size),
+  _max_datagram_size((size_t)std::max((int)async_max_datagram_size, 0)),
+  _state(S_closed),
+  _output_sent(0),
+  _total_queued(0),
+  _total_sent(0)
+{
+}
+
+/**
+ * Wraps a socket that was just accepted by an AsyncDatagramListener.  The
+ * connection takes ownership of the socket.  The caller is responsible for
+ * adding it to the reactor.
+ */
+AsyncDatagramConnection::
+AsyncDatagramConnection(SocketReactor *reactor, SOCKET socket,
+                        int tcp_header_size) :
+  _reactor(reactor),
+  _tcp_header_size(tcp_header_size),
+  _max_datagram_size((size_t)std::max((int)async_max_datagram_size, 0)),
+  _state(S_connected),
+  _output_sent(0),
+  _total_queued(0),
+  _total_sent(0)
+{
+  _socket.SetSocket(socket);
+  _socket.SetNonBlocking();
+  _socket.SetNoDelay();
+}
+
+/**
+ *
+ */
+AsyncDatagramConnection::
+~AsyncDatagramConnection() {
+  // The reactor holds a reference to us as long as we are open, so by the
+  // time we get here, there is nothing left to cancel.
+  _socket.Close();
+}
+
+/**
+ * Opens a connection to the indicated server.  Returns a future that is done
+ * when the connection has been established, or cancelled if it could not be.
+ * The host name is resolved immediately, which may block.
+ */
+PT(AsyncFuture) AsyncDatagramConnection::
+connect(const std::string &hostname, int port) {
+  return do_connect(hostname, port, false, nullptr);
+}
+
+#ifdef HAVE_OPENSSL
+/**
+ * Opens a secure connection to the indicated server.  Returns a future that
+ * is done once the SSL handshake has completed and the server's certificate
+ * has been verified according to the settings of the indicated HTTPClient,
+ * or the global HTTPClient if it is nullptr.  The future is cancelled if the
+ * connection could not be established, or the server could not be verified.
+ *
+ * Datagrams may be sent right away; they are held until the handshake is
+ * done.  Use a tcp-header-size of 0 to exchange a plain stream of bytes, as
+ * for an https request.
+ */
+PT(AsyncFuture) AsyncDatagramConnection::
+connect_tls(const std::string &hostname, int port, HTTPClient *client) {
+  return do_connect(hostname, port, true, client);
+}
+#endif  // HAVE_OPENSSL
+
+/**
+ * The implementation of connect() and connect_tls().
+ */
+PT(AsyncFuture) AsyncDatagramConnection::
+do_connect(const std::string &hostname, int port, bool use_tls,
+           HTTPClient *client) {
+  PT(AsyncFuture) future = new AsyncFuture;
+
+  Socket_Address address;
+  if (!address.set_host(hostname, port)) {
+    event_cat.error()
+      << "Unable to resolve " << hostname << "\n";
+    future->cancel();
+    return future;
+  }
+
+  {
+    LightMutexHolder holder(_lock);
+    nassertd(_state == S_closed) {
+      future->cancel();
+      return future;
+    }
+
+    if (!_socket.ActiveOpenNonBlocking(address)) {
+      event_cat.error()
+        << "Unable to connect to " << hostname << ":" << port << "\n";
+      future->cancel();
+      return future;
+    }
+    _socket.SetNoDelay();
+
+#ifdef HAVE_OPENSSL
+    _tls.clear();
+    if (use_tls) {
+      _tls = new SSLMemoryChannel(client, hostname, port);
+    }
+#endif
+
+    _state = S_connecting;
+    _connect_future = future;
+  }
+
+  _reactor->add_connection(this);
+  return future;
+}
+
+/**
+ * Returns a future whose result is the next datagram received on this
+ * connection.  If several calls are outstanding, they are completed in the
+ * order they were made.  The future is cancelled if the connection is closed
+ * before another datagram arrives.
+ */
+PT(AsyncFuture) AsyncDatagramConnection::
+recv_datagram() {
+  PT(AsyncDatagramFuture) future = new AsyncDatagramFuture;
+
+  Datagram datagram;
+  bool have_datagram = false;
+  bool closed = false;
+  {
+    LightMutexHolder holder(_lock);
+    if (!_received.empty()) {
+      datagram = std::move(_received.front());
+      _received.pop_front();
+      have_datagram = true;
+    } else if (_state == S_closed) {
+      closed = true;
+    } else {
+      _recv_futures.push_back(future);
+    }
+  }
+
+  if (have_datagram) {
+    future->set_datagram(std::move(datagram));
+  } else if (closed) {
+    future->cancel();
+  }
+  return future.p();
+}
+
+/**
+ * Queues the indicated datagram for sending, and returns a future that is
+ * done once it has been handed to the operating system.  If the socket can
+ * take it right away, this happens before send() returns.  The future is
+ * cancelled if the connection is closed before then.
+ */
+PT(AsyncFuture) AsyncDatagramConnection::
+send(const Datagram &datagram) {
+  PT(AsyncFuture) future = new AsyncFuture;
+
+  Completions done;
+  bool blocked = false;
+  {
+    LightMutexHolder holder(_lock);
+    size_t length = datagram.get_length();
+    if (_state == S_closed) {
+      done._cancelled.push_back(future);
+
+    } else if (_tcp_header_size == 2 && length >= 0x10000) {
+      event_cat.error()
+        << "Attempt to send TCP datagram of " << length
+        << " bytes--too long!\n";
+      done._cancelled.push_back(future);
+
+    } else {
+      Datagram header;
+      if (_tcp_header_size == 2) {
+        header.add_uint16((uint16_t)length);
+      } else if (_tcp_header_size == 4) {
+        header.add_uint32((uint32_t)length);
+      }
+      const unsigned char *header_data = (const unsigned char *)header.get_data();
+      const unsigned char *data = (const unsigned char *)datagram.get_data();
+#ifdef HAVE_OPENSSL
+      if (_tls != nullptr) {
+        if (!_tls->write(header_data, header.get_length()) ||
+            !_tls->write(data, length)) {
+          done._cancelled.push_back(future);
+        } else if (_state == S_connected) {
+          size_t start = _output.size();
+          _tls->get_output(_output);
+          _total_queued += _output.size() - start;
+          _send_futures.push_back(std::make_pair(_total_queued, future));
+        } else {
+          _tls_send_futures.push_back(future);
+        }
+      } else
+#endif  // HAVE_OPENSSL
+      {
+        _output.insert(_output.end(), header_data, header_data + header.get_length());
+        _output.insert(_output.end(), data, data + length);
+        _total_queued += header.get_length() + length;
+        _send_futures.push_back(std::make_pair(_total_queued, future));
+      }
+
+      if (_state == S_connected) {
+        do_write(done);
+      }
+      // If the socket couldn't take it all, the reactor has to start watching
+      // for it to become writable.
+      blocked = (_state != S_closed && _output_sent < _output.size());
+    }
+  }
+
+  if (blocked) {
+    _reactor->wake();
+  }
+  done.run();
+  return future;
+}
+
+/**
+ * Closes the connection.  Any pending futures are cancelled, but datagrams
+ * that were already received may still be retrieved with recv_datagram().
+ */
+void AsyncDatagramConnection::
+close() {
+  Completions done;
+  {
+    LightMutexHolder holder(_lock);
+#ifdef HAVE_OPENSSL
+    if (_tls != nullptr && _state == S_connected) {
+      // Tell the server we are done, if the socket will take it right away.
+      _tls->shutdown();
+      update_tls(done);
+      do_write(done);
+    }
+#endif
+    do_close(done);
+  }
+  _reactor->wake();
+  done.run();
+}
+
+/**
+ * Returns true if the connection is open and established.
+ */
+bool AsyncDatagramConnection::
+is_connected() const {
+  LightMutexHolder holder(_lock);
+  return _state == S_connected;
+}
+
+/**
+ * Returns true if the connection is open and established, and encrypted with
+ * SSL; see connect_tls().
+ */
+bool AsyncDatagramConnection::
+is_secure() const {
+#ifdef HAVE_OPENSSL
+  LightMutexHolder holder(_lock);
+  return _state == S_connected && _tls != nullptr;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Completes all of the collected futures.
+ */
+void AsyncDatagramConnection::Completions::
+run() {
+  for (AsyncFuture *future : _finished) {
+    future->set_result(nullptr);
+  }
+  for (AsyncFuture *future : _cancelled) {
+    future->cancel();
+  }
+  for (auto &pair : _received) {
+    pair.first->set_datagram(std::move(pair.second));
+  }
+}
+
+/**
+ * Called by the reactor to find out what to wait for.  Returns false if the
+ * connection is closed, and should be forgotten.
+ */
+bool AsyncDatagramConnection::
+get_select_state(SOCKET &fd, bool &want_write) {
+  LightMutexHolder holder(_lock);
+  if (_state == S_closed) {
+    return false;
+  }
+  fd = _socket.GetSocket();
+  want_write = (_state == S_connecting || _output_sent < _output.size());
+  return true;
+}
+
+/**
+ * Called by the reactor when the socket has data to read.
+ */
+void AsyncDatagramConnection::
+handle_read() {
+  Completions done;
+  {
+    LightMutexHolder holder(_lock);
+    if (_state != S_connected && _state != S_handshaking) {
+      return;
+    }
+
+    char buffer[read_buffer_size];
+    bool closed = false;
+    while (true) {
+      int bytes_read = _socket.RecvData(buffer, read_buffer_size);
+      if (bytes_read > 0) {
+#ifdef HAVE_OPENSSL
+        if (_tls != nullptr) {
+          _tls->receive((unsigned char *)buffer, bytes_read);
+        } else
+#endif
+        {
+          _input.insert(_input.end(), (unsigned char *)buffer,
+                        (unsigned char *)buffer + bytes_read);
+        }
+        if (bytes_read < read_buffer_size) {
+          break;
+        }
+      } else {
+        closed = (bytes_read == 0 ||
+                  Socket_IP::GetLastError() != LOCAL_BLOCKING_ERROR);
+        break;
+      }
+    }
+
+#ifdef HAVE_OPENSSL
+    if (_tls != nullptr) {
+      // Decrypt what we can, and send whatever the SSL protocol wants to send
+      // in response, such as the rest of the handshake.
+      if (update_tls(done)) {
+        do_write(done);
+      } else {
+        closed = true;
+      }
+    }
+#endif
+
+    parse_input(done);
+    if (closed) {
+      do_close(done);
+    }
+  }
+  done.run();
+}
+
+/**
+ * Called by the reactor when the socket can be written to, or has finished
+ * connecting.
+ */
+void AsyncDatagramConnection::
+handle_write() {
+  Completions done;
+  {
+    LightMutexHolder holder(_lock);
+    if (_state == S_connecting) {
+      int error = 0;
+      socklen_t length = sizeof(error);
+      if (getsockopt(_socket.GetSocket(), SOL_SOCKET, SO_ERROR,
+                     (char *)&error, &length) != 0 || error != 0) {
+        event_cat.warning()
+          << "Connection failed with error " << error << "\n";
+        do_close(done);
+      } else {
+#ifdef HAVE_OPENSSL
+        if (_tls != nullptr) {
+          // The connect future is completed once the handshake is done.
+          _state = S_handshaking;
+          if (!update_tls(done)) {
+            do_close(done);
+          } else {
+            do_write(done);
+          }
+        } else
+#endif
+        {
+          _state = S_connected;
+          done._finished.push_back(_connect_future);
+          _connect_future.clear();
+          do_write(done);
+        }
+      }
+
+    } else if (_state == S_connected || _state == S_handshaking) {
+      do_write(done);
+    }
+  }
+  done.run();
+}
+
+/**
+ * Called by the reactor when select() reports an exceptional condition on the
+ * socket, which on Windows is how a failed connection attempt is reported.
+ */
+void AsyncDatagramConnection::
+handle_error() {
+  Completions done;
+  {
+    LightMutexHolder holder(_lock);
+    if (_state == S_connecting) {
+      do_close(done);
+    }
+  }
+  done.run();
+}
+
+/**
+ * Extracts as many complete datagrams as are available in the input buffer.
+ * Assumes the lock is held.
+ */
+void AsyncDatagramConnection::
+parse_input(Completions &done) {
+  if (_tcp_header_size == 0) {
+    // Without a length prefix, whatever we read is a datagram.
+    if (!_input.empty()) {
+      deliver(Datagram(std::move(_input)), done);
+      _input.clear();
+    }
+    return;
+  }
+
+  size_t header_size = (size_t)_tcp_header_size;
+  size_t pos = 0;
+  while (_input.size() - pos >= header_size) {
+    DatagramTCPHeader header(&_input[pos], _tcp_header_size);
+    int size = header.get_datagram_size(_tcp_header_size);
+    if (size < 0) {
+      event_cat.error()
+        << "Received invalid datagram header, closing connection.\n";
+      do_close(done);
+      return;
+    }
+    if ((size_t)size > _max_datagram_size) {
+      event_cat.error()
+        << "Received header for datagram of " << size
+        << " bytes, larger than the limit of " << _max_datagram_size
+        << "; closing connection.\n";
+      do_close(done);
+      return;
+    }
+    if (_input.size() - pos - header_size < (size_t)size) {
+      break;
+    }
+
+    const unsigned char *data = &_input[pos + header_size];
+    deliver(Datagram(data, size), done);
+    pos += header_size + size;
+  }
+
+  _input.erase(_input.begin(), _input.begin() + pos);
+}
+
+/**
+ * Hands the datagram to the oldest outstanding recv_datagram() future, or
+ * keeps it for the next call if there is none.  Assumes the lock is held.
+ */
+void AsyncDatagramConnection::
+deliver(Datagram &&datagram, Completions &done) {
+  while (!_recv_futures.empty()) {
+    PT(AsyncDatagramFuture) future = std::move(_recv_futures.front());
+    _recv_futures.pop_front();
+
+    // Skip any futures that the application has given up on.
+    if (!future->done()) {
+      done._received.push_back(std::make_pair(std::move(future), std::move(datagram)));
+      return;
+    }
+  }
+  _received.push_back(std::move(datagram));
+}
+
+/**
+ * Writes as much of the output buffer as the socket will take without
+ * blocking, and completes the sends that have been fully written.  Assumes
+ * the lock is held.
+ */
+void AsyncDatagramConnection::
+do_write(Completions &done) {
+  while (_output_sent < _output.size()) {
+    int size = (int)std::min(_output.size() - _output_sent, (size_t)0x40000000);
+    int bytes_sent = _socket.SendData((const char *)&_output[_output_sent], size);
+    if (bytes_sent <= 0) {
+      if (Socket_IP::GetLastError() != LOCAL_BLOCKING_ERROR) {
+        do_close(done);
+        return;
+      }
+      break;
+    }
+    _output_sent += bytes_sent;
+    _total_sent += bytes_sent;
+  }
+
+  if (_output_sent == _output.size()) {
+    _output.clear();
+    _output_sent = 0;
+  }
+
+  while (!_send_futures.empty() && _send_futures.front().first <= _total_sent) {
+    done._finished.push_back(std::move(_send_futures.front().second));
+    _send_futures.pop_front();
+  }
+}
+
+/**
+ * Closes the socket and cancels all of the pending futures.  Assumes the lock
+ * is held.
+ */
+void AsyncDatagramConnection::
+do_close(Completions &done) {
+  if (_state == S_closed) {
+    return;
+  }
+  _socket.Close();
+  _state = S_closed;
+
+  if (_connect_future != nullptr) {
+    done._cancelled.push_back(std::move(_connect_future));
+  }
+  for (PT(AsyncDatagramFuture) &future : _recv_futures) {
+    done._cancelled.push_back(future.p());
+  }
+  _recv_futures.clear();
+  for (auto &pair : _send_futures) {
+    done._cancelled.push_back(std::move(pair.second));
+  }
+  _send_futures.clear();
+#ifdef HAVE_OPENSSL
+  for (PT(AsyncFuture) &future : _tls_send_futures) {
+    done._cancelled.push_back(std::move(future));
+  }
+  _tls_send_futures.clear();
+#endif
+
+  _output.clear();
+  _output_sent = 0;
+  _input.clear();
+}
+
+#ifdef HAVE_OPENSSL
+/**
+ * Catches up with the SSL channel after data has been passed to it: finishes
+ * the connection once the handshake is done, appends any data it has
+ * decrypted to the input buffer, and moves whatever it has to send to the
+ * output buffer.  Returns false if the handshake failed, or the secure
+ * session has ended.  Assumes the lock is held.
+ */
+bool AsyncDatagramConnection::
+update_tls(Completions &done) {
+  if (_state == S_handshaking) {
+    switch (_tls->get_state()) {
+    case SSLMemoryChannel::S_handshake:
+      break;
+
+    case SSLMemoryChannel::S_ready:
+      if (event_cat.is_debug()) {
+        event_cat.debug()
+          << "Secure connection to " << _tls->get_hostname() << " using "
+          << _tls->get_cipher_name() << "\n";
+      }
+      _state = S_connected;
+      done._finished.push_back(std::move(_connect_future));
+      _connect_future.clear();
+      break;
+
+    default:
+      event_cat.warning()
+        << "Unable to establish secure connection to "
+        << _tls->get_hostname() << "\n";
+      return false;
+    }
+  }
+
+  bool open = true;
+  if (_state == S_connected) {
+    open = _tls->read(_input);
+  }
+
+  size_t start = _output.size();
+  _tls->get_output(_output);
+  _total_queued += _output.size() - start;
+
+  if (_state == S_connected && !_tls_send_futures.empty()) {
+    // The datagrams that were sent during the handshake have just been
+    // encrypted, along with the end of the handshake.
+    for (PT(AsyncFuture) &future : _tls_send_futures) {
+      _send_futures.push_back(std::make_pair(_total_queued, std::move(future)));
+    }
+    _tls_send_futures.clear();
+  }
+  return open;
+}
+#endif  // HAVE_OPENSSL
+
+#endif  // HAVE_NET && WANT_NATIVE_NET
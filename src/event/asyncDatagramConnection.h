@@ -0,0 +1,201 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file asyncDatagramConnection.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef ASYNCDATAGRAMCONNECTION_H
+#define ASYNCDATAGRAMCONNECTION_H
+
+#include "pandabase.h"
+
+// These classes doesn't exist at all unless the net library is built.
+#if defined(HAVE_NET) && defined(WANT_NATIVE_NET)
+
+#include "asyncFuture.h"
+#include "socketReactor.h"
+#include "datagram.h"
+#include "socket_tcp.h"
+#include "lightMutex.h"
+#include "pdeque.h"
+#include "vector_uchar.h"
+
+#ifdef HAVE_OPENSSL
+#include "sslMemoryChannel.h"
+#endif
+
+class HTTPClient;
+
+/**
+ * The future returned by AsyncDatagramConnection::recv_datagram().  Its
+ * result is the datagram that was received.
+ */
+class EXPCL_PANDA_EVENT AsyncDatagramFuture final : public AsyncFuture {
+public:
+  INLINE AsyncDatagramFuture();
+  ALLOC_DELETED_CHAIN(AsyncDatagramFuture);
+
+PUBLISHED:
+  INLINE const Datagram &get_datagram() const;
+
+public:
+  INLINE void set_datagram(Datagram &&datagram);
+
+private:
+  Datagram _datagram;
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    AsyncFuture::init_type();
+    register_type(_type_handle, "AsyncDatagramFuture",
+                  AsyncFuture::get_class_type());
+  }
+  virtual TypeHandle get_type() const override {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() override {init_type(); return get_class_type();}
+
+private:
+  static TypeHandle _type_handle;
+};
+
+/**
+ * A TCP connection that exchanges datagrams, framed in the same way as
+ * ConnectionReader and ConnectionWriter frame them, whose operations return
+ * futures instead of blocking or requiring the application to poll.  The
+ * futures are completed by a SocketReactor, and may be awaited from a
+ * coroutine or task.
+ *
+ * A connection opened with connect_tls() is encrypted with SSL.  The
+ * handshake is carried out by the reactor along with all of the other
+ * traffic, so any number of secure connections may share its one thread.
+ *
+ * A connection remains registered with its reactor, and so stays alive, until
+ * close() is called or the other end closes it.  At that point, all pending
+ * futures are cancelled.
+ */
+class EXPCL_PANDA_EVENT AsyncDatagramConnection : public TypedReferenceCount {
+PUBLISHED:
+  explicit AsyncDatagramConnection(SocketReactor *reactor = nullptr);
+  virtual ~AsyncDatagramConnection();
+
+  INLINE void set_tcp_header_size(int tcp_header_size);
+  INLINE int get_tcp_header_size() const;
+  INLINE void set_max_datagram_size(size_t max_datagram_size);
+  INLINE size_t get_max_datagram_size() const;
+
+  PT(AsyncFuture) connect(const std::string &hostname, int port);
+#ifdef HAVE_OPENSSL
+  PT(AsyncFuture) connect_tls(const std::string &hostname, int port,
+                              HTTPClient *client = nullptr);
+#endif
+  PT(AsyncFuture) recv_datagram();
+  PT(AsyncFuture) send(const Datagram &datagram);
+  void close();
+
+  bool is_connected() const;
+  bool is_secure() const;
+  INLINE SocketReactor *get_reactor() const;
+
+public:
+  AsyncDatagramConnection(SocketReactor *reactor, SOCKET socket,
+                          int tcp_header_size);
+
+private:
+  // The futures to complete once the lock has been released.
+  class Completions {
+  public:
+    void run();
+
+    pvector<PT(AsyncFuture)> _finished;
+    pvector<PT(AsyncFuture)> _cancelled;
+    pvector<std::pair<PT(AsyncDatagramFuture), Datagram> > _received;
+  };
+
+  PT(AsyncFuture) do_connect(const std::string &hostname, int port,
+                             bool use_tls, HTTPClient *client);
+
+  bool get_select_state(SOCKET &fd, bool &want_write);
+  void handle_read();
+  void handle_write();
+  void handle_error();
+
+  void parse_input(Completions &done);
+  void deliver(Datagram &&datagram, Completions &done);
+  void do_write(Completions &done);
+  void do_close(Completions &done);
+#ifdef HAVE_OPENSSL
+  bool update_tls(Completions &done);
+#endif
+
+  enum State {
+    S_closed,
+    S_connecting,
+    S_handshaking,
+    S_connected,
+  };
+
+  PT(SocketReactor) _reactor;
+  int _tcp_header_size;
+  size_t _max_datagram_size;
+
+  mutable LightMutex _lock;
+  Socket_TCP _socket;
+  State _state;
+  PT(AsyncFuture) _connect_future;
+
+  vector_uchar _input;
+  pdeque<Datagram> _received;
+  pdeque<PT(AsyncDatagramFuture)> _recv_futures;
+
+  // _output holds the bytes not yet written, starting at _output_sent.  Each
+  // pending send is completed once _total_sent reaches its end offset.
+  vector_uchar _output;
+  size_t _output_sent;
+  uint64_t _total_queued;
+  uint64_t _total_sent;
+  pdeque<std::pair<uint64_t, PT(AsyncFuture)> > _send_futures;
+
+#ifdef HAVE_OPENSSL
+  // The SSL state, if this is a secure connection.  Sends made before the
+  // handshake has completed wait in _tls_send_futures, since it isn't known
+  // yet where they end up in _output.
+  PT(SSLMemoryChannel) _tls;
+  pvector<PT(AsyncFuture)> _tls_send_futures;
+#endif
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    TypedReferenceCount::init_type();
+    register_type(_type_handle, "AsyncDatagramConnection",
+                  TypedReferenceCount::get_class_type());
+  }
+  virtual TypeHandle get_type() const {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
+
+private:
+  static TypeHandle _type_handle;
+
+  friend class SocketReactor;
+};
+
+#include "asyncDatagramConnection.I"
+
+#endif  // HAVE_NET && WANT_NATIVE_NET
+
+#endif
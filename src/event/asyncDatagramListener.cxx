@@ -0,0 +1,187 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file asyncDatagramListener.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "asyncDatagramListener.h"
+
+// This file only defines anything if the net library is built.
+#if defined(HAVE_NET) && defined(WANT_NATIVE_NET)
+
+#include "config_event.h"
+#include "lightMutexHolder.h"
+#include "socket_address.h"
+
+TypeHandle AsyncDatagramListener::_type_handle;
+
+/**
+ * If reactor is nullptr, the global SocketReactor is used.
+ */
+AsyncDatagramListener::
+AsyncDatagramListener(SocketReactor *reactor) :
+  _reactor(reactor != nullptr ? reactor : SocketReactor::get_global_ptr()),
+  _tcp_header_size(tcp_header_size),
+  _listening(false)
+{
+}
+
+/**
+ *
+ */
+AsyncDatagramListener::
+~AsyncDatagramListener() {
+  _socket.Close();
+}
+
+/**
+ * Starts listening for connections on the indicated port.  Returns true on
+ * success, false if the port could not be opened.
+ */
+bool AsyncDatagramListener::
+listen(int port, int backlog) {
+  {
+    LightMutexHolder holder(_lock);
+    nassertr(!_listening, false);
+
+    if (!_socket.OpenForListen((unsigned short)port, backlog)) {
+      event_cat.error()
+        << "Unable to listen on port " << port << "\n";
+      return false;
+    }
+    _socket.SetNonBlocking();
+    _listening = true;
+  }
+
+  _reactor->add_listener(this);
+  return true;
+}
+
+/**
+ * Returns a future whose result is the next incoming connection, an
+ * AsyncDatagramConnection that is already registered with the reactor.  The
+ * future is cancelled if the listener is closed first.
+ */
+PT(AsyncFuture) AsyncDatagramListener::
+accept() {
+  PT(AsyncFuture) future = new AsyncFuture;
+
+  PT(AsyncDatagramConnection) connection;
+  bool closed = false;
+  {
+    LightMutexHolder holder(_lock);
+    if (!_accepted.empty()) {
+      connection = std::move(_accepted.front());
+      _accepted.pop_front();
+    } else if (!_listening) {
+      closed = true;
+    } else {
+      _accept_futures.push_back(future);
+    }
+  }
+
+  if (connection != nullptr) {
+    future->set_result(connection.p());
+  } else if (closed) {
+    future->cancel();
+  }
+  return future;
+}
+
+/**
+ * Stops listening, and cancels any pending accept() futures.  Connections that
+ * were already accepted are not affected.
+ */
+void AsyncDatagramListener::
+close() {
+  pdeque<PT(AsyncFuture)> futures;
+  {
+    LightMutexHolder holder(_lock);
+    if (!_listening) {
+      return;
+    }
+    _socket.Close();
+    _listening = false;
+    futures.swap(_accept_futures);
+  }
+  _reactor->wake();
+
+  for (AsyncFuture *future : futures) {
+    future->cancel();
+  }
+}
+
+/**
+ * Returns true if the listener is open.
+ */
+bool AsyncDatagramListener::
+is_listening() const {
+  LightMutexHolder holder(_lock);
+  return _listening;
+}
+
+/**
+ * Called by the reactor to find out which socket to wait on.  Returns false
+ * if the listener is closed, and should be forgotten.
+ */
+bool AsyncDatagramListener::
+get_select_state(SOCKET &fd) {
+  LightMutexHolder holder(_lock);
+  if (!_listening) {
+    return false;
+  }
+  fd = _socket.GetSocket();
+  return true;
+}
+
+/**
+ * Called by the reactor when there are connections waiting to be accepted.
+ */
+void AsyncDatagramListener::
+handle_accept() {
+  pvector<std::pair<PT(AsyncFuture), PT(AsyncDatagramConnection)> > done;
+  pvector<PT(AsyncDatagramConnection)> accepted;
+  {
+    LightMutexHolder holder(_lock);
+    if (!_listening) {
+      return;
+    }
+
+    SOCKET socket;
+    Socket_Address address;
+    while (_socket.GetIncomingConnection(socket, address)) {
+      PT(AsyncDatagramConnection) connection =
+        new AsyncDatagramConnection(_reactor, socket, _tcp_header_size);
+      accepted.push_back(connection);
+
+      // Skip any futures that the application has given up on.
+      while (!_accept_futures.empty() && _accept_futures.front()->done()) {
+        _accept_futures.pop_front();
+      }
+      if (!_accept_futures.empty()) {
+        done.push_back(std::make_pair(std::move(_accept_futures.front()), connection));
+        _accept_futures.pop_front();
+      } else {
+        _accepted.push_back(std::move(connection));
+      }
+    }
+  }
+
+  // The connections are registered before anyone gets to see them, so that
+  // a recv_datagram() on a new connection can't be missed.
+  for (AsyncDatagramConnection *connection : accepted) {
+    _reactor->add_connection(connection);
+  }
+  for (auto &pair : done) {
+    pair.first->set_result(pair.second.p());
+  }
+}
+
+#endif  // HAVE_NET && WANT_NATIVE_NET
@@ -0,0 +1,85 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file asyncDatagramListener.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef ASYNCDATAGRAMLISTENER_H
+#define ASYNCDATAGRAMLISTENER_H
+
+#include "pandabase.h"
+
+// This class doesn't exist at all unless the net library is built.
+#if defined(HAVE_NET) && defined(WANT_NATIVE_NET)
+
+#include "asyncFuture.h"
+#include "asyncDatagramConnection.h"
+#include "socketReactor.h"
+#include "socket_tcp_listen.h"
+#include "lightMutex.h"
+#include "pdeque.h"
+
+/**
+ * A TCP rendezvous socket that hands out each incoming connection as an
+ * AsyncDatagramConnection, through the future returned by accept().
+ */
+class EXPCL_PANDA_EVENT AsyncDatagramListener : public TypedReferenceCount {
+PUBLISHED:
+  explicit AsyncDatagramListener(SocketReactor *reactor = nullptr);
+  virtual ~AsyncDatagramListener();
+
+  INLINE void set_tcp_header_size(int tcp_header_size);
+  INLINE int get_tcp_header_size() const;
+
+  bool listen(int port, int backlog = 1024);
+  PT(AsyncFuture) accept();
+  void close();
+
+  bool is_listening() const;
+  INLINE SocketReactor *get_reactor() const;
+
+private:
+  bool get_select_state(SOCKET &fd);
+  void handle_accept();
+
+  PT(SocketReactor) _reactor;
+  int _tcp_header_size;
+
+  mutable LightMutex _lock;
+  Socket_TCP_Listen _socket;
+  bool _listening;
+  pdeque<PT(AsyncDatagramConnection)> _accepted;
+  pdeque<PT(AsyncFuture)> _accept_futures;
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    TypedReferenceCount::init_type();
+    register_type(_type_handle, "AsyncDatagramListener",
+                  TypedReferenceCount::get_class_type());
+  }
+  virtual TypeHandle get_type() const {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
+
+private:
+  static TypeHandle _type_handle;
+
+  friend class SocketReactor;
+};
+
+#include "asyncDatagramListener.I"
+
+#endif  // HAVE_NET && WANT_NATIVE_NET
+
+#endif
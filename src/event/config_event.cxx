@@ -12,6 +12,8 @@
  */
 
 #include "config_event.h"
+#include "asyncDatagramConnection.h"
+#include "asyncDatagramListener.h"
 #include "asyncFuture.h"
 #include "asyncTask.h"
 #include "asyncTaskChain.h"
@@ -35,7 +37,20 @@ Configure(config_event);
 NotifyCategoryDef(event, "");
 NotifyCategoryDef(task, "");
 
+#if defined(HAVE_NET) && defined(WANT_NATIVE_NET)
+ConfigVariableInt async_max_datagram_size
+("async-max-datagram-size", 1048576,
+ PRC_DESC("The default for AsyncDatagramConnection::set_max_datagram_size(): "
+          "the largest datagram, in bytes, that a connection will accept "
+          "from the other end before closing the connection."));
+#endif
+
 ConfigureFn(config_event) {
+#if defined(HAVE_NET) && defined(WANT_NATIVE_NET)
+  AsyncDatagramConnection::init_type();
+  AsyncDatagramFuture::init_type();
+  AsyncDatagramListener::init_type();
+#endif
   AsyncFuture::init_type();
   AsyncGatheringFuture::init_type();
   AsyncTask::init_type();
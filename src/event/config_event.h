@@ -17,8 +17,13 @@
 #include "pandabase.h"
 
 #include "notifyCategoryProxy.h"
+#include "configVariableInt.h"
 
 NotifyCategoryDecl(event, EXPCL_PANDA_EVENT, EXPTP_PANDA_EVENT);
 NotifyCategoryDecl(task, EXPCL_PANDA_EVENT, EXPTP_PANDA_EVENT);
 
+#if defined(HAVE_NET) && defined(WANT_NATIVE_NET)
+extern EXPCL_PANDA_EVENT ConfigVariableInt async_max_datagram_size;
+#endif
+
 #endif
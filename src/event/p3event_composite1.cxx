@@ -1,3 +1,5 @@
+#include "asyncDatagramConnection.cxx"
+#include "asyncDatagramListener.cxx"
 #include "asyncFuture.cxx"
 #include "asyncTask.cxx"
 #include "asyncTaskChain.cxx"
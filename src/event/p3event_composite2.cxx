@@ -6,3 +6,4 @@
 #include "eventReceiver.cxx"
 #include "pt_Event.cxx"
 
+#include "socketReactor.cxx"
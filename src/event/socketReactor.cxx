@@ -0,0 +1,378 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file socketReactor.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "socketReactor.h"
+
+// This file only defines anything if the net library is built.
+#if defined(HAVE_NET) && defined(WANT_NATIVE_NET)
+
+#include "asyncDatagramConnection.h"
+#include "asyncDatagramListener.h"
+#include "config_event.h"
+#include "mutexHolder.h"
+#include "socket_portable.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+SocketReactor *SocketReactor::_global_ptr = nullptr;
+
+/**
+ * Creates a new reactor.  If the platform supports true threads, its thread
+ * is started right away.
+ */
+SocketReactor::
+SocketReactor() :
+  _lock("SocketReactor::_lock"),
+  _shutdown(false)
+{
+#ifndef _WIN32
+  if (pipe(_wake_pipe) == 0) {
+    fcntl(_wake_pipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(_wake_pipe[1], F_SETFL, O_NONBLOCK);
+  } else {
+    _wake_pipe[0] = -1;
+    _wake_pipe[1] = -1;
+  }
+#endif
+
+  if (Thread::is_true_threads()) {
+    _thread = new ReactorThread(this);
+    if (!_thread->start(TP_normal, true)) {
+      _thread.clear();
+    }
+  }
+}
+
+/**
+ *
+ */
+SocketReactor::
+~SocketReactor() {
+  shutdown();
+
+#ifndef _WIN32
+  if (_wake_pipe[0] != -1) {
+    ::close(_wake_pipe[0]);
+    ::close(_wake_pipe[1]);
+  }
+#endif
+}
+
+/**
+ * Waits up to timeout seconds for socket activity, and completes whatever
+ * futures are ready.  This must be called periodically if the reactor does
+ * not have its own thread; otherwise, it does nothing.
+ */
+void SocketReactor::
+poll(double timeout) {
+  if (_thread == nullptr) {
+    run_once(timeout);
+  }
+}
+
+/**
+ * Stops the reactor thread, and closes all of the connections and listeners
+ * that are still registered.
+ */
+void SocketReactor::
+shutdown() {
+  {
+    MutexHolder holder(_lock);
+    if (_shutdown) {
+      return;
+    }
+    _shutdown = true;
+  }
+
+  if (_thread != nullptr) {
+    wake();
+    _thread->join();
+    _thread.clear();
+  }
+
+  Connections connections;
+  Listeners listeners;
+  {
+    MutexHolder holder(_lock);
+    connections.swap(_connections);
+    listeners.swap(_listeners);
+  }
+  for (AsyncDatagramConnection *connection : connections) {
+    connection->close();
+  }
+  for (AsyncDatagramListener *listener : listeners) {
+    listener->close();
+  }
+}
+
+/**
+ * Returns the reactor that is used by connections and listeners that were not
+ * given one explicitly.
+ */
+SocketReactor *SocketReactor::
+get_global_ptr() {
+  if (_global_ptr == nullptr) {
+    _global_ptr = new SocketReactor;
+    _global_ptr->ref();
+  }
+  return _global_ptr;
+}
+
+/**
+ * Starts watching the indicated connection.  It is forgotten again once it
+ * is closed.
+ */
+void SocketReactor::
+add_connection(AsyncDatagramConnection *connection) {
+  {
+    MutexHolder holder(_lock);
+    _connections.push_back(connection);
+  }
+  wake();
+}
+
+/**
+ * Starts watching the indicated listener.  It is forgotten again once it is
+ * closed.
+ */
+void SocketReactor::
+add_listener(AsyncDatagramListener *listener) {
+  {
+    MutexHolder holder(_lock);
+    _listeners.push_back(listener);
+  }
+  wake();
+}
+
+/**
+ * Interrupts the reactor's wait, so that it picks up any change in the set of
+ * sockets it should be watching.
+ */
+void SocketReactor::
+wake() {
+#ifndef _WIN32
+  if (_wake_pipe[1] != -1) {
+    char c = 0;
+    ssize_t result = ::write(_wake_pipe[1], &c, 1);
+    (void)result;
+  }
+#endif
+}
+
+/**
+ * The main loop of the reactor thread.
+ */
+void SocketReactor::
+thread_run() {
+  while (true) {
+    {
+      MutexHolder holder(_lock);
+      if (_shutdown) {
+        return;
+      }
+    }
+    run_once(-1.0);
+  }
+}
+
+/**
+ * Returns true if the indicated socket may be added to an fd_set that already
+ * holds num_fds sockets.  On Windows, an fd_set is a list of up to FD_SETSIZE
+ * sockets; elsewhere, it is a bitmask indexed by the descriptor, and setting a
+ * descriptor beyond the end of it would write past the end of the fd_set.
+ */
+static bool
+fits_fd_set(SOCKET fd, int num_fds) {
+#ifdef _WIN32
+  return num_fds < FD_SETSIZE;
+#else
+  return fd >= 0 && fd < FD_SETSIZE;
+#endif
+}
+
+/**
+ * Waits for activity on any of the registered sockets, up to timeout seconds,
+ * or indefinitely if timeout is negative, and handles it.
+ *
+ * Since this uses select(), a socket that cannot be placed in an fd_set is
+ * closed with an error, rather than watched.
+ */
+void SocketReactor::
+run_once(double timeout) {
+  // Take a snapshot of the sockets to watch, forgetting any that were closed.
+  // The snapshot also keeps them alive while we handle them below.
+  Connections connections;
+  Listeners listeners;
+  {
+    MutexHolder holder(_lock);
+    size_t j = 0;
+    for (size_t i = 0; i < _connections.size(); ++i) {
+      SOCKET fd;
+      bool want_write;
+      if (_connections[i]->get_select_state(fd, want_write)) {
+        _connections[j++] = _connections[i];
+      }
+    }
+    _connections.resize(j);
+
+    j = 0;
+    for (size_t i = 0; i < _listeners.size(); ++i) {
+      SOCKET fd;
+      if (_listeners[i]->get_select_state(fd)) {
+        _listeners[j++] = _listeners[i];
+      }
+    }
+    _listeners.resize(j);
+
+    connections = _connections;
+    listeners = _listeners;
+  }
+
+  fd_set read_set, write_set, except_set;
+  FD_ZERO(&read_set);
+  FD_ZERO(&write_set);
+  FD_ZERO(&except_set);
+  SOCKET max_fd = 0;
+  int num_fds = 0;
+
+  pvector<SOCKET> connection_fds(connections.size(), BAD_SOCKET);
+  for (size_t i = 0; i < connections.size(); ++i) {
+    SOCKET fd;
+    bool want_write;
+    if (connections[i]->get_select_state(fd, want_write)) {
+      if (!fits_fd_set(fd, num_fds)) {
+        event_cat.error()
+          << "Too many sockets for select(); closing connection on socket "
+          << fd << ".\n";
+        connections[i]->close();
+        continue;
+      }
+      connection_fds[i] = fd;
+      FD_SET(fd, &read_set);
+      FD_SET(fd, &except_set);
+      if (want_write) {
+        FD_SET(fd, &write_set);
+      }
+      max_fd = std::max(max_fd, fd);
+      ++num_fds;
+    }
+  }
+
+  pvector<SOCKET> listener_fds(listeners.size(), BAD_SOCKET);
+  for (size_t i = 0; i < listeners.size(); ++i) {
+    SOCKET fd;
+    if (listeners[i]->get_select_state(fd)) {
+      if (!fits_fd_set(fd, num_fds)) {
+        event_cat.error()
+          << "Too many sockets for select(); closing listener on socket "
+          << fd << ".\n";
+        listeners[i]->close();
+        continue;
+      }
+      listener_fds[i] = fd;
+      FD_SET(fd, &read_set);
+      max_fd = std::max(max_fd, fd);
+      ++num_fds;
+    }
+  }
+
+#ifdef _WIN32
+  // There is no wake pipe on Windows, so we never wait for long; otherwise a
+  // newly added socket, or a send that couldn't be completed right away,
+  // would go unnoticed until some other socket became active.
+  if (timeout < 0.0 || timeout > 0.01) {
+    timeout = 0.01;
+  }
+  if (num_fds == 0) {
+    // Windows' select() refuses to wait on nothing at all.
+    Thread::sleep(timeout);
+    return;
+  }
+#else
+  if (_wake_pipe[0] != -1 && fits_fd_set(_wake_pipe[0], num_fds)) {
+    FD_SET(_wake_pipe[0], &read_set);
+    max_fd = std::max(max_fd, (SOCKET)_wake_pipe[0]);
+  } else if (timeout < 0.0 || timeout > 0.01) {
+    timeout = 0.01;
+  }
+#endif
+
+  struct timeval tv;
+  struct timeval *tvp = nullptr;
+  if (timeout >= 0.0) {
+    tv.tv_sec = (long)timeout;
+    tv.tv_usec = (long)((timeout - (double)tv.tv_sec) * 1000000.0);
+    tvp = &tv;
+  }
+
+  int result = DO_SELECT(max_fd + 1, &read_set, &write_set, &except_set, tvp);
+  if (result <= 0) {
+    // Either a timeout or an interrupted call; there is nothing to handle.
+    return;
+  }
+
+#ifndef _WIN32
+  if (_wake_pipe[0] != -1 && fits_fd_set(_wake_pipe[0], num_fds) &&
+      FD_ISSET(_wake_pipe[0], &read_set)) {
+    char buffer[64];
+    while (::read(_wake_pipe[0], buffer, sizeof(buffer)) > 0) {
+    }
+  }
+#endif
+
+  for (size_t i = 0; i < connections.size(); ++i) {
+    SOCKET fd = connection_fds[i];
+    if (fd == BAD_SOCKET) {
+      continue;
+    }
+    if (FD_ISSET(fd, &except_set)) {
+      connections[i]->handle_error();
+    }
+    if (FD_ISSET(fd, &write_set)) {
+      connections[i]->handle_write();
+    }
+    if (FD_ISSET(fd, &read_set)) {
+      connections[i]->handle_read();
+    }
+  }
+
+  for (size_t i = 0; i < listeners.size(); ++i) {
+    SOCKET fd = listener_fds[i];
+    if (fd != BAD_SOCKET && FD_ISSET(fd, &read_set)) {
+      listeners[i]->handle_accept();
+    }
+  }
+}
+
+/**
+ *
+ */
+SocketReactor::ReactorThread::
+ReactorThread(SocketReactor *reactor) :
+  Thread("SocketReactor", "SocketReactor"),
+  _reactor(reactor)
+{
+}
+
+/**
+ *
+ */
+void SocketReactor::ReactorThread::
+thread_main() {
+  _reactor->thread_run();
+}
+
+#endif  // HAVE_NET && WANT_NATIVE_NET
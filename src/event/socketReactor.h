@@ -0,0 +1,92 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file socketReactor.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef SOCKETREACTOR_H
+#define SOCKETREACTOR_H
+
+#include "pandabase.h"
+
+// This class doesn't exist at all unless the net library is built.
+#if defined(HAVE_NET) && defined(WANT_NATIVE_NET)
+
+#include "referenceCount.h"
+#include "pointerTo.h"
+#include "pmutex.h"
+#include "thread.h"
+#include "pvector.h"
+
+class AsyncDatagramConnection;
+class AsyncDatagramListener;
+
+/**
+ * Waits for activity on the sockets of a set of AsyncDatagramConnections and
+ * AsyncDatagramListeners, and completes their futures as data arrives or can
+ * be sent.
+ *
+ * If the platform supports true threads, this runs in its own thread, and
+ * the futures are completed in the background.  Otherwise, poll() must be
+ * called periodically, for instance from a task.
+ */
+class EXPCL_PANDA_EVENT SocketReactor : public ReferenceCount {
+PUBLISHED:
+  SocketReactor();
+  ~SocketReactor();
+
+  INLINE bool is_threaded() const;
+  BLOCKING void poll(double timeout = 0.0);
+  void shutdown();
+
+  static SocketReactor *get_global_ptr();
+
+public:
+  void add_connection(AsyncDatagramConnection *connection);
+  void add_listener(AsyncDatagramListener *listener);
+  void wake();
+
+private:
+  void thread_run();
+  void run_once(double timeout);
+
+  class ReactorThread : public Thread {
+  public:
+    ReactorThread(SocketReactor *reactor);
+    virtual void thread_main();
+
+    SocketReactor *_reactor;
+  };
+
+  Mutex _lock;
+  typedef pvector<PT(AsyncDatagramConnection)> Connections;
+  typedef pvector<PT(AsyncDatagramListener)> Listeners;
+  Connections _connections;
+  Listeners _listeners;
+
+  PT(ReactorThread) _thread;
+  bool _shutdown;
+
+#ifndef _WIN32
+  // The reactor thread also waits on the read end of this pipe, so that it
+  // can be woken up when there is a new socket to watch.
+  int _wake_pipe[2];
+#endif
+
+  static SocketReactor *_global_ptr;
+
+  friend class ReactorThread;
+};
+
+#include "socketReactor.I"
+
+#endif  // HAVE_NET && WANT_NATIVE_NET
+
+#endif
@@ -0,0 +1,253 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_async_echo.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "asyncDatagramConnection.h"
+#include "asyncDatagramListener.h"
+#include "asyncTask.h"
+#include "asyncTaskManager.h"
+#include "datagramIterator.h"
+#include "trueClock.h"
+#include "panda_getopt.h"
+#include "preprocess_argv.h"
+
+#include <algorithm>
+
+// This is a loopback echo benchmark of AsyncDatagramConnection.  It starts an
+// echo server, and a number of client tasks that each send datagrams one at a
+// time and wait for them to come back.  All of the tasks run on the task
+// manager, and are only woken up when the future they are awaiting is
+// completed by the SocketReactor.  It reports the number of round trips per
+// second and the 99th percentile of the round trip time.
+
+static int port = 4998;
+static int num_clients = 16;
+static int num_messages = 1000;
+static int message_size = 64;
+
+static pvector<double> round_trips;
+static int clients_done = 0;
+
+static bool
+get_command_line_opts(int &argc, char **&argv) {
+  extern char *optarg;
+  extern int optind;
+  const char *options = "p:c:m:s:";
+  int flag = getopt(argc, argv, options);
+  while (flag != EOF) {
+    switch (flag) {
+    case 'p':
+      port = atoi(optarg);
+      break;
+
+    case 'c':
+      num_clients = std::max(atoi(optarg), 1);
+      break;
+
+    case 'm':
+      num_messages = std::max(atoi(optarg), 1);
+      break;
+
+    case 's':
+      message_size = std::max(atoi(optarg), 8);
+      break;
+
+    case '?':
+      nout
+        << "test_async_echo [-p port] [-c clients] [-m messages] [-s size]\n";
+      return false;
+    }
+
+    flag = getopt(argc, argv, options);
+  }
+
+  argv += (optind - 1);
+  argc -= (optind - 1);
+
+  return true;
+}
+
+/**
+ * Sends back every datagram received on one connection, until it is closed.
+ */
+class EchoTask : public AsyncTask {
+public:
+  EchoTask(AsyncDatagramConnection *connection) :
+    AsyncTask("echo"),
+    _connection(connection)
+  {
+  }
+
+  virtual DoneStatus do_task() {
+    while (true) {
+      if (_future == nullptr) {
+        _future = _connection->recv_datagram();
+      }
+      if (!_future->done()) {
+        return _future->add_waiting_task(this) ? DS_await : DS_cont;
+      }
+      if (_future->cancelled()) {
+        return DS_done;
+      }
+      AsyncDatagramFuture *future = DCAST(AsyncDatagramFuture, _future.p());
+      _connection->send(future->get_datagram());
+      _future.clear();
+    }
+  }
+
+  PT(AsyncDatagramConnection) _connection;
+  PT(AsyncFuture) _future;
+};
+
+/**
+ * Starts an EchoTask for each incoming connection.
+ */
+class AcceptTask : public AsyncTask {
+public:
+  AcceptTask(AsyncDatagramListener *listener) :
+    AsyncTask("accept"),
+    _listener(listener)
+  {
+  }
+
+  virtual DoneStatus do_task() {
+    while (true) {
+      if (_future == nullptr) {
+        _future = _listener->accept();
+      }
+      if (!_future->done()) {
+        return _future->add_waiting_task(this) ? DS_await : DS_cont;
+      }
+      if (_future->cancelled()) {
+        return DS_done;
+      }
+      AsyncDatagramConnection *connection =
+        DCAST(AsyncDatagramConnection, _future->get_result());
+      get_manager()->add(new EchoTask(connection));
+      _future.clear();
+    }
+  }
+
+  PT(AsyncDatagramListener) _listener;
+  PT(AsyncFuture) _future;
+};
+
+/**
+ * Connects to the server, and then sends datagrams one at a time, timing how
+ * long each takes to come back.
+ */
+class ClientTask : public AsyncTask {
+public:
+  ClientTask() :
+    AsyncTask("client"),
+    _connection(new AsyncDatagramConnection),
+    _sent(0)
+  {
+  }
+
+  virtual DoneStatus do_task() {
+    TrueClock *clock = TrueClock::get_global_ptr();
+    while (true) {
+      if (_future == nullptr) {
+        _future = _connection->connect("127.0.0.1", port);
+      }
+      if (!_future->done()) {
+        return _future->add_waiting_task(this) ? DS_await : DS_cont;
+      }
+      if (_future->cancelled()) {
+        nout << "Connection lost.\n";
+        ++clients_done;
+        return DS_done;
+      }
+
+      if (_future->is_exact_type(AsyncDatagramFuture::get_class_type())) {
+        // A datagram came back.
+        AsyncDatagramFuture *future = DCAST(AsyncDatagramFuture, _future.p());
+        DatagramIterator scan(future->get_datagram());
+        round_trips.push_back(clock->get_short_time() - scan.get_float64());
+      }
+
+      if (_sent == num_messages) {
+        _connection->close();
+        ++clients_done;
+        return DS_done;
+      }
+
+      Datagram datagram;
+      datagram.add_float64(clock->get_short_time());
+      datagram.pad_bytes(message_size - 8);
+      _connection->send(datagram);
+      ++_sent;
+      _future = _connection->recv_datagram();
+    }
+  }
+
+  PT(AsyncDatagramConnection) _connection;
+  PT(AsyncFuture) _future;
+  int _sent;
+};
+
+int
+main(int argc, char *argv[]) {
+  preprocess_argv(argc, argv);
+  if (!get_command_line_opts(argc, argv)) {
+    return (1);
+  }
+
+  SocketReactor *reactor = SocketReactor::get_global_ptr();
+  PT(AsyncDatagramListener) listener = new AsyncDatagramListener(reactor);
+  if (!listener->listen(port)) {
+    nout << "Cannot grab port " << port << ".\n";
+    return (1);
+  }
+
+  PT(AsyncTaskManager) task_mgr = AsyncTaskManager::get_global_ptr();
+  task_mgr->add(new AcceptTask(listener));
+  for (int i = 0; i < num_clients; ++i) {
+    task_mgr->add(new ClientTask);
+  }
+
+  nout << num_clients << " clients, " << num_messages << " datagrams of "
+       << message_size << " bytes each, "
+       << (reactor->is_threaded() ? "threaded" : "polled") << " reactor.\n";
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  round_trips.reserve((size_t)num_clients * num_messages);
+  double start = clock->get_short_time();
+  double timeout = start + 60.0;
+  while (clients_done < num_clients && clock->get_short_time() < timeout) {
+    task_mgr->poll();
+    if (reactor->is_threaded()) {
+      Thread::force_yield();
+    } else {
+      reactor->poll(0.001);
+    }
+  }
+  double elapsed = clock->get_short_time() - start;
+
+  listener->close();
+  reactor->shutdown();
+
+  if (round_trips.empty()) {
+    nout << "No round trips completed.\n";
+    return (1);
+  }
+
+  std::sort(round_trips.begin(), round_trips.end());
+  double p99 = round_trips[std::min(round_trips.size() - 1, round_trips.size() * 99 / 100)];
+  nout << round_trips.size() << " round trips in " << elapsed << " s: "
+       << (int)(round_trips.size() / elapsed) << " round trips/s, p99 "
+       << p99 * 1000000.0 << " us\n";
+
+  return (clients_done == num_clients && (int)round_trips.size() == num_clients * num_messages) ? 0 : 1;
+}
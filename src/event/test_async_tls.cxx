@@ -0,0 +1,239 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_async_tls.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "asyncDatagramConnection.h"
+#include "asyncTask.h"
+#include "asyncTaskManager.h"
+#include "httpClient.h"
+#include "filename.h"
+#include "trueClock.h"
+#include "panda_getopt.h"
+#include "preprocess_argv.h"
+
+#include <algorithm>
+
+// This runs a number of https clients at once over AsyncDatagramConnection,
+// all of them serviced by the one SocketReactor thread.  Each opens a secure
+// connection, makes a series of requests on it, and waits for each response
+// in turn.  It is meant to be run against fake_http_server in https mode:
+//
+//   fake_http_server 4443 cert.pem key.pem
+//   test_async_tls -p 4443 -a cert.pem
+//
+// Without -a, the server's certificate is not checked at all.
+
+#ifdef HAVE_OPENSSL
+
+static std::string hostname = "localhost";
+static int port = 4443;
+static int num_clients = 16;
+static int num_requests = 10;
+static Filename ca_filename;
+
+static pvector<double> handshake_times;
+static int responses = 0;
+static int clients_done = 0;
+
+static bool
+get_command_line_opts(int &argc, char **&argv) {
+  extern char *optarg;
+  extern int optind;
+  const char *options = "h:p:c:r:a:";
+  int flag = getopt(argc, argv, options);
+  while (flag != EOF) {
+    switch (flag) {
+    case 'h':
+      hostname = optarg;
+      break;
+
+    case 'p':
+      port = atoi(optarg);
+      break;
+
+    case 'c':
+      num_clients = std::max(atoi(optarg), 1);
+      break;
+
+    case 'r':
+      num_requests = std::max(atoi(optarg), 1);
+      break;
+
+    case 'a':
+      ca_filename = Filename::from_os_specific(optarg);
+      break;
+
+    case '?':
+      nout
+        << "test_async_tls [-h host] [-p port] [-c clients] [-r requests] "
+        << "[-a ca.pem]\n";
+      return false;
+    }
+
+    flag = getopt(argc, argv, options);
+  }
+
+  argv += (optind - 1);
+  argc -= (optind - 1);
+
+  return true;
+}
+
+/**
+ * Opens a secure connection, and makes one request after another on it.
+ */
+class ClientTask : public AsyncTask {
+public:
+  ClientTask(HTTPClient *client) :
+    AsyncTask("client"),
+    _client(client),
+    _connection(new AsyncDatagramConnection),
+    _connected(false),
+    _start(0.0),
+    _sent(0)
+  {
+    // The response comes as a plain stream of bytes.
+    _connection->set_tcp_header_size(0);
+  }
+
+  virtual DoneStatus do_task() {
+    TrueClock *clock = TrueClock::get_global_ptr();
+    while (true) {
+      if (_future == nullptr) {
+        _start = clock->get_short_time();
+        _future = _connection->connect_tls(hostname, port, _client);
+      }
+      if (!_future->done()) {
+        return _future->add_waiting_task(this) ? DS_await : DS_cont;
+      }
+      if (_future->cancelled()) {
+        nout << "Connection lost.\n";
+        ++clients_done;
+        return DS_done;
+      }
+
+      if (!_connected) {
+        _connected = true;
+        handshake_times.push_back(clock->get_short_time() - _start);
+
+      } else {
+        AsyncDatagramFuture *future = DCAST(AsyncDatagramFuture, _future.p());
+        _response += future->get_datagram().get_message();
+        if (!have_response()) {
+          _future = _connection->recv_datagram();
+          continue;
+        }
+        ++responses;
+      }
+
+      if (_sent == num_requests) {
+        _connection->close();
+        ++clients_done;
+        return DS_done;
+      }
+
+      Datagram request;
+      request.append_data("GET / HTTP/1.1\r\nHost: " + hostname + "\r\n\r\n");
+      _connection->send(request);
+      ++_sent;
+      _response.clear();
+      _future = _connection->recv_datagram();
+    }
+  }
+
+  // Returns true if _response holds the headers and the complete body.
+  bool have_response() const {
+    size_t end = _response.find("\r\n\r\n");
+    if (end == std::string::npos) {
+      return false;
+    }
+    size_t length = 0;
+    size_t p = _response.find("Content-Length:");
+    if (p != std::string::npos && p < end) {
+      length = (size_t)atoi(_response.c_str() + p + 15);
+    }
+    return _response.size() >= end + 4 + length;
+  }
+
+  PT(HTTPClient) _client;
+  PT(AsyncDatagramConnection) _connection;
+  PT(AsyncFuture) _future;
+  bool _connected;
+  double _start;
+  int _sent;
+  std::string _response;
+};
+
+int
+main(int argc, char *argv[]) {
+  preprocess_argv(argc, argv);
+  if (!get_command_line_opts(argc, argv)) {
+    return (1);
+  }
+
+  PT(HTTPClient) client = new HTTPClient;
+  if (ca_filename.empty()) {
+    client->set_verify_ssl(HTTPClient::VS_no_verify);
+  } else if (!client->load_certificates(ca_filename)) {
+    nout << "Unable to load " << ca_filename << ".\n";
+    return (1);
+  }
+
+  SocketReactor *reactor = SocketReactor::get_global_ptr();
+  PT(AsyncTaskManager) task_mgr = AsyncTaskManager::get_global_ptr();
+  for (int i = 0; i < num_clients; ++i) {
+    task_mgr->add(new ClientTask(client));
+  }
+
+  nout << num_clients << " clients, " << num_requests
+       << " requests each to " << hostname << ":" << port << ", "
+       << (reactor->is_threaded() ? "threaded" : "polled") << " reactor.\n";
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  double timeout = start + 60.0;
+  while (clients_done < num_clients && clock->get_short_time() < timeout) {
+    task_mgr->poll();
+    if (reactor->is_threaded()) {
+      Thread::force_yield();
+    } else {
+      reactor->poll(0.001);
+    }
+  }
+  double elapsed = clock->get_short_time() - start;
+
+  reactor->shutdown();
+
+  if (handshake_times.empty()) {
+    nout << "No secure connections were established.\n";
+    return (1);
+  }
+
+  std::sort(handshake_times.begin(), handshake_times.end());
+  double median = handshake_times[handshake_times.size() / 2];
+  nout << handshake_times.size() << " handshakes, median "
+       << median * 1000.0 << " ms; " << responses << " responses in "
+       << elapsed << " s: " << (int)(responses / elapsed) << " requests/s\n";
+
+  return (responses == num_clients * num_requests) ? 0 : 1;
+}
+
+#else  // HAVE_OPENSSL
+
+int
+main(int argc, char *argv[]) {
+  nout << "test_async_tls requires OpenSSL.\n";
+  return (1);
+}
+
+#endif  // HAVE_OPENSSL
@@ -14,9 +14,12 @@
     compress_string.h \
     config_express.h \
     copy_stream.h \
-    datagram.I datagram.h datagramGenerator.I \
-    datagramGenerator.h \
+    datagram.I datagram.h datagramBitReader.I datagramBitReader.h \
+    datagramBitWriter.I datagramBitWriter.h \
+    datagramBufferPool.I datagramBufferPool.h \
+    datagramGenerator.I datagramGenerator.h \
     datagramIterator.I datagramIterator.h datagramSink.I datagramSink.h \
+    datagramView.I datagramView.h \
     dcast.h dcast.T \
     encrypt_string.h \
     error_utils.h \
@@ -79,7 +82,8 @@
     compress_string.cxx \
     config_express.cxx \
     copy_stream.cxx \
-    datagram.cxx datagramGenerator.cxx \
+    datagram.cxx datagramBitReader.cxx datagramBitWriter.cxx \
+    datagramBufferPool.cxx datagramGenerator.cxx \
     datagramIterator.cxx \
     datagramSink.cxx \
     dcast.cxx \
@@ -135,9 +139,12 @@
     compress_string.h \
     config_express.h \
     copy_stream.h \
-    datagram.I datagram.h datagramGenerator.I \
-    datagramGenerator.h \
+    datagram.I datagram.h datagramBitReader.I datagramBitReader.h \
+    datagramBitWriter.I datagramBitWriter.h \
+    datagramBufferPool.I datagramBufferPool.h \
+    datagramGenerator.I datagramGenerator.h \
     datagramIterator.I datagramIterator.h datagramSink.I datagramSink.h \
+    datagramView.I datagramView.h \
     dcast.h dcast.T \
     encrypt_string.h \
     error_utils.h \
@@ -270,6 +277,28 @@
 #end test_bin_target
 
 
+#begin test_bin_target
+  #define TARGET test_datagram_packing
+  #define LOCAL_LIBS $[LOCAL_LIBS] p3express
+  #define OTHER_LIBS p3dtoolutil:c p3dtool:m p3prc
+
+  #define SOURCES \
+    test_datagram_packing.cxx
+
+#end test_bin_target
+
+
+#begin test_bin_target
+  #define TARGET test_datagram_view
+  #define LOCAL_LIBS $[LOCAL_LIBS] p3express
+  #define OTHER_LIBS p3dtoolutil:c p3dtool:m p3prc
+
+  #define SOURCES \
+    test_datagram_view.cxx
+
+#end test_bin_target
+
+
 #begin test_bin_target
   #define TARGET test_ordered_vector
 
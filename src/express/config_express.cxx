@@ -86,6 +86,12 @@ ConfigVariableBool collect_tcp
 ConfigVariableDouble collect_tcp_interval
 ("collect-tcp-interval", 0.2);
 
+ConfigVariableInt datagram_buffer_pool_size
+("datagram-buffer-pool-size", 64,
+ PRC_DESC("The maximum number of released datagram buffers of each size that "
+          "the global DatagramBufferPool will hold on to for reuse.  Set this "
+          "to 0 to disable pooling of datagram buffers."));
+
 /**
  * Initializes the library.  This must be called at least once before any of
  * the functions or classes in this library can be used.  Normally it will be
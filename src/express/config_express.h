@@ -54,6 +54,8 @@ extern ConfigVariableBool multifile_always_binary;
 extern EXPCL_PANDA_EXPRESS ConfigVariableBool collect_tcp;
 extern EXPCL_PANDA_EXPRESS ConfigVariableDouble collect_tcp_interval;
 
+extern EXPCL_PANDA_EXPRESS ConfigVariableInt datagram_buffer_pool_size;
+
 extern EXPCL_PANDA_EXPRESS void init_libexpress();
 
 #endif /* __CONFIG_UTIL_H__ */
@@ -75,6 +75,11 @@ PUBLISHED:
   INLINE void add_be_float32(PN_float32 value);
   INLINE void add_be_float64(PN_float64 value);
 
+  // These functions pack integers in as few bytes as their magnitude allows,
+  // seven bits to a byte.
+  INLINE void add_varuint(uint64_t value);
+  INLINE void add_varint(int64_t value);
+
   INLINE void add_string(const std::string &str);
   INLINE void add_string32(const std::string &str);
   INLINE void add_z_string(const std::string &str);
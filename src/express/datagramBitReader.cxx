@@ -0,0 +1,26 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file datagramBitReader.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "datagramBitReader.h"
+
+/**
+ * Extracts a value written by DatagramBitWriter::add_quantized_float() with
+ * the same range and number of bits.
+ */
+PN_float32 DatagramBitReader::
+get_quantized_float(PN_float32 min_value, PN_float32 max_value, int num_bits) {
+  nassertr(num_bits >= 1 && num_bits <= 32, min_value);
+  double max_step = (double)(((uint64_t)1 << num_bits) - 1);
+  double t = (double)get_bits(num_bits) / max_step;
+  return (PN_float32)((double)min_value + t * ((double)max_value - (double)min_value));
+}
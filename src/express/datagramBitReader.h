@@ -0,0 +1,49 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file datagramBitReader.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef DATAGRAMBITREADER_H
+#define DATAGRAMBITREADER_H
+
+#include "pandabase.h"
+#include "datagramIterator.h"
+#include "numeric_types.h"
+
+/**
+ * Extracts the values written by a DatagramBitWriter.  Bytes are taken from
+ * the DatagramIterator only as they are needed, so once the bits have been
+ * read and align() has been called, the iterator may be used to read whatever
+ * follows them.
+ */
+class EXPCL_PANDA_EXPRESS DatagramBitReader {
+PUBLISHED:
+  INLINE explicit DatagramBitReader(DatagramIterator &source);
+
+  INLINE uint32_t get_bits(int num_bits);
+  INLINE bool get_bool();
+  INLINE int32_t get_int(int num_bits);
+  PN_float32 get_quantized_float(PN_float32 min_value, PN_float32 max_value,
+                                 int num_bits);
+
+  INLINE void align();
+  INLINE size_t get_num_bits() const;
+
+private:
+  DatagramIterator *_source;
+  uint64_t _buffer;
+  int _num_buffered;
+  size_t _num_bits;
+};
+
+#include "datagramBitReader.I"
+
+#endif
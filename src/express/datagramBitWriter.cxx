@@ -0,0 +1,38 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file datagramBitWriter.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "datagramBitWriter.h"
+
+#include <math.h>
+
+/**
+ * Adds a floating-point value, which is clamped to the range [min_value,
+ * max_value] and rounded to one of 2^num_bits evenly spaced steps across it,
+ * including both ends.  The error is at most half a step.
+ */
+void DatagramBitWriter::
+add_quantized_float(PN_float32 value, PN_float32 min_value,
+                    PN_float32 max_value, int num_bits) {
+  nassertv(num_bits >= 1 && num_bits <= 32);
+  nassertv(max_value > min_value);
+
+  double max_step = (double)(((uint64_t)1 << num_bits) - 1);
+  double t = ((double)value - (double)min_value) / ((double)max_value - (double)min_value);
+  if (!(t > 0.0)) {
+    // This also catches NaN.
+    t = 0.0;
+  } else if (t > 1.0) {
+    t = 1.0;
+  }
+  add_bits((uint32_t)floor(t * max_step + 0.5), num_bits);
+}
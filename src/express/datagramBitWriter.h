@@ -0,0 +1,54 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file datagramBitWriter.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef DATAGRAMBITWRITER_H
+#define DATAGRAMBITWRITER_H
+
+#include "pandabase.h"
+#include "datagram.h"
+#include "numeric_types.h"
+
+/**
+ * Appends values of arbitrary bit widths to a Datagram, packed together
+ * without regard to byte boundaries, least significant bit first.  They may
+ * be read back with a DatagramBitReader.
+ *
+ * Whole bytes are added to the Datagram as they fill up; the last partial
+ * byte is padded with zero bits and added by flush(), which must be called
+ * before anything else is added to the Datagram, and is called by the
+ * destructor.
+ */
+class EXPCL_PANDA_EXPRESS DatagramBitWriter {
+PUBLISHED:
+  INLINE explicit DatagramBitWriter(Datagram &datagram);
+  INLINE ~DatagramBitWriter();
+
+  INLINE void add_bits(uint32_t value, int num_bits);
+  INLINE void add_bool(bool value);
+  INLINE void add_int(int32_t value, int num_bits);
+  void add_quantized_float(PN_float32 value, PN_float32 min_value,
+                           PN_float32 max_value, int num_bits);
+
+  INLINE void flush();
+  INLINE size_t get_num_bits() const;
+
+private:
+  Datagram *_datagram;
+  uint64_t _buffer;
+  int _num_buffered;
+  size_t _num_bits;
+};
+
+#include "datagramBitWriter.I"
+
+#endif
@@ -0,0 +1,159 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file datagramBufferPool.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "datagramBufferPool.h"
+#include "datagram.h"
+#include "lightMutexHolder.h"
+#include "config_express.h"
+
+AtomicAdjust::Pointer DatagramBufferPool::_global_ptr = nullptr;
+
+/**
+ * Creates a pool that keeps up to max_free_per_bin released buffers of each
+ * size.
+ */
+DatagramBufferPool::
+DatagramBufferPool(size_t max_free_per_bin) :
+  _max_free_per_bin(max_free_per_bin)
+{
+}
+
+/**
+ *
+ */
+DatagramBufferPool::
+~DatagramBufferPool() {
+}
+
+/**
+ * Returns an empty array with room for at least size bytes, reusing a
+ * released one if there is one available.  The caller is free to append to it
+ * or resize it as it likes.
+ */
+PTA_uchar DatagramBufferPool::
+get_buffer(size_t size) {
+  int bits = min_bin_bits;
+  while (bits <= max_bin_bits && ((size_t)1 << bits) < size) {
+    ++bits;
+  }
+
+  if (bits > max_bin_bits) {
+    // Too big to be worth keeping around.
+    PTA_uchar buffer = PTA_uchar::empty_array(0);
+    buffer.v().reserve(size);
+    return buffer;
+  }
+
+  pvector<PTA_uchar> &bin = _bins[bits - min_bin_bits];
+  {
+    LightMutexHolder holder(_lock);
+    if (!bin.empty()) {
+      PTA_uchar buffer = std::move(bin.back());
+      bin.pop_back();
+      return buffer;
+    }
+  }
+
+  PTA_uchar buffer = PTA_uchar::empty_array(0);
+  buffer.v().reserve((size_t)1 << bits);
+  return buffer;
+}
+
+/**
+ * Gives the indicated array back to the pool, and clears the PTA_uchar.  The
+ * array is only kept if nothing else is still referencing it, and if its
+ * capacity fits one of the bins.
+ */
+void DatagramBufferPool::
+release_buffer(PTA_uchar &buffer) {
+  if (buffer == nullptr) {
+    return;
+  }
+  if (buffer.get_ref_count() != 1) {
+    buffer.clear();
+    return;
+  }
+
+  // File the buffer under the largest bin it can satisfy.
+  size_t capacity = buffer.v().capacity();
+  int bits = max_bin_bits;
+  while (bits >= min_bin_bits && ((size_t)1 << bits) > capacity) {
+    --bits;
+  }
+  if (bits < min_bin_bits || capacity > ((size_t)2 << max_bin_bits)) {
+    buffer.clear();
+    return;
+  }
+
+  buffer.v().clear();
+
+  pvector<PTA_uchar> &bin = _bins[bits - min_bin_bits];
+  LightMutexHolder holder(_lock);
+  if (bin.size() < _max_free_per_bin) {
+    bin.push_back(std::move(buffer));
+  }
+  buffer.clear();
+}
+
+/**
+ * Takes the storage out of the indicated datagram, leaving it empty, and
+ * gives it back to the pool.  This should be called once the application is
+ * done with a datagram it received, so that the buffer may be used for a
+ * future one.  If the datagram's storage is shared with another Datagram, it
+ * is merely released.
+ */
+void DatagramBufferPool::
+release(Datagram &datagram) {
+  PTA_uchar buffer = datagram.get_array().cast_non_const();
+  datagram.set_array(PTA_uchar());
+  release_buffer(buffer);
+}
+
+/**
+ * Returns the number of released buffers currently held by the pool.
+ */
+size_t DatagramBufferPool::
+get_num_free() const {
+  LightMutexHolder holder(_lock);
+  size_t num_free = 0;
+  for (int i = 0; i < num_bins; ++i) {
+    num_free += _bins[i].size();
+  }
+  return num_free;
+}
+
+/**
+ * Frees all of the buffers held by the pool.
+ */
+void DatagramBufferPool::
+clear() {
+  LightMutexHolder holder(_lock);
+  for (int i = 0; i < num_bins; ++i) {
+    _bins[i].clear();
+  }
+}
+
+/**
+ * Creates the global pool, if another thread has not already done so.
+ */
+DatagramBufferPool *DatagramBufferPool::
+make_global_ptr() {
+  DatagramBufferPool *ptr = new DatagramBufferPool(datagram_buffer_pool_size);
+  void *result = AtomicAdjust::compare_and_exchange_ptr(_global_ptr, nullptr, (void *)ptr);
+  if (result != nullptr) {
+    // Someone else beat us to it.
+    delete ptr;
+    return (DatagramBufferPool *)result;
+  }
+  return ptr;
+}
@@ -0,0 +1,69 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file datagramBufferPool.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef DATAGRAMBUFFERPOOL_H
+#define DATAGRAMBUFFERPOOL_H
+
+#include "pandabase.h"
+#include "pta_uchar.h"
+#include "lightMutex.h"
+#include "atomicAdjust.h"
+#include "pvector.h"
+
+class Datagram;
+
+/**
+ * A pool of previously-allocated arrays for use as Datagram storage.  Code
+ * that receives a steady stream of datagrams, like the ConnectionReader, can
+ * take its buffers from here instead of allocating a new one for each
+ * datagram; once the application is done with a datagram, it may hand it back
+ * with release() so that its buffer can be used again.
+ *
+ * Buffers are kept in bins by capacity, in powers of two from 256 bytes to 64
+ * KB.  Larger requests are simply allocated, and are not kept when they are
+ * released.
+ */
+class EXPCL_PANDA_EXPRESS DatagramBufferPool {
+PUBLISHED:
+  explicit DatagramBufferPool(size_t max_free_per_bin);
+  ~DatagramBufferPool();
+
+  PTA_uchar get_buffer(size_t size);
+  void release_buffer(PTA_uchar &buffer);
+  void release(Datagram &datagram);
+
+  size_t get_num_free() const;
+  void clear();
+
+  INLINE static DatagramBufferPool *get_global_ptr();
+
+private:
+  static DatagramBufferPool *make_global_ptr();
+
+  enum {
+    min_bin_bits = 8,
+    max_bin_bits = 16,
+    num_bins = max_bin_bits - min_bin_bits + 1,
+  };
+
+  size_t _max_free_per_bin;
+
+  mutable LightMutex _lock;
+  pvector<PTA_uchar> _bins[num_bins];
+
+  static AtomicAdjust::Pointer _global_ptr;
+};
+
+#include "datagramBufferPool.I"
+
+#endif
@@ -28,7 +28,7 @@ get_string() {
   uint16_t s_len = get_uint16();
 
   nassertr(_datagram != nullptr, "");
-  nassertr(_current_index + s_len <= _datagram->get_length(), "");
+  nassertr(_current_index + s_len <= get_end_index(), "");
 
   const char *ptr = (const char *)_datagram->get_data();
   size_t last_index = _current_index;
@@ -47,7 +47,7 @@ get_string32() {
   uint32_t s_len = get_uint32();
 
   nassertr(_datagram != nullptr, "");
-  nassertr(_current_index + s_len <= _datagram->get_length(), "");
+  nassertr(_current_index + s_len <= get_end_index(), "");
 
   const char *ptr = (const char *)_datagram->get_data();
   size_t last_index = _current_index;
@@ -66,7 +66,7 @@ get_z_string() {
 
   // First, determine the length of the string.
   const char *ptr = (const char *)_datagram->get_data();
-  size_t length = _datagram->get_length();
+  size_t length = get_end_index();
   size_t p = _current_index;
   while (p < length && ptr[p] != '\0') {
     ++p;
@@ -86,7 +86,7 @@ get_z_string() {
 string DatagramIterator::
 get_fixed_string(size_t size) {
   nassertr(_datagram != nullptr, "");
-  nassertr(_current_index + size <= _datagram->get_length(), "");
+  nassertr(_current_index + size <= get_end_index(), "");
 
   const char *ptr = (const char *)_datagram->get_data();
   string s(ptr + _current_index, size);
@@ -106,7 +106,7 @@ get_wstring() {
   uint32_t s_len = get_uint32();
 
   nassertr(_datagram != nullptr, wstring());
-  nassertr(_current_index + s_len * 2 <= _datagram->get_length(), wstring());
+  nassertr(_current_index + s_len * 2 <= get_end_index(), wstring());
 
   wstring result;
   result.reserve(s_len);
@@ -126,7 +126,7 @@ vector_uchar DatagramIterator::
 extract_bytes(size_t size) {
   nassertr((int)size >= 0, vector_uchar());
   nassertr(_datagram != nullptr, vector_uchar());
-  nassertr(_current_index + size <= _datagram->get_length(), vector_uchar());
+  nassertr(_current_index + size <= get_end_index(), vector_uchar());
 
   const unsigned char *ptr = (const unsigned char *)_datagram->get_data();
   ptr += _current_index;
@@ -146,7 +146,7 @@ size_t DatagramIterator::
 extract_bytes(unsigned char *into, size_t size) {
   nassertr((int)size >= 0, 0);
   nassertr(_datagram != nullptr, 0);
-  nassertr(_current_index + size <= _datagram->get_length(), 0);
+  nassertr(_current_index + size <= get_end_index(), 0);
 
   const char *ptr = (const char *)_datagram->get_data();
   memcpy(into, ptr + _current_index, size);
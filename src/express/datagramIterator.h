@@ -17,16 +17,33 @@
 #include "pandabase.h"
 
 #include "datagram.h"
+#include "datagramView.h"
 #include "numeric_types.h"
 
 /**
  * A class to retrieve the individual data elements previously stored in a
  * Datagram.  Elements may be retrieved one at a time; it is up to the caller
  * to know the correct type and order of each element.
+ *
+ * The *_view() methods return references to the bytes within the Datagram
+ * rather than copies of them, and get_slice() returns an iterator over a
+ * sub-range of the same Datagram.  These allow a message to be parsed without
+ * allocating memory for each field, but the results are only valid as long as
+ * the Datagram is not modified or destroyed.
  */
 class EXPCL_PANDA_EXPRESS DatagramIterator {
 public:
   INLINE void assign(Datagram &datagram, size_t offset = 0);
+  INLINE size_t get_end_index() const;
+
+  INLINE DatagramView get_string_view();
+  INLINE DatagramView get_string32_view();
+  INLINE DatagramView get_blob_view();
+  INLINE DatagramView get_blob32_view();
+  INLINE DatagramView extract_bytes_view(size_t size);
+  INLINE DatagramView get_remaining_view() const;
+
+  INLINE DatagramIterator get_slice(size_t size);
 
 PUBLISHED:
   INLINE DatagramIterator();
@@ -55,6 +72,9 @@ PUBLISHED:
   INLINE PN_float32 get_be_float32();
   INLINE PN_float64 get_be_float64();
 
+  INLINE uint64_t get_varuint();
+  INLINE int64_t get_varint();
+
   std::string get_string();
   std::string get_string32();
   std::string get_z_string();
@@ -80,6 +100,7 @@ PUBLISHED:
 private:
   const Datagram *_datagram;
   size_t _current_index;
+  size_t _end_index;
 
 public:
   static TypeHandle get_class_type() {
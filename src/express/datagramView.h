@@ -0,0 +1,55 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file datagramView.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef DATAGRAMVIEW_H
+#define DATAGRAMVIEW_H
+
+#include "pandabase.h"
+#include "vector_uchar.h"
+#include "pnotify.h"
+
+/**
+ * A non-owning reference to a range of bytes within a Datagram, as returned
+ * by DatagramIterator::get_string_view() and friends.  No copy of the data
+ * is made; the view is only valid until the Datagram it was taken from is
+ * modified or destroyed.
+ */
+class EXPCL_PANDA_EXPRESS DatagramView {
+public:
+  INLINE DatagramView();
+  INLINE DatagramView(const unsigned char *data, size_t size);
+
+  INLINE const unsigned char *data() const;
+  INLINE size_t size() const;
+  INLINE bool empty() const;
+
+  INLINE const unsigned char *begin() const;
+  INLINE const unsigned char *end() const;
+  INLINE unsigned char operator [] (size_t n) const;
+
+  INLINE std::string get_string() const;
+  INLINE vector_uchar get_blob() const;
+
+  INLINE bool operator == (const DatagramView &other) const;
+  INLINE bool operator != (const DatagramView &other) const;
+  INLINE bool operator == (const std::string &other) const;
+  INLINE bool operator != (const std::string &other) const;
+
+private:
+  const unsigned char *_data;
+  size_t _size;
+};
+
+#include "datagramView.I"
+
+#endif
@@ -4,6 +4,9 @@
 #include "compress_string.cxx"
 #include "copy_stream.cxx"
 #include "datagram.cxx"
+#include "datagramBitReader.cxx"
+#include "datagramBitWriter.cxx"
+#include "datagramBufferPool.cxx"
 #include "datagramGenerator.cxx"
 #include "datagramIterator.cxx"
 #include "datagramSink.cxx"
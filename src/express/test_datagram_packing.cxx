@@ -0,0 +1,288 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_datagram_packing.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "datagram.h"
+#include "datagramIterator.h"
+#include "datagramBitWriter.h"
+#include "datagramBitReader.h"
+#include "trueClock.h"
+#include "pvector.h"
+
+#include <limits>
+
+// This checks that the varint and bit-packed encodings of Datagram round-trip
+// their edge cases, and then compares them with the fixed-width encodings on
+// a typical stream of object fields: small ids, counts and flags, signed
+// deltas, and floats in a known range.  For each encoding it reports the
+// bytes and nanoseconds per field, writing and reading.
+
+static const int num_objects = 100000;
+static int num_failures = 0;
+
+static void
+check(bool condition, const char *message) {
+  if (!condition) {
+    nout << "FAILED: " << message << "\n";
+    ++num_failures;
+  }
+}
+
+static void
+test_varints() {
+  static const uint64_t uvalues[] = {
+    0, 1, 127, 128, 255, 300, 16383, 16384, 0xffffffffu, 0x100000000ull,
+    std::numeric_limits<uint64_t>::max(),
+  };
+  static const int64_t svalues[] = {
+    0, 1, -1, 63, -64, 64, -65, 0x7fffffff, -0x7fffffff - 1,
+    std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min(),
+  };
+
+  Datagram dg;
+  for (uint64_t value : uvalues) {
+    dg.add_varuint(value);
+  }
+  for (int64_t value : svalues) {
+    dg.add_varint(value);
+  }
+
+  DatagramIterator scan(dg);
+  for (uint64_t value : uvalues) {
+    check(scan.get_varuint() == value, "varuint round trip");
+  }
+  for (int64_t value : svalues) {
+    check(scan.get_varint() == value, "varint round trip");
+  }
+  check(scan.get_remaining_size() == 0, "varints consume the whole datagram");
+
+  Datagram small;
+  small.add_varuint(127);
+  small.add_varint(-64);
+  check(small.get_length() == 2, "small varints take one byte");
+
+  Datagram large;
+  large.add_varuint(std::numeric_limits<uint64_t>::max());
+  check(large.get_length() == 10, "the largest varint takes ten bytes");
+}
+
+static void
+test_bits() {
+  Datagram dg;
+  {
+    DatagramBitWriter writer(dg);
+    writer.add_bool(true);
+    writer.add_bits(5, 3);
+    writer.add_int(-3, 4);
+    writer.add_int(7, 4);
+    writer.add_bits(0xdeadbeef, 32);
+    writer.add_int(std::numeric_limits<int32_t>::min(), 32);
+    writer.add_bool(false);
+    writer.add_bits(0x12345, 17);
+    check(writer.get_num_bits() == 1 + 3 + 4 + 4 + 32 + 32 + 1 + 17,
+          "bit count");
+  }
+  // The writer pads the last byte when it is flushed.
+  check(dg.get_length() == (94 + 7) / 8, "bit-packed length");
+  dg.add_uint8(0xa5);
+
+  DatagramIterator scan(dg);
+  {
+    DatagramBitReader reader(scan);
+    check(reader.get_bool() == true, "bool");
+    check(reader.get_bits(3) == 5, "unsigned bits");
+    check(reader.get_int(4) == -3, "negative signed bits");
+    check(reader.get_int(4) == 7, "positive signed bits");
+    check(reader.get_bits(32) == 0xdeadbeef, "32 bits");
+    check(reader.get_int(32) == std::numeric_limits<int32_t>::min(),
+          "32 signed bits");
+    check(reader.get_bool() == false, "bool");
+    check(reader.get_bits(17) == 0x12345, "17 bits");
+    reader.align();
+  }
+  check(scan.get_uint8() == 0xa5, "byte after the aligned bits");
+}
+
+static void
+test_quantized() {
+  static const int bit_counts[] = { 4, 8, 12, 16, 24 };
+  for (int num_bits : bit_counts) {
+    PN_float32 min_value = -100.0f;
+    PN_float32 max_value = 250.0f;
+    PN_float32 step = (max_value - min_value) / (PN_float32)((1u << num_bits) - 1);
+
+    Datagram dg;
+    pvector<PN_float32> values;
+    {
+      DatagramBitWriter writer(dg);
+      for (int i = 0; i <= 1000; ++i) {
+        PN_float32 value = min_value + (max_value - min_value) * i / 1000.0f;
+        values.push_back(value);
+        writer.add_quantized_float(value, min_value, max_value, num_bits);
+      }
+      // Out-of-range values are clamped.
+      writer.add_quantized_float(-1000.0f, min_value, max_value, num_bits);
+      writer.add_quantized_float(1000.0f, min_value, max_value, num_bits);
+    }
+
+    DatagramIterator scan(dg);
+    DatagramBitReader reader(scan);
+    PN_float32 max_error = 0.0f;
+    for (PN_float32 value : values) {
+      PN_float32 result = reader.get_quantized_float(min_value, max_value, num_bits);
+      max_error = std::max(max_error, (PN_float32)fabs(result - value));
+    }
+    check(max_error <= step * 0.5f + 0.0001f, "quantization error within half a step");
+    check(reader.get_quantized_float(min_value, max_value, num_bits) == min_value,
+          "clamped to the minimum");
+    check(reader.get_quantized_float(min_value, max_value, num_bits) == max_value,
+          "clamped to the maximum");
+
+    nout << num_bits << "-bit floats: max error " << max_error
+         << " (step " << step << ")\n";
+  }
+}
+
+/**
+ * A typical object update: an id, a small count, a pair of flags, a signed
+ * delta and three coordinates within the world bounds.
+ */
+class Fields {
+public:
+  uint32_t _id;
+  uint32_t _count;
+  bool _visible;
+  bool _moving;
+  int32_t _delta;
+  PN_float32 _pos[3];
+};
+static const int fields_per_object = 8;
+
+static void
+report(const char *name, size_t length, double write_time, double read_time) {
+  double num_fields = (double)num_objects * fields_per_object;
+  nout << name << ": " << length / num_fields << " bytes/field, write "
+       << write_time * 1.0e9 / num_fields << " ns/field, read "
+       << read_time * 1.0e9 / num_fields << " ns/field\n";
+}
+
+static void
+benchmark() {
+  pvector<Fields> objects(num_objects);
+  uint32_t seed = 1;
+  for (Fields &fields : objects) {
+    seed = seed * 1103515245 + 12345;
+    fields._id = (uint32_t)(&fields - &objects[0]) * 3;
+    fields._count = (seed >> 16) % 20;
+    fields._visible = (seed & 0x100) != 0;
+    fields._moving = (seed & 0x200) != 0;
+    fields._delta = (int32_t)((seed >> 8) % 200) - 100;
+    for (int i = 0; i < 3; ++i) {
+      seed = seed * 1103515245 + 12345;
+      fields._pos[i] = ((seed >> 8) % 100000) * 0.01f - 500.0f;
+    }
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  uint64_t checksum = 0;
+
+  {
+    Datagram dg;
+    double start = clock->get_short_time();
+    for (const Fields &fields : objects) {
+      dg.add_uint32(fields._id);
+      dg.add_uint32(fields._count);
+      dg.add_bool(fields._visible);
+      dg.add_bool(fields._moving);
+      dg.add_int32(fields._delta);
+      for (int i = 0; i < 3; ++i) {
+        dg.add_float32(fields._pos[i]);
+      }
+    }
+    double write_time = clock->get_short_time() - start;
+
+    start = clock->get_short_time();
+    DatagramIterator scan(dg);
+    for (int n = 0; n < num_objects; ++n) {
+      checksum += scan.get_uint32();
+      checksum += scan.get_uint32();
+      checksum += scan.get_bool();
+      checksum += scan.get_bool();
+      checksum += scan.get_int32();
+      for (int i = 0; i < 3; ++i) {
+        checksum += (uint64_t)scan.get_float32();
+      }
+    }
+    double read_time = clock->get_short_time() - start;
+    report("fixed width", dg.get_length(), write_time, read_time);
+  }
+
+  {
+    Datagram dg;
+    double start = clock->get_short_time();
+    uint32_t last_id = 0;
+    for (const Fields &fields : objects) {
+      dg.add_varuint(fields._id - last_id);
+      last_id = fields._id;
+      dg.add_varuint(fields._count);
+      {
+        DatagramBitWriter writer(dg);
+        writer.add_bool(fields._visible);
+        writer.add_bool(fields._moving);
+        writer.add_int(fields._delta, 9);
+        for (int i = 0; i < 3; ++i) {
+          writer.add_quantized_float(fields._pos[i], -512.0f, 512.0f, 16);
+        }
+      }
+    }
+    double write_time = clock->get_short_time() - start;
+
+    start = clock->get_short_time();
+    DatagramIterator scan(dg);
+    uint32_t id = 0;
+    for (int n = 0; n < num_objects; ++n) {
+      id += (uint32_t)scan.get_varuint();
+      checksum += id;
+      checksum += scan.get_varuint();
+      DatagramBitReader reader(scan);
+      checksum += reader.get_bool();
+      checksum += reader.get_bool();
+      checksum += reader.get_int(9);
+      for (int i = 0; i < 3; ++i) {
+        checksum += (uint64_t)reader.get_quantized_float(-512.0f, 512.0f, 16);
+      }
+      reader.align();
+    }
+    double read_time = clock->get_short_time() - start;
+    check(scan.get_remaining_size() == 0, "packed stream consumed");
+    report("packed", dg.get_length(), write_time, read_time);
+  }
+
+  // Keep the reads from being optimized away.
+  nout << "(checksum " << checksum << ")\n";
+}
+
+int
+main(int argc, char *argv[]) {
+  test_varints();
+  test_bits();
+  test_quantized();
+
+  if (num_failures != 0) {
+    nout << num_failures << " checks failed.\n";
+    return (1);
+  }
+
+  benchmark();
+  return (0);
+}
@@ -0,0 +1,228 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_datagram_view.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "datagram.h"
+#include "datagramIterator.h"
+#include "datagramView.h"
+#include "datagramBufferPool.h"
+#include "pnotify.h"
+
+// This checks that the views returned by DatagramIterator point into the
+// datagram and compare by content, that a slice cannot read past its own end
+// even though the datagram goes on, and that a DatagramBufferPool hands
+// released buffers out again, but never takes a buffer that another Datagram
+// is still using.
+//
+// Reading past the end of a slice is expected to fail an assertion; these
+// are caught and cleared, so this should be run without assert-abort.
+
+static int num_failures = 0;
+
+static void
+check(bool condition, const char *message) {
+  if (!condition) {
+    nout << "FAILED: " << message << "\n";
+    ++num_failures;
+  }
+}
+
+/**
+ * Returns true if an assertion has failed since the last call, and clears
+ * it.
+ */
+static bool
+assert_failed() {
+  Notify *notify = Notify::ptr();
+  bool failed = notify->has_assert_failed();
+  notify->clear_assert_failed();
+  return failed;
+}
+
+static void
+test_views() {
+  Datagram dg;
+  dg.add_string("hello");
+  dg.add_blob(vector_uchar(3, 7));
+  dg.add_string("hello");
+  dg.add_string("");
+
+  DatagramIterator scan(dg);
+  const unsigned char *start = (const unsigned char *)dg.get_data();
+  DatagramView hello = scan.get_string_view();
+  check(hello.data() == start + 2, "view points into the datagram");
+  check(hello.size() == 5 && hello == std::string("hello"),
+        "view matches the string");
+  check(hello != std::string("hell") && hello != std::string("hellos"),
+        "view doesn't match a prefix or extension of the string");
+
+  DatagramView blob = scan.get_blob_view();
+  check(blob.get_blob() == vector_uchar(3, 7), "blob view copies out");
+  check(blob != hello, "views of different lengths differ");
+
+  // A view compares by content, not by where the bytes are.
+  DatagramView hello2 = scan.get_string_view();
+  check(hello2.data() != hello.data(), "second string is a separate view");
+  check(hello2 == hello, "views of the same bytes are equal");
+  check(hello2.get_string() == "hello", "view copies out");
+
+  DatagramView empty = scan.get_string_view();
+  check(empty.empty() && empty == DatagramView() && empty == std::string(),
+        "empty views are equal");
+  check(scan.get_remaining_size() == 0 && scan.get_remaining_view().empty(),
+        "views consume the datagram");
+
+  Datagram other;
+  other.add_string("jello");
+  DatagramIterator other_scan(other);
+  check(other_scan.get_string_view() != hello,
+        "views of different bytes differ");
+
+  check(!assert_failed(), "no assertions while reading views");
+}
+
+static void
+test_slices() {
+  Datagram dg;
+  dg.add_uint8(1);
+  dg.add_uint16(0x1234);
+  dg.add_uint32(0xdeadbeef);
+  dg.add_uint8(2);
+  dg.add_string("after");
+
+  DatagramIterator scan(dg);
+  check(scan.get_uint8() == 1, "read before slice");
+
+  DatagramIterator slice = scan.get_slice(6);
+  check(scan.get_current_index() == 7, "slice is skipped by the parent");
+  check(slice.get_current_index() == 1 && slice.get_end_index() == 7,
+        "slice covers its bytes");
+  check(slice.get_remaining_size() == 6, "slice remaining size");
+  check(slice.get_remaining_view().size() == 6, "slice remaining view");
+
+  // A nested slice ends where its parent does.
+  DatagramIterator inner = slice.get_slice(2);
+  check(inner.get_uint16() == 0x1234, "read inside nested slice");
+  check(inner.get_remaining_size() == 0, "nested slice is used up");
+  check(slice.get_uint32() == 0xdeadbeef, "read inside slice");
+  check(slice.get_remaining_size() == 0, "slice is used up");
+  check(!assert_failed(), "no assertions while reading within the slice");
+
+  // Every kind of read past the end of the slice fails, even though the
+  // datagram goes on, and leaves the slice where it was.
+  check(slice.get_uint8() == 0 && assert_failed(), "byte read past slice fails");
+  check(slice.get_uint32() == 0 && assert_failed(), "int read past slice fails");
+  check(slice.get_string().empty() && assert_failed(),
+        "string read past slice fails");
+  check(slice.extract_bytes_view(1).empty() && assert_failed(),
+        "view past slice fails");
+  slice.get_slice(1);
+  check(assert_failed(), "slice past slice fails");
+  check(slice.get_current_index() == 7, "failed reads don't move the slice");
+
+  // A string whose length runs past the end of the slice fails too.
+  DatagramIterator scan2(dg);
+  scan2.skip_bytes(7);
+  DatagramIterator short_slice = scan2.get_slice(4);
+  check(short_slice.get_uint8() == 2, "read inside second slice");
+  check(short_slice.get_string_view().empty() && assert_failed(),
+        "string running past slice fails");
+
+  // The parent iterator still reads the rest of the datagram.
+  check(scan.get_uint8() == 2, "read after slice");
+  check(scan.get_string() == "after", "string after slice");
+  check(scan.get_remaining_size() == 0, "datagram is used up");
+
+  // Slicing more than is left fails.
+  DatagramIterator scan3(dg);
+  scan3.get_slice(dg.get_length() + 1);
+  check(assert_failed(), "oversized slice fails");
+  check(scan3.get_current_index() == 0, "oversized slice doesn't move");
+}
+
+static void
+test_pool() {
+  DatagramBufferPool pool(2);
+  check(pool.get_num_free() == 0, "new pool is empty");
+
+  // A buffer comes back empty, with at least the requested capacity.
+  PTA_uchar buffer = pool.get_buffer(100);
+  check(buffer != nullptr && buffer.size() == 0 && buffer.v().capacity() >= 100,
+        "buffer has the requested capacity");
+  const pvector<unsigned char> *storage = &buffer.v();
+
+  Datagram dg;
+  dg.set_array(buffer);
+  buffer.clear();
+  dg.add_string("some data");
+
+  // Releasing the datagram empties it and keeps its buffer.
+  pool.release(dg);
+  check(dg.get_length() == 0, "released datagram is empty");
+  check(pool.get_num_free() == 1, "released buffer is kept");
+
+  PTA_uchar reused = pool.get_buffer(200);
+  check(&reused.v() == storage, "released buffer is reused");
+  check(reused.size() == 0, "reused buffer is empty");
+  check(pool.get_num_free() == 0, "reused buffer is taken from the pool");
+
+  // A buffer that another Datagram still shares is not taken.
+  Datagram dg2;
+  dg2.set_array(reused);
+  reused.clear();
+  dg2.add_string("shared");
+  Datagram copy = dg2;
+  pool.release(dg2);
+  check(dg2.get_length() == 0, "released shared datagram is empty");
+  check(pool.get_num_free() == 0, "shared buffer is not kept");
+  DatagramIterator scan(copy);
+  check(scan.get_string() == "shared", "copy keeps the shared buffer");
+
+  // Once the copy is the only one left, its buffer may be kept.
+  pool.release(copy);
+  check(pool.get_num_free() == 1, "unshared buffer is kept");
+  PTA_uchar again = pool.get_buffer(10);
+  check(&again.v() == storage, "buffer is reused again");
+  again.clear();
+
+  // Large requests are not kept, and neither are buffers beyond the limit.
+  PTA_uchar large = pool.get_buffer(1 << 20);
+  check(large.v().capacity() >= (1 << 20), "large buffer has its capacity");
+  pool.release_buffer(large);
+  check(large == nullptr, "released buffer is cleared");
+  check(pool.get_num_free() == 0, "large buffer is not kept");
+
+  for (int i = 0; i < 3; ++i) {
+    PTA_uchar extra = PTA_uchar::empty_array(0);
+    extra.v().reserve(1000);
+    pool.release_buffer(extra);
+  }
+  check(pool.get_num_free() == 2, "pool keeps only as many as its limit");
+
+  pool.clear();
+  check(pool.get_num_free() == 0, "cleared pool is empty");
+}
+
+int
+main(int argc, char *argv[]) {
+  test_views();
+  test_slices();
+  test_pool();
+
+  if (num_failures != 0) {
+    nout << num_failures << " checks failed.\n";
+    return 1;
+  }
+  nout << "All checks passed.\n";
+  return 0;
+}
@@ -11390,6 +11390,20 @@ end_bind_clip_planes() {
 void CLP(GraphicsStateGuardian)::
 set_state_and_transform(const RenderState *target,
                         const TransformState *transform) {
+  set_state_delta_and_transform(target, transform, nullptr,
+                                RenderState::SlotMask());
+}
+
+/**
+ * Like set_state_and_transform(), but changed_slots indicates which
+ * attributes differ between prev_state and target.  If the GSG is still in
+ * prev_state, this saves comparing the two states again here.
+ */
+void CLP(GraphicsStateGuardian)::
+set_state_delta_and_transform(const RenderState *target,
+                              const TransformState *transform,
+                              const RenderState *prev_state,
+                              const RenderState::SlotMask &changed_slots) {
   report_my_gl_errors();
 #ifndef NDEBUG
   if (gsg_cat.is_spam()) {
@@ -11424,6 +11438,15 @@ set_state_and_transform(const RenderState *target,
   }
   _target_rs = target;
 
+  // Find out which attributes differ from the current state.  The cull
+  // thread may already have worked this out for us.
+  RenderState::SlotMask changed;
+  if (prev_state != nullptr && prev_state == _state_rs) {
+    changed = changed_slots;
+  } else {
+    changed = target->get_changed_slots(_state_rs);
+  }
+
 #ifndef OPENGLES_1
   determine_target_shader();
   _instance_count = _target_shader->get_instance_count();
@@ -11447,7 +11470,7 @@ set_state_and_transform(const RenderState *target,
 #endif
 
   int antialias_slot = AntialiasAttrib::get_class_slot();
-  if (_target_rs->get_attrib(antialias_slot) != _state_rs->get_attrib(antialias_slot) ||
+  if (changed.get_bit(antialias_slot) ||
       !_state_mask.get_bit(antialias_slot)) {
     // PStatGPUTimer timer(this, _draw_set_state_antialias_pcollector);
     do_issue_antialias();
@@ -11455,7 +11478,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int clip_plane_slot = ClipPlaneAttrib::get_class_slot();
-  if (_target_rs->get_attrib(clip_plane_slot) != _state_rs->get_attrib(clip_plane_slot) ||
+  if (changed.get_bit(clip_plane_slot) ||
       !_state_mask.get_bit(clip_plane_slot)) {
     // PStatGPUTimer timer(this, _draw_set_state_clip_plane_pcollector);
     do_issue_clip_plane();
@@ -11464,8 +11487,8 @@ set_state_and_transform(const RenderState *target,
 
   int color_slot = ColorAttrib::get_class_slot();
   int color_scale_slot = ColorScaleAttrib::get_class_slot();
-  if (_target_rs->get_attrib(color_slot) != _state_rs->get_attrib(color_slot) ||
-      _target_rs->get_attrib(color_scale_slot) != _state_rs->get_attrib(color_scale_slot) ||
+  if (changed.get_bit(color_slot) ||
+      changed.get_bit(color_scale_slot) ||
       !_state_mask.get_bit(color_slot) ||
       !_state_mask.get_bit(color_scale_slot)) {
     // PStatGPUTimer timer(this, _draw_set_state_color_pcollector);
@@ -11476,7 +11499,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int cull_face_slot = CullFaceAttrib::get_class_slot();
-  if (_target_rs->get_attrib(cull_face_slot) != _state_rs->get_attrib(cull_face_slot) ||
+  if (changed.get_bit(cull_face_slot) ||
       !_state_mask.get_bit(cull_face_slot)) {
     // PStatGPUTimer timer(this, _draw_set_state_cull_face_pcollector);
     do_issue_cull_face();
@@ -11484,7 +11507,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int depth_offset_slot = DepthOffsetAttrib::get_class_slot();
-  if (_target_rs->get_attrib(depth_offset_slot) != _state_rs->get_attrib(depth_offset_slot) ||
+  if (changed.get_bit(depth_offset_slot) ||
       !_state_mask.get_bit(depth_offset_slot)) {
     // PStatGPUTimer timer(this, _draw_set_state_depth_offset_pcollector);
     do_issue_depth_offset();
@@ -11492,7 +11515,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int depth_test_slot = DepthTestAttrib::get_class_slot();
-  if (_target_rs->get_attrib(depth_test_slot) != _state_rs->get_attrib(depth_test_slot) ||
+  if (changed.get_bit(depth_test_slot) ||
       !_state_mask.get_bit(depth_test_slot)) {
     // PStatGPUTimer timer(this, _draw_set_state_depth_test_pcollector);
     do_issue_depth_test();
@@ -11500,7 +11523,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int depth_write_slot = DepthWriteAttrib::get_class_slot();
-  if (_target_rs->get_attrib(depth_write_slot) != _state_rs->get_attrib(depth_write_slot) ||
+  if (changed.get_bit(depth_write_slot) ||
       !_state_mask.get_bit(depth_write_slot)) {
     // PStatGPUTimer timer(this, _draw_set_state_depth_write_pcollector);
     do_issue_depth_write();
@@ -11508,7 +11531,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int render_mode_slot = RenderModeAttrib::get_class_slot();
-  if (_target_rs->get_attrib(render_mode_slot) != _state_rs->get_attrib(render_mode_slot) ||
+  if (changed.get_bit(render_mode_slot) ||
       !_state_mask.get_bit(render_mode_slot)) {
     // PStatGPUTimer timer(this, _draw_set_state_render_mode_pcollector);
     do_issue_render_mode();
@@ -11517,7 +11540,7 @@ set_state_and_transform(const RenderState *target,
 
 #if !defined(OPENGLES) || defined(OPENGLES_1)
   int logic_op_slot = LogicOpAttrib::get_class_slot();
-  if (_target_rs->get_attrib(logic_op_slot) != _state_rs->get_attrib(logic_op_slot) ||
+  if (changed.get_bit(logic_op_slot) ||
       !_state_mask.get_bit(logic_op_slot)) {
     // PStatGPUTimer timer(this, _draw_set_state_logic_op_pcollector);
     do_issue_logic_op();
@@ -11528,9 +11551,9 @@ set_state_and_transform(const RenderState *target,
   int transparency_slot = TransparencyAttrib::get_class_slot();
   int color_write_slot = ColorWriteAttrib::get_class_slot();
   int color_blend_slot = ColorBlendAttrib::get_class_slot();
-  if (_target_rs->get_attrib(transparency_slot) != _state_rs->get_attrib(transparency_slot) ||
-      _target_rs->get_attrib(color_write_slot) != _state_rs->get_attrib(color_write_slot) ||
-      _target_rs->get_attrib(color_blend_slot) != _state_rs->get_attrib(color_blend_slot) ||
+  if (changed.get_bit(transparency_slot) ||
+      changed.get_bit(color_write_slot) ||
+      changed.get_bit(color_blend_slot) ||
       !_state_mask.get_bit(transparency_slot) ||
       !_state_mask.get_bit(color_write_slot) ||
       !_state_mask.get_bit(color_blend_slot)
@@ -11547,7 +11570,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int texture_slot = TextureAttrib::get_class_slot();
-  if (_target_rs->get_attrib(texture_slot) != _state_rs->get_attrib(texture_slot) ||
+  if (changed.get_bit(texture_slot) ||
       !_state_mask.get_bit(texture_slot)) {
     PStatGPUTimer timer(this, _draw_set_state_texture_pcollector);
     determine_target_texture();
@@ -11568,8 +11591,8 @@ set_state_and_transform(const RenderState *target,
   if (_tex_gen_modifies_mat) {
     int tex_gen_slot = TexGenAttrib::get_class_slot();
     int tex_matrix_slot = TexMatrixAttrib::get_class_slot();
-    if (_target_rs->get_attrib(tex_gen_slot) != _state_rs->get_attrib(tex_gen_slot) ||
-        _target_rs->get_attrib(tex_matrix_slot) != _state_rs->get_attrib(tex_matrix_slot) ||
+    if (changed.get_bit(tex_gen_slot) ||
+        changed.get_bit(tex_matrix_slot) ||
         !_state_mask.get_bit(tex_gen_slot) ||
         !_state_mask.get_bit(tex_matrix_slot)) {
       _state_mask.clear_bit(tex_gen_slot);
@@ -11578,7 +11601,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int tex_matrix_slot = TexMatrixAttrib::get_class_slot();
-  if (_target_rs->get_attrib(tex_matrix_slot) != _state_rs->get_attrib(tex_matrix_slot) ||
+  if (changed.get_bit(tex_matrix_slot) ||
       !_state_mask.get_bit(tex_matrix_slot)) {
     // PStatGPUTimer timer(this, _draw_set_state_tex_matrix_pcollector);
 #ifdef SUPPORT_FIXED_FUNCTION
@@ -11595,7 +11618,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int stencil_slot = StencilAttrib::get_class_slot();
-  if (_target_rs->get_attrib(stencil_slot) != _state_rs->get_attrib(stencil_slot) ||
+  if (changed.get_bit(stencil_slot) ||
       !_state_mask.get_bit(stencil_slot)) {
     // PStatGPUTimer timer(this, _draw_set_state_stencil_pcollector);
     do_issue_stencil();
@@ -11603,7 +11626,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int scissor_slot = ScissorAttrib::get_class_slot();
-  if (_target_rs->get_attrib(scissor_slot) != _state_rs->get_attrib(scissor_slot) ||
+  if (changed.get_bit(scissor_slot) ||
       !_state_mask.get_bit(scissor_slot)) {
     // PStatGPUTimer timer(this, _draw_set_state_scissor_pcollector);
     do_issue_scissor();
@@ -11613,7 +11636,7 @@ set_state_and_transform(const RenderState *target,
 #ifdef SUPPORT_FIXED_FUNCTION
   if (has_fixed_function_pipeline()) {
     int alpha_test_slot = AlphaTestAttrib::get_class_slot();
-    if (_target_rs->get_attrib(alpha_test_slot) != _state_rs->get_attrib(alpha_test_slot) ||
+    if (changed.get_bit(alpha_test_slot) ||
         !_state_mask.get_bit(alpha_test_slot)
 #ifndef OPENGLES_1
         || (_target_shader->get_flag(ShaderAttrib::F_subsume_alpha_test) !=
@@ -11626,7 +11649,7 @@ set_state_and_transform(const RenderState *target,
     }
 
     int rescale_normal_slot = RescaleNormalAttrib::get_class_slot();
-    if (_target_rs->get_attrib(rescale_normal_slot) != _state_rs->get_attrib(rescale_normal_slot) ||
+    if (changed.get_bit(rescale_normal_slot) ||
         !_state_mask.get_bit(rescale_normal_slot)) {
       // PStatGPUTimer timer(this, _draw_set_state_rescale_normal_pcollector);
       do_issue_rescale_normal();
@@ -11634,7 +11657,7 @@ set_state_and_transform(const RenderState *target,
     }
 
     int shade_model_slot = ShadeModelAttrib::get_class_slot();
-    if (_target_rs->get_attrib(shade_model_slot) != _state_rs->get_attrib(shade_model_slot) ||
+    if (changed.get_bit(shade_model_slot) ||
         !_state_mask.get_bit(shade_model_slot)) {
       // PStatGPUTimer timer(this, _draw_set_state_shade_model_pcollector);
       do_issue_shade_model();
@@ -11651,7 +11674,7 @@ set_state_and_transform(const RenderState *target,
     }
 
     int material_slot = MaterialAttrib::get_class_slot();
-    if (_target_rs->get_attrib(material_slot) != _state_rs->get_attrib(material_slot) ||
+    if (changed.get_bit(material_slot) ||
         !_state_mask.get_bit(material_slot)) {
       // PStatGPUTimer timer(this, _draw_set_state_material_pcollector);
       do_issue_material();
@@ -11659,7 +11682,7 @@ set_state_and_transform(const RenderState *target,
     }
 
     int light_slot = LightAttrib::get_class_slot();
-    if (_target_rs->get_attrib(light_slot) != _state_rs->get_attrib(light_slot) ||
+    if (changed.get_bit(light_slot) ||
         !_state_mask.get_bit(light_slot)) {
       // PStatGPUTimer timer(this, _draw_set_state_light_pcollector);
       do_issue_light();
@@ -11667,7 +11690,7 @@ set_state_and_transform(const RenderState *target,
     }
 
     int fog_slot = FogAttrib::get_class_slot();
-    if (_target_rs->get_attrib(fog_slot) != _state_rs->get_attrib(fog_slot) ||
+    if (changed.get_bit(fog_slot) ||
         !_state_mask.get_bit(fog_slot)) {
       // PStatGPUTimer timer(this, _draw_set_state_fog_pcollector);
       do_issue_fog();
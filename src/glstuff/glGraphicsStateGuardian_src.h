@@ -433,6 +433,10 @@ public:
 
   virtual void set_state_and_transform(const RenderState *state,
                                        const TransformState *transform);
+  virtual void set_state_delta_and_transform(const RenderState *state,
+                                             const TransformState *transform,
+                                             const RenderState *prev_state,
+                                             const RenderState::SlotMask &changed_slots);
 
   void bind_fbo(GLuint fbo);
   virtual bool get_supports_cg_profile(const std::string &name) const;
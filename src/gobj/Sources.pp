@@ -266,3 +266,23 @@
     pythonTexturePoolFilter.h
 
 #end lib_target
+
+#begin test_bin_target
+  #define TARGET test_vertex_data_page
+
+  #define SOURCES \
+    test_vertex_data_page.cxx
+
+  #define LOCAL_LIBS $[LOCAL_LIBS] p3gobj
+
+#end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_munged_data_cache
+
+  #define SOURCES \
+    test_munged_data_cache.cxx
+
+  #define LOCAL_LIBS $[LOCAL_LIBS] p3gobj
+
+#end test_bin_target
@@ -229,7 +229,7 @@ munge_data_impl(const GeomVertexData *data) {
     return data;
   }
 
-  return data->convert_to(new_format);
+  return data->convert_to(new_format, true);
 }
 
 /**
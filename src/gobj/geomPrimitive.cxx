@@ -30,6 +30,7 @@
 #include "ioPtaDatagramInt.h"
 #include "indent.h"
 #include "pStatTimer.h"
+#include "vector_int.h"
 
 using std::max;
 using std::min;
@@ -42,6 +43,8 @@ PStatCollector GeomPrimitive::_decompose_pcollector("*:Munge:Decompose");
 PStatCollector GeomPrimitive::_doubleside_pcollector("*:Munge:Doubleside");
 PStatCollector GeomPrimitive::_reverse_pcollector("*:Munge:Reverse");
 PStatCollector GeomPrimitive::_rotate_pcollector("*:Munge:Rotate");
+PStatCollector GeomPrimitive::_optimize_vertex_cache_pcollector("*:Munge:Optimize vertex cache");
+PStatCollector GeomPrimitive::_optimize_overdraw_pcollector("*:Munge:Optimize overdraw");
 
 /**
  * Constructs an invalid object.  Only used when reading from bam.
@@ -1049,6 +1052,355 @@ make_adjacency() const {
   return nullptr;
 }
 
+/**
+ * Returns the average cache miss ratio of the primitive: the number of
+ * vertices that would have to be transformed per triangle when the triangles
+ * are drawn in their current order through a post-transform vertex cache of
+ * the indicated number of entries, modeled as a FIFO.  The ideal value
+ * approaches 0.5 for a large regular mesh; the worst case is 3.0.
+ *
+ * This is only meaningful for an indexed list of triangles; for any other
+ * primitive, it returns the number of vertices per primitive.
+ */
+PN_stdfloat GeomPrimitive::
+get_acmr(int cache_size) const {
+  if (!is_indexed_triangle_list() || get_num_vertices() == 0) {
+    return (PN_stdfloat)get_num_vertices_per_primitive();
+  }
+  nassertr(cache_size > 0, 3.0f);
+
+  int num_vertices = get_num_vertices();
+  int num_unique = get_max_vertex() + 1;
+
+  // Each vertex records the "time" at which it entered the cache; it is
+  // still in the cache if fewer than cache_size misses have occurred since.
+  vector_int entered(num_unique, -cache_size - 1);
+  int num_misses = 0;
+
+  GeomVertexReader index(get_vertices(), 0);
+  for (int i = 0; i < num_vertices; ++i) {
+    int vi = index.get_data1i();
+    nassertr(vi >= 0 && vi < num_unique, 3.0f);
+    if (num_misses - entered[vi] > cache_size) {
+      entered[vi] = num_misses;
+      ++num_misses;
+    }
+  }
+
+  return (PN_stdfloat)num_misses / (PN_stdfloat)(num_vertices / 3);
+}
+
+/**
+ * Returns a new primitive with the triangles reordered so as to make better
+ * use of the post-transform vertex cache of the graphics hardware, using Tom
+ * Forsyth's linear-speed vertex cache optimization algorithm.  cache_size is
+ * the number of cache entries to optimize for; the resulting order also
+ * performs well on caches of other sizes.
+ *
+ * The set of triangles and their winding order are not changed, only the
+ * order in which they are drawn.  If the primitive is not an indexed list of
+ * triangles, returns the original primitive unchanged; call decompose() first
+ * to optimize strips or fans.
+ */
+CPT(GeomPrimitive) GeomPrimitive::
+optimize_vertex_cache(int cache_size) const {
+  if (!is_indexed_triangle_list() || get_num_vertices() < 6) {
+    return this;
+  }
+
+  PStatTimer timer(_optimize_vertex_cache_pcollector);
+  cache_size = std::max(cache_size, 4);
+
+  int num_vertices = get_num_vertices();
+  int num_triangles = num_vertices / 3;
+  int num_unique = get_max_vertex() + 1;
+
+  vector_int indices(num_vertices);
+  {
+    GeomVertexReader index(get_vertices(), 0);
+    for (int i = 0; i < num_vertices; ++i) {
+      indices[i] = index.get_data1i();
+      nassertr(indices[i] >= 0 && indices[i] < num_unique, this);
+    }
+  }
+
+  // Build the vertex-to-triangle adjacency, as a packed list of triangle
+  // numbers per vertex.  valence[] counts the triangles not yet emitted.
+  vector_int valence(num_unique, 0);
+  for (int i = 0; i < num_vertices; ++i) {
+    ++valence[indices[i]];
+  }
+  vector_int adj_start(num_unique + 1, 0);
+  for (int vi = 0; vi < num_unique; ++vi) {
+    adj_start[vi + 1] = adj_start[vi] + valence[vi];
+  }
+  vector_int adjacency(num_vertices);
+  {
+    vector_int fill(adj_start.begin(), adj_start.end() - 1);
+    for (int i = 0; i < num_vertices; ++i) {
+      adjacency[fill[indices[i]]++] = i / 3;
+    }
+  }
+
+  // Scores are those suggested in Forsyth's paper: the three most recently
+  // used vertices get a fixed score, so that the next triangle doesn't
+  // simply repeat the last one, and vertices with few remaining triangles
+  // are boosted so that we don't leave lonely triangles behind.
+  pvector<float> cache_score(cache_size + 3);
+  for (int p = 0; p < cache_size + 3; ++p) {
+    if (p < 3) {
+      cache_score[p] = 0.75f;
+    } else if (p < cache_size) {
+      float s = 1.0f - (float)(p - 3) / (float)(cache_size - 3);
+      cache_score[p] = cpow(s, 1.5f);
+    } else {
+      cache_score[p] = 0.0f;
+    }
+  }
+
+  vector_int cache_pos(num_unique, -1);
+  pvector<float> vertex_score(num_unique);
+  for (int vi = 0; vi < num_unique; ++vi) {
+    vertex_score[vi] = (valence[vi] == 0) ? -1.0f : 2.0f / csqrt((float)valence[vi]);
+  }
+
+  pvector<float> triangle_score(num_triangles);
+  pvector<bool> emitted(num_triangles, false);
+  int best_triangle = -1;
+  float best_score = -1.0f;
+  for (int t = 0; t < num_triangles; ++t) {
+    triangle_score[t] = vertex_score[indices[t * 3]] +
+      vertex_score[indices[t * 3 + 1]] + vertex_score[indices[t * 3 + 2]];
+    if (triangle_score[t] > best_score) {
+      best_score = triangle_score[t];
+      best_triangle = t;
+    }
+  }
+
+  // The simulated LRU cache, with room for three vertices to fall off the
+  // end so we can reset their scores.
+  vector_int cache;
+  cache.reserve(cache_size + 3);
+  vector_int new_cache;
+  new_cache.reserve(cache_size + 3);
+
+  PT(GeomPrimitive) new_prim = make_copy();
+  PT(GeomVertexArrayData) new_vertices = make_index_data();
+  new_vertices->unclean_set_num_rows(num_vertices);
+  GeomVertexWriter to(new_vertices, 0);
+
+  int next_unemitted = 0;
+  for (int n = 0; n < num_triangles; ++n) {
+    if (best_triangle < 0) {
+      // Nothing in the cache touches a remaining triangle; start over with
+      // the next triangle in the original order.
+      while (emitted[next_unemitted]) {
+        ++next_unemitted;
+      }
+      best_triangle = next_unemitted;
+    }
+
+    int t = best_triangle;
+    nassertr(!emitted[t], this);
+    emitted[t] = true;
+
+    new_cache.clear();
+    for (int k = 0; k < 3; ++k) {
+      int vi = indices[t * 3 + k];
+      to.set_data1i(vi);
+      new_cache.push_back(vi);
+
+      // Remove this triangle from the vertex's list of live triangles.
+      int *begin = &adjacency[adj_start[vi]];
+      int *end = begin + valence[vi];
+      int *found = std::find(begin, end, t);
+      nassertr(found != end, this);
+      std::swap(*found, *(end - 1));
+      --valence[vi];
+    }
+    for (int vi : cache) {
+      if (vi != new_cache[0] && vi != new_cache[1] && vi != new_cache[2]) {
+        new_cache.push_back(vi);
+      }
+    }
+    cache.swap(new_cache);
+
+    // Rescore everything in the cache, including those vertices that just
+    // fell out of it, and the triangles that use them.
+    for (size_t p = 0; p < cache.size(); ++p) {
+      int vi = cache[p];
+      cache_pos[vi] = ((int)p < cache_size) ? (int)p : -1;
+      if (valence[vi] == 0) {
+        vertex_score[vi] = -1.0f;
+      } else {
+        vertex_score[vi] = 2.0f / csqrt((float)valence[vi]);
+        if (cache_pos[vi] >= 0) {
+          vertex_score[vi] += cache_score[p];
+        }
+      }
+    }
+
+    best_triangle = -1;
+    best_score = -1.0f;
+    for (int vi : cache) {
+      const int *adj = &adjacency[adj_start[vi]];
+      for (int j = 0; j < valence[vi]; ++j) {
+        int at = adj[j];
+        float score = vertex_score[indices[at * 3]] +
+          vertex_score[indices[at * 3 + 1]] + vertex_score[indices[at * 3 + 2]];
+        triangle_score[at] = score;
+        if (score > best_score) {
+          best_score = score;
+          best_triangle = at;
+        }
+      }
+    }
+
+    if ((int)cache.size() > cache_size) {
+      cache.resize(cache_size);
+    }
+  }
+
+  nassertr(to.is_at_end(), this);
+  new_prim->set_vertices(new_vertices);
+  return new_prim;
+}
+
+/**
+ * Returns a new primitive with the triangles reordered to reduce overdraw,
+ * while mostly preserving the vertex cache efficiency of the current order.
+ * It is therefore best to call this on the result of
+ * optimize_vertex_cache().
+ *
+ * The triangles are split into clusters at the points where the order
+ * already loses the contents of the vertex cache, and the clusters are then
+ * sorted so that those facing outward from the center of the mesh are drawn
+ * first, as these are the most likely to occlude the others.  This is the
+ * approach described by Sander, Nehab and Barczak.
+ *
+ * vertex_data is used to look up the vertex positions.  If the primitive is
+ * not an indexed list of triangles, returns the original primitive.
+ */
+CPT(GeomPrimitive) GeomPrimitive::
+optimize_overdraw(const GeomVertexData *vertex_data, int cache_size) const {
+  if (!is_indexed_triangle_list() || get_num_vertices() < 6 ||
+      !vertex_data->has_column(InternalName::get_vertex())) {
+    return this;
+  }
+
+  PStatTimer timer(_optimize_overdraw_pcollector);
+  nassertr(cache_size > 0, this);
+
+  int num_vertices = get_num_vertices();
+  int num_triangles = num_vertices / 3;
+  int num_unique = get_max_vertex() + 1;
+  nassertr(num_unique <= vertex_data->get_num_rows(), this);
+
+  vector_int indices(num_vertices);
+  {
+    GeomVertexReader index(get_vertices(), 0);
+    for (int i = 0; i < num_vertices; ++i) {
+      indices[i] = index.get_data1i();
+    }
+  }
+
+  // Find the cluster boundaries: a new cluster starts wherever a triangle
+  // misses the (FIFO) cache on all three of its vertices, since nothing is
+  // lost by drawing such a triangle at some other point.
+  vector_int cluster_starts;
+  {
+    vector_int entered(num_unique, -cache_size - 1);
+    int num_misses = 0;
+    for (int t = 0; t < num_triangles; ++t) {
+      int tri_misses = 0;
+      for (int k = 0; k < 3; ++k) {
+        int vi = indices[t * 3 + k];
+        if (num_misses - entered[vi] > cache_size) {
+          entered[vi] = num_misses;
+          ++num_misses;
+          ++tri_misses;
+        }
+      }
+      if (tri_misses == 3 || t == 0) {
+        cluster_starts.push_back(t);
+      }
+    }
+  }
+  if (cluster_starts.size() < 2) {
+    return this;
+  }
+  int num_clusters = (int)cluster_starts.size();
+  cluster_starts.push_back(num_triangles);
+
+  // Compute the area-weighted centroid and the average normal of each
+  // cluster, and of the mesh as a whole.
+  pvector<LPoint3> positions(num_unique);
+  {
+    GeomVertexReader vertex(vertex_data, InternalName::get_vertex());
+    for (int vi = 0; vi < num_unique; ++vi) {
+      vertex.set_row_unsafe(vi);
+      positions[vi] = vertex.get_data3();
+    }
+  }
+
+  pvector<LPoint3> cluster_centroids(num_clusters);
+  pvector<LVector3> cluster_normals(num_clusters);
+  LPoint3 mesh_centroid(0, 0, 0);
+  PN_stdfloat mesh_area = 0;
+
+  for (int c = 0; c < num_clusters; ++c) {
+    LPoint3 centroid(0, 0, 0);
+    LVector3 normal(0, 0, 0);
+    PN_stdfloat area = 0;
+    for (int t = cluster_starts[c]; t < cluster_starts[c + 1]; ++t) {
+      const LPoint3 &p0 = positions[indices[t * 3]];
+      const LPoint3 &p1 = positions[indices[t * 3 + 1]];
+      const LPoint3 &p2 = positions[indices[t * 3 + 2]];
+      LVector3 cross_product = (p1 - p0).cross(p2 - p0);
+      PN_stdfloat tri_area = cross_product.length();
+      centroid += (p0 + p1 + p2) * (tri_area / 3.0f);
+      normal += cross_product;
+      area += tri_area;
+    }
+    mesh_centroid += centroid;
+    mesh_area += area;
+    if (area > 0) {
+      centroid /= area;
+    }
+    normal.normalize();
+    cluster_centroids[c] = centroid;
+    cluster_normals[c] = normal;
+  }
+  if (mesh_area > 0) {
+    mesh_centroid /= mesh_area;
+  }
+
+  // Sort the clusters by decreasing outwardness.
+  typedef std::pair<PN_stdfloat, int> SortEntry;
+  pvector<SortEntry> sorted(num_clusters);
+  for (int c = 0; c < num_clusters; ++c) {
+    sorted[c].first = -cluster_normals[c].dot(cluster_centroids[c] - mesh_centroid);
+    sorted[c].second = c;
+  }
+  std::stable_sort(sorted.begin(), sorted.end());
+
+  PT(GeomPrimitive) new_prim = make_copy();
+  PT(GeomVertexArrayData) new_vertices = make_index_data();
+  new_vertices->unclean_set_num_rows(num_vertices);
+  GeomVertexWriter to(new_vertices, 0);
+
+  for (const SortEntry &entry : sorted) {
+    int c = entry.second;
+    for (int i = cluster_starts[c] * 3; i < cluster_starts[c + 1] * 3; ++i) {
+      to.set_data1i(indices[i]);
+    }
+  }
+
+  nassertr(to.is_at_end(), this);
+  new_prim->set_vertices(new_vertices);
+  return new_prim;
+}
+
 /**
  * Returns the number of bytes consumed by the primitive and its index
  * table(s).
@@ -1530,6 +1882,17 @@ clear_prepared(PreparedGraphicsObjects *prepared_objects) {
   }
 }
 
+/**
+ * Returns true if this is an indexed list of independent triangles, which is
+ * the only kind of primitive on which the vertex cache and overdraw
+ * optimizations operate.
+ */
+bool GeomPrimitive::
+is_indexed_triangle_list() const {
+  return get_primitive_type() == PT_polygons && !is_composite() &&
+    get_num_vertices_per_primitive() == 3 && is_indexed();
+}
+
 /**
  * Returns the largest index value that can be stored in an index of the
  * indicated type, minus one (to leave room for a potential strip cut index)
@@ -136,6 +136,11 @@ PUBLISHED:
   CPT(GeomPrimitive) make_patches() const;
   virtual CPT(GeomPrimitive) make_adjacency() const;
 
+  PN_stdfloat get_acmr(int cache_size = 16) const;
+  CPT(GeomPrimitive) optimize_vertex_cache(int cache_size = 32) const;
+  CPT(GeomPrimitive) optimize_overdraw(const GeomVertexData *vertex_data,
+                                       int cache_size = 32) const;
+
   int get_num_bytes() const;
   INLINE int get_data_size_bytes() const;
   INLINE UpdateSeq get_modified() const;
@@ -212,6 +217,7 @@ private:
   static CPT(GeomVertexArrayFormat) make_index_format(NumericType index_type);
 
   void clear_prepared(PreparedGraphicsObjects *prepared_objects);
+  bool is_indexed_triangle_list() const;
   static int get_highest_index_value(NumericType index_type);
   static int get_strip_cut_index(NumericType index_type);
 
@@ -313,6 +319,8 @@ private:
   static PStatCollector _doubleside_pcollector;
   static PStatCollector _reverse_pcollector;
   static PStatCollector _rotate_pcollector;
+  static PStatCollector _optimize_vertex_cache_pcollector;
+  static PStatCollector _optimize_overdraw_pcollector;
 
 public:
   virtual void write_datagram(BamWriter *manager, Datagram &dg);
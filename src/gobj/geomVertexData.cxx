@@ -21,6 +21,9 @@
 #include "bamWriter.h"
 #include "pset.h"
 #include "indent.h"
+#include "bamCache.h"
+#include "bamCacheRecord.h"
+#include "addHash.h"
 
 using std::ostream;
 
@@ -32,6 +35,7 @@ TypeHandle GeomVertexDataPipelineReader::_type_handle;
 TypeHandle GeomVertexDataPipelineWriter::_type_handle;
 
 PStatCollector GeomVertexData::_convert_pcollector("*:Munge:Convert");
+PStatCollector GeomVertexData::_convert_cache_pcollector("*:Munge:Convert:Disk cache");
 PStatCollector GeomVertexData::_scale_color_pcollector("*:Munge:Scale color");
 PStatCollector GeomVertexData::_set_color_pcollector("*:Munge:Set color");
 PStatCollector GeomVertexData::_animation_pcollector("*:Animation");
@@ -701,6 +705,19 @@ copy_row_from(int dest_row, const GeomVertexData *source,
  */
 CPT(GeomVertexData) GeomVertexData::
 convert_to(const GeomVertexFormat *new_format) const {
+  return convert_to(new_format, false);
+}
+
+/**
+ * A variant of convert_to() that is used by GeomMunger.  If allow_disk_cache
+ * is true and BamCache::get_cache_munged_data() is enabled, a result that is
+ * not found in the in-memory cache is next looked up in the model cache, and
+ * a freshly computed result is written to it, keyed on a hash of this vertex
+ * data's contents and the target format.  This allows munging to be skipped
+ * on subsequent runs of the application.
+ */
+CPT(GeomVertexData) GeomVertexData::
+convert_to(const GeomVertexFormat *new_format, bool allow_disk_cache) const {
   Thread *current_thread = Thread::get_current_thread();
 
   if (new_format == get_format()) {
@@ -738,20 +755,56 @@ convert_to(const GeomVertexFormat *new_format) const {
     // result.
   }
 
-  // Okay, convert the data to the new format.
-  if (gobj_cat.is_debug()) {
-    gobj_cat.debug()
-      << "Converting " << get_num_rows() << " rows from " << *get_format()
-      << " to " << *new_format << "\n";
+  PT(GeomVertexData) new_data;
+
+  BamCache *cache = BamCache::get_global_ptr();
+  PT(BamCacheRecord) record;
+  if (allow_disk_cache && cache->get_cache_munged_data()) {
+    // See if some previous session already did this conversion for us.
+    PStatTimer timer(_convert_cache_pcollector);
+    record = cache->lookup(get_munge_cache_pathname(new_format, current_thread), "vdo");
+    if (record != nullptr && record->has_data()) {
+      new_data = DCAST(GeomVertexData, record->get_data());
+      if (new_data->get_format() != new_format ||
+          new_data->get_num_rows() != get_num_rows()) {
+        // Must be a hash collision.  Recompute it.
+        new_data.clear();
+      } else {
+        if (gobj_cat.is_debug()) {
+          gobj_cat.debug()
+            << "Converted vertex data " << get_name()
+            << " was found in disk cache.\n";
+        }
+        // The tables are shared with the source data, not duplicated.
+        new_data->set_name(get_name());
+        new_data->set_usage_hint(get_usage_hint());
+        new_data->set_transform_blend_table(get_transform_blend_table());
+        new_data->set_slider_table(get_slider_table());
+        record.clear();
+      }
+    }
   }
-  PStatTimer timer(_convert_pcollector);
 
-  PT(GeomVertexData) new_data =
-    new GeomVertexData(get_name(), new_format, get_usage_hint());
-  new_data->set_transform_blend_table(get_transform_blend_table());
-  new_data->set_slider_table(get_slider_table());
+  if (new_data == nullptr) {
+    // Okay, convert the data to the new format.
+    if (gobj_cat.is_debug()) {
+      gobj_cat.debug()
+        << "Converting " << get_num_rows() << " rows from " << *get_format()
+        << " to " << *new_format << "\n";
+    }
+    PStatTimer timer(_convert_pcollector);
+
+    new_data = new GeomVertexData(get_name(), new_format, get_usage_hint());
+    new_data->set_transform_blend_table(get_transform_blend_table());
+    new_data->set_slider_table(get_slider_table());
 
-  new_data->copy_from(this, false);
+    new_data->copy_from(this, false);
+
+    if (record != nullptr) {
+      record->set_data(new_data);
+      cache->store(record);
+    }
+  }
 
   // Record the new result in the cache.
   if (entry == nullptr) {
@@ -1356,6 +1409,41 @@ describe_vertex(ostream &out, int row) const {
   }
 }
 
+/**
+ * Returns the pseudo source filename under which the result of converting
+ * this vertex data to the indicated format is stored in the BamCache.  It
+ * encodes a hash of the vertex contents and source format, and a hash of the
+ * target format, neither of which depend on pointer values, so the same
+ * filename is produced in subsequent runs.
+ */
+Filename GeomVertexData::
+get_munge_cache_pathname(const GeomVertexFormat *new_format,
+                         Thread *current_thread) const {
+  std::ostringstream format_strm;
+  get_format()->write(format_strm, 0);
+  std::string format_desc = format_strm.str();
+
+  size_t data_hash = AddHash::add_hash(0, (const uint8_t *)format_desc.data(),
+                                       format_desc.size());
+  size_t num_arrays = get_num_arrays();
+  for (size_t i = 0; i < num_arrays; ++i) {
+    CPT(GeomVertexArrayDataHandle) handle = get_array(i)->get_handle(current_thread);
+    data_hash = AddHash::add_hash(data_hash, handle->get_read_pointer(true),
+                                  handle->get_data_size_bytes());
+  }
+
+  format_strm.str(std::string());
+  new_format->write(format_strm, 0);
+  format_desc = format_strm.str();
+  size_t format_hash = AddHash::add_hash(0, (const uint8_t *)format_desc.data(),
+                                         format_desc.size());
+
+  std::ostringstream strm;
+  strm << "/munged-vertex-data/" << std::hex << data_hash
+       << "_" << format_hash << "_" << std::dec << get_num_rows();
+  return Filename(strm.str());
+}
+
 /**
  * Removes all of the previously-cached results of convert_to().
  *
@@ -38,6 +38,7 @@
 #include "pmap.h"
 #include "pvector.h"
 #include "deletedChain.h"
+#include "filename.h"
 
 class FactoryParams;
 class GeomVertexColumn;
@@ -172,6 +173,9 @@ PUBLISHED:
   void clear_cache_stage();
 
 public:
+  CPT(GeomVertexData) convert_to(const GeomVertexFormat *new_format,
+                                 bool allow_disk_cache) const;
+
   static INLINE uint32_t pack_abcd(unsigned int a, unsigned int b,
                                     unsigned int c, unsigned int d);
   static INLINE unsigned int unpack_abcd_a(uint32_t data);
@@ -186,6 +190,8 @@ public:
 
 private:
   static void do_set_color(GeomVertexData *vdata, const LColor &color);
+  Filename get_munge_cache_pathname(const GeomVertexFormat *new_format,
+                                    Thread *current_thread) const;
 
   static void bytewise_copy(unsigned char *to, int to_stride,
                             const unsigned char *from, int from_stride,
@@ -349,6 +355,7 @@ private:
                                     size_t stride, const LMatrix4f &matf);
 
   static PStatCollector _convert_pcollector;
+  static PStatCollector _convert_cache_pcollector;
   static PStatCollector _scale_color_pcollector;
   static PStatCollector _set_color_pcollector;
   static PStatCollector _animation_pcollector;
@@ -0,0 +1,196 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_munged_data_cache.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "geomVertexData.h"
+#include "geomVertexFormat.h"
+#include "geomVertexReader.h"
+#include "geomVertexWriter.h"
+#include "bamCache.h"
+#include "config_gobj.h"
+#include "pnotify.h"
+
+#include <sstream>
+
+// This converts vertex data to another format with the munged-data disk
+// cache enabled, in a fresh cache directory, as a GeomMunger would.
+//
+// The first conversion must be computed and stored.  Converting a separate
+// but identical vertex data, which is not in the in-memory cache, must then
+// find the result in the disk cache, and give the same vertices.  Changing a
+// single vertex, disabling the munged-data cache, or converting without
+// allowing the disk cache must each compute the result again.
+//
+// Whether a result was computed or read from the cache is told from the
+// debug output of the gobj category, so the hits and misses are only checked
+// in a build that has debug output compiled in.
+
+static int num_failures = 0;
+
+static void
+check(bool condition, const char *message) {
+  if (!condition) {
+    nout << "FAILED: " << message << "\n";
+    ++num_failures;
+  }
+}
+
+static const int num_rows = 100;
+
+/**
+ * Returns vertex data with positions and colors, which differs from the
+ * others made by this function only if changed_row is not -1.
+ */
+static PT(GeomVertexData)
+make_data(int changed_row = -1) {
+  PT(GeomVertexData) vdata = new GeomVertexData
+    ("data", GeomVertexFormat::get_v3c4(), Geom::UH_static);
+  GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+  GeomVertexWriter color(vdata, InternalName::get_color());
+  for (int i = 0; i < num_rows; ++i) {
+    PN_stdfloat z = (i == changed_row) ? 1.0f : 0.0f;
+    vertex.add_data3((PN_stdfloat)i, (PN_stdfloat)(i * 2), z);
+    color.add_data4((PN_stdfloat)(i % 2), 0.5f, 0.25f, 1.0f);
+  }
+  return vdata;
+}
+
+/**
+ * How a converted vertex data came about, as told by the debug output.
+ */
+enum Outcome {
+  O_computed,
+  O_cache_hit,
+  O_none,
+  O_unknown,
+};
+
+/**
+ * Converts the vertex data to the target format, and reports whether the
+ * result was computed, read from the disk cache, or neither.
+ */
+static CPT(GeomVertexData)
+convert(const GeomVertexData *vdata, bool allow_disk_cache, Outcome &outcome) {
+  std::ostringstream log;
+  Notify *notify = Notify::ptr();
+  std::ostream *saved = notify->get_ostream_ptr();
+  notify->set_ostream_ptr(&log, false);
+
+  CPT(GeomVertexData) result =
+    vdata->convert_to(GeomVertexFormat::get_v3n3c4(), allow_disk_cache);
+
+  notify->set_ostream_ptr(saved, false);
+
+  std::string text = log.str();
+  bool computed = (text.find("Converting ") != std::string::npos);
+  bool hit = (text.find("found in disk cache") != std::string::npos);
+  if (!gobj_cat.is_debug()) {
+    outcome = O_unknown;
+  } else if (computed && !hit) {
+    outcome = O_computed;
+  } else if (hit && !computed) {
+    outcome = O_cache_hit;
+  } else {
+    outcome = O_none;
+  }
+  return result;
+}
+
+/**
+ * Returns true if the converted data has the rows and values of the
+ * original.
+ */
+static bool
+same_vertices(const GeomVertexData *converted, const GeomVertexData *original) {
+  if (converted == nullptr ||
+      converted->get_format() != GeomVertexFormat::get_v3n3c4() ||
+      converted->get_num_rows() != original->get_num_rows()) {
+    return false;
+  }
+  GeomVertexReader from_vertex(original, InternalName::get_vertex());
+  GeomVertexReader from_color(original, InternalName::get_color());
+  GeomVertexReader to_vertex(converted, InternalName::get_vertex());
+  GeomVertexReader to_color(converted, InternalName::get_color());
+  while (!from_vertex.is_at_end()) {
+    if (!from_vertex.get_data3().almost_equal(to_vertex.get_data3()) ||
+        !from_color.get_data4().almost_equal(to_color.get_data4())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Returns true if the outcome is the expected one, or can't be told.
+ */
+static bool
+outcome_is(Outcome outcome, Outcome expected) {
+  return outcome == expected || outcome == O_unknown;
+}
+
+int
+main(int argc, char *argv[]) {
+  Filename root = Filename::temporary("", "munged_cache_");
+  BamCache *cache = BamCache::get_global_ptr();
+  cache->set_root(root);
+  cache->set_active(true);
+  cache->set_read_only(false);
+  cache->set_cache_munged_data(true);
+  check(cache->get_cache_munged_data(), "munged-data cache is enabled");
+
+  gobj_cat->set_severity(NS_debug);
+  Outcome outcome;
+
+  PT(GeomVertexData) first = make_data();
+  CPT(GeomVertexData) first_result = convert(first, true, outcome);
+  check(outcome_is(outcome, O_computed), "first conversion is computed");
+  check(same_vertices(first_result, first), "first conversion is correct");
+
+  // The same vertex data is found in memory, without looking at the disk.
+  CPT(GeomVertexData) again = convert(first, true, outcome);
+  check(again == first_result, "repeated conversion comes from memory");
+  check(outcome_is(outcome, O_none), "repeated conversion doesn't touch disk");
+
+  PT(GeomVertexData) second = make_data();
+  CPT(GeomVertexData) second_result = convert(second, true, outcome);
+  check(outcome_is(outcome, O_cache_hit), "identical data is found on disk");
+  check(second_result != first_result, "disk hit is a separate object");
+  check(same_vertices(second_result, second), "disk hit is correct");
+  check(second_result != nullptr && second_result->get_usage_hint() == Geom::UH_static,
+        "disk hit takes the usage hint of the source");
+
+  PT(GeomVertexData) changed = make_data(50);
+  CPT(GeomVertexData) changed_result = convert(changed, true, outcome);
+  check(outcome_is(outcome, O_computed), "changed data is computed");
+  check(same_vertices(changed_result, changed), "changed data is correct");
+
+  PT(GeomVertexData) not_allowed = make_data();
+  CPT(GeomVertexData) not_allowed_result = convert(not_allowed, false, outcome);
+  check(outcome_is(outcome, O_computed), "disallowed disk cache is not used");
+  check(same_vertices(not_allowed_result, not_allowed),
+        "conversion without the disk cache is correct");
+
+  cache->set_cache_munged_data(false);
+  PT(GeomVertexData) disabled = make_data();
+  CPT(GeomVertexData) disabled_result = convert(disabled, true, outcome);
+  check(outcome_is(outcome, O_computed), "disabled disk cache is not used");
+  check(same_vertices(disabled_result, disabled),
+        "conversion with the cache disabled is correct");
+
+  if (num_failures != 0) {
+    nout << num_failures << " checks failed.\n";
+    return 1;
+  }
+  nout << "All checks passed.\n";
+  return 0;
+}
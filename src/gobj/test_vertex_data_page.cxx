@@ -0,0 +1,129 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_vertex_data_page.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "vertexDataBook.h"
+#include "vertexDataPage.h"
+#include "vertexDataBlock.h"
+#include "simpleLru.h"
+#include "load_prc_file.h"
+#include "pnotify.h"
+
+#include <sstream>
+
+// This evicts a page of vertex data into the compressed LRU and makes it
+// resident again, and checks that the bytes survive the round trip.  It does
+// this once with CM_default on both the book and in
+// vertex-data-compression-method, which must still end up using zlib, and
+// once with zlib named explicitly.
+//
+// Paging is done synchronously by setting vertex-data-page-threads to 0.
+
+static int num_failures = 0;
+
+static void
+check(bool condition, const char *message) {
+  if (!condition) {
+    nout << "FAILED: " << message << "\n";
+    ++num_failures;
+  }
+}
+
+static void
+test_round_trip(VertexDataPage::CompressionMethod book_method) {
+  static const size_t data_size = 40000;
+
+  VertexDataBook book(65536);
+  book.set_compression_method(book_method);
+  VertexDataBlock *block = book.alloc(data_size);
+  check(block != nullptr, "block is allocated");
+  if (block == nullptr) {
+    return;
+  }
+  VertexDataPage *page = block->get_page();
+
+  // Something that compresses, but isn't trivial.
+  unsigned char *data = block->get_pointer(true);
+  for (size_t i = 0; i < data_size; ++i) {
+    data[i] = (unsigned char)((i * 7) % 61 + (i / 1024));
+  }
+
+  size_t input_before = VertexDataPage::get_total_compress_input();
+  size_t output_before = VertexDataPage::get_total_compress_output();
+  size_t expand_before = VertexDataPage::get_total_decompress_output();
+
+  VertexDataPage::get_global_lru(VertexDataPage::RC_resident)->evict_to(0);
+  check(page->get_ram_class() == VertexDataPage::RC_compressed,
+        "page is evicted to the compressed LRU");
+
+  if (VertexDataPage::has_compression_method(VertexDataPage::CM_zlib)) {
+    // Without this, CM_default would reach the zlib path and fail its check.
+    check(page->get_compression_method() == VertexDataPage::CM_zlib,
+          "page is compressed with zlib");
+    size_t input = VertexDataPage::get_total_compress_input() - input_before;
+    size_t output = VertexDataPage::get_total_compress_output() - output_before;
+    check(input >= data_size, "compressor saw the whole page");
+    check(output != 0 && output < input, "page got smaller");
+  } else {
+    check(page->get_compression_method() == VertexDataPage::CM_default,
+          "page is kept as-is without a compressor");
+  }
+
+  page->request_resident();
+  check(page->get_ram_class() == VertexDataPage::RC_resident,
+        "page is resident again");
+  if (page->get_compression_method() != VertexDataPage::CM_default) {
+    check(VertexDataPage::get_total_decompress_output() - expand_before >= data_size,
+          "decompressor restored the whole page");
+  }
+
+  data = block->get_pointer(true);
+  bool same = true;
+  for (size_t i = 0; i < data_size && same; ++i) {
+    same = (data[i] == (unsigned char)((i * 7) % 61 + (i / 1024)));
+  }
+  check(same, "data survives the round trip");
+}
+
+static void
+test_parse() {
+  VertexDataPage::CompressionMethod method = VertexDataPage::CM_zlib;
+  std::istringstream in("default");
+  in >> method;
+  check(method == VertexDataPage::CM_default, "'default' parses");
+
+  std::ostringstream out;
+  out << VertexDataPage::CM_zlib;
+  check(out.str() == "zlib", "zlib prints");
+}
+
+int
+main(int argc, char *argv[]) {
+  load_prc_file_data("test_vertex_data_page",
+                     "vertex-data-page-threads 0\n"
+                     "vertex-data-compression-method default\n");
+
+  // Evicted resident pages only go to the compressed LRU if it has room.
+  VertexDataPage::get_global_lru(VertexDataPage::RC_compressed)->set_max_size(1 << 24);
+
+  test_parse();
+  test_round_trip(VertexDataPage::CM_default);
+  test_round_trip(VertexDataPage::CM_zlib);
+
+  if (num_failures != 0) {
+    nout << num_failures << " checks failed.\n";
+    return 1;
+  }
+  nout << "All checks passed.\n";
+  return 0;
+}
@@ -18,7 +18,9 @@
  *
  */
 VertexDataBook::
-VertexDataBook(size_t block_size) {
+VertexDataBook(size_t block_size) :
+  _compression_method(VertexDataPage::CM_default)
+{
   // Make sure the block_size is an integer multiple of the system's page
   // size.
   _block_size = memory_hook->round_up_to_page_size(block_size);
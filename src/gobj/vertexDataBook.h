@@ -34,6 +34,11 @@ PUBLISHED:
 
   INLINE VertexDataBlock *alloc(size_t size);
 
+  INLINE void set_compression_method(VertexDataPage::CompressionMethod method);
+  INLINE VertexDataPage::CompressionMethod get_compression_method() const;
+  MAKE_PROPERTY(compression_method, get_compression_method,
+                set_compression_method);
+
   INLINE size_t get_num_pages() const;
 
   size_t count_total_page_size() const;
@@ -52,6 +57,7 @@ private:
 
 private:
   size_t _block_size;
+  VertexDataPage::CompressionMethod _compression_method;
 
   typedef pset<VertexDataPage *, IndirectLess<VertexDataPage> > Pages;
   Pages _pages;
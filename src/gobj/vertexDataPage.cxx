@@ -13,6 +13,8 @@
 
 #include "vertexDataPage.h"
 #include "configVariableInt.h"
+#include "configVariableEnum.h"
+#include "string_utils.h"
 #include "vertexDataSaveFile.h"
 #include "vertexDataBook.h"
 #include "vertexDataBlock.h"
@@ -25,6 +27,10 @@
 #include <zlib.h>
 #endif
 
+using std::istream;
+using std::ostream;
+using std::string;
+
 ConfigVariableInt max_resident_vertex_data
 ("max-resident-vertex-data", -1,
  PRC_DESC("Specifies the maximum number of bytes of all vertex data "
@@ -41,9 +47,15 @@ ConfigVariableInt max_compressed_vertex_data
           "the least-recently-used ones will be temporarily flushed to "
           "disk until they are needed.  Set it to -1 for no limit."));
 
+ConfigVariableEnum<VertexDataPage::CompressionMethod> vertex_data_compression_method
+("vertex-data-compression-method", VertexDataPage::CM_zlib,
+ PRC_DESC("Specifies the codec to use when compressing vertex data pages "
+          "in memory, for VertexDataBooks that don't specify their own.  "
+          "Currently the only codec is 'zlib'; 'default' also means zlib."));
+
 ConfigVariableInt vertex_data_compression_level
 ("vertex-data-compression-level", 1,
- PRC_DESC("Specifies the zlib compression level to use when compressing "
+ PRC_DESC("Specifies the compression level to use when compressing "
           "vertex data.  The number should be in the range 1 to 9, where "
           "larger values are slower but give better compression."));
 
@@ -83,6 +95,10 @@ PStatCollector VertexDataPage::_vdata_restore_pcollector("*:Vertex Data:Restore"
 PStatCollector VertexDataPage::_thread_wait_pcollector("Wait:Idle");
 PStatCollector VertexDataPage::_alloc_pages_pcollector("System memory:MMap:Vertex data");
 
+AtomicAdjust::Integer VertexDataPage::_total_compress_input = 0;
+AtomicAdjust::Integer VertexDataPage::_total_compress_output = 0;
+AtomicAdjust::Integer VertexDataPage::_total_decompress_output = 0;
+
 TypeHandle VertexDataPage::_type_handle;
 TypeHandle VertexDataPage::DeflatePage::_type_handle;
 
@@ -115,6 +131,7 @@ VertexDataPage(size_t book_size) :
   _size = 0;
   _uncompressed_size = 0;
   _ram_class = RC_resident;
+  _compression_method = CM_default;
   _pending_ram_class = RC_resident;
 }
 
@@ -134,6 +151,7 @@ VertexDataPage(VertexDataBook *book, size_t page_size, size_t block_size) :
   _size = page_size;
 
   _uncompressed_size = _size;
+  _compression_method = CM_default;
   _pending_ram_class = RC_resident;
   set_ram_class(RC_resident);
 }
@@ -207,6 +225,26 @@ flush_threads() {
   }
 }
 
+/**
+ * Returns true if the indicated compression method has been compiled into
+ * this build of Panda, false otherwise.  CM_default is available whenever
+ * the codec it stands for is.
+ */
+bool VertexDataPage::
+has_compression_method(CompressionMethod method) {
+  switch (method) {
+  case CM_default:
+  case CM_zlib:
+#ifdef HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  return false;
+}
+
 /**
  *
  */
@@ -348,76 +386,30 @@ make_resident() {
   }
 
   if (_ram_class == RC_compressed) {
-#ifdef HAVE_ZLIB
-    PStatTimer timer(_vdata_decompress_pcollector);
-
-    if (gobj_cat.is_debug()) {
-      gobj_cat.debug()
-        << "Expanding page from " << _size
-        << " to " << _uncompressed_size << "\n";
-    }
-    size_t new_allocated_size = round_up(_uncompressed_size);
-    unsigned char *new_data = alloc_page_data(new_allocated_size);
-    unsigned char *end_data = new_data + new_allocated_size;
-
-    z_stream z_source;
-#ifdef USE_MEMORY_NOWRAPPERS
-    z_source.zalloc = Z_NULL;
-    z_source.zfree = Z_NULL;
-#else
-    z_source.zalloc = (alloc_func)&do_zlib_alloc;
-    z_source.zfree = (free_func)&do_zlib_free;
-#endif
-
-    z_source.opaque = Z_NULL;
-    z_source.msg = (char *) "no error message";
+    if (_compression_method != CM_default) {
+      PStatTimer timer(_vdata_decompress_pcollector);
 
-    z_source.next_in = (Bytef *)(char *)_page_data;
-    z_source.avail_in = _size;
-    z_source.next_out = (Bytef *)new_data;
-    z_source.avail_out = new_allocated_size;
-
-    int result = inflateInit(&z_source);
-    if (result < 0) {
-      nassert_raise("zlib error");
-      return;
-    }
-    Thread::consider_yield();
+      if (gobj_cat.is_debug()) {
+        gobj_cat.debug()
+          << "Expanding page from " << _size
+          << " to " << _uncompressed_size << " using "
+          << _compression_method << "\n";
+      }
+      size_t new_allocated_size = round_up(_uncompressed_size);
+      unsigned char *new_data = alloc_page_data(new_allocated_size);
 
-    size_t output_size = 0;
-
-    int flush = 0;
-    result = 0;
-    while (result != Z_STREAM_END) {
-      unsigned char *start_out = (unsigned char *)z_source.next_out;
-      nassertv(start_out < end_data);
-      z_source.avail_out = std::min((size_t)(end_data - start_out), (size_t)inflate_page_size);
-      nassertv(z_source.avail_out != 0);
-      result = inflate(&z_source, flush);
-      if (result < 0 && result != Z_BUF_ERROR) {
-        nassert_raise("zlib error");
+      if (!do_decompress(_compression_method, new_data, new_allocated_size)) {
+        free_page_data(new_data, new_allocated_size);
+        nassert_raise("vertex data decompression error");
         return;
       }
-      size_t bytes_produced = (size_t)((unsigned char *)z_source.next_out - start_out);
-      output_size += bytes_produced;
-      if (bytes_produced == 0) {
-        // If we ever produce no bytes, then start flushing the output.
-        flush = Z_FINISH;
-      }
 
-      Thread::consider_yield();
+      free_page_data(_page_data, _allocated_size);
+      _page_data = new_data;
+      _size = _uncompressed_size;
+      _allocated_size = new_allocated_size;
+      AtomicAdjust::add(_total_decompress_output, (AtomicAdjust::Integer)_size);
     }
-    nassertv(z_source.avail_in == 0);
-    nassertv(output_size == _uncompressed_size);
-
-    result = inflateEnd(&z_source);
-    nassertv(result == Z_OK);
-
-    free_page_data(_page_data, _allocated_size);
-    _page_data = new_data;
-    _size = _uncompressed_size;
-    _allocated_size = new_allocated_size;
-#endif
 
     set_lru_size(_size);
     set_ram_class(RC_resident);
@@ -445,109 +437,232 @@ make_compressed() {
   if (_ram_class == RC_resident) {
     nassertv(_size == _uncompressed_size);
 
-#ifdef HAVE_ZLIB
+    CompressionMethod method = CM_default;
+    if (_book != nullptr) {
+      // The book shares our lock, so it's safe to read this here.
+      method = _book->_compression_method;
+    }
+    method = resolve_compression_method(method);
+
     PStatTimer timer(_vdata_compress_pcollector);
 
-    DeflatePage *page = new DeflatePage;
-    DeflatePage *head = page;
+    unsigned char *new_data;
+    size_t new_size, new_allocated_size;
+    if (do_compress(method, new_data, new_size, new_allocated_size)) {
+      // Now free the original, uncompressed data, and put this new compressed
+      // buffer in its place.
+      free_page_data(_page_data, _allocated_size);
+      _page_data = new_data;
+      _size = new_size;
+      _allocated_size = new_allocated_size;
+      _compression_method = method;
+      AtomicAdjust::add(_total_compress_input, (AtomicAdjust::Integer)_uncompressed_size);
+      AtomicAdjust::add(_total_compress_output, (AtomicAdjust::Integer)_size);
+
+      if (gobj_cat.is_debug()) {
+        gobj_cat.debug()
+          << "Compressed " << *this << " from " << _uncompressed_size
+          << " to " << _size << " using " << method << "\n";
+      }
+    } else {
+      // No compressor is available; the page is simply marked compressed
+      // (which moves it to the compressed LRU) but holds its original data.
+      _compression_method = CM_default;
+    }
+    set_lru_size(_size);
+    set_ram_class(RC_compressed);
+  }
+}
+
+/**
+ * Compresses the resident page data with the indicated codec into a newly-
+ * allocated buffer, which is returned in new_data.  Returns true on success,
+ * or false if the codec is not available in this build.  The original page
+ * data is not modified.
+ *
+ * Assumes the lock is already held.
+ */
+bool VertexDataPage::
+do_compress(CompressionMethod method, unsigned char *&new_data,
+            size_t &new_size, size_t &new_allocated_size) {
+#ifdef HAVE_ZLIB
+  nassertr(method == CM_zlib, false);
+
+  DeflatePage *page = new DeflatePage;
+  DeflatePage *head = page;
 
-    z_stream z_dest;
+  z_stream z_dest;
 #ifdef USE_MEMORY_NOWRAPPERS
-    z_dest.zalloc = Z_NULL;
-    z_dest.zfree = Z_NULL;
+  z_dest.zalloc = Z_NULL;
+  z_dest.zfree = Z_NULL;
 #else
-    z_dest.zalloc = (alloc_func)&do_zlib_alloc;
-    z_dest.zfree = (free_func)&do_zlib_free;
+  z_dest.zalloc = (alloc_func)&do_zlib_alloc;
+  z_dest.zfree = (free_func)&do_zlib_free;
 #endif
 
-    z_dest.opaque = Z_NULL;
-    z_dest.msg = (char *) "no error message";
+  z_dest.opaque = Z_NULL;
+  z_dest.msg = (char *) "no error message";
+
+  int result = deflateInit(&z_dest, vertex_data_compression_level);
+  if (result < 0) {
+    nassert_raise("zlib error");
+    return false;
+  }
+  Thread::consider_yield();
+
+  z_dest.next_in = (Bytef *)(char *)_page_data;
+  z_dest.avail_in = _uncompressed_size;
+  size_t output_size = 0;
+
+  // Compress the data into one or more individual pages.  We have to
+  // compress it page-at-a-time, since we're not really sure how big the
+  // result will be (so we can't easily pre-allocate a buffer).
+  int flush = 0;
+  result = 0;
+  while (result != Z_STREAM_END) {
+    unsigned char *start_out = (page->_buffer + page->_used_size);
+    z_dest.next_out = (Bytef *)start_out;
+    z_dest.avail_out = (size_t)deflate_page_size - page->_used_size;
+    if (z_dest.avail_out == 0) {
+      DeflatePage *new_page = new DeflatePage;
+      page->_next = new_page;
+      page = new_page;
+      start_out = page->_buffer;
+      z_dest.next_out = (Bytef *)start_out;
+      z_dest.avail_out = deflate_page_size;
+    }
 
-    int result = deflateInit(&z_dest, vertex_data_compression_level);
-    if (result < 0) {
+    result = deflate(&z_dest, flush);
+    if (result < 0 && result != Z_BUF_ERROR) {
       nassert_raise("zlib error");
-      return;
+      return false;
+    }
+    size_t bytes_produced = (size_t)((unsigned char *)z_dest.next_out - start_out);
+    page->_used_size += bytes_produced;
+    nassertr(page->_used_size <= deflate_page_size, false);
+    output_size += bytes_produced;
+    if (bytes_produced == 0) {
+      // If we ever produce no bytes, then start flushing the output.
+      flush = Z_FINISH;
     }
-    Thread::consider_yield();
 
-    z_dest.next_in = (Bytef *)(char *)_page_data;
-    z_dest.avail_in = _uncompressed_size;
-    size_t output_size = 0;
-
-    // Compress the data into one or more individual pages.  We have to
-    // compress it page-at-a-time, since we're not really sure how big the
-    // result will be (so we can't easily pre-allocate a buffer).
-    int flush = 0;
-    result = 0;
-    while (result != Z_STREAM_END) {
-      unsigned char *start_out = (page->_buffer + page->_used_size);
-      z_dest.next_out = (Bytef *)start_out;
-      z_dest.avail_out = (size_t)deflate_page_size - page->_used_size;
-      if (z_dest.avail_out == 0) {
-        DeflatePage *new_page = new DeflatePage;
-        page->_next = new_page;
-        page = new_page;
-        start_out = page->_buffer;
-        z_dest.next_out = (Bytef *)start_out;
-        z_dest.avail_out = deflate_page_size;
-      }
+    Thread::consider_yield();
+  }
+  nassertr(z_dest.avail_in == 0, false);
+
+  result = deflateEnd(&z_dest);
+  nassertr(result == Z_OK, false);
+
+  // Now we know how big the result will be.  Allocate a buffer, and copy the
+  // data from the various pages.
+
+  new_size = output_size;
+  new_allocated_size = round_up(output_size);
+  new_data = alloc_page_data(new_allocated_size);
+
+  size_t copied_size = 0;
+  unsigned char *p = new_data;
+  page = head;
+  while (page != nullptr) {
+    memcpy(p, page->_buffer, page->_used_size);
+    copied_size += page->_used_size;
+    p += page->_used_size;
+    DeflatePage *next = page->_next;
+    delete page;
+    page = next;
+  }
+  nassertr(copied_size == output_size, false);
+  return true;
 
-      result = deflate(&z_dest, flush);
-      if (result < 0 && result != Z_BUF_ERROR) {
-        nassert_raise("zlib error");
-        return;
-      }
-      size_t bytes_produced = (size_t)((unsigned char *)z_dest.next_out - start_out);
-      page->_used_size += bytes_produced;
-      nassertv(page->_used_size <= deflate_page_size);
-      output_size += bytes_produced;
-      if (bytes_produced == 0) {
-        // If we ever produce no bytes, then start flushing the output.
-        flush = Z_FINISH;
-      }
+#else  // HAVE_ZLIB
+  return false;
+#endif  // HAVE_ZLIB
+}
 
-      Thread::consider_yield();
-    }
-    nassertv(z_dest.avail_in == 0);
+/**
+ * Expands the compressed page data, which was compressed with the indicated
+ * codec, into the indicated buffer, which must be large enough to hold
+ * _uncompressed_size bytes.  Returns true on success, false on failure.
+ *
+ * Assumes the lock is already held.
+ */
+bool VertexDataPage::
+do_decompress(CompressionMethod method, unsigned char *new_data,
+              size_t new_allocated_size) {
+#ifdef HAVE_ZLIB
+  nassertr(method == CM_zlib, false);
+  unsigned char *end_data = new_data + new_allocated_size;
 
-    result = deflateEnd(&z_dest);
-    nassertv(result == Z_OK);
+  z_stream z_source;
+#ifdef USE_MEMORY_NOWRAPPERS
+  z_source.zalloc = Z_NULL;
+  z_source.zfree = Z_NULL;
+#else
+  z_source.zalloc = (alloc_func)&do_zlib_alloc;
+  z_source.zfree = (free_func)&do_zlib_free;
+#endif
 
-    // Now we know how big the result will be.  Allocate a buffer, and copy
-    // the data from the various pages.
+  z_source.opaque = Z_NULL;
+  z_source.msg = (char *) "no error message";
 
-    size_t new_allocated_size = round_up(output_size);
-    unsigned char *new_data = alloc_page_data(new_allocated_size);
+  z_source.next_in = (Bytef *)(char *)_page_data;
+  z_source.avail_in = _size;
+  z_source.next_out = (Bytef *)new_data;
+  z_source.avail_out = new_allocated_size;
 
-    size_t copied_size = 0;
-    unsigned char *p = new_data;
-    page = head;
-    while (page != nullptr) {
-      memcpy(p, page->_buffer, page->_used_size);
-      copied_size += page->_used_size;
-      p += page->_used_size;
-      DeflatePage *next = page->_next;
-      delete page;
-      page = next;
+  int result = inflateInit(&z_source);
+  if (result < 0) {
+    return false;
+  }
+  Thread::consider_yield();
+
+  size_t output_size = 0;
+
+  int flush = 0;
+  result = 0;
+  while (result != Z_STREAM_END) {
+    unsigned char *start_out = (unsigned char *)z_source.next_out;
+    nassertr(start_out < end_data, false);
+    z_source.avail_out = std::min((size_t)(end_data - start_out), (size_t)inflate_page_size);
+    nassertr(z_source.avail_out != 0, false);
+    result = inflate(&z_source, flush);
+    if (result < 0 && result != Z_BUF_ERROR) {
+      return false;
+    }
+    size_t bytes_produced = (size_t)((unsigned char *)z_source.next_out - start_out);
+    output_size += bytes_produced;
+    if (bytes_produced == 0) {
+      // If we ever produce no bytes, then start flushing the output.
+      flush = Z_FINISH;
     }
-    nassertv(copied_size == output_size);
 
-    // Now free the original, uncompressed data, and put this new compressed
-    // buffer in its place.
-    free_page_data(_page_data, _allocated_size);
-    _page_data = new_data;
-    _size = output_size;
-    _allocated_size = new_allocated_size;
+    Thread::consider_yield();
+  }
+  nassertr(z_source.avail_in == 0, false);
+  nassertr(output_size == _uncompressed_size, false);
 
-    if (gobj_cat.is_debug()) {
-      gobj_cat.debug()
-        << "Compressed " << *this << " from " << _uncompressed_size
-        << " to " << _size << "\n";
-    }
-#endif
-    set_lru_size(_size);
-    set_ram_class(RC_compressed);
+  result = inflateEnd(&z_source);
+  nassertr(result == Z_OK, false);
+  return true;
+
+#else  // HAVE_ZLIB
+  return false;
+#endif  // HAVE_ZLIB
+}
+
+/**
+ * Maps CM_default, either on the book or in vertex-data-compression-method,
+ * to the actual codec that will be used to compress a page.
+ */
+VertexDataPage::CompressionMethod VertexDataPage::
+resolve_compression_method(CompressionMethod method) {
+  if (method == CM_default) {
+    method = vertex_data_compression_method;
+  }
+  if (method == CM_default) {
+    method = CM_zlib;
   }
+  return method;
 }
 
 /**
@@ -986,3 +1101,42 @@ thread_main() {
     Thread::consider_yield();
   }
 }
+
+/**
+ *
+ */
+ostream &
+operator << (ostream &out, VertexDataPage::CompressionMethod method) {
+  switch (method) {
+  case VertexDataPage::CM_default:
+    return out << "default";
+
+  case VertexDataPage::CM_zlib:
+    return out << "zlib";
+
+  }
+
+  return out << "**invalid VertexDataPage::CompressionMethod (" << (int)method << ")**";
+}
+
+/**
+ *
+ */
+istream &
+operator >> (istream &in, VertexDataPage::CompressionMethod &method) {
+  string word;
+  in >> word;
+
+  if (cmp_nocase(word, "default") == 0) {
+    method = VertexDataPage::CM_default;
+  } else if (cmp_nocase(word, "zlib") == 0) {
+    method = VertexDataPage::CM_zlib;
+
+  } else {
+    gobj_cat->error()
+      << "Invalid VertexDataPage::CompressionMethod value: " << word << "\n";
+    method = VertexDataPage::CM_zlib;
+  }
+
+  return in;
+}
@@ -24,6 +24,7 @@
 #include "thread.h"
 #include "mutexHolder.h"
 #include "pdeque.h"
+#include "atomicAdjust.h"
 
 class VertexDataBook;
 class VertexDataBlock;
@@ -51,6 +52,13 @@ PUBLISHED:
     RC_end_of_list,  // list marker; do not use
   };
 
+  // The codec used to compress a page in-memory when it is evicted from the
+  // resident LRU.
+  enum CompressionMethod {
+    CM_default,  // according to vertex-data-compression-method, else zlib
+    CM_zlib,
+  };
+
   INLINE RamClass get_ram_class() const;
   INLINE RamClass get_pending_ram_class() const;
   INLINE void request_resident();
@@ -59,6 +67,9 @@ PUBLISHED:
   INLINE VertexDataBlock *get_first_block() const;
 
   INLINE VertexDataBook *get_book() const;
+  INLINE CompressionMethod get_compression_method() const;
+
+  static bool has_compression_method(CompressionMethod method);
 
   INLINE static SimpleLru *get_global_lru(RamClass rclass);
   INLINE static SimpleLru *get_pending_lru();
@@ -70,6 +81,9 @@ PUBLISHED:
   INLINE static int get_num_threads();
   INLINE static int get_num_pending_reads();
   INLINE static int get_num_pending_writes();
+  INLINE static size_t get_total_compress_input();
+  INLINE static size_t get_total_compress_output();
+  INLINE static size_t get_total_decompress_output();
   static void stop_threads();
   static void flush_threads();
 
@@ -95,6 +109,12 @@ private:
   void make_compressed();
   void make_disk();
 
+  bool do_compress(CompressionMethod method, unsigned char *&new_data,
+                   size_t &new_size, size_t &new_allocated_size);
+  bool do_decompress(CompressionMethod method, unsigned char *new_data,
+                     size_t new_allocated_size);
+  static CompressionMethod resolve_compression_method(CompressionMethod method);
+
   bool do_save_to_disk();
   void do_restore_from_disk();
 
@@ -158,6 +178,7 @@ private:
   unsigned char *_page_data;
   size_t _size, _allocated_size, _uncompressed_size;
   RamClass _ram_class;
+  CompressionMethod _compression_method;
   PT(VertexDataSaveBlock) _saved_block;
   size_t _book_size;
   size_t _block_size;
@@ -212,6 +233,11 @@ private:
   static PStatCollector _thread_wait_pcollector;
   static PStatCollector _alloc_pages_pcollector;
 
+  // Running byte totals for the compressor, used to report throughput.
+  static AtomicAdjust::Integer _total_compress_input;
+  static AtomicAdjust::Integer _total_compress_output;
+  static AtomicAdjust::Integer _total_decompress_output;
+
 public:
   static TypeHandle get_class_type() {
     return _type_handle;
@@ -232,6 +258,9 @@ inline std::ostream &operator << (std::ostream &out, const VertexDataPage &page)
   return out;
 }
 
+EXPCL_PANDA_GOBJ std::ostream &operator << (std::ostream &out, VertexDataPage::CompressionMethod method);
+EXPCL_PANDA_GOBJ std::istream &operator >> (std::istream &in, VertexDataPage::CompressionMethod &method);
+
 #include "vertexDataPage.I"
 
 #endif
@@ -21,6 +21,7 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <unistd.h>
 #endif  // _WIN32
 
 #if defined(__ANDROID__) && !defined(PHAVE_LOCKF)
@@ -238,15 +239,11 @@ write_data(const unsigned char *data, size_t size, bool compressed) {
         << "Wrote " << size << " bytes in " << *Thread::get_current_thread() << " over " << floor((finish_time - start_time) * 1000.0) << " ms and " << num_passes << " passes.\n";
     }
 #else
-    // Posix case.
-    if (lseek(_fd, block->get_start(), SEEK_SET) == -1) {
-      gobj_cat.error()
-        << "Error seeking to position " << block->get_start() << " in save file.\n";
-      return nullptr;
-    }
-
+    // Posix case.  We use positioned writes, which saves a seek call per
+    // block and doesn't depend on the shared file offset.
+    off_t offset = (off_t)block->get_start();
     while (size > 0) {
-      ssize_t result = ::write(_fd, data, size);
+      ssize_t result = ::pwrite(_fd, data, size, offset);
       if (result < 0) {
         if (errno == EAGAIN) {
           Thread::force_yield();
@@ -261,6 +258,7 @@ write_data(const unsigned char *data, size_t size, bool compressed) {
       Thread::consider_yield();
       data += result;
       size -= result;
+      offset += result;
     }
 #endif  // _WIN32
   }
@@ -322,26 +320,23 @@ read_data(unsigned char *data, size_t size, VertexDataSaveBlock *block) {
 
 #else
   // Posix case.
-  if (lseek(_fd, block->get_start(), SEEK_SET) == -1) {
-    gobj_cat.error()
-      << "Error seeking to position " << block->get_start() << " in save file.\n";
-    return false;
-  }
+  off_t offset = (off_t)block->get_start();
   while (size > 0) {
-    ssize_t result = read(_fd, data, size);
-    if (result == -1) {
-      if (errno == EAGAIN) {
+    ssize_t result = ::pread(_fd, data, size, offset);
+    if (result <= 0) {
+      if (result == -1 && errno == EAGAIN) {
         Thread::force_yield();
-      } else {
-        gobj_cat.error()
-          << "Error reading " << size << " bytes from save file.\n";
-        return false;
+        continue;
       }
+      gobj_cat.error()
+        << "Error reading " << size << " bytes from save file.\n";
+      return false;
     }
 
     Thread::consider_yield();
     data += result;
     size -= result;
+    offset += result;
   }
 #endif  // _WIN32
 
@@ -23,9 +23,12 @@
     shaderTerrainMesh.I shaderTerrainMesh.h \
     lineSegs.I lineSegs.h \
     multitexReducer.I multitexReducer.h multitexReducer.cxx \
+    meshSimplifier.I meshSimplifier.h \
     nodeVertexTransform.I nodeVertexTransform.h \
+    occlusionDepthBuffer.I occlusionDepthBuffer.h \
     pfmVizzer.I pfmVizzer.h \
-    rigidBodyCombiner.I rigidBodyCombiner.h
+    rigidBodyCombiner.I rigidBodyCombiner.h \
+    softwareOcclusionCullTraverser.I softwareOcclusionCullTraverser.h
 
   #define COMPOSITE_SOURCES \
     cardMaker.cxx \
@@ -35,15 +38,18 @@
     frameRateMeter.cxx \
     meshDrawer.cxx \
     meshDrawer2D.cxx \
+    meshSimplifier.cxx \
     geoMipTerrain.cxx \
     sceneGraphAnalyzerMeter.cxx \
     heightfieldTesselator.cxx \
     shaderTerrainMesh.cxx \
     nodeVertexTransform.cxx \
     pfmVizzer.cxx \
+    occlusionDepthBuffer.cxx \
     pipeOcclusionCullTraverser.cxx \
     lineSegs.cxx \
-    rigidBodyCombiner.cxx
+    rigidBodyCombiner.cxx \
+    softwareOcclusionCullTraverser.cxx
 
   #define INSTALL_HEADERS \
     cardMaker.I cardMaker.h \
@@ -58,10 +64,33 @@
     shaderTerrainMesh.I shaderTerrainMesh.h \
     lineSegs.I lineSegs.h \
     multitexReducer.I multitexReducer.h \
+    meshSimplifier.I meshSimplifier.h \
     nodeVertexTransform.I nodeVertexTransform.h \
+    occlusionDepthBuffer.I occlusionDepthBuffer.h \
     pfmVizzer.I pfmVizzer.h \
-    rigidBodyCombiner.I rigidBodyCombiner.h
+    rigidBodyCombiner.I rigidBodyCombiner.h \
+    softwareOcclusionCullTraverser.I softwareOcclusionCullTraverser.h
 
   #define IGATESCAN all
 
 #end lib_target
+
+#begin test_bin_target
+  #define TARGET test_occlusion_cull
+  #define LOCAL_LIBS \
+    p3grutil p3display p3cull p3pgraph p3gobj p3putil p3express p3pstatclient
+
+  #define SOURCES \
+    test_occlusion_cull.cxx
+
+#end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_mesh_simplifier
+  #define LOCAL_LIBS \
+    p3grutil p3pgraph p3gobj p3linmath p3putil p3express
+
+  #define SOURCES \
+    test_mesh_simplifier.cxx
+
+#end test_bin_target
@@ -23,6 +23,7 @@
 #include "nodeVertexTransform.h"
 #include "rigidBodyCombiner.h"
 #include "pipeOcclusionCullTraverser.h"
+#include "softwareOcclusionCullTraverser.h"
 #include "shaderTerrainMesh.h"
 
 #include "dconfig.h"
@@ -127,6 +128,7 @@ init_libgrutil() {
   NodeVertexTransform::init_type();
   RigidBodyCombiner::init_type();
   PipeOcclusionCullTraverser::init_type();
+  SoftwareOcclusionCullTraverser::init_type();
   SceneGraphAnalyzerMeter::init_type();
   ShaderTerrainMesh::init_type();
 
@@ -0,0 +1,799 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file meshSimplifier.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "meshSimplifier.h"
+#include "fadeLodNode.h"
+#include "geomTriangles.h"
+#include "geomVertexReader.h"
+#include "geometricBoundingVolume.h"
+#include "internalName.h"
+#include "config_grutil.h"
+#include "string_utils.h"
+#include "pmap.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+// Border edges are constrained by a plane perpendicular to the adjoining
+// face, weighted by this factor, so that the outline of an open mesh is
+// preserved in preference to its interior.
+static const double boundary_weight = 10.0;
+
+// A collapse is rejected if it would turn any remaining triangle by more
+// than about 80 degrees, which catches folds as well as outright flips.
+static const double min_normal_dot = 0.2;
+
+/**
+ *
+ */
+MeshSimplifier::
+MeshSimplifier() :
+  _num_levels(3),
+  _reduction(0.5f),
+  _attribute_weight(0.05f),
+  _error_ratio(0.001f),
+  _far_distance(1000000.0f),
+  _fade(false),
+  _last_error(0.0f)
+{
+}
+
+/**
+ * Generates get_num_levels() successively simplified versions of the
+ * indicated GeomNode, and returns a new LODNode (or FadeLODNode, if
+ * set_fade() has been called) with a copy of the original node as its first
+ * child and the simplified versions as the remaining children.
+ *
+ * The switch distances are chosen so that each level is shown from the
+ * distance at which its simplification error falls below get_error_ratio()
+ * times the distance.  The center of the LODNode is set to the center of the
+ * original node's bounding volume.
+ *
+ * Fewer levels are generated if the mesh can't be reduced any further, or if
+ * a level would not be shown before get_far_distance().
+ */
+PT(LODNode) MeshSimplifier::
+make_lod(const GeomNode *node) {
+  nassertr(node != nullptr, nullptr);
+
+  PT(LODNode) lod;
+  if (_fade) {
+    lod = new FadeLODNode(node->get_name());
+  } else {
+    lod = new LODNode(node->get_name());
+  }
+
+  CPT(BoundingVolume) bounds = node->get_bounds();
+  const GeometricBoundingVolume *gbv = bounds->as_geometric_bounding_volume();
+  if (gbv != nullptr && !gbv->is_empty() && !gbv->is_infinite()) {
+    lod->set_center(gbv->get_approx_center());
+  }
+
+  PT(PandaNode) level0 = node->make_copy();
+  lod->add_child(level0);
+
+  pvector<PN_stdfloat> distances;
+  distances.push_back(0.0f);
+
+  int prev_triangles = count_triangles(node);
+  PN_stdfloat ratio = 1.0f;
+  for (int level = 1; level <= _num_levels; ++level) {
+    ratio *= _reduction;
+    PT(GeomNode) simplified = simplify(node, ratio);
+    int num_triangles = count_triangles(simplified);
+    if (num_triangles == 0 || num_triangles >= prev_triangles) {
+      // We can't get any further.
+      break;
+    }
+
+    // Make sure the distances increase strictly, even if the simplification
+    // happened to be lossless.
+    PN_stdfloat distance = _last_error / _error_ratio;
+    distance = std::max(distance, distances.back() * 1.25f);
+    distance = std::max(distance, (PN_stdfloat)0.001f);
+    if (distance >= _far_distance) {
+      break;
+    }
+
+    if (grutil_cat.is_debug()) {
+      grutil_cat.debug()
+        << "LOD level " << level << " of " << node->get_name() << ": "
+        << num_triangles << " triangles, error " << _last_error
+        << ", switch at " << distance << "\n";
+    }
+
+    simplified->set_name(node->get_name() + "-lod" + format_string(level));
+    lod->add_child(simplified);
+    distances.push_back(distance);
+    prev_triangles = num_triangles;
+  }
+
+  distances.push_back(_far_distance);
+  for (size_t i = 0; i + 1 < distances.size(); ++i) {
+    lod->add_switch(distances[i + 1], distances[i]);
+  }
+
+  return lod;
+}
+
+/**
+ * Returns a copy of the indicated GeomNode in which each Geom has been
+ * simplified to the indicated fraction of its original triangle count, or as
+ * close to it as possible.  The vertices along any boundary shared between
+ * two of the node's Geoms are kept in place.
+ *
+ * Afterwards, get_last_error() returns the largest error introduced in any
+ * of the Geoms.
+ */
+PT(GeomNode) MeshSimplifier::
+simplify(const GeomNode *node, PN_stdfloat ratio) {
+  nassertr(node != nullptr, nullptr);
+
+  // Find the points that lie on the boundary of more than one Geom; these
+  // are typically the places where two different materials meet.
+  LockedPoints locked;
+  int num_geoms = node->get_num_geoms();
+  if (num_geoms > 1) {
+    pmap<LPoint3, int> border_count;
+    for (int i = 0; i < num_geoms; ++i) {
+      LockedPoints points;
+      get_border_points(node->get_geom(i), points);
+      for (const LPoint3 &point : points) {
+        ++border_count[point];
+      }
+    }
+    for (const auto &item : border_count) {
+      if (item.second > 1) {
+        locked.insert(item.first);
+      }
+    }
+  }
+
+  PT(GeomNode) result = DCAST(GeomNode, node->make_copy());
+  result->remove_all_geoms();
+
+  _last_error = 0.0f;
+  for (int i = 0; i < num_geoms; ++i) {
+    PN_stdfloat error;
+    PT(Geom) geom = do_simplify(node->get_geom(i), ratio, locked, error);
+    _last_error = std::max(_last_error, error);
+    result->add_geom(geom, node->get_geom_state(i));
+  }
+
+  return result;
+}
+
+/**
+ * Returns a copy of the indicated Geom simplified to the indicated fraction
+ * of its original triangle count, or as close to it as possible.  The new
+ * Geom shares the original GeomVertexData.  Non-triangle primitives are
+ * copied unchanged.
+ */
+PT(Geom) MeshSimplifier::
+simplify_geom(const Geom *geom, PN_stdfloat ratio) {
+  nassertr(geom != nullptr, nullptr);
+  return do_simplify(geom, ratio, LockedPoints(), _last_error);
+}
+
+/**
+ * The implementation of simplify_geom().  Vertices at any of the indicated
+ * positions are never moved.  error is filled in with the largest distance
+ * of a collapse that was performed.
+ */
+PT(Geom) MeshSimplifier::
+do_simplify(const Geom *geom, PN_stdfloat ratio, const LockedPoints &locked,
+            PN_stdfloat &error) const {
+  error = 0.0f;
+
+  CPT(GeomVertexData) vdata = geom->get_vertex_data();
+  const GeomVertexFormat *format = vdata->get_format();
+  if (!format->has_column(InternalName::get_vertex())) {
+    return geom->make_copy();
+  }
+
+  // Collect all of the triangles together; other kinds of primitives are
+  // passed through unchanged.
+  vector_int indices;
+  pvector<CPT(GeomPrimitive)> other_prims;
+  GeomEnums::UsageHint usage_hint = geom->get_usage_hint();
+  GeomEnums::ShadeModel shade_model = GeomEnums::SM_uniform;
+  bool got_triangles = false;
+
+  int num_primitives = geom->get_num_primitives();
+  for (int i = 0; i < num_primitives; ++i) {
+    CPT(GeomPrimitive) prim = geom->get_primitive(i);
+    if (prim->get_primitive_type() == GeomEnums::PT_polygons) {
+      CPT(GeomPrimitive) triangles = prim->decompose();
+      if (triangles->get_num_vertices_per_primitive() == 3) {
+        if (!got_triangles) {
+          usage_hint = triangles->get_usage_hint();
+          shade_model = triangles->get_shade_model();
+          got_triangles = true;
+        }
+        int num_vertices = triangles->get_num_vertices();
+        for (int vi = 0; vi < num_vertices; ++vi) {
+          indices.push_back(triangles->get_vertex(vi));
+        }
+        continue;
+      }
+    }
+    other_prims.push_back(prim);
+  }
+
+  int num_triangles = (int)indices.size() / 3;
+  int target = (int)(num_triangles * ratio);
+  if (num_triangles == 0 || num_triangles <= target) {
+    return geom->make_copy();
+  }
+
+  // Read the vertex positions, and all of the other columns as generic
+  // four-component attributes.  The transform_blend column is an index into
+  // the TransformBlendTable, so it is compared for equality only.
+  int num_rows = vdata->get_num_rows();
+  pvector<LPoint3> positions(num_rows);
+  pvector<const InternalName *> attrib_names;
+  bool has_blend = false;
+
+  size_t num_columns = format->get_num_columns();
+  for (size_t ci = 0; ci < num_columns; ++ci) {
+    const InternalName *name = format->get_column(ci)->get_name();
+    if (name == InternalName::get_vertex()) {
+      continue;
+    } else if (name == InternalName::get_transform_blend()) {
+      has_blend = true;
+    } else {
+      attrib_names.push_back(name);
+    }
+  }
+
+  int num_attribs = (int)attrib_names.size();
+  pvector<LVecBase4> attribs(num_rows * num_attribs);
+  vector_int blends(has_blend ? num_rows : 0);
+  {
+    GeomVertexReader vertex(vdata, InternalName::get_vertex());
+    for (int ri = 0; ri < num_rows; ++ri) {
+      positions[ri] = vertex.get_data3();
+    }
+    for (int ai = 0; ai < num_attribs; ++ai) {
+      GeomVertexReader reader(vdata, attrib_names[ai]);
+      for (int ri = 0; ri < num_rows; ++ri) {
+        attribs[ri * num_attribs + ai] = reader.get_data4();
+      }
+    }
+    if (has_blend) {
+      GeomVertexReader reader(vdata, InternalName::get_transform_blend());
+      for (int ri = 0; ri < num_rows; ++ri) {
+        blends[ri] = reader.get_data1i();
+      }
+    }
+  }
+
+  // Weld together rows that are exact duplicates of each other, as is common
+  // in unindexed or carelessly exported models.
+  {
+    vector_int canonical(num_rows);
+    pmap<std::string, int> rows_by_key;
+    for (int ri = 0; ri < num_rows; ++ri) {
+      std::string key((const char *)&positions[ri], sizeof(LPoint3));
+      if (num_attribs != 0) {
+        key.append((const char *)&attribs[ri * num_attribs],
+                   sizeof(LVecBase4) * num_attribs);
+      }
+      if (has_blend) {
+        key.append((const char *)&blends[ri], sizeof(int));
+      }
+      canonical[ri] = rows_by_key.insert(std::make_pair(key, ri)).first->second;
+    }
+    for (int &vi : indices) {
+      nassertr(vi >= 0 && vi < num_rows, geom->make_copy());
+      vi = canonical[vi];
+    }
+  }
+
+  // Now group the rows by position.  More than one row at a given position
+  // indicates a seam in the texture coordinates or normals.
+  vector_int pos_id(num_rows, -1);
+  pvector<LPoint3> points;
+  pvector<vector_int> pos_rows;
+  {
+    pmap<LPoint3, int> ids;
+    for (int vi : indices) {
+      if (pos_id[vi] < 0) {
+        auto result = ids.insert(std::make_pair(positions[vi], (int)points.size()));
+        if (result.second) {
+          points.push_back(positions[vi]);
+          pos_rows.push_back(vector_int());
+        }
+        pos_id[vi] = result.first->second;
+        pos_rows[pos_id[vi]].push_back(vi);
+      }
+    }
+  }
+  int num_points = (int)points.size();
+
+  pvector<vector_int> row_tris(num_rows);
+  pvector<bool> alive(num_triangles, true);
+  int num_alive = num_triangles;
+  for (int ti = 0; ti < num_triangles; ++ti) {
+    const int *tri = &indices[ti * 3];
+    int p0 = pos_id[tri[0]];
+    int p1 = pos_id[tri[1]];
+    int p2 = pos_id[tri[2]];
+    if (p0 == p1 || p1 == p2 || p2 == p0) {
+      alive[ti] = false;
+      --num_alive;
+      continue;
+    }
+    for (int k = 0; k < 3; ++k) {
+      row_tris[tri[k]].push_back(ti);
+    }
+  }
+
+  // Accumulate the area-weighted face quadrics at each point, and count the
+  // uses of each edge to find the borders.
+  pvector<Quadric> quadrics(num_points);
+  pmap<std::pair<int, int>, int> edge_count;
+  for (int ti = 0; ti < num_triangles; ++ti) {
+    if (!alive[ti]) {
+      continue;
+    }
+    int p[3] = { pos_id[indices[ti * 3]], pos_id[indices[ti * 3 + 1]], pos_id[indices[ti * 3 + 2]] };
+    LVector3 normal = (points[p[1]] - points[p[0]]).cross(points[p[2]] - points[p[0]]);
+    double area = normal.length() * 0.5;
+    if (normal.normalize()) {
+      PN_stdfloat d = -normal.dot(points[p[0]]);
+      for (int k = 0; k < 3; ++k) {
+        quadrics[p[k]].add_plane(normal, d, area);
+      }
+    }
+    for (int k = 0; k < 3; ++k) {
+      int a = p[k];
+      int b = p[(k + 1) % 3];
+      ++edge_count[std::make_pair(std::min(a, b), std::max(a, b))];
+    }
+  }
+
+  pvector<vector_int> border_neighbors(num_points);
+  for (int ti = 0; ti < num_triangles; ++ti) {
+    if (!alive[ti]) {
+      continue;
+    }
+    int p[3] = { pos_id[indices[ti * 3]], pos_id[indices[ti * 3 + 1]], pos_id[indices[ti * 3 + 2]] };
+    LVector3 normal = (points[p[1]] - points[p[0]]).cross(points[p[2]] - points[p[0]]);
+    if (!normal.normalize()) {
+      continue;
+    }
+    for (int k = 0; k < 3; ++k) {
+      int a = p[k];
+      int b = p[(k + 1) % 3];
+      if (edge_count[std::make_pair(std::min(a, b), std::max(a, b))] != 1) {
+        continue;
+      }
+      LVector3 edge = points[b] - points[a];
+      LVector3 perp = edge.cross(normal);
+      if (perp.normalize()) {
+        PN_stdfloat d = -perp.dot(points[a]);
+        double weight = boundary_weight * edge.length_squared();
+        quadrics[a].add_plane(perp, d, weight);
+        quadrics[b].add_plane(perp, d, weight);
+      }
+      border_neighbors[a].push_back(b);
+      border_neighbors[b].push_back(a);
+    }
+  }
+
+  pvector<bool> is_locked(num_points, false);
+  if (!locked.empty()) {
+    for (int pi = 0; pi < num_points; ++pi) {
+      is_locked[pi] = (locked.count(points[pi]) != 0);
+    }
+  }
+
+  // The attribute error is scaled to the size of the mesh, so that the
+  // attribute weight is independent of the units of the model.
+  LPoint3 center(0.0f, 0.0f, 0.0f);
+  for (const LPoint3 &point : points) {
+    center += point;
+  }
+  center /= (PN_stdfloat)num_points;
+  double radius_squared = 0.0;
+  for (const LPoint3 &point : points) {
+    radius_squared = std::max(radius_squared, (double)(point - center).length_squared());
+  }
+  double attrib_scale = _attribute_weight * radius_squared;
+
+  // Returns true if the triangle still references the indicated row.
+  auto has_row = [&](int ti, int row) {
+    const int *tri = &indices[ti * 3];
+    return tri[0] == row || tri[1] == row || tri[2] == row;
+  };
+
+  // Fills in the points connected to the indicated point by a live triangle.
+  auto get_neighbors = [&](int from, vector_int &neighbors) {
+    neighbors.clear();
+    for (int row : pos_rows[from]) {
+      for (int ti : row_tris[row]) {
+        if (alive[ti] && has_row(ti, row)) {
+          for (int k = 0; k < 3; ++k) {
+            int pi = pos_id[indices[ti * 3 + k]];
+            if (pi != from) {
+              neighbors.push_back(pi);
+            }
+          }
+        }
+      }
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+  };
+
+  // Determines whether the point "from" may be collapsed onto the point "to",
+  // as far as the seams and borders are concerned, and at what cost.  Each
+  // row at "from" must be connected to exactly one row at "to", which it
+  // will be merged into; this keeps seams intact.
+  auto evaluate = [&](int from, int to, Candidate &candidate, vector_int &targets) {
+    if (is_locked[from]) {
+      return false;
+    }
+    if (!border_neighbors[from].empty() &&
+        std::find(border_neighbors[from].begin(), border_neighbors[from].end(), to) == border_neighbors[from].end()) {
+      // A border point may only slide along the border.
+      return false;
+    }
+
+    targets.clear();
+    double attrib_error = 0.0;
+    for (int row : pos_rows[from]) {
+      int target_row = -1;
+      for (int ti : row_tris[row]) {
+        if (!alive[ti] || !has_row(ti, row)) {
+          continue;
+        }
+        for (int k = 0; k < 3; ++k) {
+          int vi = indices[ti * 3 + k];
+          if (pos_id[vi] == to) {
+            if (target_row < 0) {
+              target_row = vi;
+            } else if (target_row != vi) {
+              return false;
+            }
+          }
+        }
+      }
+      if (target_row < 0) {
+        return false;
+      }
+      targets.push_back(target_row);
+
+      for (int ai = 0; ai < num_attribs; ++ai) {
+        LVecBase4 delta = attribs[row * num_attribs + ai] - attribs[target_row * num_attribs + ai];
+        attrib_error += delta.length_squared();
+      }
+      if (has_blend && blends[row] != blends[target_row]) {
+        attrib_error += 1.0;
+      }
+    }
+
+    Quadric quadric = quadrics[from];
+    quadric += quadrics[to];
+    double dist2 = quadric.evaluate(points[to]);
+    if (quadric._weight > 0.0) {
+      dist2 /= quadric._weight;
+    }
+    candidate._error = sqrt(dist2);
+    candidate._cost = dist2 + attrib_scale * attrib_error;
+    candidate._from = from;
+    candidate._to = to;
+    return true;
+  };
+
+  // Checks the rest of the conditions for collapsing "from" onto "to", which
+  // are more expensive to test, so that they are only tested for the
+  // cheapest candidates.
+  vector_int from_neighbors, to_neighbors, opposite;
+  auto is_valid = [&](int from, int to) {
+    // The link condition: the only points that may be connected to both
+    // "from" and "to" are the third points of the triangles along the edge
+    // between them.  Any other common neighbor would end up joined to the
+    // merged point by two different edges, pinching the surface.
+    opposite.clear();
+    for (int row : pos_rows[from]) {
+      for (int ti : row_tris[row]) {
+        if (!alive[ti] || !has_row(ti, row)) {
+          continue;
+        }
+        int p[3] = { pos_id[indices[ti * 3]], pos_id[indices[ti * 3 + 1]], pos_id[indices[ti * 3 + 2]] };
+        if (p[0] == to || p[1] == to || p[2] == to) {
+          opposite.push_back(p[0] + p[1] + p[2] - from - to);
+        }
+      }
+    }
+    std::sort(opposite.begin(), opposite.end());
+    opposite.erase(std::unique(opposite.begin(), opposite.end()), opposite.end());
+    if (opposite.empty() || opposite.size() > 2) {
+      // They don't share a proper edge.
+      return false;
+    }
+    get_neighbors(from, from_neighbors);
+    get_neighbors(to, to_neighbors);
+    vector_int::const_iterator fi = from_neighbors.begin();
+    vector_int::const_iterator ni = to_neighbors.begin();
+    while (fi != from_neighbors.end() && ni != to_neighbors.end()) {
+      if (*fi < *ni) {
+        ++fi;
+      } else if (*ni < *fi) {
+        ++ni;
+      } else {
+        if (!std::binary_search(opposite.begin(), opposite.end(), *fi)) {
+          return false;
+        }
+        ++fi;
+        ++ni;
+      }
+    }
+
+    // Reject the collapse if it would flip or fold any of the remaining
+    // triangles, or squash one flat.
+    for (int row : pos_rows[from]) {
+      for (int ti : row_tris[row]) {
+        if (!alive[ti] || !has_row(ti, row)) {
+          continue;
+        }
+        int p[3] = { pos_id[indices[ti * 3]], pos_id[indices[ti * 3 + 1]], pos_id[indices[ti * 3 + 2]] };
+        if (p[0] == to || p[1] == to || p[2] == to) {
+          // This triangle will disappear.
+          continue;
+        }
+        LVector3 before = (points[p[1]] - points[p[0]]).cross(points[p[2]] - points[p[0]]);
+        LPoint3 moved[3];
+        for (int k = 0; k < 3; ++k) {
+          moved[k] = (p[k] == from) ? points[to] : points[p[k]];
+        }
+        LVector3 after = (moved[1] - moved[0]).cross(moved[2] - moved[0]);
+        double before_length = before.length();
+        double after_length = after.length();
+        if (before_length > 0.0 &&
+            before.dot(after) <= min_normal_dot * before_length * after_length) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  };
+
+  // Keep the cheapest collapse of every point in a priority queue.  When a
+  // point's neighborhood changes, its version is bumped and its collapse
+  // evaluated anew; entries with an old version are skipped when they come
+  // up.  Since a collapse also depends on the point it is collapsed onto,
+  // it is checked once more before it is performed if that point has been
+  // touched in the meantime, and put back in the queue if it has become
+  // invalid or more expensive.
+  typedef std::priority_queue<Candidate, pvector<Candidate>, std::greater<Candidate> > Queue;
+  Queue queue;
+  vector_int version(num_points, 0);
+  vector_int targets;
+
+  vector_int best_neighbors;
+  pvector<Candidate> best_candidates;
+  auto queue_best = [&](int from) {
+    ++version[from];
+    if (pos_rows[from].empty() || is_locked[from]) {
+      return;
+    }
+    get_neighbors(from, best_neighbors);
+    best_candidates.clear();
+    for (int to : best_neighbors) {
+      Candidate candidate;
+      if (evaluate(from, to, candidate, targets)) {
+        best_candidates.push_back(candidate);
+      }
+    }
+    std::sort(best_candidates.begin(), best_candidates.end());
+    for (Candidate &candidate : best_candidates) {
+      if (is_valid(from, candidate._to)) {
+        candidate._version = version[from];
+        candidate._to_version = version[candidate._to];
+        queue.push(candidate);
+        break;
+      }
+    }
+  };
+
+  for (int from = 0; from < num_points; ++from) {
+    queue_best(from);
+  }
+
+  int num_collapses = 0;
+  vector_int neighbors;
+  while (num_alive > target && !queue.empty()) {
+    Candidate candidate = queue.top();
+    queue.pop();
+    int from = candidate._from;
+    int to = candidate._to;
+    if (candidate._version != version[from]) {
+      continue;
+    }
+
+    // If neither point has been touched since, the collapse is still just as
+    // it was; we only need the target rows again.
+    bool unchanged = (candidate._to_version == version[to]);
+    Candidate check;
+    if (!evaluate(from, to, check, targets) ||
+        (!unchanged && (check._cost > candidate._cost || !is_valid(from, to)))) {
+      queue_best(from);
+      continue;
+    }
+
+    // These are the points whose neighborhoods are about to change.
+    get_neighbors(from, neighbors);
+
+    const vector_int &rows = pos_rows[from];
+    for (size_t i = 0; i < rows.size(); ++i) {
+      int row = rows[i];
+      int target_row = targets[i];
+      for (int ti : row_tris[row]) {
+        if (!alive[ti] || !has_row(ti, row)) {
+          continue;
+        }
+        int *tri = &indices[ti * 3];
+        for (int k = 0; k < 3; ++k) {
+          if (tri[k] == row) {
+            tri[k] = target_row;
+          }
+        }
+        int p0 = pos_id[tri[0]];
+        int p1 = pos_id[tri[1]];
+        int p2 = pos_id[tri[2]];
+        if (p0 == p1 || p1 == p2 || p2 == p0) {
+          alive[ti] = false;
+          --num_alive;
+        } else {
+          row_tris[target_row].push_back(ti);
+        }
+      }
+      row_tris[row].clear();
+
+      // Drop the triangles that have just disappeared from the surviving
+      // row's list, so that it doesn't keep on growing.
+      vector_int &tris = row_tris[target_row];
+      tris.erase(std::remove_if(tris.begin(), tris.end(),
+                                [&](int ti) { return !alive[ti]; }),
+                 tris.end());
+    }
+    pos_rows[from].clear();
+    quadrics[to] += quadrics[from];
+
+    // Reconnect the border through the surviving point.
+    for (int pi : border_neighbors[from]) {
+      vector_int &other = border_neighbors[pi];
+      other.erase(std::remove(other.begin(), other.end(), from), other.end());
+      if (pi != to) {
+        other.push_back(to);
+        border_neighbors[to].push_back(pi);
+      }
+    }
+    border_neighbors[from].clear();
+
+    error = std::max(error, (PN_stdfloat)check._error);
+    ++num_collapses;
+
+    // The surviving point has taken over all of the triangles of the removed
+    // one, so it and the removed one's neighbors must be looked at again.
+    // The other neighbors of the surviving point are only affected through
+    // its quadric, which is caught when their collapses come up.
+    ++version[from];
+    for (int pi : neighbors) {
+      queue_best(pi);
+    }
+  }
+
+  PT(GeomTriangles) triangles = new GeomTriangles(usage_hint);
+  triangles->set_shade_model(shade_model);
+  for (int ti = 0; ti < num_triangles; ++ti) {
+    if (alive[ti]) {
+      triangles->add_vertices(indices[ti * 3], indices[ti * 3 + 1], indices[ti * 3 + 2]);
+      triangles->close_primitive();
+    }
+  }
+
+  PT(Geom) result = geom->make_copy();
+  result->clear_primitives();
+  for (const GeomPrimitive *prim : other_prims) {
+    result->add_primitive(prim);
+  }
+  if (num_alive != 0) {
+    result->add_primitive(triangles);
+  }
+
+  if (grutil_cat.is_debug()) {
+    grutil_cat.debug()
+      << "Simplified " << num_triangles << " triangles to " << num_alive
+      << " (target " << target << ") in " << num_collapses
+      << " collapses, error "
+      << error << "\n";
+  }
+
+  return result;
+}
+
+/**
+ * Adds the positions of all of the vertices that lie on an open edge of the
+ * triangles of the indicated Geom.
+ */
+void MeshSimplifier::
+get_border_points(const Geom *geom, LockedPoints &points) {
+  CPT(GeomVertexData) vdata = geom->get_vertex_data();
+  GeomVertexReader vertex(vdata, InternalName::get_vertex());
+  if (!vertex.has_column()) {
+    return;
+  }
+
+  pmap<std::pair<LPoint3, LPoint3>, int> edge_count;
+  int num_primitives = geom->get_num_primitives();
+  for (int i = 0; i < num_primitives; ++i) {
+    CPT(GeomPrimitive) prim = geom->get_primitive(i);
+    if (prim->get_primitive_type() != GeomEnums::PT_polygons) {
+      continue;
+    }
+    CPT(GeomPrimitive) triangles = prim->decompose();
+    if (triangles->get_num_vertices_per_primitive() != 3) {
+      continue;
+    }
+    int num_vertices = triangles->get_num_vertices();
+    for (int vi = 0; vi + 2 < num_vertices; vi += 3) {
+      LPoint3 p[3];
+      for (int k = 0; k < 3; ++k) {
+        vertex.set_row_unsafe(triangles->get_vertex(vi + k));
+        p[k] = vertex.get_data3();
+      }
+      for (int k = 0; k < 3; ++k) {
+        const LPoint3 &a = p[k];
+        const LPoint3 &b = p[(k + 1) % 3];
+        if (a < b) {
+          ++edge_count[std::make_pair(a, b)];
+        } else {
+          ++edge_count[std::make_pair(b, a)];
+        }
+      }
+    }
+  }
+
+  for (const auto &item : edge_count) {
+    if (item.second == 1) {
+      points.insert(item.first.first);
+      points.insert(item.first.second);
+    }
+  }
+}
+
+/**
+ * Returns the total number of triangles in the Geoms of the indicated node.
+ */
+int MeshSimplifier::
+count_triangles(const GeomNode *node) {
+  int num_triangles = 0;
+  int num_geoms = node->get_num_geoms();
+  for (int i = 0; i < num_geoms; ++i) {
+    CPT(Geom) geom = node->get_geom(i);
+    int num_primitives = geom->get_num_primitives();
+    for (int j = 0; j < num_primitives; ++j) {
+      CPT(GeomPrimitive) prim = geom->get_primitive(j);
+      if (prim->get_primitive_type() == GeomEnums::PT_polygons) {
+        num_triangles += prim->get_num_faces();
+      }
+    }
+  }
+  return num_triangles;
+}
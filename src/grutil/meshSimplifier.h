@@ -0,0 +1,128 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file meshSimplifier.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+
+#include "pandabase.h"
+#include "geomNode.h"
+#include "geom.h"
+#include "lodNode.h"
+#include "luse.h"
+#include "pointerTo.h"
+#include "pset.h"
+#include "pvector.h"
+#include "vector_int.h"
+
+/**
+ * This object generates reduced-detail versions of the Geoms in a GeomNode,
+ * by successively collapsing the edges whose removal introduces the least
+ * error, as measured by the quadric error metric of Garland and Heckbert.
+ *
+ * Each collapse merges a vertex into one of its neighbors, so no new vertices
+ * are ever created: the simplified Geoms share the original GeomVertexData,
+ * and texture coordinates, normals, colors and joint weights are preserved
+ * exactly on the vertices that remain.  Vertices on a texture or normal seam
+ * are only collapsed along the seam, and vertices on the boundary between
+ * two Geoms (for instance, where two materials meet) are never moved, so
+ * that no cracks open up between them.
+ *
+ * make_lod() builds a complete LODNode or FadeLODNode out of several such
+ * levels, choosing the switch distances from the error of each level.
+ */
+class EXPCL_PANDA_GRUTIL MeshSimplifier {
+PUBLISHED:
+  MeshSimplifier();
+
+  INLINE void set_num_levels(int num_levels);
+  INLINE int get_num_levels() const;
+  MAKE_PROPERTY(num_levels, get_num_levels, set_num_levels);
+
+  INLINE void set_reduction(PN_stdfloat reduction);
+  INLINE PN_stdfloat get_reduction() const;
+  MAKE_PROPERTY(reduction, get_reduction, set_reduction);
+
+  INLINE void set_attribute_weight(PN_stdfloat attribute_weight);
+  INLINE PN_stdfloat get_attribute_weight() const;
+  MAKE_PROPERTY(attribute_weight, get_attribute_weight, set_attribute_weight);
+
+  INLINE void set_error_ratio(PN_stdfloat error_ratio);
+  INLINE PN_stdfloat get_error_ratio() const;
+  MAKE_PROPERTY(error_ratio, get_error_ratio, set_error_ratio);
+
+  INLINE void set_far_distance(PN_stdfloat far_distance);
+  INLINE PN_stdfloat get_far_distance() const;
+  MAKE_PROPERTY(far_distance, get_far_distance, set_far_distance);
+
+  INLINE void set_fade(bool fade);
+  INLINE bool get_fade() const;
+  MAKE_PROPERTY(fade, get_fade, set_fade);
+
+  PT(LODNode) make_lod(const GeomNode *node);
+  PT(GeomNode) simplify(const GeomNode *node, PN_stdfloat ratio);
+  PT(Geom) simplify_geom(const Geom *geom, PN_stdfloat ratio);
+
+  INLINE PN_stdfloat get_last_error() const;
+  MAKE_PROPERTY(last_error, get_last_error);
+
+private:
+  typedef pset<LPoint3> LockedPoints;
+
+  PT(Geom) do_simplify(const Geom *geom, PN_stdfloat ratio,
+                       const LockedPoints &locked, PN_stdfloat &error) const;
+  static void get_border_points(const Geom *geom, LockedPoints &points);
+  static int count_triangles(const GeomNode *node);
+
+  // A symmetric 4x4 matrix representing the sum of squared distances to a
+  // set of planes, along with the total weight of those planes.
+  class Quadric {
+  public:
+    INLINE Quadric();
+    INLINE void add_plane(const LVector3 &normal, PN_stdfloat d, double weight);
+    INLINE void operator += (const Quadric &other);
+    INLINE double evaluate(const LPoint3 &point) const;
+
+    double _a00, _a01, _a02, _a11, _a12, _a22;
+    double _b0, _b1, _b2;
+    double _c;
+    double _weight;
+  };
+
+  class Candidate {
+  public:
+    INLINE bool operator < (const Candidate &other) const;
+    INLINE bool operator > (const Candidate &other) const;
+
+    double _cost;
+    double _error;
+    int _from;
+    int _to;
+
+    // The versions of the neighborhoods of _from and _to for which this was
+    // computed.
+    int _version;
+    int _to_version;
+  };
+
+  int _num_levels;
+  PN_stdfloat _reduction;
+  PN_stdfloat _attribute_weight;
+  PN_stdfloat _error_ratio;
+  PN_stdfloat _far_distance;
+  bool _fade;
+  PN_stdfloat _last_error;
+};
+
+#include "meshSimplifier.I"
+
+#endif
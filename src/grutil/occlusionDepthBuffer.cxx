@@ -0,0 +1,403 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file occlusionDepthBuffer.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "occlusionDepthBuffer.h"
+
+#include <math.h>
+
+// The value stored in a pixel that no occluder covers.  It is farther than
+// any depth an object can have, so an empty pixel never hides anything.
+static const float empty_depth = 1.0e30f;
+
+/**
+ *
+ */
+OcclusionDepthBuffer::
+OcclusionDepthBuffer(int x_size, int y_size) :
+  _depth_bias(1.0e-4f)
+{
+  set_size(x_size, y_size);
+}
+
+/**
+ * Changes the resolution of the full-resolution buffer.  This also clears
+ * the buffer and discards any triangles that have been added.
+ */
+void OcclusionDepthBuffer::
+set_size(int x_size, int y_size) {
+  nassertv(x_size > 0 && y_size > 0);
+
+  _levels.clear();
+  while (true) {
+    Level level;
+    level._x_size = x_size;
+    level._y_size = y_size;
+    level._depth.resize((size_t)x_size * (size_t)y_size, empty_depth);
+    _levels.push_back(std::move(level));
+
+    if (x_size == 1 && y_size == 1) {
+      break;
+    }
+    x_size = (x_size + 1) / 2;
+    y_size = (y_size + 1) / 2;
+  }
+
+  _triangles.clear();
+}
+
+/**
+ * Empties the buffer and discards the triangles that have been added, in
+ * preparation for a new frame.
+ */
+void OcclusionDepthBuffer::
+clear() {
+  _triangles.clear();
+  Levels::iterator li;
+  for (li = _levels.begin(); li != _levels.end(); ++li) {
+    std::fill((*li)._depth.begin(), (*li)._depth.end(), empty_depth);
+  }
+}
+
+/**
+ * Adds a triangle to be rasterized by the next call to rasterize().  The
+ * vertices are given in clip space, that is, after multiplication by the
+ * projection matrix but before the division by w.  The triangle is clipped
+ * against the near plane here; there is no need to clip it against the
+ * other planes.
+ */
+void OcclusionDepthBuffer::
+add_triangle(const LVecBase4 &a, const LVecBase4 &b, const LVecBase4 &c) {
+  const LVecBase4 *in[3] = { &a, &b, &c };
+
+  int num_inside = 0;
+  PN_stdfloat dist[3];
+  for (int i = 0; i < 3; ++i) {
+    dist[i] = (*in[i])[2] + (*in[i])[3];
+    if (dist[i] >= 0) {
+      ++num_inside;
+    }
+  }
+
+  if (num_inside == 0) {
+    return;
+  }
+  if (num_inside == 3) {
+    add_clipped_triangle(a, b, c);
+    return;
+  }
+
+  // Clip the polygon against the near plane, z + w >= 0.  This yields either
+  // a triangle or a quad, which we add as a fan.
+  LVecBase4 out[4];
+  int num_out = 0;
+  for (int i = 0; i < 3; ++i) {
+    int j = (i + 1) % 3;
+    if (dist[i] >= 0) {
+      out[num_out++] = *in[i];
+    }
+    if ((dist[i] >= 0) != (dist[j] >= 0)) {
+      PN_stdfloat t = dist[i] / (dist[i] - dist[j]);
+      out[num_out++] = *in[i] + (*in[j] - *in[i]) * t;
+    }
+  }
+
+  for (int i = 1; i + 1 < num_out; ++i) {
+    add_clipped_triangle(out[0], out[i], out[i + 1]);
+  }
+}
+
+/**
+ * Rasterizes all of the triangles that have been added into the
+ * full-resolution buffer.  This is equivalent to calling rasterize_rows()
+ * over the whole buffer.
+ */
+void OcclusionDepthBuffer::
+rasterize() {
+  rasterize_rows(0, get_y_size());
+}
+
+/**
+ * Fills in the levels of the hierarchical-Z pyramid from the full-resolution
+ * buffer.  This must be called after rasterization is complete, and before
+ * any of the occlusion tests are made.
+ */
+void OcclusionDepthBuffer::
+build_pyramid() {
+  for (size_t li = 1; li < _levels.size(); ++li) {
+    const Level &src = _levels[li - 1];
+    Level &dest = _levels[li];
+
+    const float *src_depth = &src._depth[0];
+    float *dest_depth = &dest._depth[0];
+
+    for (int y = 0; y < dest._y_size; ++y) {
+      const float *row0 = src_depth + (size_t)(y * 2) * src._x_size;
+      const float *row1 = row0;
+      if (y * 2 + 1 < src._y_size) {
+        row1 = row0 + src._x_size;
+      }
+      float *dest_row = dest_depth + (size_t)y * dest._x_size;
+
+      int x_pairs = src._x_size / 2;
+      for (int x = 0; x < x_pairs; ++x) {
+        float d0 = std::max(row0[x * 2], row0[x * 2 + 1]);
+        float d1 = std::max(row1[x * 2], row1[x * 2 + 1]);
+        dest_row[x] = std::max(d0, d1);
+      }
+      if (x_pairs < dest._x_size) {
+        // An odd column at the right edge.
+        dest_row[x_pairs] = std::max(row0[x_pairs * 2], row1[x_pairs * 2]);
+      }
+    }
+  }
+}
+
+/**
+ * Returns the depth stored in the indicated texel of the indicated level of
+ * the pyramid, in normalized device depth.  Returns a very large number if
+ * no occluder covers the texel.  This is mainly useful for debugging.
+ */
+PN_stdfloat OcclusionDepthBuffer::
+get_depth(int x, int y, int level) const {
+  nassertr(level >= 0 && level < (int)_levels.size(), empty_depth);
+  const Level &lev = _levels[level];
+  nassertr(x >= 0 && x < lev._x_size && y >= 0 && y < lev._y_size, empty_depth);
+  return lev._depth[(size_t)y * lev._x_size + x];
+}
+
+/**
+ * Returns true if the rectangle, given in normalized device coordinates, is
+ * completely hidden by the occluders at every point, given that its nearest
+ * point lies at the indicated normalized device depth.  A rectangle that
+ * lies wholly off the screen is never reported as occluded; that is the job
+ * of the view-frustum test.
+ */
+bool OcclusionDepthBuffer::
+is_rect_occluded(PN_stdfloat min_x, PN_stdfloat min_y,
+                 PN_stdfloat max_x, PN_stdfloat max_y,
+                 PN_stdfloat min_depth) const {
+  if (max_x < -1 || min_x > 1 || max_y < -1 || min_y > 1) {
+    return false;
+  }
+
+  const Level &base = _levels[0];
+  int x0 = (int)floor((min_x * 0.5f + 0.5f) * base._x_size);
+  int x1 = (int)floor((max_x * 0.5f + 0.5f) * base._x_size);
+  int y0 = (int)floor((min_y * 0.5f + 0.5f) * base._y_size);
+  int y1 = (int)floor((max_y * 0.5f + 0.5f) * base._y_size);
+  x0 = std::max(x0, 0);
+  y0 = std::max(y0, 0);
+  x1 = std::min(x1, base._x_size - 1);
+  y1 = std::min(y1, base._y_size - 1);
+
+  // Choose the finest level at which the rectangle covers no more than two
+  // texels in each direction.  Each texel there covers a superset of the
+  // pixels it stands for, so the test remains conservative.
+  int li = 0;
+  while (li + 1 < (int)_levels.size() &&
+         ((x1 >> li) - (x0 >> li) > 1 || (y1 >> li) - (y0 >> li) > 1)) {
+    ++li;
+  }
+
+  const Level &level = _levels[li];
+  float depth = (float)min_depth - _depth_bias;
+  for (int y = (y0 >> li); y <= (y1 >> li); ++y) {
+    const float *row = &level._depth[(size_t)y * level._x_size];
+    for (int x = (x0 >> li); x <= (x1 >> li); ++x) {
+      if (row[x] >= depth) {
+        // Some part of the rectangle might be in front of the occluders.
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Returns true if the axis-aligned box is completely hidden by the
+ * occluders.  clip_mat transforms the coordinate space of the box into clip
+ * space.  A box that crosses the near plane is never reported as occluded.
+ */
+bool OcclusionDepthBuffer::
+is_box_occluded(const LPoint3 &min_point, const LPoint3 &max_point,
+                const LMatrix4 &clip_mat) const {
+  LPoint3 min_ndc, max_ndc;
+  if (!project_box(min_point, max_point, clip_mat, min_ndc, max_ndc)) {
+    return false;
+  }
+  return is_rect_occluded(min_ndc[0], min_ndc[1], max_ndc[0], max_ndc[1],
+                          min_ndc[2]);
+}
+
+/**
+ * Rasterizes all of the triangles that have been added into the rows of the
+ * full-resolution buffer in the range [first_row, end_row).  Different
+ * ranges may be rasterized by different threads at the same time, but
+ * triangles may not be added while this is going on.
+ */
+void OcclusionDepthBuffer::
+rasterize_rows(int first_row, int end_row) {
+  Level &base = _levels[0];
+  first_row = std::max(first_row, 0);
+  end_row = std::min(end_row, base._y_size);
+
+  Triangles::const_iterator ti;
+  for (ti = _triangles.begin(); ti != _triangles.end(); ++ti) {
+    const ScreenTriangle &tri = (*ti);
+    int y_begin = std::max(tri._min_row, first_row);
+    int y_end = std::min(tri._end_row, end_row);
+    if (y_begin >= y_end) {
+      continue;
+    }
+
+    float x0 = tri._x[0], y0 = tri._y[0];
+    float x1 = tri._x[1], y1 = tri._y[1];
+    float x2 = tri._x[2], y2 = tri._y[2];
+
+    // The triangles were wound counter-clockwise when they were added, so
+    // each edge function is non-negative inside the triangle.
+    float area = (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0);
+    float inv_area = 1.0f / area;
+
+    // The depth is an affine function of the screen position, since it has
+    // already been divided by w.
+    float dzdx = ((tri._z[1] - tri._z[0]) * (y2 - y0) -
+                  (tri._z[2] - tri._z[0]) * (y1 - y0)) * inv_area;
+    float dzdy = ((x1 - x0) * (tri._z[2] - tri._z[0]) -
+                  (x2 - x0) * (tri._z[1] - tri._z[0])) * inv_area;
+
+    int x_begin = std::max((int)floor(std::min(x0, std::min(x1, x2))), 0);
+    int x_end = std::min((int)ceil(std::max(x0, std::max(x1, x2))), base._x_size);
+    if (x_begin >= x_end) {
+      continue;
+    }
+
+    // Edge functions e(x, y) = a * x + b * y + c, evaluated at pixel centers.
+    float a0 = y1 - y2, b0 = x2 - x1, c0 = x1 * y2 - x2 * y1;
+    float a1 = y2 - y0, b1 = x0 - x2, c1 = x2 * y0 - x0 * y2;
+    float a2 = y0 - y1, b2 = x1 - x0, c2 = x0 * y1 - x1 * y0;
+
+    for (int y = y_begin; y < y_end; ++y) {
+      float py = (float)y + 0.5f;
+      float px = (float)x_begin + 0.5f;
+      float e0 = a0 * px + b0 * py + c0;
+      float e1 = a1 * px + b1 * py + c1;
+      float e2 = a2 * px + b2 * py + c2;
+      float z = tri._z[0] + dzdx * (px - x0) + dzdy * (py - y0);
+
+      // This loop is kept free of branches so that the compiler may
+      // vectorize it.
+      float *row = &base._depth[(size_t)y * base._x_size];
+      int count = x_end - x_begin;
+      for (int i = 0; i < count; ++i) {
+        float fi = (float)i;
+        bool inside = (e0 + a0 * fi >= 0.0f) & (e1 + a1 * fi >= 0.0f) &
+                      (e2 + a2 * fi >= 0.0f);
+        float pz = z + dzdx * fi;
+        float old_z = row[x_begin + i];
+        row[x_begin + i] = (inside && pz < old_z) ? pz : old_z;
+      }
+    }
+  }
+}
+
+/**
+ * Projects the eight corners of the axis-aligned box by clip_mat, and fills
+ * in the bounding box of the result in normalized device coordinates.
+ * Returns false if any corner lies behind the near plane, in which case the
+ * box covers an unbounded part of the screen and the result is not filled
+ * in.
+ */
+bool OcclusionDepthBuffer::
+project_box(const LPoint3 &min_point, const LPoint3 &max_point,
+            const LMatrix4 &clip_mat, LPoint3 &min_ndc, LPoint3 &max_ndc) {
+  min_ndc.set(1.0e30f, 1.0e30f, 1.0e30f);
+  max_ndc.set(-1.0e30f, -1.0e30f, -1.0e30f);
+
+  for (int i = 0; i < 8; ++i) {
+    LVecBase4 corner((i & 1) ? max_point[0] : min_point[0],
+                     (i & 2) ? max_point[1] : min_point[1],
+                     (i & 4) ? max_point[2] : min_point[2],
+                     1.0f);
+    LVecBase4 clip = clip_mat.xform(corner);
+    if (clip[3] <= 1.0e-6f || clip[2] < -clip[3]) {
+      return false;
+    }
+    LPoint3 ndc(clip[0], clip[1], clip[2]);
+    ndc /= clip[3];
+    min_ndc = min_ndc.fmin(ndc);
+    max_ndc = max_ndc.fmax(ndc);
+  }
+  return true;
+}
+
+/**
+ * Adds a triangle that is known to lie entirely in front of the near plane.
+ * Projects it to buffer space and records it for rasterization.
+ */
+void OcclusionDepthBuffer::
+add_clipped_triangle(const LVecBase4 &a, const LVecBase4 &b,
+                     const LVecBase4 &c) {
+  const LVecBase4 *in[3] = { &a, &b, &c };
+  const Level &base = _levels[0];
+
+  ScreenTriangle tri;
+  int num_beyond_far = 0;
+  for (int i = 0; i < 3; ++i) {
+    const LVecBase4 &v = *in[i];
+    if (v[3] <= 1.0e-6f) {
+      // This can only happen with an unusual projection matrix.
+      return;
+    }
+    float inv_w = 1.0f / (float)v[3];
+    tri._x[i] = ((float)v[0] * inv_w * 0.5f + 0.5f) * base._x_size;
+    tri._y[i] = ((float)v[1] * inv_w * 0.5f + 0.5f) * base._y_size;
+    tri._z[i] = (float)v[2] * inv_w;
+    if (tri._z[i] > 1.0f) {
+      ++num_beyond_far;
+    }
+  }
+
+  if (num_beyond_far == 3) {
+    return;
+  }
+
+  float area = (tri._x[1] - tri._x[0]) * (tri._y[2] - tri._y[0]) -
+               (tri._x[2] - tri._x[0]) * (tri._y[1] - tri._y[0]);
+  if (fabs(area) < 1.0e-6f) {
+    return;
+  }
+  if (area < 0.0f) {
+    // Occluders are rendered without regard to facing, so just fix the
+    // winding order.
+    std::swap(tri._x[1], tri._x[2]);
+    std::swap(tri._y[1], tri._y[2]);
+    std::swap(tri._z[1], tri._z[2]);
+  }
+
+  float min_y = std::min(tri._y[0], std::min(tri._y[1], tri._y[2]));
+  float max_y = std::max(tri._y[0], std::max(tri._y[1], tri._y[2]));
+  float min_x = std::min(tri._x[0], std::min(tri._x[1], tri._x[2]));
+  float max_x = std::max(tri._x[0], std::max(tri._x[1], tri._x[2]));
+  if (max_x < 0.0f || min_x > (float)base._x_size ||
+      max_y < 0.0f || min_y > (float)base._y_size) {
+    return;
+  }
+
+  tri._min_row = std::max((int)floor(min_y), 0);
+  tri._end_row = std::min((int)ceil(max_y), base._y_size);
+  if (tri._min_row < tri._end_row) {
+    _triangles.push_back(tri);
+  }
+}
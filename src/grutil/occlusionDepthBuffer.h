@@ -0,0 +1,110 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file occlusionDepthBuffer.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef OCCLUSIONDEPTHBUFFER_H
+#define OCCLUSIONDEPTHBUFFER_H
+
+#include "pandabase.h"
+#include "referenceCount.h"
+#include "luse.h"
+#include "pvector.h"
+
+/**
+ * A small depth buffer that is rendered on the CPU, for the purpose of
+ * software occlusion culling.  Occluder triangles are given in clip space;
+ * they are clipped to the near plane and rasterized at low resolution into a
+ * buffer of normalized device depths, from which a hierarchical-Z pyramid is
+ * then built.  Each texel of each level of the pyramid stores the farthest
+ * depth of the four texels below it, so that a screen rectangle can be
+ * tested conservatively by looking at no more than four texels.
+ *
+ * Rasterization may be split into horizontal bands of rows, each of which
+ * may be filled by a different thread, since no two bands touch the same
+ * memory.
+ *
+ * This class has no dependencies on the graphics pipe, so it can also be used
+ * (and tested) without opening a window.
+ */
+class EXPCL_PANDA_GRUTIL OcclusionDepthBuffer : public ReferenceCount {
+PUBLISHED:
+  explicit OcclusionDepthBuffer(int x_size = 256, int y_size = 128);
+
+  void set_size(int x_size, int y_size);
+  INLINE int get_x_size() const;
+  INLINE int get_y_size() const;
+  MAKE_PROPERTY(x_size, get_x_size);
+  MAKE_PROPERTY(y_size, get_y_size);
+
+  INLINE void set_depth_bias(PN_stdfloat depth_bias);
+  INLINE PN_stdfloat get_depth_bias() const;
+  MAKE_PROPERTY(depth_bias, get_depth_bias, set_depth_bias);
+
+  void clear();
+  void add_triangle(const LVecBase4 &a, const LVecBase4 &b,
+                    const LVecBase4 &c);
+  INLINE int get_num_triangles() const;
+
+  void rasterize();
+  void build_pyramid();
+
+  INLINE int get_num_levels() const;
+  PN_stdfloat get_depth(int x, int y, int level = 0) const;
+
+  bool is_rect_occluded(PN_stdfloat min_x, PN_stdfloat min_y,
+                        PN_stdfloat max_x, PN_stdfloat max_y,
+                        PN_stdfloat min_depth) const;
+  bool is_box_occluded(const LPoint3 &min_point, const LPoint3 &max_point,
+                       const LMatrix4 &clip_mat) const;
+
+public:
+  void rasterize_rows(int first_row, int end_row);
+
+  static bool project_box(const LPoint3 &min_point, const LPoint3 &max_point,
+                          const LMatrix4 &clip_mat,
+                          LPoint3 &min_ndc, LPoint3 &max_ndc);
+
+private:
+  void add_clipped_triangle(const LVecBase4 &a, const LVecBase4 &b,
+                            const LVecBase4 &c);
+
+  // A triangle that has been projected into buffer space, with x and y in
+  // pixels and z in normalized device depth.
+  class ScreenTriangle {
+  public:
+    float _x[3];
+    float _y[3];
+    float _z[3];
+    int _min_row;
+    int _end_row;
+  };
+  typedef pvector<ScreenTriangle> Triangles;
+  Triangles _triangles;
+
+  class Level {
+  public:
+    int _x_size;
+    int _y_size;
+    pvector<float> _depth;
+  };
+  typedef pvector<Level> Levels;
+
+  // _levels[0] is the buffer that is rasterized into; the remaining levels
+  // are filled in by build_pyramid().
+  Levels _levels;
+
+  float _depth_bias;
+};
+
+#include "occlusionDepthBuffer.I"
+
+#endif
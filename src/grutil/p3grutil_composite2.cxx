@@ -1,8 +1,11 @@
 #include "meshDrawer.cxx"
 #include "meshDrawer2D.cxx"
+#include "meshSimplifier.cxx"
 #include "movieTexture.cxx"
 #include "nodeVertexTransform.cxx"
+#include "occlusionDepthBuffer.cxx"
 #include "pipeOcclusionCullTraverser.cxx"
 #include "pfmVizzer.cxx"
 #include "rigidBodyCombiner.cxx"
+#include "softwareOcclusionCullTraverser.cxx"
 
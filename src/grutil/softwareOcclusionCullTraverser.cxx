@@ -0,0 +1,690 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file softwareOcclusionCullTraverser.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "softwareOcclusionCullTraverser.h"
+#include "cullTraverserData.h"
+#include "sceneSetup.h"
+#include "lens.h"
+#include "geomNode.h"
+#include "geom.h"
+#include "geomPrimitive.h"
+#include "geomVertexReader.h"
+#include "finiteBoundingVolume.h"
+#include "renderEffects.h"
+#include "transparencyAttrib.h"
+#include "alphaTestAttrib.h"
+#include "depthWriteAttrib.h"
+#include "colorWriteAttrib.h"
+#include "renderModeAttrib.h"
+#include "nodePathCollection.h"
+#include "clockObject.h"
+#include "mutexHolder.h"
+#include "pStatTimer.h"
+#include "configVariableInt.h"
+#include "configVariableDouble.h"
+#include "config_grutil.h"
+
+PStatCollector SoftwareOcclusionCullTraverser::_setup_occlusion_pcollector("Cull:Occlusion:Setup");
+PStatCollector SoftwareOcclusionCullTraverser::_draw_occlusion_pcollector("Cull:Occlusion:Occluders");
+PStatCollector SoftwareOcclusionCullTraverser::_test_occlusion_pcollector("Cull:Occlusion:Test");
+
+PStatCollector SoftwareOcclusionCullTraverser::_occlusion_passed_pcollector("Occlusion results:Visible");
+PStatCollector SoftwareOcclusionCullTraverser::_occlusion_failed_pcollector("Occlusion results:Occluded");
+PStatCollector SoftwareOcclusionCullTraverser::_occlusion_tests_pcollector("Occlusion tests");
+
+TypeHandle SoftwareOcclusionCullTraverser::_type_handle;
+
+static ConfigVariableInt software_occlusion_size
+("software-occlusion-size", "256 128",
+ PRC_DESC("Specify the x y size of the depth buffer into which the occluders "
+          "are rasterized by the SoftwareOcclusionCullTraverser."));
+
+static ConfigVariableInt software_occlusion_threads
+("software-occlusion-threads", 2,
+ PRC_DESC("The number of additional threads that help the cull thread to "
+          "rasterize the occluders for the SoftwareOcclusionCullTraverser.  "
+          "Each thread, including the cull thread, fills in an equal band "
+          "of rows.  Set this to 0 to rasterize on the cull thread alone.  "
+          "This is ignored if true threads are not available."));
+
+static ConfigVariableDouble software_occlusion_depth_bias
+("software-occlusion-depth-bias", 0.0001,
+ PRC_DESC("The amount, in normalized device depth, by which a node must lie "
+          "behind the occluders before the SoftwareOcclusionCullTraverser "
+          "considers it hidden."));
+
+static ConfigVariableInt max_occluder_triangles
+("max-occluder-triangles", 20000,
+ PRC_DESC("The maximum total number of occluder triangles that the "
+          "SoftwareOcclusionCullTraverser will rasterize in one frame.  "
+          "Occluders beyond this limit are skipped for that frame."));
+
+static ConfigVariableDouble auto_occluder_screen_fraction
+("auto-occluder-screen-fraction", 0.1,
+ PRC_DESC("When automatic occluders are enabled on a "
+          "SoftwareOcclusionCullTraverser, a GeomNode whose bounding box "
+          "covers at least this fraction of the screen is used as an "
+          "occluder in the following frames."));
+
+static ConfigVariableInt auto_occluder_max_triangles
+("auto-occluder-max-triangles", 1000,
+ PRC_DESC("A GeomNode with more triangles than this is never chosen "
+          "automatically as an occluder, since it would cost too much to "
+          "rasterize."));
+
+static ConfigVariableInt max_auto_occluders
+("max-auto-occluders", 16,
+ PRC_DESC("The maximum number of occluders that the "
+          "SoftwareOcclusionCullTraverser will choose automatically."));
+
+static ConfigVariableInt auto_occluder_frames
+("auto-occluder-frames", 30,
+ PRC_DESC("An automatically chosen occluder is dropped again once it has "
+          "failed to cover auto-occluder-screen-fraction of the screen for "
+          "this many frames."));
+
+/**
+ *
+ */
+SoftwareOcclusionCullTraverser::
+SoftwareOcclusionCullTraverser() :
+  _auto_occluders(false),
+  _live(false),
+  _world_to_clip(LMatrix4::ident_mat()),
+  _threads_tried(false),
+  _cvar(_lock),
+  _job_seq(0),
+  _bands_pending(0),
+  _shutdown(false)
+{
+  if (software_occlusion_size.get_num_words() < 2) {
+    _buffer = new OcclusionDepthBuffer(software_occlusion_size,
+                                       software_occlusion_size);
+  } else {
+    _buffer = new OcclusionDepthBuffer(software_occlusion_size[0],
+                                       software_occlusion_size[1]);
+  }
+  _buffer->set_depth_bias(software_occlusion_depth_bias);
+}
+
+/**
+ *
+ */
+SoftwareOcclusionCullTraverser::
+~SoftwareOcclusionCullTraverser() {
+  stop_threads();
+}
+
+/**
+ * Sets the SceneSetup object that indicates the initial camera position,
+ * etc.  This must be called before traversal begins.  The occluders are
+ * rasterized at this point.
+ */
+void SoftwareOcclusionCullTraverser::
+set_scene(SceneSetup *scene_setup, GraphicsStateGuardianBase *gsg,
+          bool dr_incomplete_render) {
+  CullTraverser::set_scene(scene_setup, gsg, dr_incomplete_render);
+
+  PStatTimer timer(_setup_occlusion_pcollector);
+
+  _buffer->clear();
+  _live = false;
+
+  const Lens *lens = scene_setup->get_lens();
+  if (lens == nullptr || _occluders.empty()) {
+    return;
+  }
+
+  _world_to_clip = scene_setup->get_world_transform()->get_mat() *
+    lens->get_projection_mat();
+
+  int frame = ClockObject::get_global_clock()->get_frame_count();
+  expire_auto_occluders(frame - auto_occluder_frames);
+
+  const NodePath &scene_root = scene_setup->get_scene_root();
+  int triangle_budget = max_occluder_triangles;
+
+  Occluders::const_iterator oi;
+  for (oi = _occluders.begin(); oi != _occluders.end(); ++oi) {
+    const Occluder &occluder = (*oi);
+    int num_triangles = (int)occluder._vertices.size() / 3;
+    if (num_triangles > triangle_budget) {
+      continue;
+    }
+    if (occluder._node_path.is_empty() ||
+        !scene_root.is_ancestor_of(occluder._node_path) ||
+        occluder._node_path.is_hidden(get_camera_mask())) {
+      continue;
+    }
+    triangle_budget -= num_triangles;
+
+    CPT(TransformState) transform =
+      occluder._node_path.get_transform(scene_root);
+    LMatrix4 clip_mat = transform->get_mat() * _world_to_clip;
+
+    const LPoint3 *vertices = &occluder._vertices[0];
+    size_t num_vertices = occluder._vertices.size();
+    for (size_t vi = 0; vi + 2 < num_vertices; vi += 3) {
+      _buffer->add_triangle(clip_mat.xform(LVecBase4(vertices[vi], 1.0f)),
+                            clip_mat.xform(LVecBase4(vertices[vi + 1], 1.0f)),
+                            clip_mat.xform(LVecBase4(vertices[vi + 2], 1.0f)));
+    }
+  }
+
+  if (_buffer->get_num_triangles() == 0) {
+    return;
+  }
+
+  render_occluders();
+  _live = true;
+}
+
+/**
+ * Should be called when the traverser has finished traversing its scene,
+ * this gives it a chance to do any necessary finalization.
+ */
+void SoftwareOcclusionCullTraverser::
+end_traverse() {
+  CullTraverser::end_traverse();
+
+  _occlusion_passed_pcollector.flush_level();
+  _occlusion_failed_pcollector.flush_level();
+  _occlusion_tests_pcollector.flush_level();
+}
+
+/**
+ * Adds the indicated node, and all of the geometry below it, as an occluder.
+ * If the node is already an occluder, its triangles are extracted anew.
+ */
+void SoftwareOcclusionCullTraverser::
+add_occluder(const NodePath &occluder) {
+  nassertv(!occluder.is_empty());
+
+  Occluders::iterator oi;
+  for (oi = _occluders.begin(); oi != _occluders.end(); ++oi) {
+    if ((*oi)._node_path == occluder) {
+      make_occluder(*oi, occluder);
+      (*oi)._automatic = false;
+      index_occluders();
+      return;
+    }
+  }
+
+  Occluder new_occluder;
+  make_occluder(new_occluder, occluder);
+  new_occluder._automatic = false;
+  new_occluder._last_frame = 0;
+  _occluders.push_back(std::move(new_occluder));
+  index_occluders();
+}
+
+/**
+ * Removes the indicated occluder.  Returns true if it was an occluder, false
+ * if it was not.
+ */
+bool SoftwareOcclusionCullTraverser::
+remove_occluder(const NodePath &occluder) {
+  Occluders::iterator oi;
+  for (oi = _occluders.begin(); oi != _occluders.end(); ++oi) {
+    if ((*oi)._node_path == occluder) {
+      _occluders.erase(oi);
+      index_occluders();
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Removes all occluders, including those that were chosen automatically.
+ */
+void SoftwareOcclusionCullTraverser::
+clear_occluders() {
+  _occluders.clear();
+  _occluder_nodes.clear();
+}
+
+/**
+ * Traverses all the children of the indicated node, with the given data,
+ * which has been converted into the node's space.  If the node is hidden
+ * behind the occluders, its children are not traversed.
+ */
+void SoftwareOcclusionCullTraverser::
+traverse_below(CullTraverserData &data) {
+  if (!_live && !_auto_occluders) {
+    CullTraverser::traverse_below(data);
+    return;
+  }
+
+  PandaNode *node = data.node();
+  OccluderNodes::const_iterator ni = _occluder_nodes.find(node);
+  bool is_occluder = (ni != _occluder_nodes.end());
+  if (is_occluder && !_occluders[(*ni).second]._automatic) {
+    // Don't let an occluder hide itself.
+    CullTraverser::traverse_below(data);
+    return;
+  }
+
+  PandaNodePipelineReader *node_reader = data.node_reader();
+  CPT(BoundingVolume) bounds = node_reader->get_bounds();
+  const FiniteBoundingVolume *fbv = bounds->as_finite_bounding_volume();
+  if (fbv == nullptr || bounds->is_empty()) {
+    CullTraverser::traverse_below(data);
+    return;
+  }
+
+  LPoint3 min_ndc, max_ndc;
+  bool projected;
+  {
+    PStatTimer timer(_test_occlusion_pcollector);
+
+    // The bounding volume is in the space of the node's parent, but
+    // _net_transform already includes the node's own transform.
+    LMatrix4 clip_mat = data._net_transform->get_mat() * _world_to_clip;
+    const TransformState *transform = node_reader->get_transform();
+    if (!transform->is_identity()) {
+      clip_mat = transform->get_inverse()->get_mat() * clip_mat;
+    }
+
+    // If the node crosses the near plane, it can't be hidden.
+    projected = OcclusionDepthBuffer::project_box(fbv->get_min(),
+                                                  fbv->get_max(), clip_mat,
+                                                  min_ndc, max_ndc);
+
+    if (projected && _live && !is_occluder) {
+      _occlusion_tests_pcollector.add_level(1);
+      if (_buffer->is_rect_occluded(min_ndc[0], min_ndc[1],
+                                    max_ndc[0], max_ndc[1], min_ndc[2])) {
+        _occlusion_failed_pcollector.add_level(1);
+        return;
+      }
+      _occlusion_passed_pcollector.add_level(1);
+    }
+  }
+
+  if (projected && _auto_occluders && node->is_geom_node()) {
+    consider_auto_occluder(data, min_ndc, max_ndc);
+  }
+
+  CullTraverser::traverse_below(data);
+}
+
+/**
+ * Extracts the triangles of all of the GeomNodes at or below the indicated
+ * node into the occluder, in the coordinate space of that node.
+ */
+void SoftwareOcclusionCullTraverser::
+make_occluder(Occluder &occluder, const NodePath &node_path) const {
+  Thread *current_thread = Thread::get_current_thread();
+
+  occluder._node_path = node_path;
+  occluder._vertices.clear();
+  occluder._geom_nodes.clear();
+
+  NodePathCollection geom_nodes = node_path.find_all_matches("**/+GeomNode");
+  if (node_path.node()->is_geom_node()) {
+    geom_nodes.add_path(node_path);
+  }
+
+  for (int i = 0; i < geom_nodes.get_num_paths(); ++i) {
+    NodePath np = geom_nodes.get_path(i);
+    GeomNode *gnode = DCAST(GeomNode, np.node());
+    occluder._geom_nodes.push_back(gnode);
+
+    LMatrix4 mat = np.get_transform(node_path, current_thread)->get_mat();
+
+    GeomNode::Geoms geoms = gnode->get_geoms(current_thread);
+    for (int gi = 0; gi < geoms.get_num_geoms(); ++gi) {
+      CPT(Geom) geom = geoms.get_geom(gi);
+      if (geom->get_primitive_type() != Geom::PT_polygons) {
+        continue;
+      }
+
+      GeomVertexReader vertex(geom->get_vertex_data(current_thread),
+                              InternalName::get_vertex(), current_thread);
+      if (!vertex.has_column()) {
+        continue;
+      }
+
+      for (size_t pi = 0; pi < geom->get_num_primitives(); ++pi) {
+        CPT(GeomPrimitive) prim = geom->get_primitive(pi)->decompose();
+        int num_vertices = prim->get_num_vertices();
+        for (int vi = 0; vi + 2 < num_vertices; vi += 3) {
+          for (int k = 0; k < 3; ++k) {
+            vertex.set_row_unsafe(prim->get_vertex(vi + k));
+            occluder._vertices.push_back(mat.xform_point(vertex.get_data3()));
+          }
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Called for each GeomNode that passes the occlusion test while automatic
+ * occluders are enabled.  If the node covers enough of the screen, makes it
+ * an occluder for the following frames.
+ */
+void SoftwareOcclusionCullTraverser::
+consider_auto_occluder(CullTraverserData &data,
+                       const LPoint3 &min_ndc, const LPoint3 &max_ndc) {
+  PN_stdfloat width = std::min(max_ndc[0], (PN_stdfloat)1) -
+                      std::max(min_ndc[0], (PN_stdfloat)-1);
+  PN_stdfloat height = std::min(max_ndc[1], (PN_stdfloat)1) -
+                       std::max(min_ndc[1], (PN_stdfloat)-1);
+  if (width <= 0 || height <= 0 ||
+      width * height < auto_occluder_screen_fraction * 4) {
+    return;
+  }
+
+  int frame = ClockObject::get_global_clock()->get_frame_count();
+
+  OccluderNodes::const_iterator ni = _occluder_nodes.find(data.node());
+  if (ni != _occluder_nodes.end()) {
+    int index = (*ni).second;
+    if (is_solid_occluder(data)) {
+      // It is already an automatic occluder; keep it around a while longer.
+      _occluders[index]._last_frame = frame;
+    } else {
+      // It has become transparent, or otherwise unsuitable, since it was
+      // chosen; don't wait for it to expire.
+      _occluders.erase(_occluders.begin() + index);
+      index_occluders();
+    }
+    return;
+  }
+
+  if (data.node_reader()->get_nested_vertices() >
+      auto_occluder_max_triangles * 3) {
+    return;
+  }
+
+  if (!is_solid_occluder(data)) {
+    return;
+  }
+
+  int num_automatic = 0;
+  Occluders::const_iterator oi;
+  for (oi = _occluders.begin(); oi != _occluders.end(); ++oi) {
+    if ((*oi)._automatic) {
+      ++num_automatic;
+    }
+  }
+  if (num_automatic >= max_auto_occluders) {
+    return;
+  }
+
+  Occluder occluder;
+  make_occluder(occluder, data.get_node_path());
+  occluder._automatic = true;
+  occluder._last_frame = frame;
+  if (occluder._vertices.empty()) {
+    return;
+  }
+
+  if (grutil_cat.is_debug()) {
+    grutil_cat.debug()
+      << "Using " << occluder._node_path << " as an automatic occluder\n";
+  }
+  _occluders.push_back(std::move(occluder));
+  index_occluders();
+}
+
+/**
+ * Returns true if the indicated GeomNode may be chosen as an automatic
+ * occluder.  Everything it draws, in the net state it is rendered with, must
+ * be filled, opaque, not alpha-tested, and must write both color and depth,
+ * or else the things behind it would be culled while they are still visible.
+ * Its vertices must not be animated, as on a Character, since the occluder
+ * keeps the triangles it extracted when it was chosen; and neither it nor
+ * any of its ancestors may have an effect that adjusts the transform at cull
+ * time, such as a billboard or compass, since the occluder is placed with
+ * the node's ordinary net transform.
+ */
+bool SoftwareOcclusionCullTraverser::
+is_solid_occluder(CullTraverserData &data) const {
+  Thread *current_thread = get_current_thread();
+
+  NodePath node_path = data.get_node_path();
+  while (!node_path.is_empty()) {
+    if (node_path.node()->get_effects(current_thread)->has_adjust_transform()) {
+      return false;
+    }
+    node_path = node_path.get_parent(current_thread);
+  }
+
+  GeomNode *gnode = DCAST(GeomNode, data.node());
+  GeomNode::Geoms geoms = gnode->get_geoms(current_thread);
+  for (int gi = 0; gi < geoms.get_num_geoms(); ++gi) {
+    CPT(Geom) geom = geoms.get_geom(gi);
+    CPT(GeomVertexData) vdata = geom->get_vertex_data(current_thread);
+    if (vdata->get_format()->get_animation().get_animation_type() != GeomEnums::AT_none) {
+      return false;
+    }
+
+    CPT(RenderState) state = data._state->compose(geoms.get_geom_state(gi));
+
+    const TransparencyAttrib *transparency;
+    if (state->get_attrib(transparency) &&
+        transparency->get_mode() != TransparencyAttrib::M_none) {
+      return false;
+    }
+
+    const AlphaTestAttrib *alpha_test;
+    if (state->get_attrib(alpha_test) &&
+        alpha_test->get_mode() != RenderAttrib::M_none &&
+        alpha_test->get_mode() != RenderAttrib::M_always) {
+      return false;
+    }
+
+    const DepthWriteAttrib *depth_write;
+    if (state->get_attrib(depth_write) &&
+        depth_write->get_mode() == DepthWriteAttrib::M_off) {
+      return false;
+    }
+
+    const ColorWriteAttrib *color_write;
+    if (state->get_attrib(color_write) &&
+        (color_write->get_channels() & ColorWriteAttrib::C_rgb) != ColorWriteAttrib::C_rgb) {
+      return false;
+    }
+
+    const RenderModeAttrib *render_mode;
+    if (state->get_attrib(render_mode) &&
+        (render_mode->get_mode() == RenderModeAttrib::M_wireframe ||
+         render_mode->get_mode() == RenderModeAttrib::M_point)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Removes all of the automatic occluders that have not qualified as such
+ * since before the indicated frame.
+ */
+void SoftwareOcclusionCullTraverser::
+expire_auto_occluders(int min_frame) {
+  Occluders::iterator oi = _occluders.begin();
+  Occluders::iterator out = oi;
+  for (; oi != _occluders.end(); ++oi) {
+    if (!(*oi)._automatic || (*oi)._last_frame >= min_frame) {
+      if (out != oi) {
+        (*out) = std::move(*oi);
+      }
+      ++out;
+    }
+  }
+  if (out != _occluders.end()) {
+    _occluders.erase(out, _occluders.end());
+    index_occluders();
+  }
+}
+
+/**
+ * Rebuilds _occluder_nodes after the list of occluders has changed.
+ */
+void SoftwareOcclusionCullTraverser::
+index_occluders() {
+  _occluder_nodes.clear();
+  for (size_t i = 0; i < _occluders.size(); ++i) {
+    const Occluder &occluder = _occluders[i];
+    pvector<const PandaNode *>::const_iterator gi;
+    for (gi = occluder._geom_nodes.begin();
+         gi != occluder._geom_nodes.end();
+         ++gi) {
+      _occluder_nodes[*gi] = (int)i;
+    }
+  }
+}
+
+/**
+ * Rasterizes the triangles that have been added to the depth buffer, sharing
+ * the work among the raster threads, and builds the hierarchical-Z pyramid.
+ */
+void SoftwareOcclusionCullTraverser::
+render_occluders() {
+  PStatTimer timer(_draw_occlusion_pcollector);
+
+  if (!_threads_tried && software_occlusion_threads > 0 &&
+      Thread::is_true_threads()) {
+    start_threads();
+  }
+
+  if (_threads.empty()) {
+    _buffer->rasterize();
+
+  } else {
+    {
+      MutexHolder holder(_lock);
+      _bands_pending = (int)_threads.size();
+      ++_job_seq;
+      _cvar.notify_all();
+    }
+
+    // The cull thread takes the last band itself.
+    rasterize_band((int)_threads.size());
+
+    MutexHolder holder(_lock);
+    while (_bands_pending > 0) {
+      _cvar.wait();
+    }
+  }
+
+  _buffer->build_pyramid();
+}
+
+/**
+ * Starts the raster threads.  The bands are numbered over the threads that
+ * actually started, so if some of them could not be, the remaining ones
+ * still cover every row between them; if none could, the cull thread
+ * rasterizes the whole buffer by itself.
+ */
+void SoftwareOcclusionCullTraverser::
+start_threads() {
+  MutexHolder holder(_lock);
+  _shutdown = false;
+  _threads_tried = true;
+
+  int num_threads = software_occlusion_threads;
+  _threads.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    int band = (int)_threads.size();
+    std::ostringstream name_strm;
+    name_strm << "OcclusionRaster" << band;
+    PT(RasterThread) thread = new RasterThread(this, band, name_strm.str());
+    if (thread->start(TP_normal, true)) {
+      _threads.push_back(thread);
+    }
+  }
+
+  if ((int)_threads.size() < num_threads) {
+    grutil_cat.warning()
+      << "Could only start " << _threads.size() << " of " << num_threads
+      << " occlusion raster threads.\n";
+  }
+}
+
+/**
+ * Signals all the raster threads to stop and waits for them.
+ */
+void SoftwareOcclusionCullTraverser::
+stop_threads() {
+  RasterThreads threads;
+  {
+    MutexHolder holder(_lock);
+    _shutdown = true;
+    _cvar.notify_all();
+    threads.swap(_threads);
+  }
+
+  RasterThreads::iterator ti;
+  for (ti = threads.begin(); ti != threads.end(); ++ti) {
+    (*ti)->join();
+  }
+}
+
+/**
+ * Rasterizes the nth of the equal bands of rows into which the depth buffer
+ * is divided, one for each raster thread plus one for the cull thread.
+ */
+void SoftwareOcclusionCullTraverser::
+rasterize_band(int band) {
+  int num_bands = (int)_threads.size() + 1;
+  int y_size = _buffer->get_y_size();
+  _buffer->rasterize_rows(y_size * band / num_bands,
+                          y_size * (band + 1) / num_bands);
+}
+
+/**
+ *
+ */
+SoftwareOcclusionCullTraverser::RasterThread::
+RasterThread(SoftwareOcclusionCullTraverser *trav, int band,
+             const std::string &name) :
+  Thread(name, name),
+  _trav(trav),
+  _band(band),
+  _last_seq(trav->_job_seq)
+{
+}
+
+/**
+ * The main processing loop for each raster thread.
+ */
+void SoftwareOcclusionCullTraverser::RasterThread::
+thread_main() {
+  MutexHolder holder(_trav->_lock);
+
+  while (true) {
+    while (_trav->_job_seq == _last_seq) {
+      if (_trav->_shutdown) {
+        return;
+      }
+      _trav->_cvar.wait();
+    }
+    if (_trav->_shutdown) {
+      return;
+    }
+    _last_seq = _trav->_job_seq;
+
+    _trav->_lock.release();
+    _trav->rasterize_band(_band);
+    _trav->_lock.acquire();
+
+    if (--_trav->_bands_pending == 0) {
+      _trav->_cvar.notify_all();
+    }
+  }
+}
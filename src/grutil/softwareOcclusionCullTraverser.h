@@ -0,0 +1,172 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file softwareOcclusionCullTraverser.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef SOFTWAREOCCLUSIONCULLTRAVERSER_H
+#define SOFTWAREOCCLUSIONCULLTRAVERSER_H
+
+#include "pandabase.h"
+#include "cullTraverser.h"
+#include "occlusionDepthBuffer.h"
+#include "nodePath.h"
+#include "thread.h"
+#include "pmutex.h"
+#include "conditionVarFull.h"
+#include "pmap.h"
+#include "pvector.h"
+
+/**
+ * This specialization of CullTraverser performs occlusion culling entirely on
+ * the CPU.  At the start of each frame, a set of occluders is rasterized into
+ * a small OcclusionDepthBuffer, optionally spread over several threads;
+ * during the traversal, the bounding box of each node is then tested against
+ * the hierarchical-Z pyramid of that buffer, and a node that is completely
+ * hidden is not traversed any further.
+ *
+ * Unlike PipeOcclusionCullTraverser, this does not interfere with the
+ * graphics pipe, and the results are available immediately, but the
+ * occluders must be chosen with some care: they should be large, simple and
+ * solid.  Occluders may be designated explicitly with add_occluder(), or, if
+ * set_auto_occluders() is enabled, any GeomNode that covers a sufficiently
+ * large part of the screen is automatically used as an occluder in the
+ * following frames, as long as it is opaque, writes depth, and is neither
+ * animated nor a billboard.
+ *
+ * The triangles of each occluder are extracted once, when it is added; call
+ * add_occluder() again if its geometry changes.  Its transform, however, is
+ * recomputed every frame.
+ */
+class EXPCL_PANDA_GRUTIL SoftwareOcclusionCullTraverser : public CullTraverser {
+PUBLISHED:
+  SoftwareOcclusionCullTraverser();
+  SoftwareOcclusionCullTraverser(const SoftwareOcclusionCullTraverser &copy) = delete;
+  virtual ~SoftwareOcclusionCullTraverser();
+
+  virtual void set_scene(SceneSetup *scene_setup,
+                         GraphicsStateGuardianBase *gsg,
+                         bool dr_incomplete_render);
+  virtual void end_traverse();
+
+  void add_occluder(const NodePath &occluder);
+  bool remove_occluder(const NodePath &occluder);
+  void clear_occluders();
+  INLINE int get_num_occluders() const;
+  INLINE NodePath get_occluder(int n) const;
+  MAKE_SEQ(get_occluders, get_num_occluders, get_occluder);
+
+  INLINE void set_auto_occluders(bool auto_occluders);
+  INLINE bool get_auto_occluders() const;
+  MAKE_PROPERTY(auto_occluders, get_auto_occluders, set_auto_occluders);
+
+  INLINE OcclusionDepthBuffer *get_depth_buffer() const;
+  MAKE_PROPERTY(depth_buffer, get_depth_buffer);
+
+protected:
+  virtual void traverse_below(CullTraverserData &data);
+
+private:
+  class Occluder {
+  public:
+    NodePath _node_path;
+
+    // The vertices of the occluder's triangles, three at a time, in the
+    // coordinate space of _node_path.
+    pvector<LPoint3> _vertices;
+    pvector<const PandaNode *> _geom_nodes;
+
+    bool _automatic;
+    int _last_frame;
+  };
+  typedef pvector<Occluder> Occluders;
+
+  void make_occluder(Occluder &occluder, const NodePath &node_path) const;
+  void consider_auto_occluder(CullTraverserData &data,
+                              const LPoint3 &min_ndc, const LPoint3 &max_ndc);
+  bool is_solid_occluder(CullTraverserData &data) const;
+  void expire_auto_occluders(int frame);
+  void index_occluders();
+  void render_occluders();
+
+  void start_threads();
+  void stop_threads();
+  void rasterize_band(int band);
+
+private:
+  PT(OcclusionDepthBuffer) _buffer;
+  Occluders _occluders;
+  bool _auto_occluders;
+  bool _live;
+
+  // Maps every GeomNode that contributes to an occluder to the index of that
+  // occluder.  Occluders are not tested against themselves.
+  typedef pmap<const PandaNode *, int> OccluderNodes;
+  OccluderNodes _occluder_nodes;
+
+  LMatrix4 _world_to_clip;
+
+  class RasterThread : public Thread {
+  public:
+    RasterThread(SoftwareOcclusionCullTraverser *trav, int band,
+                 const std::string &name);
+    virtual void thread_main();
+
+    SoftwareOcclusionCullTraverser *_trav;
+    int _band;
+
+    // The value of _job_seq when this thread last took on a band.  Only
+    // accessed with the traverser's _lock held.
+    int _last_seq;
+  };
+  typedef pvector<PT(RasterThread) > RasterThreads;
+  RasterThreads _threads;
+
+  // Set once start_threads() has been called, so that it isn't tried again
+  // every frame if no threads could be started.
+  bool _threads_tried;
+
+  // Protects the following members, which are used to hand out the bands
+  // of rows to the raster threads.
+  Mutex _lock;
+  ConditionVarFull _cvar;
+  int _job_seq;
+  int _bands_pending;
+  bool _shutdown;
+
+  static PStatCollector _setup_occlusion_pcollector;
+  static PStatCollector _draw_occlusion_pcollector;
+  static PStatCollector _test_occlusion_pcollector;
+
+  static PStatCollector _occlusion_passed_pcollector;
+  static PStatCollector _occlusion_failed_pcollector;
+  static PStatCollector _occlusion_tests_pcollector;
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    CullTraverser::init_type();
+    register_type(_type_handle, "SoftwareOcclusionCullTraverser",
+                  CullTraverser::get_class_type());
+  }
+  virtual TypeHandle get_type() const {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
+
+private:
+  static TypeHandle _type_handle;
+};
+
+#include "softwareOcclusionCullTraverser.I"
+
+#endif
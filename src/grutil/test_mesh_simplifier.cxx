@@ -0,0 +1,269 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_mesh_simplifier.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "meshSimplifier.h"
+#include "geom.h"
+#include "geomTriangles.h"
+#include "geomVertexData.h"
+#include "geomVertexReader.h"
+#include "geomVertexWriter.h"
+#include "pmap.h"
+#include "mathNumbers.h"
+
+#include <algorithm>
+
+// This simplifies a closed sphere and a flat, open grid to various fractions
+// of their triangle counts, and checks the results:
+//
+// - the number of triangles must come within 10% of the target, without
+//   going over it;
+// - the mesh must remain manifold: on the sphere, every edge must still be
+//   shared by exactly two triangles, which use it in opposite directions;
+//   on the grid, no edge may be used by more than two triangles, nor twice
+//   in the same direction;
+// - no triangle may be flipped or squashed flat;
+// - the reported error must bound how far the surface moved.  The grid is
+//   flat, so it must be simplified without any error at all, and keep its
+//   outline; the centers of the sphere's triangles must not sink further
+//   below its surface than a small multiple of the error.
+
+/**
+ * Returns a sphere of radius 1 around the origin, made of the indicated
+ * number of rings and segments, with every vertex shared by all of the
+ * triangles that meet there.
+ */
+static PT(Geom)
+make_sphere(int num_rings, int num_segments) {
+  PT(GeomVertexData) vdata = new GeomVertexData
+    ("sphere", GeomVertexFormat::get_v3(), Geom::UH_static);
+  GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+  vertex.add_data3(0.0f, 0.0f, 1.0f);
+  for (int r = 1; r < num_rings; ++r) {
+    double theta = MathNumbers::pi * r / num_rings;
+    for (int s = 0; s < num_segments; ++s) {
+      double phi = 2.0 * MathNumbers::pi * s / num_segments;
+      vertex.add_data3(sin(theta) * cos(phi), sin(theta) * sin(phi), cos(theta));
+    }
+  }
+  vertex.add_data3(0.0f, 0.0f, -1.0f);
+  int south = 1 + (num_rings - 1) * num_segments;
+
+  auto index = [&](int r, int s) {
+    return 1 + (r - 1) * num_segments + (s % num_segments);
+  };
+
+  PT(GeomTriangles) tris = new GeomTriangles(Geom::UH_static);
+  for (int s = 0; s < num_segments; ++s) {
+    tris->add_vertices(0, index(1, s), index(1, s + 1));
+  }
+  for (int r = 1; r < num_rings - 1; ++r) {
+    for (int s = 0; s < num_segments; ++s) {
+      tris->add_vertices(index(r, s), index(r + 1, s), index(r + 1, s + 1));
+      tris->add_vertices(index(r, s), index(r + 1, s + 1), index(r, s + 1));
+    }
+  }
+  for (int s = 0; s < num_segments; ++s) {
+    tris->add_vertices(index(num_rings - 1, s), south, index(num_rings - 1, s + 1));
+  }
+
+  PT(Geom) geom = new Geom(vdata);
+  geom->add_primitive(tris);
+  return geom;
+}
+
+/**
+ * Returns a flat square grid of size by size quads in the XY plane, facing
+ * +Z.
+ */
+static PT(Geom)
+make_grid(int size) {
+  PT(GeomVertexData) vdata = new GeomVertexData
+    ("grid", GeomVertexFormat::get_v3(), Geom::UH_static);
+  GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+  for (int y = 0; y <= size; ++y) {
+    for (int x = 0; x <= size; ++x) {
+      vertex.add_data3(x, y, 0.0f);
+    }
+  }
+
+  PT(GeomTriangles) tris = new GeomTriangles(Geom::UH_static);
+  for (int y = 0; y < size; ++y) {
+    for (int x = 0; x < size; ++x) {
+      int a = y * (size + 1) + x;
+      tris->add_vertices(a, a + 1, a + size + 2);
+      tris->add_vertices(a, a + size + 2, a + size + 1);
+    }
+  }
+
+  PT(Geom) geom = new Geom(vdata);
+  geom->add_primitive(tris);
+  return geom;
+}
+
+/**
+ * Reads the vertex positions of the Geom, and the indices of the vertices of
+ * its triangles, three at a time.
+ */
+static void
+get_triangles(const Geom *geom, pvector<LPoint3> &points, vector_int &indices) {
+  CPT(GeomVertexData) vdata = geom->get_vertex_data();
+  GeomVertexReader vertex(vdata, InternalName::get_vertex());
+  points.clear();
+  while (!vertex.is_at_end()) {
+    points.push_back(vertex.get_data3());
+  }
+
+  indices.clear();
+  for (size_t i = 0; i < geom->get_num_primitives(); ++i) {
+    CPT(GeomPrimitive) prim = geom->get_primitive(i)->decompose();
+    if (prim->get_primitive_type() != Geom::PT_polygons) {
+      continue;
+    }
+    int num_vertices = prim->get_num_vertices();
+    for (int vi = 0; vi < num_vertices; ++vi) {
+      indices.push_back(prim->get_vertex(vi));
+    }
+  }
+}
+
+/**
+ * Simplifies the Geom to the indicated ratio, and checks the result.  If
+ * is_sphere is true, the Geom is the closed sphere from make_sphere();
+ * otherwise, it is the flat grid from make_grid().  error is filled in with
+ * the reported error.
+ */
+static bool
+run_test(const std::string &name, const Geom *geom, PN_stdfloat ratio,
+         bool is_sphere, PN_stdfloat &error) {
+  pvector<LPoint3> points;
+  vector_int indices;
+  get_triangles(geom, points, indices);
+  int orig_triangles = (int)indices.size() / 3;
+  int target = (int)(orig_triangles * ratio);
+
+  LPoint3 orig_min(points[0]), orig_max(points[0]);
+  for (const LPoint3 &point : points) {
+    orig_min = orig_min.fmin(point);
+    orig_max = orig_max.fmax(point);
+  }
+
+  MeshSimplifier simplifier;
+  PT(Geom) result = simplifier.simplify_geom(geom, ratio);
+  error = simplifier.get_last_error();
+  get_triangles(result, points, indices);
+  int num_triangles = (int)indices.size() / 3;
+
+  bool okflag = true;
+  if (num_triangles > target || num_triangles < target * 9 / 10) {
+    nout << name << ": got " << num_triangles << " triangles, expected "
+         << target << ".\n";
+    okflag = false;
+  }
+
+  // Count the uses of each edge in each direction, and look for flipped or
+  // degenerate triangles.
+  pmap<std::pair<int, int>, int> edges;
+  int num_bad = 0;
+  double max_depth = 0.0;
+  LPoint3 new_min(points[indices[0]]), new_max(points[indices[0]]);
+  for (int ti = 0; ti < num_triangles; ++ti) {
+    const int *tri = &indices[ti * 3];
+    for (int k = 0; k < 3; ++k) {
+      ++edges[std::make_pair(tri[k], tri[(k + 1) % 3])];
+      new_min = new_min.fmin(points[tri[k]]);
+      new_max = new_max.fmax(points[tri[k]]);
+    }
+
+    const LPoint3 &a = points[tri[0]];
+    const LPoint3 &b = points[tri[1]];
+    const LPoint3 &c = points[tri[2]];
+    LVector3 normal = (b - a).cross(c - a);
+    if (is_sphere) {
+      LPoint3 center = (a + b + c) / 3.0f;
+      max_depth = std::max(max_depth, 1.0 - center.length());
+      if (normal.dot(center) <= 0.0f) {
+        ++num_bad;
+      }
+    } else if (normal[2] <= 0.0f) {
+      ++num_bad;
+    }
+  }
+  if (num_bad != 0) {
+    nout << name << ": " << num_bad << " triangles are flipped or degenerate.\n";
+    okflag = false;
+  }
+
+  int num_nonmanifold = 0;
+  for (const auto &item : edges) {
+    auto reverse = edges.find(std::make_pair(item.first.second, item.first.first));
+    int num_reverse = (reverse != edges.end()) ? reverse->second : 0;
+    if (item.second != 1 || (is_sphere && num_reverse != 1)) {
+      ++num_nonmanifold;
+    }
+  }
+  if (num_nonmanifold != 0) {
+    nout << name << ": " << num_nonmanifold << " edges are not manifold.\n";
+    okflag = false;
+  }
+
+  if (is_sphere) {
+    if (error <= 0.0f || max_depth > error * 3.0f) {
+      nout << name << ": surface sank by " << max_depth
+           << ", but the reported error is " << error << ".\n";
+      okflag = false;
+    }
+  } else {
+    if (error > 0.0001f) {
+      nout << name << ": flat grid reported an error of " << error << ".\n";
+      okflag = false;
+    }
+    if (!new_min.almost_equal(orig_min) || !new_max.almost_equal(orig_max)) {
+      nout << name << ": outline of the grid was not preserved.\n";
+      okflag = false;
+    }
+  }
+
+  nout << name << " at " << ratio << ": " << orig_triangles << " -> "
+       << num_triangles << " triangles, error " << error << ", "
+       << (okflag ? "ok" : "FAILED") << ".\n";
+  return okflag;
+}
+
+int
+main(int argc, char *argv[]) {
+  bool okflag = true;
+
+  PT(Geom) sphere = make_sphere(16, 32);
+  PN_stdfloat prev_error = 0.0f;
+  static const PN_stdfloat sphere_ratios[] = { 0.5f, 0.25f, 0.1f, 0.05f };
+  for (PN_stdfloat ratio : sphere_ratios) {
+    PN_stdfloat error;
+    okflag = run_test("sphere", sphere, ratio, true, error) && okflag;
+    if (error < prev_error) {
+      nout << "sphere: error went down from " << prev_error << " to " << error
+           << " as more triangles were removed.\n";
+      okflag = false;
+    }
+    prev_error = error;
+  }
+
+  PT(Geom) grid = make_grid(20);
+  static const PN_stdfloat grid_ratios[] = { 0.5f, 0.1f, 0.01f };
+  for (PN_stdfloat ratio : grid_ratios) {
+    PN_stdfloat error;
+    okflag = run_test("grid", grid, ratio, false, error) && okflag;
+  }
+
+  return okflag ? 0 : 1;
+}
@@ -0,0 +1,286 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_occlusion_cull.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "softwareOcclusionCullTraverser.h"
+#include "graphicsStateGuardian.h"
+#include "cullHandler.h"
+#include "cullableObject.h"
+#include "sceneSetup.h"
+#include "camera.h"
+#include "perspectiveLens.h"
+#include "cardMaker.h"
+#include "geomNode.h"
+#include "geom.h"
+#include "geomTriangles.h"
+#include "geomVertexData.h"
+#include "geomVertexWriter.h"
+#include "nodePath.h"
+#include "load_prc_file.h"
+#include "transparencyAttrib.h"
+#include "depthWriteAttrib.h"
+
+#include <algorithm>
+
+// This culls a small scene with a SoftwareOcclusionCullTraverser.  A wall
+// stands in front of the camera and is used as the occluder; one box is
+// placed directly behind it, another one off to the side, and a third one in
+// front of it.  No window is opened, since the occluders are rasterized on
+// the CPU.
+//
+// The test fails unless the box behind the wall is culled and the other two
+// are not.  This is repeated with different numbers of raster threads, so
+// that the depth buffer is divided into bands in different ways.
+//
+// Then the wall is left for the traverser to pick as an automatic occluder,
+// over two frames.  An opaque wall must be picked and must hide the box; a
+// transparent wall, one that doesn't write depth, or a billboard must not be
+// picked, and the box behind it must still be drawn.
+
+/**
+ * A GSG that can't draw anything; the traverser only needs one to exist.
+ */
+class TestGSG : public GraphicsStateGuardian {
+public:
+  TestGSG() : GraphicsStateGuardian(CS_default, nullptr, nullptr) {
+  }
+};
+
+/**
+ * Remembers which Geoms were drawn.
+ */
+class RecordingCullHandler : public CullHandler {
+public:
+  virtual void record_object(CullableObject *object,
+                             const CullTraverser *traverser) {
+    _geoms.push_back(object->_geom);
+    delete object;
+  }
+
+  bool was_drawn(const Geom *geom) const {
+    return std::find(_geoms.begin(), _geoms.end(), geom) != _geoms.end();
+  }
+
+  pvector<CPT(Geom) > _geoms;
+};
+
+/**
+ * Returns a Geom with two triangles that span the corners of an axis-aligned
+ * box of the indicated size around the origin.
+ */
+static PT(Geom)
+make_box(PN_stdfloat size) {
+  PT(GeomVertexData) vdata = new GeomVertexData
+    ("box", GeomVertexFormat::get_v3(), Geom::UH_static);
+  GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+  vertex.add_data3(-size, -size, -size);
+  vertex.add_data3(size, -size, -size);
+  vertex.add_data3(size, size, size);
+  vertex.add_data3(-size, size, size);
+
+  PT(GeomTriangles) tris = new GeomTriangles(Geom::UH_static);
+  tris->add_vertices(0, 1, 2);
+  tris->add_vertices(0, 2, 3);
+
+  PT(Geom) geom = new Geom(vdata);
+  geom->add_primitive(tris);
+  return geom;
+}
+
+/**
+ * Adds a box at the indicated position to the scene, and returns its Geom.
+ */
+static CPT(Geom)
+add_box(NodePath &render, const std::string &name, const LPoint3 &pos) {
+  PT(GeomNode) node = new GeomNode(name);
+  PT(Geom) geom = make_box(1.0f);
+  node->add_geom(geom);
+  NodePath np = render.attach_new_node(node);
+  np.set_pos(pos);
+  return geom;
+}
+
+/**
+ * Returns a SceneSetup for the indicated camera, looking down the Y axis from
+ * the origin.
+ */
+static PT(SceneSetup)
+make_scene_setup(NodePath &render, NodePath &camera, Camera *camera_node,
+                 Lens *lens) {
+  PT(SceneSetup) scene_setup = new SceneSetup;
+  scene_setup->set_viewport_size(800, 600);
+  scene_setup->set_scene_root(render);
+  scene_setup->set_camera_path(camera);
+  scene_setup->set_camera_node(camera_node);
+  scene_setup->set_lens(lens);
+  scene_setup->set_initial_state(RenderState::make_empty());
+  scene_setup->set_camera_transform(TransformState::make_identity());
+  scene_setup->set_world_transform(TransformState::make_identity());
+  scene_setup->set_cs_transform(TransformState::make_identity());
+  scene_setup->set_cs_world_transform(TransformState::make_identity());
+  return scene_setup;
+}
+
+/**
+ * Culls the scene once with the indicated number of raster threads, and
+ * returns true if the right boxes were drawn.
+ */
+static bool
+run_test(int num_threads) {
+  load_prc_file_data("test_occlusion_cull",
+                     "software-occlusion-threads " + std::to_string(num_threads));
+
+  NodePath render("render");
+
+  CardMaker cm("wall");
+  cm.set_frame(-5.0f, 5.0f, -5.0f, 5.0f);
+  NodePath wall = render.attach_new_node(cm.generate());
+  wall.set_y(10.0f);
+
+  CPT(Geom) hidden = add_box(render, "hidden", LPoint3(0.0f, 20.0f, 0.0f));
+  CPT(Geom) beside = add_box(render, "beside", LPoint3(14.0f, 20.0f, 0.0f));
+  CPT(Geom) in_front = add_box(render, "in_front", LPoint3(0.0f, 5.0f, 0.0f));
+
+  PT(PerspectiveLens) lens = new PerspectiveLens;
+  lens->set_fov(90.0f);
+  lens->set_near_far(1.0f, 100.0f);
+  PT(Camera) camera_node = new Camera("camera", lens);
+  NodePath camera = render.attach_new_node(camera_node);
+
+  PT(TestGSG) gsg = new TestGSG;
+  PT(SceneSetup) scene_setup =
+    make_scene_setup(render, camera, camera_node, lens);
+
+  RecordingCullHandler cull_handler;
+  PT(SoftwareOcclusionCullTraverser) trav = new SoftwareOcclusionCullTraverser;
+  trav->add_occluder(wall);
+  trav->set_cull_handler(&cull_handler);
+  trav->set_scene(scene_setup, gsg, false);
+  trav->traverse(render);
+  trav->end_traverse();
+
+  bool okflag = true;
+  if (trav->get_depth_buffer()->get_num_triangles() == 0) {
+    nout << "No occluder triangles were rasterized.\n";
+    okflag = false;
+  }
+  if (cull_handler.was_drawn(hidden)) {
+    nout << "The box behind the wall was drawn.\n";
+    okflag = false;
+  }
+  if (!cull_handler.was_drawn(beside)) {
+    nout << "The box beside the wall was culled.\n";
+    okflag = false;
+  }
+  if (!cull_handler.was_drawn(in_front)) {
+    nout << "The box in front of the wall was culled.\n";
+    okflag = false;
+  }
+
+  nout << num_threads << " raster threads: " << cull_handler._geoms.size()
+       << " Geoms drawn, " << (okflag ? "ok" : "FAILED") << ".\n";
+  return okflag;
+}
+
+enum WallKind {
+  WK_opaque,
+  WK_transparent,
+  WK_no_depth_write,
+  WK_billboard,
+};
+
+/**
+ * Culls the scene for two frames with automatic occluders enabled and no
+ * explicit occluder, and returns true if the wall was picked as an occluder
+ * and hid the box behind it only if it is opaque.
+ */
+static bool
+run_auto_test(WallKind kind, const char *description) {
+  load_prc_file_data("test_occlusion_cull", "software-occlusion-threads 0");
+
+  NodePath render("render");
+
+  CardMaker cm("wall");
+  cm.set_frame(-5.0f, 5.0f, -5.0f, 5.0f);
+  NodePath wall = render.attach_new_node(cm.generate());
+  wall.set_y(10.0f);
+  switch (kind) {
+  case WK_opaque:
+    break;
+  case WK_transparent:
+    wall.set_transparency(TransparencyAttrib::M_alpha);
+    wall.set_alpha_scale(0.5f);
+    break;
+  case WK_no_depth_write:
+    wall.set_depth_write(false);
+    break;
+  case WK_billboard:
+    wall.set_billboard_point_eye();
+    break;
+  }
+
+  CPT(Geom) hidden = add_box(render, "hidden", LPoint3(0.0f, 20.0f, 0.0f));
+
+  PT(PerspectiveLens) lens = new PerspectiveLens;
+  lens->set_fov(90.0f);
+  lens->set_near_far(1.0f, 100.0f);
+  PT(Camera) camera_node = new Camera("camera", lens);
+  NodePath camera = render.attach_new_node(camera_node);
+
+  PT(TestGSG) gsg = new TestGSG;
+  PT(SceneSetup) scene_setup =
+    make_scene_setup(render, camera, camera_node, lens);
+
+  PT(SoftwareOcclusionCullTraverser) trav = new SoftwareOcclusionCullTraverser;
+  trav->set_auto_occluders(true);
+
+  // The wall is picked during the first frame, and used in the second.
+  RecordingCullHandler cull_handler;
+  for (int frame = 0; frame < 2; ++frame) {
+    cull_handler._geoms.clear();
+    trav->set_cull_handler(&cull_handler);
+    trav->set_scene(scene_setup, gsg, false);
+    trav->traverse(render);
+    trav->end_traverse();
+  }
+
+  bool expect_occluder = (kind == WK_opaque);
+  bool okflag = true;
+  if ((trav->get_num_occluders() != 0) != expect_occluder) {
+    nout << "The " << description << " wall was "
+         << (expect_occluder ? "not " : "") << "picked as an occluder.\n";
+    okflag = false;
+  }
+  if (cull_handler.was_drawn(hidden) == expect_occluder) {
+    nout << "The box behind the " << description << " wall was "
+         << (expect_occluder ? "drawn" : "culled") << ".\n";
+    okflag = false;
+  }
+
+  nout << "Automatic occluders, " << description << " wall: "
+       << (okflag ? "ok" : "FAILED") << ".\n";
+  return okflag;
+}
+
+int
+main(int argc, char *argv[]) {
+  bool okflag = true;
+  okflag = run_test(0) && okflag;
+  okflag = run_test(1) && okflag;
+  okflag = run_test(3) && okflag;
+  okflag = run_auto_test(WK_opaque, "opaque") && okflag;
+  okflag = run_auto_test(WK_transparent, "transparent") && okflag;
+  okflag = run_auto_test(WK_no_depth_write, "depth-write-off") && okflag;
+  okflag = run_auto_test(WK_billboard, "billboard") && okflag;
+  return okflag ? 0 : 1;
+}
@@ -20,6 +20,7 @@
 #include "nodeCachedReferenceCount.h"
 #include "luse.h"
 #include "lightMutex.h"
+#include "bitMask.h"
 
 // A handful of forward references.
 
@@ -126,6 +127,7 @@ PUBLISHED:
   virtual bool get_supports_texture_srgb() const=0;
 
   virtual bool get_supports_hlsl() const=0;
+  virtual bool get_supports_geometry_instancing() const=0;
 
 public:
   // These are some general interface functions; they're defined here mainly
@@ -179,6 +181,16 @@ public:
   virtual void set_state_and_transform(const RenderState *state,
                                        const TransformState *transform)=0;
 
+  // This is a variant of set_state_and_transform() for the CullBins, which
+  // have already determined at cull time which attributes differ between
+  // prev_state, the state of the object drawn before this one, and state.
+  // The changed_slots mask may only be trusted if the GSG is still in
+  // prev_state.
+  virtual void set_state_delta_and_transform(const RenderState *state,
+                                             const TransformState *transform,
+                                             const RenderState *prev_state,
+                                             const BitMask64 &changed_slots)=0;
+
   // This function may only be called during a render traversal; it will
   // compute the distance to the indicated point, assumed to be in eye
   // coordinates, from the camera plane.  This is a virtual function because
@@ -300,6 +300,58 @@ set_from_matrix(const FLOATNAME(LMatrix3) &m) {
   }
 }
 
+/**
+ * Writes the quaternion, which should be normalized, to the bit writer in
+ * 2 + 3 * num_bits bits.  The largest component is left out, since it can
+ * be computed from the other three; those are known to lie within
+ * +/- sqrt(1/2), which gives num_bits bits more precision to work with.
+ */
+void FLOATNAME(LQuaternion)::
+write_datagram_quantized(DatagramBitWriter &destination, int num_bits) const {
+  FLOATNAME(LQuaternion) q(*this);
+  q.normalize();
+
+  int largest = 0;
+  for (int i = 1; i < 4; ++i) {
+    if (cabs(q._v(i)) > cabs(q._v(largest))) {
+      largest = i;
+    }
+  }
+
+  // q and -q are the same rotation, so we can always make the largest
+  // component positive, and needn't store its sign.
+  if (q._v(largest) < 0) {
+    q = -q;
+  }
+
+  // This is sqrt(1/2).
+  const PN_float32 limit = 0.70710678f;
+  destination.add_bits(largest, 2);
+  for (int i = 0; i < 4; ++i) {
+    if (i != largest) {
+      destination.add_quantized_float((PN_float32)q._v(i), -limit, limit, num_bits);
+    }
+  }
+}
+
+/**
+ * Reads a quaternion written by write_datagram_quantized() with the same
+ * number of bits.
+ */
+void FLOATNAME(LQuaternion)::
+read_datagram_quantized(DatagramBitReader &source, int num_bits) {
+  const PN_float32 limit = 0.70710678f;
+  int largest = (int)source.get_bits(2);
+  FLOATTYPE sum = 0;
+  for (int i = 0; i < 4; ++i) {
+    if (i != largest) {
+      _v(i) = source.get_quantized_float(-limit, limit, num_bits);
+      sum += _v(i) * _v(i);
+    }
+  }
+  _v(largest) = csqrt(std::max((FLOATTYPE)0, (FLOATTYPE)1 - sum));
+}
+
 /**
  *
  */
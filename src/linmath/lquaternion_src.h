@@ -114,6 +114,10 @@ PUBLISHED:
   INLINE_LINMATH bool is_almost_identity(FLOATTYPE tolerance) const;
   INLINE_LINMATH static const FLOATNAME(LQuaternion) &ident_quat();
 
+  void write_datagram_quantized(DatagramBitWriter &destination,
+                                int num_bits) const;
+  void read_datagram_quantized(DatagramBitReader &source, int num_bits);
+
 private:
   static const FLOATNAME(LQuaternion) _ident_quat;
 
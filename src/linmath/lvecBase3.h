@@ -20,6 +20,8 @@
 #include "pnotify.h"
 #include "datagram.h"
 #include "datagramIterator.h"
+#include "datagramBitWriter.h"
+#include "datagramBitReader.h"
 #include "checksumHashGenerator.h"
 #include "mathNumbers.h"
 #include "deg_2_rad.h"
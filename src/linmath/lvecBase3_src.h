@@ -176,6 +176,17 @@ PUBLISHED:
   INLINE_LINMATH void write_datagram(Datagram &destination) const;
   INLINE_LINMATH void read_datagram(DatagramIterator &source);
 
+#ifndef FLOATTYPE_IS_INT
+  INLINE_LINMATH void write_datagram_quantized(DatagramBitWriter &destination,
+                                               FLOATTYPE min_value,
+                                               FLOATTYPE max_value,
+                                               int num_bits) const;
+  INLINE_LINMATH void read_datagram_quantized(DatagramBitReader &source,
+                                              FLOATTYPE min_value,
+                                              FLOATTYPE max_value,
+                                              int num_bits);
+#endif
+
 public:
   // The underlying implementation is via the Eigen library, if available.
 
@@ -165,5 +165,31 @@ int main(int argc, char *argv[]) {
     nout << "\n";
   }
 
+  {
+    LVecBase3f pos(12.5f, -3.25f, 100.0f);
+    LQuaternionf quat;
+    quat.set_hpr(LVecBase3f(30.0f, -45.0f, 10.0f));
+
+    Datagram dg;
+    {
+      DatagramBitWriter writer(dg);
+      pos.write_datagram_quantized(writer, -512.0f, 512.0f, 16);
+      quat.write_datagram_quantized(writer, 12);
+    }
+
+    DatagramIterator scan(dg);
+    DatagramBitReader reader(scan);
+    LVecBase3f pos2;
+    LQuaternionf quat2;
+    pos2.read_datagram_quantized(reader, -512.0f, 512.0f, 16);
+    quat2.read_datagram_quantized(reader, 12);
+
+    nout << "\nquantized into " << dg.get_length() << " bytes:\n"
+         << "pos " << pos << " -> " << pos2 << "\n"
+         << "quat " << quat << " -> " << quat2
+         << " (same rotation: "
+         << quat.almost_same_direction(quat2, 0.001f) << ")\n";
+  }
+
   return(0);
 }
@@ -4,7 +4,7 @@
 #define WIN_SYS_LIBS iphlpapi.lib
 
 #define BUILD_DIRECTORY $[and $[HAVE_NET],$[WANT_NATIVE_NET]]
-#define USE_PACKAGES net
+#define USE_PACKAGES net zlib
 
 #begin lib_target
   #define TARGET p3net
@@ -16,42 +16,52 @@
   #define SOURCES \
      config_net.h connection.h connectionListener.h  \
      connectionManager.N connectionManager.h \
+     connectionStats.I connectionStats.h \
      connectionReader.I connectionReader.h  \
      connectionWriter.h datagramQueue.h \
      datagramTCPHeader.I datagramTCPHeader.h  \
      datagramUDPHeader.I datagramUDPHeader.h  \
-     netAddress.h netDatagram.I netDatagram.h  \
+     netAddress.h netCompressor.h netDatagram.I netDatagram.h  \
+     netStats.I netStats.h \
      datagramGeneratorNet.I datagramGeneratorNet.h \
      datagramSinkNet.I datagramSinkNet.h \
      queuedConnectionListener.I  \
      queuedConnectionListener.h queuedConnectionManager.h  \
      queuedConnectionReader.h recentConnectionReader.h \
-     queuedReturn.h queuedReturn.I
+     queuedReturn.h queuedReturn.I \
+     reliableChannel.h reliableChannel.I \
+     ringQueue.h ringQueue.I \
+     stateSnapshot.h stateSnapshot.I
 
   #define COMPOSITE_SOURCES \
      config_net.cxx connection.cxx connectionListener.cxx  \
      connectionManager.cxx connectionReader.cxx  \
+     connectionStats.cxx \
      connectionWriter.cxx datagramQueue.cxx datagramTCPHeader.cxx  \
-     datagramUDPHeader.cxx netAddress.cxx netDatagram.cxx  \
+     datagramUDPHeader.cxx netAddress.cxx netCompressor.cxx \
+     netDatagram.cxx netStats.cxx \
      datagramGeneratorNet.cxx \
      datagramSinkNet.cxx \
      queuedConnectionListener.cxx  \
      queuedConnectionManager.cxx queuedConnectionReader.cxx  \
-     recentConnectionReader.cxx
+     recentConnectionReader.cxx reliableChannel.cxx \
+     stateSnapshot.cxx
 
   #define INSTALL_HEADERS \
     config_net.h connection.h connectionListener.h connectionManager.h \
     connectionReader.I connectionReader.h  \
+    connectionStats.I connectionStats.h \
     connectionWriter.h datagramQueue.h \
     datagramTCPHeader.I datagramTCPHeader.h \
     datagramUDPHeader.I datagramUDPHeader.h \
-    netAddress.h netDatagram.I \
-    netDatagram.h queuedConnectionListener.I \
+    netAddress.h netCompressor.h netDatagram.I \
+    netDatagram.h netStats.I netStats.h queuedConnectionListener.I \
     datagramGeneratorNet.I datagramGeneratorNet.h \
     datagramSinkNet.I datagramSinkNet.h \
     queuedConnectionListener.h queuedConnectionManager.h \
     queuedConnectionReader.h queuedReturn.I queuedReturn.h \
-    recentConnectionReader.h
+    recentConnectionReader.h reliableChannel.h reliableChannel.I \
+    ringQueue.h ringQueue.I stateSnapshot.h stateSnapshot.I
 
   #define IGATESCAN all
 
@@ -120,9 +130,37 @@
 
 #end test_bin_target
 
+#begin test_bin_target
+  #define TARGET test_reader_scaling
+  #define LOCAL_LIBS p3net
+
+  #define SOURCES \
+    test_reader_scaling.cxx
+
+#end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_compression
+  #define LOCAL_LIBS p3net
+
+  #define SOURCES \
+    test_compression.cxx
+
+#end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_reliable_udp
+  #define LOCAL_LIBS p3net
+
+  #define SOURCES \
+    test_reliable_udp.cxx
+
+#end test_bin_target
+
 #begin test_bin_target
   #define TARGET fake_http_server
   #define LOCAL_LIBS p3net
+  #define USE_PACKAGES $[USE_PACKAGES] openssl
 
   #define SOURCES \
     fake_http_server.cxx
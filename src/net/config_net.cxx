@@ -146,6 +146,53 @@ ConfigVariableEnum<ThreadPriority> net_thread_priority
  PRC_DESC("The default thread priority when creating threaded readers "
           "or writers."));
 
+ConfigVariableBool net_use_epoll
+("net-use-epoll", true,
+ PRC_DESC("On Linux, set this true to have each ConnectionReader thread wait "
+          "on its own epoll instance, with the connections divided among "
+          "the threads, rather than having all threads take turns on a "
+          "single select() call.  This scales to many more connections.  "
+          "It has no effect on other platforms.  This is consulted when "
+          "a ConnectionReader is constructed."));
+
+ConfigVariableInt net_queue_ring_size
+("net-queue-ring-size", 1024,
+ PRC_DESC("The number of datagrams (or other results) that the queues in "
+          "QueuedConnectionReader, ConnectionWriter and the like can hold "
+          "without taking a lock.  More than this may still be queued, up "
+          "to the respective maximum queue size, but more slowly.  This is "
+          "rounded up to a power of two."));
+
+ConfigVariableInt net_compression_level
+("net-compression-level", 0,
+ PRC_DESC("If this is nonzero, new TCP connections compress their datagrams "
+          "at this zlib compression level, 1 through 9.  Both ends of a "
+          "connection must agree on this setting.  See "
+          "Connection::set_compression()."));
+
+ConfigVariableInt net_max_decompressed_size
+("net-max-decompressed-size", 1048576,
+ PRC_DESC("The largest datagram, in bytes, that a compressed TCP connection "
+          "will accept after decompression.  This is also limited by the "
+          "largest datagram the tcp-header-size allows.  A connection that "
+          "sends a larger one is closed, since a small compressed datagram "
+          "may otherwise expand to an arbitrary amount of memory."));
+
+ConfigVariableInt net_write_batch_size
+("net-write-batch-size", 64,
+ PRC_DESC("The maximum number of datagrams a threaded ConnectionWriter "
+          "takes from its queue at once.  The datagrams in one batch that "
+          "go to the same connection are written together, with sendmmsg() "
+          "for UDP or writev() for TCP, where these are available."));
+
+ConfigVariableBool net_ping_frames
+("net-ping-frames", false,
+ PRC_DESC("Set this true to have new ConnectionReaders answer the ping "
+          "frames sent by ConnectionWriter::send_ping(), and time the "
+          "replies, to measure the round-trip time of each connection.  "
+          "Both ends must agree on this setting.  See "
+          "ConnectionReader::set_ping_frames()."));
+
 
 /**
  * Initializes the library.  This must be called at least once before any of
@@ -24,6 +24,18 @@
 
 // Configure variables for net package.
 
+// Batched socket calls, which move several datagrams per system call.  These
+// are not used with SIMPLE_THREADS, which relies on non-blocking sockets.
+#if !(defined(HAVE_THREADS) && defined(SIMPLE_THREADS))
+#ifdef IS_LINUX
+#define HAVE_RECVMMSG 1
+#define HAVE_SENDMMSG 1
+#endif
+#ifndef _WIN32
+#define HAVE_WRITEV 1
+#endif
+#endif
+
 NotifyCategoryDecl(net, EXPCL_PANDA_NET, EXPTP_PANDA_NET);
 
 extern int get_net_max_write_queue();
@@ -37,6 +49,12 @@ extern ConfigVariableInt net_max_read_per_epoch;
 extern ConfigVariableInt net_max_write_per_epoch;
 
 extern ConfigVariableEnum<ThreadPriority> net_thread_priority;
+extern EXPCL_PANDA_NET ConfigVariableBool net_use_epoll;
+extern ConfigVariableInt net_write_batch_size;
+extern EXPCL_PANDA_NET ConfigVariableInt net_queue_ring_size;
+extern EXPCL_PANDA_NET ConfigVariableInt net_compression_level;
+extern EXPCL_PANDA_NET ConfigVariableInt net_max_decompressed_size;
+extern EXPCL_PANDA_NET ConfigVariableBool net_ping_frames;
 
 extern EXPCL_PANDA_NET void init_libnet();
 
@@ -14,6 +14,7 @@
 #include "connection.h"
 #include "connectionManager.h"
 #include "netDatagram.h"
+#include "netCompressor.h"
 #include "datagramTCPHeader.h"
 #include "datagramUDPHeader.h"
 #include "config_net.h"
@@ -25,6 +26,30 @@
 #include "socket_tcp.h"
 #include "socket_udp.h"
 #include "dcast.h"
+#include "datagramIterator.h"
+#include "lightMutexHolder.h"
+
+#include <math.h>
+#include <algorithm>
+
+#ifdef IS_LINUX
+#include <sys/ioctl.h>
+#include <linux/sockios.h>
+#endif
+
+#if defined(HAVE_WRITEV) || defined(HAVE_SENDMMSG)
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <limits.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+// A ping frame is an ordinary datagram of exactly ping_frame_size bytes: this
+// magic number, a byte that is 0 for a ping or 1 for a pong, and the
+// TrueClock time at which the ping was sent.
+static const uint32_t ping_frame_magic = 0x9e50c1a7;
+static const size_t ping_frame_size = 13;
 
 
 /**
@@ -41,6 +66,20 @@ Connection(ConnectionManager *manager, Socket_IP *socket) :
   _collect_tcp_interval = collect_tcp_interval;
   _queued_data_start = 0.0;
   _queued_count = 0;
+  _compression_level = 0;
+  _compressor = nullptr;
+  _payload_bytes_sent = 0;
+  _wire_bytes_sent = 0;
+  _payload_bytes_received = 0;
+  _wire_bytes_received = 0;
+  _datagrams_sent = 0;
+  _datagrams_received = 0;
+
+  _rtt = 0.0;
+  _rtt_variance = 0.0;
+  _min_rtt = 0.0;
+  _last_rtt = 0.0;
+  _num_rtt_samples = 0;
 
 #if defined(HAVE_THREADS) && defined(SIMPLE_THREADS)
   // In the presence of SIMPLE_THREADS, we use non-blocking IO.  We simulate
@@ -50,6 +89,11 @@ Connection(ConnectionManager *manager, Socket_IP *socket) :
       << "Unable to set non-blocking status on socket\n";
   }
 #endif
+
+  if (net_compression_level != 0 &&
+      _socket->is_exact_type(Socket_TCP::get_class_type())) {
+    set_compression(net_compression_level);
+  }
 }
 
 /**
@@ -66,6 +110,10 @@ Connection::
     _socket->Close();
     delete _socket;
   }
+
+#ifdef HAVE_ZLIB
+  delete _compressor;
+#endif
 }
 
 /**
@@ -176,6 +224,172 @@ flush() {
 }
 
 
+/**
+ * Enables or disables compression of the datagrams sent and received on this
+ * connection.  level is the zlib compression level, 1 (fastest) through 9
+ * (smallest), or 0 to disable compression.  If a dictionary is given, it
+ * should contain byte sequences that are expected to be common in the
+ * traffic, such as the field names and typical values of the messages sent
+ * right after connecting.
+ *
+ * The datagrams are compressed as one continuous stream, so that each
+ * datagram benefits from the ones sent before it.  This means that both ends
+ * of the connection must enable compression, with the same dictionary, at the
+ * same point in the stream: typically immediately after connecting (see
+ * net-compression-level), or after an uncompressed handshake in which the
+ * two ends agree to it.  It is only supported on TCP connections, and is not
+ * applied to raw datagrams.
+ *
+ * Returns true on success, false if compression is not available.
+ */
+bool Connection::
+set_compression(int level, const vector_uchar &dictionary) {
+  nassertr(level >= 0 && level <= 9, false);
+  if (level != 0 && !_socket->is_exact_type(Socket_TCP::get_class_type())) {
+    net_cat.error()
+      << "Compression is only supported on TCP connections.\n";
+    return false;
+  }
+
+  LightReMutexHolder holder(_write_mutex);
+
+  // Anything already queued was compressed with the old settings.
+  do_flush();
+
+#ifdef HAVE_ZLIB
+  bool okflag = true;
+  NetCompressor *compressor = nullptr;
+  if (level != 0) {
+    compressor = new NetCompressor(level, dictionary);
+    if (!compressor->is_valid()) {
+      delete compressor;
+      compressor = nullptr;
+      level = 0;
+      okflag = false;
+    }
+  }
+
+  // A reader thread may be in the middle of decompressing with the old one.
+  {
+    LightMutexHolder decompress_holder(_decompress_mutex);
+    delete _compressor;
+    _compressor = compressor;
+    _compression_level = level;
+  }
+  return okflag;
+
+#else
+  if (level != 0) {
+    net_cat.error()
+      << "Cannot enable compression; zlib is not available.\n";
+    return false;
+  }
+  return true;
+#endif  // HAVE_ZLIB
+}
+
+/**
+ * Returns the compression level set by set_compression(), or 0 if the
+ * connection is not compressed.
+ */
+int Connection::
+get_compression_level() const {
+  return _compression_level;
+}
+
+/**
+ * Returns the total number of bytes of datagram data that have been sent on
+ * this connection, before compression and not counting headers.
+ */
+uint64_t Connection::
+get_payload_bytes_sent() const {
+  return (uint64_t)AtomicAdjust::get(_payload_bytes_sent);
+}
+
+/**
+ * Returns the total number of bytes that have been sent on this connection,
+ * including headers, after compression.  Comparing this with
+ * get_payload_bytes_sent() shows how well compression is doing.  TCP
+ * datagrams are counted when they are queued, even if collect-tcp mode is
+ * holding them back.
+ */
+uint64_t Connection::
+get_wire_bytes_sent() const {
+  return (uint64_t)AtomicAdjust::get(_wire_bytes_sent);
+}
+
+/**
+ * Returns the total number of bytes of datagram data that have been received
+ * on this connection, after decompression and not counting headers.
+ */
+uint64_t Connection::
+get_payload_bytes_received() const {
+  return (uint64_t)AtomicAdjust::get(_payload_bytes_received);
+}
+
+/**
+ * Returns the total number of bytes that have been received on this
+ * connection, including headers, before decompression.
+ */
+uint64_t Connection::
+get_wire_bytes_received() const {
+  return (uint64_t)AtomicAdjust::get(_wire_bytes_received);
+}
+
+/**
+ * Returns a snapshot of the traffic on this connection so far, along with the
+ * round-trip time measured by ping frames, if any, and the state of the send
+ * buffer.
+ */
+ConnectionStats Connection::
+get_stats() const {
+  ConnectionStats stats;
+  stats._payload_bytes_sent = get_payload_bytes_sent();
+  stats._wire_bytes_sent = get_wire_bytes_sent();
+  stats._datagrams_sent = (uint64_t)AtomicAdjust::get(_datagrams_sent);
+  stats._payload_bytes_received = get_payload_bytes_received();
+  stats._wire_bytes_received = get_wire_bytes_received();
+  stats._datagrams_received = (uint64_t)AtomicAdjust::get(_datagrams_received);
+
+  {
+    LightMutexHolder holder(_rtt_lock);
+    stats._rtt = _rtt;
+    stats._rtt_variance = _rtt_variance;
+    stats._min_rtt = _min_rtt;
+    stats._last_rtt = _last_rtt;
+    stats._num_rtt_samples = _num_rtt_samples;
+  }
+
+  {
+    LightReMutexHolder holder(_write_mutex);
+    stats._send_queued_bytes = (int)_queued_data.size();
+  }
+
+  if (_socket != nullptr && _socket->Active()) {
+    int size = 0;
+#ifdef _WIN32
+    int size_len = sizeof(size);
+#else
+    socklen_t size_len = sizeof(size);
+#endif
+    if (getsockopt(_socket->GetSocket(), SOL_SOCKET, SO_SNDBUF,
+                   (char *)&size, &size_len) == 0) {
+      stats._send_buffer_size = size;
+    }
+
+#ifdef IS_LINUX
+    // Only Linux will tell us how much of the buffer is still unacknowledged.
+    int queued = 0;
+    if (_socket->is_exact_type(Socket_TCP::get_class_type()) &&
+        ioctl(_socket->GetSocket(), SIOCOUTQ, &queued) == 0) {
+      stats._send_buffer_bytes = queued;
+    }
+#endif
+  }
+
+  return stats;
+}
+
 /**
  * Sets whether nonblocking I/O should be in effect.
  */
@@ -332,29 +546,50 @@ send_datagram(const NetDatagram &datagram, int tcp_header_size) {
         << ", ok = " << okflag << "\n";
     }
 
+    if (okflag) {
+      AtomicAdjust::add(_payload_bytes_sent, datagram.get_length());
+      AtomicAdjust::add(_wire_bytes_sent, bytes_to_send);
+      AtomicAdjust::inc(_datagrams_sent);
+    }
+
     return check_send_error(okflag);
   }
 
+  // The datagrams must be compressed in the order they are sent, so we hold
+  // the lock from here on.
+  LightReMutexHolder holder(_write_mutex);
+
+  const NetDatagram *sending = &datagram;
+  NetDatagram compressed;
+  if (_compressor != nullptr) {
+    if (!compress_datagram(datagram, compressed)) {
+      return check_send_error(false);
+    }
+    sending = &compressed;
+  }
+
   // We might queue up TCP packets for later sending.
-  if (tcp_header_size == 2 && datagram.get_length() >= 0x10000) {
+  if (tcp_header_size == 2 && sending->get_length() >= 0x10000) {
     net_cat.error()
-      << "Attempt to send TCP datagram of " << datagram.get_length()
+      << "Attempt to send TCP datagram of " << sending->get_length()
       << " bytes--too long!\n";
     nassert_raise("Datagram too long");
     return false;
   }
 
-  DatagramTCPHeader header(datagram, tcp_header_size);
+  DatagramTCPHeader header(*sending, tcp_header_size);
 
-  LightReMutexHolder holder(_write_mutex);
   CPTA_uchar header_data = header.get_array();
-  CPTA_uchar message = datagram.get_array();
+  CPTA_uchar message = sending->get_array();
   _queued_data.insert(_queued_data.end(), header_data.begin(), header_data.end());
   _queued_data.insert(_queued_data.end(), message.begin(), message.end());
   _queued_count++;
+  AtomicAdjust::add(_payload_bytes_sent, datagram.get_length());
+  AtomicAdjust::add(_wire_bytes_sent, header_data.size() + message.size());
+  AtomicAdjust::inc(_datagrams_sent);
 
   if (net_cat.is_debug()) {
-    header.verify_datagram(datagram, tcp_header_size);
+    header.verify_datagram(*sending, tcp_header_size);
   }
 
   if (!_collect_tcp ||
@@ -400,6 +635,12 @@ send_raw_datagram(const NetDatagram &datagram) {
         << ", ok = " << okflag << "\n";
     }
 
+    if (okflag) {
+      AtomicAdjust::add(_payload_bytes_sent, data.size());
+      AtomicAdjust::add(_wire_bytes_sent, data.size());
+      AtomicAdjust::inc(_datagrams_sent);
+    }
+
     return check_send_error(okflag);
   }
 
@@ -408,6 +649,9 @@ send_raw_datagram(const NetDatagram &datagram) {
   CPTA_uchar msg = datagram.get_array();
   _queued_data.insert(_queued_data.end(), msg.begin(), msg.end());
   _queued_count++;
+  AtomicAdjust::add(_payload_bytes_sent, msg.size());
+  AtomicAdjust::add(_wire_bytes_sent, msg.size());
+  AtomicAdjust::inc(_datagrams_sent);
 
   if (!_collect_tcp ||
       TrueClock::get_global_ptr()->get_short_time() - _queued_data_start >= _collect_tcp_interval) {
@@ -417,6 +661,346 @@ send_raw_datagram(const NetDatagram &datagram) {
   return true;
 }
 
+/**
+ * This method is intended only to be called by ConnectionWriter.  It writes
+ * the indicated datagrams, in order, with as few system calls as possible:
+ * UDP datagrams are sent with sendmmsg(), and TCP datagrams are gathered
+ * together with their headers into a single writev().  Returns true on
+ * success, false on failure.
+ */
+bool Connection::
+send_datagrams(const NetDatagram *const *datagrams, size_t count,
+               int tcp_header_size, bool raw) {
+  nassertr(_socket != nullptr, false);
+  if (count == 0) {
+    return true;
+  }
+
+  if (_socket->is_exact_type(Socket_UDP::get_class_type())) {
+#ifdef HAVE_SENDMMSG
+    if (count > 1) {
+      return send_udp_batch(datagrams, count, raw);
+    }
+#endif
+  } else {
+#ifdef HAVE_WRITEV
+    // In collect-tcp mode, the datagrams are held back anyway, so there is
+    // nothing to be gained here.
+    if (!raw && !_collect_tcp) {
+      return send_tcp_batch(datagrams, count, tcp_header_size);
+    }
+#endif
+  }
+
+  bool okflag = true;
+  for (size_t i = 0; i < count && okflag; ++i) {
+    if (raw) {
+      okflag = send_raw_datagram(*datagrams[i]);
+    } else {
+      okflag = send_datagram(*datagrams[i], tcp_header_size);
+    }
+  }
+  return okflag;
+}
+
+/**
+ * Sends the indicated UDP datagrams, each to its own address, with as few
+ * calls to sendmmsg() as possible.  The headers are sent from a separate
+ * buffer, so the datagrams themselves are not copied.
+ */
+bool Connection::
+send_udp_batch(const NetDatagram *const *datagrams, size_t count, bool raw) {
+#ifdef HAVE_SENDMMSG
+  Socket_UDP *udp;
+  DCAST_INTO_R(udp, _socket, false);
+
+  pvector<DatagramUDPHeader> headers;
+  pvector<Socket_Address> addrs;
+  pvector<struct iovec> iovs(count * 2);
+  pvector<struct mmsghdr> msgs(count);
+  headers.reserve(count);
+  addrs.reserve(count);
+
+  for (size_t i = 0; i < count; ++i) {
+    const NetDatagram &datagram = *datagrams[i];
+    struct iovec *iov = &iovs[i * 2];
+    int iovlen = 0;
+    if (!raw) {
+      headers.push_back(DatagramUDPHeader(datagram));
+      CPTA_uchar header_data = headers.back().get_array();
+      iov[iovlen].iov_base = (void *)header_data.p();
+      iov[iovlen].iov_len = header_data.size();
+      ++iovlen;
+    }
+    iov[iovlen].iov_base = (void *)datagram.get_data();
+    iov[iovlen].iov_len = datagram.get_length();
+    ++iovlen;
+
+    addrs.push_back(datagram.get_address().get_addr());
+    struct msghdr &hdr = msgs[i].msg_hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_name = &addrs.back().GetAddressInfo();
+    hdr.msg_namelen = SA_SIZEOF(&addrs.back().GetAddressInfo());
+    hdr.msg_iov = iov;
+    hdr.msg_iovlen = iovlen;
+  }
+
+  LightReMutexHolder holder(_write_mutex);
+  size_t sent = 0;
+  while (sent < count) {
+    int result = sendmmsg(udp->GetSocket(), &msgs[sent], count - sent, 0);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    sent += result;
+  }
+
+  if (net_cat.is_spam()) {
+    net_cat.spam()
+      << "Sent " << sent << " of " << count << " UDP datagrams to "
+      << (void *)this << "\n";
+  }
+
+  for (size_t i = 0; i < sent; ++i) {
+    size_t length = datagrams[i]->get_length();
+    AtomicAdjust::add(_payload_bytes_sent, length);
+    AtomicAdjust::add(_wire_bytes_sent, length + (raw ? 0 : datagram_udp_header_size));
+    AtomicAdjust::inc(_datagrams_sent);
+  }
+
+  return check_send_error(sent == count);
+#else
+  return false;
+#endif  // HAVE_SENDMMSG
+}
+
+/**
+ * Sends the indicated TCP datagrams, preceded by their headers and by any
+ * data already queued on this connection, with a single writev().
+ */
+bool Connection::
+send_tcp_batch(const NetDatagram *const *datagrams, size_t count,
+               int tcp_header_size) {
+#ifdef HAVE_WRITEV
+  Socket_TCP *tcp;
+  DCAST_INTO_R(tcp, _socket, false);
+
+  LightReMutexHolder holder(_write_mutex);
+
+  // If the connection is compressed, the datagrams are compressed under the
+  // lock, so that they go through the stream in the order they are sent.
+  pvector<NetDatagram> compressed;
+  if (_compressor != nullptr) {
+    compressed.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+      if (!compress_datagram(*datagrams[i], compressed[i])) {
+        return check_send_error(false);
+      }
+    }
+  }
+
+  // The headers are packed together into one buffer, which must not be
+  // reallocated once the iovecs point into it.
+  vector_uchar header_data;
+  header_data.reserve(count * tcp_header_size);
+  for (size_t i = 0; i < count; ++i) {
+    const NetDatagram &datagram = compressed.empty() ? *datagrams[i] : compressed[i];
+    if (tcp_header_size == 2 && datagram.get_length() >= 0x10000) {
+      net_cat.error()
+        << "Attempt to send TCP datagram of " << datagram.get_length()
+        << " bytes--too long!\n";
+      nassert_raise("Datagram too long");
+      return false;
+    }
+
+    DatagramTCPHeader header(datagram, tcp_header_size);
+    CPTA_uchar data = header.get_array();
+    header_data.insert(header_data.end(), data.begin(), data.end());
+  }
+
+  pvector<struct iovec> iovs;
+  iovs.reserve(count * 2 + 1);
+  size_t total = 0;
+  if (!_queued_data.empty()) {
+    struct iovec iov;
+    iov.iov_base = _queued_data.data();
+    iov.iov_len = _queued_data.size();
+    iovs.push_back(iov);
+    total += iov.iov_len;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    struct iovec iov;
+    if (tcp_header_size > 0) {
+      iov.iov_base = header_data.data() + i * tcp_header_size;
+      iov.iov_len = tcp_header_size;
+      iovs.push_back(iov);
+    }
+    const NetDatagram &datagram = compressed.empty() ? *datagrams[i] : compressed[i];
+    iov.iov_base = (void *)datagram.get_data();
+    iov.iov_len = datagram.get_length();
+    iovs.push_back(iov);
+    total += tcp_header_size + iov.iov_len;
+    AtomicAdjust::add(_payload_bytes_sent, datagrams[i]->get_length());
+    AtomicAdjust::add(_wire_bytes_sent, tcp_header_size + iov.iov_len);
+    AtomicAdjust::inc(_datagrams_sent);
+  }
+
+  if (net_cat.is_spam()) {
+    net_cat.spam()
+      << "Sending " << _queued_count + count << " TCP datagram(s) with "
+      << total << " total bytes to " << (void *)this << "\n";
+  }
+
+  // writev() may write only part of the data, or be limited in the number of
+  // iovecs it accepts, so we may need several calls.
+  SOCKET fd = tcp->GetSocket();
+  size_t first = 0;
+  bool okflag = true;
+  while (first < iovs.size()) {
+    int num_iovs = (int)std::min(iovs.size() - first, (size_t)IOV_MAX);
+    ssize_t result = ::writev(fd, &iovs[first], num_iovs);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      okflag = false;
+      break;
+    }
+
+    // Skip past the iovecs that were written completely.
+    size_t written = (size_t)result;
+    while (first < iovs.size() && written >= iovs[first].iov_len) {
+      written -= iovs[first].iov_len;
+      ++first;
+    }
+    if (first < iovs.size()) {
+      iovs[first].iov_base = (char *)iovs[first].iov_base + written;
+      iovs[first].iov_len -= written;
+    }
+  }
+
+  _queued_data.clear();
+  _queued_count = 0;
+  _queued_data_start = TrueClock::get_global_ptr()->get_short_time();
+
+  return check_send_error(okflag);
+#else
+  return false;
+#endif  // HAVE_WRITEV
+}
+
+/**
+ * Compresses the indicated datagram into result.  This assumes the
+ * _write_mutex is already held, and that compression is enabled.
+ */
+bool Connection::
+compress_datagram(const NetDatagram &datagram, NetDatagram &result) {
+#ifdef HAVE_ZLIB
+  nassertr(_compressor != nullptr, false);
+  return _compressor->compress(datagram, result);
+#else
+  return false;
+#endif  // HAVE_ZLIB
+}
+
+/**
+ * This method is intended only to be called by ConnectionReader, for each
+ * datagram received on this connection.  It updates the received counts, and
+ * decompresses the datagram in-place if the connection is compressed and the
+ * datagram is not raw.  header_size is the number of header bytes that
+ * preceded the datagram on the wire.  Returns false if the datagram could not
+ * be decompressed, either because it is corrupt or because it would be larger
+ * than net-max-decompressed-size or the header allows; the reader should
+ * then close the connection, since the stream cannot be recovered.
+ *
+ * Since the datagrams of a compressed connection must be decompressed in the
+ * order they were sent, the reader must call this before it releases the
+ * socket to the next reader thread.
+ */
+bool Connection::
+decode_datagram(NetDatagram &datagram, int header_size, bool raw) {
+  AtomicAdjust::add(_wire_bytes_received, header_size + datagram.get_length());
+
+#ifdef HAVE_ZLIB
+  if (!raw) {
+    LightMutexHolder holder(_decompress_mutex);
+    if (_compressor != nullptr) {
+      size_t max_size = (size_t)std::max((int)net_max_decompressed_size, 0);
+      if (header_size > 0 && header_size < (int)sizeof(size_t)) {
+        max_size = std::min(max_size, ((size_t)1 << (header_size * 8)) - 1);
+      }
+      Datagram decompressed;
+      if (!_compressor->decompress(datagram, decompressed, max_size)) {
+        return false;
+      }
+      datagram.set_array(decompressed.modify_array());
+    }
+  }
+#endif  // HAVE_ZLIB
+
+  AtomicAdjust::add(_payload_bytes_received, datagram.get_length());
+  AtomicAdjust::inc(_datagrams_received);
+  return true;
+}
+
+/**
+ * This method is intended only to be called by ConnectionReader, when a pong
+ * frame comes back.  It folds the measured round-trip time, in seconds, into
+ * the smoothed estimate, in the manner of RFC 6298.
+ */
+void Connection::
+record_rtt(double rtt) {
+  LightMutexHolder holder(_rtt_lock);
+  if (_num_rtt_samples == 0) {
+    _rtt = rtt;
+    _rtt_variance = rtt * 0.5;
+    _min_rtt = rtt;
+  } else {
+    _rtt_variance = _rtt_variance * 0.75 + fabs(_rtt - rtt) * 0.25;
+    _rtt = _rtt * 0.875 + rtt * 0.125;
+    _min_rtt = std::min(_min_rtt, rtt);
+  }
+  _last_rtt = rtt;
+  ++_num_rtt_samples;
+}
+
+/**
+ * Fills the datagram with a ping frame, or the pong frame that answers it,
+ * carrying the indicated TrueClock time of the original ping.
+ */
+void Connection::
+make_ping_frame(NetDatagram &datagram, bool pong, double time) {
+  datagram.clear();
+  datagram.add_uint32(ping_frame_magic);
+  datagram.add_uint8(pong ? 1 : 0);
+  datagram.add_float64(time);
+}
+
+/**
+ * Returns true if the datagram is a ping or pong frame, and fills in pong and
+ * time accordingly.  See make_ping_frame().
+ */
+bool Connection::
+parse_ping_frame(const Datagram &datagram, bool &pong, double &time) {
+  if (datagram.get_length() != ping_frame_size) {
+    return false;
+  }
+  DatagramIterator scan(datagram);
+  if (scan.get_uint32() != ping_frame_magic) {
+    return false;
+  }
+  uint8_t type = scan.get_uint8();
+  if (type > 1) {
+    return false;
+  }
+  pong = (type != 0);
+  time = scan.get_float64();
+  return true;
+}
+
 /**
  * The private implementation of flush(), this assumes the _write_mutex is
  * already held.
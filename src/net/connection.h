@@ -18,11 +18,16 @@
 #include "referenceCount.h"
 #include "netAddress.h"
 #include "lightReMutex.h"
+#include "lightMutex.h"
+#include "atomicAdjust.h"
+#include "connectionStats.h"
 #include "vector_uchar.h"
 
 class Socket_IP;
 class ConnectionManager;
+class Datagram;
 class NetDatagram;
+class NetCompressor;
 
 /**
  * Represents a single TCP or UDP socket for input or output.
@@ -45,6 +50,16 @@ PUBLISHED:
   BLOCKING bool consider_flush();
   BLOCKING bool flush();
 
+  bool set_compression(int level, const vector_uchar &dictionary = vector_uchar());
+  int get_compression_level() const;
+
+  uint64_t get_payload_bytes_sent() const;
+  uint64_t get_wire_bytes_sent() const;
+  uint64_t get_payload_bytes_received() const;
+  uint64_t get_wire_bytes_received() const;
+
+  ConnectionStats get_stats() const;
+
   // Socket options.  void set_nonblock(bool flag);
   void set_linger(bool flag, double time);
   void set_reuse_addr(bool flag);
@@ -59,12 +74,26 @@ PUBLISHED:
 private:
   bool send_datagram(const NetDatagram &datagram, int tcp_header_size);
   bool send_raw_datagram(const NetDatagram &datagram);
+  bool send_datagrams(const NetDatagram *const *datagrams, size_t count,
+                      int tcp_header_size, bool raw);
+  bool send_udp_batch(const NetDatagram *const *datagrams, size_t count,
+                      bool raw);
+  bool send_tcp_batch(const NetDatagram *const *datagrams, size_t count,
+                      int tcp_header_size);
+  bool compress_datagram(const NetDatagram &datagram, NetDatagram &result);
+  bool decode_datagram(NetDatagram &datagram, int header_size, bool raw);
   bool do_flush();
   bool check_send_error(bool okflag);
 
+  void record_rtt(double rtt);
+
+  static void make_ping_frame(NetDatagram &datagram, bool pong, double time);
+  static bool parse_ping_frame(const Datagram &datagram, bool &pong,
+                               double &time);
+
   ConnectionManager *_manager;
   Socket_IP *_socket;
-  LightReMutex _write_mutex;
+  mutable LightReMutex _write_mutex;
 
   bool _collect_tcp;
   double _collect_tcp_interval;
@@ -72,6 +101,29 @@ private:
   vector_uchar _queued_data;
   int _queued_count;
 
+  // The compressor is used by the writing thread with _write_mutex held, and
+  // by the reading thread with _decompress_mutex held; replacing it requires
+  // both.
+  int _compression_level;
+  NetCompressor *_compressor;
+  LightMutex _decompress_mutex;
+
+  AtomicAdjust::Integer _payload_bytes_sent;
+  AtomicAdjust::Integer _wire_bytes_sent;
+  AtomicAdjust::Integer _payload_bytes_received;
+  AtomicAdjust::Integer _wire_bytes_received;
+  AtomicAdjust::Integer _datagrams_sent;
+  AtomicAdjust::Integer _datagrams_received;
+
+  // The round-trip time measured by ping frames.
+  mutable LightMutex _rtt_lock;
+  double _rtt;
+  double _rtt_variance;
+  double _min_rtt;
+  double _last_rtt;
+  int _num_rtt_samples;
+
+  friend class ConnectionReader;
   friend class ConnectionWriter;
 };
 
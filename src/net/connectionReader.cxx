@@ -15,6 +15,7 @@
 #include "dcast.h"
 #include "connectionManager.h"
 #include "netDatagram.h"
+#include "datagramBufferPool.h"
 #include "datagramTCPHeader.h"
 #include "datagramUDPHeader.h"
 #include "config_net.h"
@@ -27,10 +28,88 @@
 #include "atomicAdjust.h"
 #include "config_downloader.h"
 
+#ifdef HAVE_EPOLL_READER
+#include <sys/epoll.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+#ifdef HAVE_RECVMMSG
+#include <sys/socket.h>
+#include <string.h>
+#endif
+
 using std::min;
+using std::max;
 
 static const int read_buffer_size = maximum_udp_datagram + datagram_udp_header_size;
 
+// The number of UDP packets that may be read with a single system call.
+#ifdef HAVE_RECVMMSG
+static const int udp_batch_size = 16;
+#else
+static const int udp_batch_size = 1;
+#endif
+
+/**
+ * Reads as many UDP packets as are waiting on the socket, up to
+ * udp_batch_size, blocking only for the first.  Returns the number of packets
+ * read, which may be 0 if a zero-length packet was received, or -1 on error.
+ */
+static int
+recv_udp_batch(Socket_UDP *socket, char (*buffers)[read_buffer_size],
+               int *lengths, Socket_Address *addrs) {
+#ifdef HAVE_RECVMMSG
+  struct mmsghdr msgs[udp_batch_size];
+  struct iovec iovs[udp_batch_size];
+  for (int i = 0; i < udp_batch_size; ++i) {
+    iovs[i].iov_base = buffers[i];
+    iovs[i].iov_len = read_buffer_size;
+    memset(&msgs[i].msg_hdr, 0, sizeof(msgs[i].msg_hdr));
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+    msgs[i].msg_hdr.msg_name = &addrs[i].GetAddressInfo();
+    msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+  }
+
+  int num_msgs = recvmmsg(socket->GetSocket(), msgs, udp_batch_size,
+                          MSG_WAITFORONE, nullptr);
+  if (num_msgs < 0) {
+    // As in GetPacket(), a blocking error counts as a zero-length read.
+    return (socket->GetLastError() == LOCAL_BLOCKING_ERROR) ? 0 : -1;
+  }
+  for (int i = 0; i < num_msgs; ++i) {
+    lengths[i] = (int)msgs[i].msg_len;
+    if (lengths[i] == 0) {
+      return i;
+    }
+  }
+  return num_msgs;
+
+#else
+  lengths[0] = read_buffer_size;
+  if (!socket->GetPacket(buffers[0], &lengths[0], addrs[0])) {
+    return -1;
+  }
+  return (lengths[0] != 0) ? 1 : 0;
+#endif  // HAVE_RECVMMSG
+}
+
+/**
+ * Fills the datagram with a copy of the indicated bytes, stored in a buffer
+ * taken from the global DatagramBufferPool.
+ */
+static void
+fill_pooled_datagram(NetDatagram &datagram, const char *data, size_t size) {
+  PTA_uchar buffer = DatagramBufferPool::get_global_ptr()->get_buffer(size);
+  buffer.v().insert(buffer.v().end(), (const unsigned char *)data,
+                    (const unsigned char *)data + size);
+  datagram.set_array(std::move(buffer));
+}
+
 /**
  *
  */
@@ -40,6 +119,10 @@ SocketInfo(const PT(Connection) &connection) :
 {
   _busy = false;
   _error = false;
+  _shard = -1;
+  _removed = 0;
+  _header_bytes_read = 0;
+  _datagram_size = -1;
 }
 
 /**
@@ -104,6 +187,7 @@ ConnectionReader(ConnectionManager *manager, int num_threads,
 
   _raw_mode = false;
   _tcp_header_size = tcp_header_size;
+  _ping_frames = net_ping_frames;
   _polling = (num_threads <= 0);
 
   _shutdown = false;
@@ -113,10 +197,41 @@ ConnectionReader(ConnectionManager *manager, int num_threads,
 
   _currently_polling_thread = -1;
 
+  _use_epoll = false;
+#ifdef HAVE_EPOLL_READER
+  if (net_use_epoll) {
+    int num_shards = std::max(num_threads, 1);
+    _shards.reserve(num_shards);
+    for (int si = 0; si < num_shards; ++si) {
+      Shard shard;
+      shard._epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+      shard._num_sockets = 0;
+      if (shard._epoll_fd < 0) {
+        net_cat.warning()
+          << "Unable to create epoll instance, falling back to select().\n";
+        break;
+      }
+      _shards.push_back(shard);
+    }
+
+    if ((int)_shards.size() == num_shards) {
+      _use_epoll = true;
+    } else {
+      for (Shard &shard : _shards) {
+        close(shard._epoll_fd);
+      }
+      _shards.clear();
+    }
+  }
+#endif  // HAVE_EPOLL_READER
+
   std::string reader_thread_name = thread_name;
   if (thread_name.empty()) {
     reader_thread_name = "ReaderThread";
   }
+  _stats = new NetStats(reader_thread_name, NetStats::D_in);
+  _stats->register_stats();
+
   int i;
   for (i = 0; i < num_threads; i++) {
     PT(ReaderThread) thread = new ReaderThread(this, reader_thread_name, i);
@@ -139,6 +254,7 @@ ConnectionReader::
   }
 
   shutdown();
+  _stats->unregister_stats();
 
   // Delete all of our old sockets.
   Sockets::iterator si;
@@ -158,6 +274,15 @@ ConnectionReader::
       sinfo->_connection.clear();
     }
   }
+
+#ifdef HAVE_EPOLL_READER
+  for (Shard &shard : _shards) {
+    for (SocketInfo *sinfo : shard._removed_sockets) {
+      delete sinfo;
+    }
+    close(shard._epoll_fd);
+  }
+#endif  // HAVE_EPOLL_READER
 }
 
 /**
@@ -187,7 +312,36 @@ add_connection(Connection *connection) {
     }
   }
 
-  _sockets.push_back(new SocketInfo(connection));
+  SocketInfo *sinfo = new SocketInfo(connection);
+
+#ifdef HAVE_EPOLL_READER
+  if (_use_epoll) {
+    // Give the socket to the shard with the fewest sockets.
+    int shard_index = 0;
+    for (int i = 1; i < (int)_shards.size(); ++i) {
+      if (_shards[i]._num_sockets < _shards[shard_index]._num_sockets) {
+        shard_index = i;
+      }
+    }
+
+    // The socket is edge-triggered; drain_socket() reads it until it has no
+    // more data.  If data is already waiting, the kernel reports it at once.
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+    event.data.ptr = sinfo;
+    if (epoll_ctl(_shards[shard_index]._epoll_fd, EPOLL_CTL_ADD,
+                  sinfo->get_socket()->GetSocket(), &event) != 0) {
+      net_cat.error()
+        << "Unable to add socket to epoll instance.\n";
+      delete sinfo;
+      return false;
+    }
+    sinfo->_shard = shard_index;
+    _shards[shard_index]._num_sockets++;
+  }
+#endif  // HAVE_EPOLL_READER
+
+  _sockets.push_back(sinfo);
 
   return true;
 }
@@ -214,9 +368,25 @@ remove_connection(Connection *connection) {
     return false;
   }
 
-  _removed_sockets.push_back(*si);
+  SocketInfo *sinfo = (*si);
   _sockets.erase(si);
 
+#ifdef HAVE_EPOLL_READER
+  if (sinfo->_shard >= 0) {
+    // The socket may already appear in a batch of events that its thread has
+    // yet to process, so it is left to that thread to delete it.
+    Shard &shard = _shards[sinfo->_shard];
+    epoll_ctl(shard._epoll_fd, EPOLL_CTL_DEL,
+              sinfo->get_socket()->GetSocket(), nullptr);
+    AtomicAdjust::set(sinfo->_removed, 1);
+    shard._num_sockets--;
+    shard._removed_sockets.push_back(sinfo);
+    return true;
+  }
+#endif  // HAVE_EPOLL_READER
+
+  _removed_sockets.push_back(sinfo);
+
   return true;
 }
 
@@ -262,6 +432,24 @@ poll() {
     return;
   }
 
+#ifdef HAVE_EPOLL_READER
+  if (_use_epoll) {
+    delete_removed_sockets(0);
+
+    double max_poll_cycle = get_net_max_poll_cycle();
+    double stop = -1.0;
+    if (max_poll_cycle >= 0.0) {
+      stop = TrueClock::get_global_ptr()->get_short_time() + max_poll_cycle;
+    }
+    while (epoll_wait_shard(0, 0, stop) > 0) {
+      if (stop >= 0.0 && TrueClock::get_global_ptr()->get_short_time() >= stop) {
+        return;
+      }
+    }
+    return;
+  }
+#endif  // HAVE_EPOLL_READER
+
   SocketInfo *sinfo = get_next_available_socket(false, -2);
   if (sinfo != nullptr) {
     double max_poll_cycle = get_net_max_poll_cycle();
@@ -345,6 +533,32 @@ get_tcp_header_size() const {
   return _tcp_header_size;
 }
 
+/**
+ * Sets whether the reader answers and times ping frames.  If this is true, a
+ * ping frame sent by ConnectionWriter::send_ping() at the other end is
+ * answered at once with a pong, and a pong that comes back is used to update
+ * the round-trip time of the connection; see Connection::get_stats().  Ping
+ * frames are not passed on to receive_datagram().
+ *
+ * This should only be enabled if the other end uses ping frames too, since
+ * otherwise an ordinary datagram that happens to look like a ping frame
+ * would be swallowed.  It has no effect in raw mode.  The default is taken
+ * from net-ping-frames.
+ */
+void ConnectionReader::
+set_ping_frames(bool ping_frames) {
+  _ping_frames = ping_frames;
+}
+
+/**
+ * Returns the current setting of the ping frames flag.  See
+ * set_ping_frames().
+ */
+bool ConnectionReader::
+get_ping_frames() const {
+  return _ping_frames;
+}
+
 /**
  * Terminates all threads cleanly.  Normally this is only called by the
  * destructor, but it may be called explicitly before destruction.
@@ -452,19 +666,19 @@ bool ConnectionReader::
 process_incoming_udp_data(SocketInfo *sinfo) {
   Socket_UDP *socket;
   DCAST_INTO_R(socket, sinfo->get_socket(), false);
-  Socket_Address addr;
 
-  // Read as many bytes as we can.
-  char buffer[read_buffer_size];
-  int bytes_read = read_buffer_size;
+  // Read as many packets as are waiting, up to the batch size.
+  char buffers[udp_batch_size][read_buffer_size];
+  int lengths[udp_batch_size];
+  Socket_Address addrs[udp_batch_size];
 
-  bool okflag = socket->GetPacket(buffer, &bytes_read, addr);
+  int num_packets = recv_udp_batch(socket, buffers, lengths, addrs);
 
-  if (!okflag) {
+  if (num_packets < 0) {
     finish_socket(sinfo);
     return false;
 
-  } else if (bytes_read == 0) {
+  } else if (num_packets == 0) {
     // The socket was closed (!).  This shouldn't happen with a UDP
     // connection.  Oh well.  Report that and return.
     if (_manager != nullptr) {
@@ -474,48 +688,52 @@ process_incoming_udp_data(SocketInfo *sinfo) {
     return false;
   }
 
-  // Since we are not running in raw mode, we decode the header to determine
-  // how big the datagram is.  This means we must have read at least a full
-  // header.
-  if (bytes_read < datagram_udp_header_size) {
-    net_cat.error()
-      << "Did not read entire header, discarding UDP datagram.\n";
-    finish_socket(sinfo);
-    return true;
-  }
+  // Now that we've read all the data, it's time to finish the socket so
+  // another thread can read the next datagram.
+  finish_socket(sinfo);
 
-  DatagramUDPHeader header(buffer);
+  for (int i = 0; i < num_packets; ++i) {
+    if (_shutdown) {
+      return false;
+    }
 
-  char *dp = buffer + datagram_udp_header_size;
-  bytes_read -= datagram_udp_header_size;
+    // Since we are not running in raw mode, we decode the header to
+    // determine how big the datagram is.  This means we must have read at
+    // least a full header.
+    int bytes_read = lengths[i];
+    if (bytes_read < datagram_udp_header_size) {
+      net_cat.error()
+        << "Did not read entire header, discarding UDP datagram.\n";
+      continue;
+    }
 
-  NetDatagram datagram(dp, bytes_read);
+    DatagramUDPHeader header(buffers[i]);
 
-  // Now that we've read all the data, it's time to finish the socket so
-  // another thread can read the next datagram.
-  finish_socket(sinfo);
+    char *dp = buffers[i] + datagram_udp_header_size;
+    bytes_read -= datagram_udp_header_size;
 
-  if (_shutdown) {
-    return false;
-  }
+    NetDatagram datagram;
+    fill_pooled_datagram(datagram, dp, bytes_read);
 
-  // And now do whatever we need to do to process the datagram.
-  if (!header.verify_datagram(datagram)) {
-    net_cat.error()
-      << "Ignoring invalid UDP datagram.\n";
-  } else {
-    datagram.set_connection(sinfo->_connection);
-    datagram.set_address(NetAddress(addr));
+    // And now do whatever we need to do to process the datagram.
+    if (!header.verify_datagram(datagram)) {
+      net_cat.error()
+        << "Ignoring invalid UDP datagram.\n";
+    } else {
+      sinfo->_connection->decode_datagram(datagram, datagram_udp_header_size, false);
+      datagram.set_connection(sinfo->_connection);
+      datagram.set_address(NetAddress(addrs[i]));
+
+      if (net_cat.is_spam()) {
+        net_cat.spam()
+          << "Received UDP datagram with "
+          << datagram_udp_header_size + datagram.get_length()
+          << " bytes on " << (void *)datagram.get_connection()
+          << " from " << datagram.get_address() << "\n";
+      }
 
-    if (net_cat.is_spam()) {
-      net_cat.spam()
-        << "Received UDP datagram with "
-        << datagram_udp_header_size + datagram.get_length()
-        << " bytes on " << (void *)datagram.get_connection()
-        << " from " << datagram.get_address() << "\n";
+      dispatch_datagram(datagram, datagram_udp_header_size);
     }
-
-    receive_datagram(datagram);
   }
 
   return true;
@@ -573,34 +791,35 @@ process_incoming_tcp_data(SocketInfo *sinfo) {
   DatagramTCPHeader header(buffer, _tcp_header_size);
   int size = header.get_datagram_size(_tcp_header_size);
 
-  // We have to loop until the entire datagram is read.
-  NetDatagram datagram;
+  // We have to loop until the entire datagram is read.  The data is read
+  // directly into a buffer from the pool.  We don't trust the header enough to
+  // allocate the whole size up front, though; the buffer only grows as the
+  // data actually arrives.
+  PTA_uchar data = DatagramBufferPool::get_global_ptr()->
+    get_buffer(max(min(size, read_buffer_size), 0));
+  int bytes_so_far = 0;
 
-  while (!_shutdown && (int)datagram.get_length() < size) {
+  while (!_shutdown && bytes_so_far < size) {
     int bytes_read;
 
-    int read_bytes = read_buffer_size;
+    int read_bytes = min(read_buffer_size, size - bytes_so_far);
 #ifdef SIMPLE_THREADS
     // In the SIMPLE_THREADS case, we want to limit the number of bytes we
     // read in a single epoch, to minimize the impact on the other threads.
-    read_bytes = min(read_buffer_size, (int)net_max_read_per_epoch);
+    read_bytes = min(read_bytes, (int)net_max_read_per_epoch);
 #endif
 
-    bytes_read =
-      socket->RecvData(buffer, min(read_bytes,
-                                   (int)(size - datagram.get_length())));
+    data.v().resize(bytes_so_far + read_bytes);
+    char *dp = (char *)data.p() + bytes_so_far;
+    bytes_read = socket->RecvData(dp, read_bytes);
 #if defined(HAVE_THREADS) && defined(SIMPLE_THREADS)
     while (bytes_read < 0 && socket->GetLastError() == LOCAL_BLOCKING_ERROR &&
            socket->Active()) {
       Thread::force_yield();
-      bytes_read =
-        socket->RecvData(buffer, min(read_bytes,
-                                     (int)(size - datagram.get_length())));
+      bytes_read = socket->RecvData(dp, read_bytes);
     }
 #endif  // SIMPLE_THREADS
 
-    char *dp = buffer;
-
     if (bytes_read <= 0) {
       // The socket was closed.  Report that and return.
       if (_manager != nullptr) {
@@ -610,20 +829,20 @@ process_incoming_tcp_data(SocketInfo *sinfo) {
       return false;
     }
 
-    int datagram_bytes =
-      min(bytes_read, (int)(size - datagram.get_length()));
-    datagram.append_data(dp, datagram_bytes);
-
-    if (bytes_read > datagram_bytes) {
-      // There were some extra bytes at the end of the datagram.  Maybe the
-      // beginning of the next datagram?  Huh.
-      net_cat.error()
-        << "Discarding " << bytes_read - datagram_bytes
-        << " bytes following TCP datagram.\n";
-    }
+    bytes_so_far += bytes_read;
+    data.v().resize(bytes_so_far);
     Thread::consider_yield();
   }
 
+  NetDatagram datagram;
+  datagram.set_array(std::move(data));
+
+  // The datagram must be decompressed before another thread can read the
+  // next one, since the decompression depends on what came before.
+  bool valid = header.verify_datagram(datagram, _tcp_header_size);
+  bool decoded = valid &&
+    sinfo->_connection->decode_datagram(datagram, _tcp_header_size, false);
+
   // Now that we've read all the data, it's time to finish the socket so
   // another thread can read the next datagram.
   finish_socket(sinfo);
@@ -632,8 +851,19 @@ process_incoming_tcp_data(SocketInfo *sinfo) {
     return false;
   }
 
+  if (valid && !decoded) {
+    // The decompression stream is now out of step with the other end, so
+    // there is no going on with this connection.
+    net_cat.error()
+      << "Could not decompress TCP datagram; closing connection.\n";
+    if (_manager != nullptr) {
+      _manager->connection_reset(sinfo->_connection, 0);
+    }
+    return false;
+  }
+
   // And now do whatever we need to do to process the datagram.
-  if (!header.verify_datagram(datagram, _tcp_header_size)) {
+  if (!valid) {
     net_cat.error()
       << "Ignoring invalid TCP datagram.\n";
   } else {
@@ -648,7 +878,7 @@ process_incoming_tcp_data(SocketInfo *sinfo) {
         << " from " << datagram.get_address() << "\n";
     }
 
-    receive_datagram(datagram);
+    dispatch_datagram(datagram, _tcp_header_size);
   }
 
   return true;
@@ -661,19 +891,19 @@ bool ConnectionReader::
 process_raw_incoming_udp_data(SocketInfo *sinfo) {
   Socket_UDP *socket;
   DCAST_INTO_R(socket, sinfo->get_socket(), false);
-  Socket_Address addr;
 
-  // Read as many bytes as we can.
-  char buffer[read_buffer_size];
-  int bytes_read = read_buffer_size;
+  // Read as many packets as are waiting, up to the batch size.
+  char buffers[udp_batch_size][read_buffer_size];
+  int lengths[udp_batch_size];
+  Socket_Address addrs[udp_batch_size];
 
-  bool okflag = socket->GetPacket(buffer, &bytes_read, addr);
+  int num_packets = recv_udp_batch(socket, buffers, lengths, addrs);
 
-  if (!okflag) {
+  if (num_packets < 0) {
     finish_socket(sinfo);
     return false;
 
-  } else if (bytes_read == 0) {
+  } else if (num_packets == 0) {
     // The socket was closed (!).  This shouldn't happen with a UDP
     // connection.  Oh well.  Report that and return.
     if (_manager != nullptr) {
@@ -683,28 +913,31 @@ process_raw_incoming_udp_data(SocketInfo *sinfo) {
     return false;
   }
 
-  // In raw mode, we simply extract all the bytes and make that a datagram.
-  NetDatagram datagram(buffer, bytes_read);
-
   // Now that we've read all the data, it's time to finish the socket so
   // another thread can read the next datagram.
   finish_socket(sinfo);
 
-  if (_shutdown) {
-    return false;
-  }
+  for (int i = 0; i < num_packets; ++i) {
+    if (_shutdown) {
+      return false;
+    }
 
-  datagram.set_connection(sinfo->_connection);
-  datagram.set_address(NetAddress(addr));
+    // In raw mode, we simply extract all the bytes and make that a datagram.
+    NetDatagram datagram;
+    fill_pooled_datagram(datagram, buffers[i], lengths[i]);
+    sinfo->_connection->decode_datagram(datagram, 0, true);
+    datagram.set_connection(sinfo->_connection);
+    datagram.set_address(NetAddress(addrs[i]));
 
-  if (net_cat.is_spam()) {
-    net_cat.spam()
-      << "Received raw UDP datagram with " << datagram.get_length()
-      << " bytes on " << (void *)datagram.get_connection()
-      << " from " << datagram.get_address() << "\n";
-  }
+    if (net_cat.is_spam()) {
+      net_cat.spam()
+        << "Received raw UDP datagram with " << datagram.get_length()
+        << " bytes on " << (void *)datagram.get_connection()
+        << " from " << datagram.get_address() << "\n";
+    }
 
-  receive_datagram(datagram);
+    dispatch_datagram(datagram, 0);
+  }
 
   return true;
 }
@@ -738,7 +971,9 @@ process_raw_incoming_tcp_data(SocketInfo *sinfo) {
   }
 
   // In raw mode, we simply extract all the bytes and make that a datagram.
-  NetDatagram datagram(buffer, bytes_read);
+  NetDatagram datagram;
+  fill_pooled_datagram(datagram, buffer, bytes_read);
+  sinfo->_connection->decode_datagram(datagram, 0, true);
 
   // Now that we've read all the data, it's time to finish the socket so
   // another thread can read the next datagram.
@@ -758,11 +993,44 @@ process_raw_incoming_tcp_data(SocketInfo *sinfo) {
       << " from " << datagram.get_address() << "\n";
   }
 
-  receive_datagram(datagram);
+  dispatch_datagram(datagram, 0);
 
   return true;
 }
 
+/**
+ * Counts the indicated datagram, which arrived with header_size bytes of
+ * header, and passes it on to receive_datagram().  Ping frames are handled
+ * here instead, if they are enabled.
+ */
+void ConnectionReader::
+dispatch_datagram(NetDatagram &datagram, int header_size) {
+  _stats->add_datagram(header_size + datagram.get_length());
+
+  bool pong;
+  double time;
+  if (_ping_frames && !_raw_mode &&
+      Connection::parse_ping_frame(datagram, pong, time)) {
+    Connection *connection = datagram.get_connection();
+    if (pong) {
+      connection->record_rtt(TrueClock::get_global_ptr()->get_short_time() - time);
+    } else {
+      // Send the pong straight back, skipping any writer's queue, so that it
+      // measures only the time on the network.
+      NetDatagram reply;
+      Connection::make_ping_frame(reply, true, time);
+      reply.set_connection(connection);
+      reply.set_address(datagram.get_address());
+      if (connection->send_datagram(reply, _tcp_header_size)) {
+        connection->flush();
+      }
+    }
+    return;
+  }
+
+  receive_datagram(datagram);
+}
+
 /**
  * This is the actual executing function for each thread.
  */
@@ -771,6 +1039,11 @@ thread_run(int thread_index) {
   nassertv(!_polling);
   nassertv(_threads[thread_index] == Thread::get_current_thread());
 
+  if (_use_epoll) {
+    epoll_thread_run(thread_index);
+    return;
+  }
+
   while (!_shutdown) {
     SocketInfo *sinfo =
       get_next_available_socket(true, thread_index);
@@ -847,7 +1120,9 @@ get_next_available_socket(bool allow_block, int current_thread_index) {
         timeout = 0;
 #endif
 
+        double start = TrueClock::get_global_ptr()->get_short_time();
         _num_results = _fdset.WaitForRead(false, timeout);
+        _stats->add_wait_time(TrueClock::get_global_ptr()->get_short_time() - start);
       }
 
       if (_num_results == 0 && allow_block) {
@@ -925,3 +1200,247 @@ accumulate_fdset(Socket_fdset &fdset) {
     }
   }
 }
+
+/**
+ * This is the executing function for each thread when the epoll backend is in
+ * use.  Each thread waits only on the sockets of its own shard.
+ */
+void ConnectionReader::
+epoll_thread_run(int shard_index) {
+  int timeout_ms = (int)(get_net_max_block() * 1000.0);
+  while (!_shutdown) {
+    delete_removed_sockets(shard_index);
+    if (epoll_wait_shard(shard_index, timeout_ms, -1.0) < 0) {
+      Thread::force_yield();
+    }
+  }
+}
+
+/**
+ * Waits up to timeout_ms milliseconds for activity on the sockets of the
+ * indicated shard, and reads all the data available on the sockets that
+ * report some.  If stop is not negative, gives up reading further sockets
+ * once the TrueClock passes that time; the remaining sockets are picked up
+ * by the next call, since their data stays in the kernel's buffers.
+ *
+ * Returns the number of sockets that reported activity, or -1 on error.
+ */
+int ConnectionReader::
+epoll_wait_shard(int shard_index, int timeout_ms, double stop) {
+#ifdef HAVE_EPOLL_READER
+  static const int max_events = 256;
+  struct epoll_event events[max_events];
+
+  TrueClock *global_clock = TrueClock::get_global_ptr();
+  double start = global_clock->get_short_time();
+  int num_events = epoll_wait(_shards[shard_index]._epoll_fd, events,
+                              max_events, timeout_ms);
+  _stats->add_wait_time(global_clock->get_short_time() - start);
+  if (num_events < 0) {
+    if (errno != EINTR) {
+      net_cat.error()
+        << "epoll_wait failed: " << strerror(errno) << "\n";
+      return -1;
+    }
+    return 0;
+  }
+
+  for (int i = 0; i < num_events && !_shutdown; ++i) {
+    SocketInfo *sinfo = (SocketInfo *)events[i].data.ptr;
+    if (!AtomicAdjust::get(sinfo->_removed)) {
+      drain_socket(sinfo);
+    }
+    if (stop >= 0.0 && global_clock->get_short_time() >= stop) {
+      // The sockets we didn't get to would not be reported again, since they
+      // are edge-triggered.  Modifying them makes the kernel check them
+      // again, so they will be returned by the next call.
+      LightMutexHolder holder(_sockets_mutex);
+      for (++i; i < num_events; ++i) {
+        sinfo = (SocketInfo *)events[i].data.ptr;
+        if (!AtomicAdjust::get(sinfo->_removed)) {
+          struct epoll_event event;
+          event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+          event.data.ptr = sinfo;
+          epoll_ctl(_shards[shard_index]._epoll_fd, EPOLL_CTL_MOD,
+                    sinfo->get_socket()->GetSocket(), &event);
+        }
+      }
+      break;
+    }
+  }
+  return num_events;
+#else
+  return -1;
+#endif  // HAVE_EPOLL_READER
+}
+
+/**
+ * Reads datagrams from the indicated socket until there is no more data
+ * waiting on it, as required by the edge-triggered epoll backend.  Returns
+ * false if the connection was closed or had an error.
+ *
+ * Since each shard has only one thread, this must never wait for data that
+ * has not arrived yet, or one slow client would hold up all of the others on
+ * the shard.  A TCP datagram that has only partly arrived is kept with the
+ * socket until the rest of it does.
+ */
+bool ConnectionReader::
+drain_socket(SocketInfo *sinfo) {
+#ifdef HAVE_EPOLL_READER
+  if (!_raw_mode && _tcp_header_size != 0 && !sinfo->is_udp()) {
+    sinfo->_busy = true;
+    bool okflag = read_available_tcp_data(sinfo);
+    finish_socket(sinfo);
+    return okflag;
+  }
+
+  // The remaining kinds of socket are only read once poll() reports that
+  // they have something, and then read only what is there.
+  struct pollfd pfd;
+  pfd.fd = sinfo->get_socket()->GetSocket();
+  pfd.events = POLLIN;
+
+  while (!_shutdown && !AtomicAdjust::get(sinfo->_removed)) {
+    sinfo->_busy = true;
+    if (!process_incoming_data(sinfo)) {
+      return false;
+    }
+
+    // The sockets are in blocking mode, so check that there is more to read
+    // before we go back for it.
+    pfd.revents = 0;
+    if (::poll(&pfd, 1, 0) <= 0 || (pfd.revents & (POLLIN | POLLHUP | POLLERR)) == 0) {
+      return true;
+    }
+    Thread::consider_yield();
+  }
+#endif  // HAVE_EPOLL_READER
+  return true;
+}
+
+/**
+ * The implementation of drain_socket() for TCP sockets with a datagram
+ * header.  Reads whatever the socket has waiting without blocking, and
+ * dispatches each datagram as soon as all of it is in.  Returns true when
+ * there is nothing more to read for now, or false if the connection was
+ * closed.
+ */
+bool ConnectionReader::
+read_available_tcp_data(SocketInfo *sinfo) {
+#ifdef HAVE_EPOLL_READER
+  Socket_TCP *socket;
+  DCAST_INTO_R(socket, sinfo->get_socket(), false);
+  int fd = socket->GetSocket();
+
+  while (!_shutdown && !AtomicAdjust::get(sinfo->_removed)) {
+    if (sinfo->_datagram_size >= 0 &&
+        (int)sinfo->_partial.size() == sinfo->_datagram_size) {
+      // We have a whole datagram.
+      NetDatagram datagram;
+      datagram.set_array(std::move(sinfo->_partial));
+      sinfo->_partial.clear();
+      sinfo->_header_bytes_read = 0;
+      sinfo->_datagram_size = -1;
+
+      if (!sinfo->_connection->decode_datagram(datagram, _tcp_header_size, false)) {
+        net_cat.error()
+          << "Could not decompress TCP datagram; closing connection.\n";
+        if (_manager != nullptr) {
+          _manager->connection_reset(sinfo->_connection, 0);
+        }
+        return false;
+      }
+
+      datagram.set_connection(sinfo->_connection);
+      datagram.set_address(NetAddress(socket->GetPeerName()));
+
+      if (net_cat.is_spam()) {
+        net_cat.spam()
+          << "Received TCP datagram with "
+          << _tcp_header_size + datagram.get_length()
+          << " bytes on " << (void *)datagram.get_connection()
+          << " from " << datagram.get_address() << "\n";
+      }
+
+      dispatch_datagram(datagram, _tcp_header_size);
+      Thread::consider_yield();
+      continue;
+    }
+
+    // Read the rest of the header, or as much of the body as fits in the
+    // buffer.  As in process_incoming_tcp_data(), the buffer only grows as
+    // the data actually arrives.
+    char *dest;
+    int want;
+    size_t have = 0;
+    if (sinfo->_datagram_size < 0) {
+      dest = (char *)sinfo->_header + sinfo->_header_bytes_read;
+      want = _tcp_header_size - sinfo->_header_bytes_read;
+    } else {
+      have = sinfo->_partial.size();
+      want = min(read_buffer_size, sinfo->_datagram_size - (int)have);
+      sinfo->_partial.v().resize(have + want);
+      dest = (char *)sinfo->_partial.p() + have;
+    }
+
+    ssize_t bytes_read = ::recv(fd, dest, want, MSG_DONTWAIT);
+    if (sinfo->_datagram_size >= 0) {
+      sinfo->_partial.v().resize(have + max(bytes_read, (ssize_t)0));
+    }
+
+    if (bytes_read < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // That's all there is for now.  The socket is edge-triggered, so
+        // we'll hear about it again when more arrives.
+        return true;
+      }
+    }
+    if (bytes_read <= 0) {
+      // The socket was closed, or failed.  Report that and return.
+      if (_manager != nullptr) {
+        _manager->connection_reset(sinfo->_connection, 0);
+      }
+      return false;
+    }
+
+    if (sinfo->_datagram_size < 0) {
+      sinfo->_header_bytes_read += (int)bytes_read;
+      if (sinfo->_header_bytes_read == _tcp_header_size) {
+        DatagramTCPHeader header(sinfo->_header, _tcp_header_size);
+        int size = header.get_datagram_size(_tcp_header_size);
+        if (size < 0) {
+          net_cat.error()
+            << "Invalid TCP datagram size " << size << "; closing connection.\n";
+          if (_manager != nullptr) {
+            _manager->connection_reset(sinfo->_connection, 0);
+          }
+          return false;
+        }
+        sinfo->_datagram_size = size;
+        sinfo->_partial = DatagramBufferPool::get_global_ptr()->
+          get_buffer(min(size, read_buffer_size));
+      }
+    }
+  }
+#endif  // HAVE_EPOLL_READER
+  return true;
+}
+
+/**
+ * Deletes the sockets that have been removed from the indicated shard.  This
+ * must only be called by the thread that waits on that shard, in between
+ * calls to epoll_wait_shard().
+ */
+void ConnectionReader::
+delete_removed_sockets(int shard_index) {
+  LightMutexHolder holder(_sockets_mutex);
+  Sockets &removed = _shards[shard_index]._removed_sockets;
+  for (SocketInfo *sinfo : removed) {
+    nassertd(!sinfo->_busy) continue;
+    delete sinfo;
+  }
+  removed.clear();
+}
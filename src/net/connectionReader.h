@@ -17,6 +17,7 @@
 #include "pandabase.h"
 
 #include "connection.h"
+#include "netStats.h"
 
 #include "pointerTo.h"
 #include "pmutex.h"
@@ -25,6 +26,14 @@
 #include "pset.h"
 #include "socket_fdset.h"
 #include "atomicAdjust.h"
+#include "pta_uchar.h"
+
+// On Linux, each reader thread waits on its own epoll instance instead of
+// sharing a select() call.  This does not apply with SIMPLE_THREADS, which
+// never blocks in the kernel.
+#if defined(IS_LINUX) && !(defined(HAVE_THREADS) && defined(SIMPLE_THREADS))
+#define HAVE_EPOLL_READER 1
+#endif
 
 class NetDatagram;
 class ConnectionManager;
@@ -72,6 +81,7 @@ PUBLISHED:
 
   ConnectionManager *get_manager() const;
   INLINE bool is_polling() const;
+  INLINE bool is_using_epoll() const;
   int get_num_threads() const;
 
   void set_raw_mode(bool mode);
@@ -80,6 +90,11 @@ PUBLISHED:
   void set_tcp_header_size(int tcp_header_size);
   int get_tcp_header_size() const;
 
+  void set_ping_frames(bool ping_frames);
+  bool get_ping_frames() const;
+
+  INLINE NetStats *get_stats() const;
+
   void shutdown();
 
 protected:
@@ -95,6 +110,20 @@ protected:
     PT(Connection) _connection;
     bool _busy;
     bool _error;
+
+    // The index of the epoll shard that monitors this socket, or -1 if the
+    // select() backend is in use.  _removed is set by remove_connection(),
+    // while the shard's thread may be reading the socket.
+    int _shard;
+    AtomicAdjust::Integer _removed;
+
+    // With the epoll backend, a TCP datagram is read a piece at a time, as
+    // it arrives; this is the part of it received so far.  _datagram_size is
+    // -1 while the header is still incomplete.
+    unsigned char _header[4];
+    int _header_bytes_read;
+    int _datagram_size;
+    PTA_uchar _partial;
   };
   typedef pvector<SocketInfo *> Sockets;
 
@@ -109,6 +138,7 @@ protected:
 
 protected:
   ConnectionManager *_manager;
+  PT(NetStats) _stats;
 
   // These structures track the total set of sockets (connections) we know
   // about.
@@ -121,6 +151,7 @@ protected:
 
 private:
   void thread_run(int thread_index);
+  void dispatch_datagram(NetDatagram &datagram, int header_size);
 
   SocketInfo *get_next_available_socket(bool allow_block,
                                         int current_thread_index);
@@ -128,9 +159,16 @@ private:
   void rebuild_select_list();
   void accumulate_fdset(Socket_fdset &fdset);
 
+  void epoll_thread_run(int shard_index);
+  int epoll_wait_shard(int shard_index, int timeout_ms, double stop);
+  bool drain_socket(SocketInfo *sinfo);
+  bool read_available_tcp_data(SocketInfo *sinfo);
+  void delete_removed_sockets(int shard_index);
+
 private:
   bool _raw_mode;
   int _tcp_header_size;
+  bool _ping_frames;
   bool _shutdown;
 
   class ReaderThread : public Thread {
@@ -162,6 +200,21 @@ private:
   // thread is so waiting.
   AtomicAdjust::Integer _currently_polling_thread;
 
+  // With the epoll backend, the sockets are divided over a number of shards,
+  // one per thread (or a single one for a polling reader).  Each shard has
+  // its own epoll instance, which is waited on only by its own thread, so a
+  // socket is only ever read by one thread.  The lists are protected by
+  // _sockets_mutex.
+  class Shard {
+  public:
+    int _epoll_fd;
+    int _num_sockets;
+    Sockets _removed_sockets;
+  };
+  typedef pvector<Shard> Shards;
+  Shards _shards;
+  bool _use_epoll;
+
   friend class ConnectionManager;
   friend class ReaderThread;
 };
@@ -0,0 +1,72 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file connectionStats.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "connectionStats.h"
+#include "indent.h"
+
+/**
+ *
+ */
+ConnectionStats::
+ConnectionStats() :
+  _payload_bytes_sent(0),
+  _wire_bytes_sent(0),
+  _datagrams_sent(0),
+  _payload_bytes_received(0),
+  _wire_bytes_received(0),
+  _datagrams_received(0),
+  _rtt(0.0),
+  _rtt_variance(0.0),
+  _min_rtt(0.0),
+  _last_rtt(0.0),
+  _num_rtt_samples(0),
+  _send_queued_bytes(0),
+  _send_buffer_bytes(-1),
+  _send_buffer_size(-1)
+{
+}
+
+/**
+ *
+ */
+void ConnectionStats::
+output(std::ostream &out) const {
+  out << _datagrams_sent << " datagrams sent, " << _datagrams_received
+      << " received";
+  if (has_rtt()) {
+    out << ", rtt " << _rtt * 1000.0 << " ms";
+  }
+}
+
+/**
+ *
+ */
+void ConnectionStats::
+write(std::ostream &out, int indent_level) const {
+  indent(out, indent_level)
+    << "sent " << _datagrams_sent << " datagrams, " << _payload_bytes_sent
+    << " bytes (" << _wire_bytes_sent << " on the wire)\n";
+  indent(out, indent_level)
+    << "received " << _datagrams_received << " datagrams, "
+    << _payload_bytes_received << " bytes (" << _wire_bytes_received
+    << " on the wire)\n";
+  if (has_rtt()) {
+    indent(out, indent_level)
+      << "rtt " << _rtt * 1000.0 << " ms +/- " << _rtt_variance * 1000.0
+      << ", min " << _min_rtt * 1000.0 << ", last " << _last_rtt * 1000.0
+      << " (" << _num_rtt_samples << " samples)\n";
+  }
+  indent(out, indent_level)
+    << "send buffer " << _send_buffer_bytes << " / " << _send_buffer_size
+    << " bytes, " << _send_queued_bytes << " bytes held back\n";
+}
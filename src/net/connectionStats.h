@@ -0,0 +1,90 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file connectionStats.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef CONNECTIONSTATS_H
+#define CONNECTIONSTATS_H
+
+#include "pandabase.h"
+#include "numeric_types.h"
+
+class Connection;
+
+/**
+ * A snapshot of the traffic and latency of a single Connection, as returned
+ * by Connection::get_stats().
+ *
+ * The round-trip time is only measured if ping frames are exchanged on the
+ * connection; see ConnectionWriter::send_ping().  It is smoothed in the same
+ * way as TCP smooths its own estimate.
+ */
+class EXPCL_PANDA_NET ConnectionStats {
+PUBLISHED:
+  ConnectionStats();
+
+  INLINE uint64_t get_payload_bytes_sent() const;
+  INLINE uint64_t get_wire_bytes_sent() const;
+  INLINE uint64_t get_datagrams_sent() const;
+  INLINE uint64_t get_payload_bytes_received() const;
+  INLINE uint64_t get_wire_bytes_received() const;
+  INLINE uint64_t get_datagrams_received() const;
+
+  INLINE bool has_rtt() const;
+  INLINE double get_rtt() const;
+  INLINE double get_rtt_variance() const;
+  INLINE double get_min_rtt() const;
+  INLINE double get_last_rtt() const;
+  INLINE int get_num_rtt_samples() const;
+
+  INLINE int get_send_queued_bytes() const;
+  INLINE int get_send_buffer_bytes() const;
+  INLINE int get_send_buffer_size() const;
+
+  void output(std::ostream &out) const;
+  void write(std::ostream &out, int indent_level = 0) const;
+
+  MAKE_PROPERTY(datagrams_sent, get_datagrams_sent);
+  MAKE_PROPERTY(datagrams_received, get_datagrams_received);
+  MAKE_PROPERTY2(rtt, has_rtt, get_rtt);
+  MAKE_PROPERTY(send_queued_bytes, get_send_queued_bytes);
+  MAKE_PROPERTY(send_buffer_bytes, get_send_buffer_bytes);
+  MAKE_PROPERTY(send_buffer_size, get_send_buffer_size);
+
+private:
+  uint64_t _payload_bytes_sent;
+  uint64_t _wire_bytes_sent;
+  uint64_t _datagrams_sent;
+  uint64_t _payload_bytes_received;
+  uint64_t _wire_bytes_received;
+  uint64_t _datagrams_received;
+
+  double _rtt;
+  double _rtt_variance;
+  double _min_rtt;
+  double _last_rtt;
+  int _num_rtt_samples;
+
+  int _send_queued_bytes;
+  int _send_buffer_bytes;
+  int _send_buffer_size;
+
+  friend class Connection;
+};
+
+INLINE std::ostream &operator << (std::ostream &out, const ConnectionStats &stats) {
+  stats.output(out);
+  return out;
+}
+
+#include "connectionStats.I"
+
+#endif
@@ -14,12 +14,16 @@
 #include "connectionWriter.h"
 #include "connectionManager.h"
 #include "datagramTCPHeader.h"
+#include "datagramUDPHeader.h"
+#include "trueClock.h"
 #include "config_net.h"
 #include "socket_tcp.h"
 #include "socket_udp.h"
 #include "pnotify.h"
 #include "config_downloader.h"
 
+#include <algorithm>
+
 /**
  *
  */
@@ -74,6 +78,9 @@ ConnectionWriter(ConnectionManager *manager, int num_threads,
   if (thread_name.empty()) {
     writer_thread_name = "WriterThread";
   }
+  _stats = new NetStats(writer_thread_name, NetStats::D_out);
+  _stats->register_stats();
+
   int i;
   for (i = 0; i < num_threads; i++) {
     PT(WriterThread) thread = new WriterThread(this, writer_thread_name, i);
@@ -96,6 +103,7 @@ ConnectionWriter::
   }
 
   shutdown();
+  _stats->unregister_stats();
 }
 
 /**
@@ -149,13 +157,20 @@ send(const Datagram &datagram, const PT(Connection) &connection, bool block) {
   copy.set_connection(connection);
 
   if (_immediate) {
+    bool okflag;
     if (_raw_mode) {
-      return connection->send_raw_datagram(copy);
+      okflag = connection->send_raw_datagram(copy);
     } else {
-      return connection->send_datagram(copy, _tcp_header_size);
+      okflag = connection->send_datagram(copy, _tcp_header_size);
+    }
+    if (okflag) {
+      count_sent(copy);
     }
+    return okflag;
   } else {
-    return _queue.insert(copy, block);
+    bool okflag = _queue.insert(std::move(copy), block);
+    _stats->note_queue_size(_queue.get_current_queue_size());
+    return okflag;
   }
 }
 
@@ -193,14 +208,70 @@ send(const Datagram &datagram, const PT(Connection) &connection,
   copy.set_address(address);
 
   if (_immediate) {
+    bool okflag;
     if (_raw_mode) {
-      return connection->send_raw_datagram(copy);
+      okflag = connection->send_raw_datagram(copy);
     } else {
-      return connection->send_datagram(copy, _tcp_header_size);
+      okflag = connection->send_datagram(copy, _tcp_header_size);
     }
+    if (okflag) {
+      count_sent(copy);
+    }
+    return okflag;
   } else {
-    return _queue.insert(copy, block);
+    bool okflag = _queue.insert(std::move(copy), block);
+    _stats->note_queue_size(_queue.get_current_queue_size());
+    return okflag;
+  }
+}
+
+/**
+ * Sends a ping frame on the indicated TCP connection.  If the
+ * ConnectionReader at the other end has ping frames enabled, it answers with
+ * a pong frame, and when that arrives, the ConnectionReader at this end uses
+ * it to update the round-trip time reported by Connection::get_stats().  See
+ * ConnectionReader::set_ping_frames().
+ *
+ * The ping is written to the socket at once, even by a threaded writer, so
+ * that the time spent on the writer's queue is not counted.  Returns true if
+ * it was sent.  Ping frames may not be sent in raw mode.
+ */
+bool ConnectionWriter::
+send_ping(const PT(Connection) &connection) {
+  nassertr(!_shutdown && !_raw_mode, false);
+  nassertr(connection != nullptr, false);
+  nassertr(connection->get_socket()->is_exact_type(Socket_TCP::get_class_type()), false);
+
+  NetDatagram ping;
+  Connection::make_ping_frame(ping, false, TrueClock::get_global_ptr()->get_short_time());
+  ping.set_connection(connection);
+  if (!connection->send_datagram(ping, _tcp_header_size) ||
+      !connection->flush()) {
+    return false;
+  }
+  count_sent(ping);
+  return true;
+}
+
+/**
+ * Sends a ping frame on the indicated UDP connection, to the indicated
+ * address.  See the above method.
+ */
+bool ConnectionWriter::
+send_ping(const PT(Connection) &connection, const NetAddress &address) {
+  nassertr(!_shutdown && !_raw_mode, false);
+  nassertr(connection != nullptr, false);
+  nassertr(connection->get_socket()->is_exact_type(Socket_UDP::get_class_type()), false);
+
+  NetDatagram ping;
+  Connection::make_ping_frame(ping, false, TrueClock::get_global_ptr()->get_short_time());
+  ping.set_connection(connection);
+  ping.set_address(address);
+  if (!connection->send_datagram(ping, _tcp_header_size)) {
+    return false;
   }
+  count_sent(ping);
+  return true;
 }
 
 /**
@@ -279,6 +350,15 @@ get_tcp_header_size() const {
   return _tcp_header_size;
 }
 
+/**
+ * Returns the counts of the datagrams and bytes this writer has sent, and
+ * the high-water mark of its queue.
+ */
+NetStats *ConnectionWriter::
+get_stats() const {
+  return _stats;
+}
+
 /**
  * Stops all the threads and cleans them up.  This is called automatically by
  * the destructor, but it may be called explicitly before destruction.
@@ -320,13 +400,62 @@ void ConnectionWriter::
 thread_run(int thread_index) {
   nassertv(!_immediate);
 
-  NetDatagram datagram;
-  while (_queue.extract(datagram)) {
-    if (_raw_mode) {
-      datagram.get_connection()->send_raw_datagram(datagram);
+  int max_count = std::max((int)net_write_batch_size, 1);
+  pvector<NetDatagram> batch;
+  while (_queue.extract_batch(batch, max_count)) {
+    send_batch(batch);
+    batch.clear();
+    Thread::consider_yield();
+  }
+}
+
+/**
+ * Sends the indicated datagrams, which were extracted from the queue
+ * together.  The datagrams for each connection are handed to that connection
+ * in one call, so that they may be written with a single system call; their
+ * order within each connection is preserved.
+ */
+void ConnectionWriter::
+send_batch(const pvector<NetDatagram> &batch) {
+  pvector<const NetDatagram *> sorted;
+  sorted.reserve(batch.size());
+  for (const NetDatagram &datagram : batch) {
+    sorted.push_back(&datagram);
+  }
+  std::stable_sort(sorted.begin(), sorted.end(),
+    [](const NetDatagram *a, const NetDatagram *b) {
+      return a->get_connection() < b->get_connection();
+    });
+
+  size_t i = 0;
+  while (i < sorted.size()) {
+    Connection *connection = sorted[i]->get_connection();
+    size_t j = i + 1;
+    while (j < sorted.size() && sorted[j]->get_connection() == connection) {
+      ++j;
+    }
+    if (connection->send_datagrams(&sorted[i], j - i, _tcp_header_size, _raw_mode)) {
+      for (size_t k = i; k < j; ++k) {
+        count_sent(*sorted[k]);
+      }
+    }
+    i = j;
+  }
+}
+
+/**
+ * Adds the indicated datagram, which has just been sent, to the stats.
+ */
+void ConnectionWriter::
+count_sent(const NetDatagram &datagram) {
+  size_t header_size = 0;
+  if (!_raw_mode) {
+    Connection *connection = datagram.get_connection();
+    if (connection->get_socket()->is_exact_type(Socket_UDP::get_class_type())) {
+      header_size = datagram_udp_header_size;
     } else {
-      datagram.get_connection()->send_datagram(datagram, _tcp_header_size);
+      header_size = _tcp_header_size;
     }
-    Thread::consider_yield();
   }
+  _stats->add_datagram(header_size + datagram.get_length());
 }
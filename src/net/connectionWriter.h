@@ -17,6 +17,7 @@
 #include "pandabase.h"
 #include "datagramQueue.h"
 #include "connection.h"
+#include "netStats.h"
 #include "pointerTo.h"
 #include "thread.h"
 #include "pvector.h"
@@ -51,6 +52,9 @@ PUBLISHED:
                      const NetAddress &address,
                      bool block = false);
 
+  bool send_ping(const PT(Connection) &connection);
+  bool send_ping(const PT(Connection) &connection, const NetAddress &address);
+
   bool is_valid_for_udp(const Datagram &datagram) const;
 
   ConnectionManager *get_manager() const;
@@ -63,6 +67,8 @@ PUBLISHED:
   void set_tcp_header_size(int tcp_header_size);
   int get_tcp_header_size() const;
 
+  NetStats *get_stats() const;
+
   void shutdown();
 
 protected:
@@ -71,6 +77,8 @@ protected:
 private:
   void thread_run(int thread_index);
   bool send_datagram(const NetDatagram &datagram);
+  void send_batch(const pvector<NetDatagram> &batch);
+  void count_sent(const NetDatagram &datagram);
 
 protected:
   ConnectionManager *_manager;
@@ -80,6 +88,7 @@ private:
   int _tcp_header_size;
   DatagramQueue _queue;
   bool _shutdown;
+  PT(NetStats) _stats;
 
   class WriterThread : public Thread {
   public:
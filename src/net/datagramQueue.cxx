@@ -20,8 +20,10 @@
  */
 DatagramQueue::
 DatagramQueue() :
+  _queue(net_queue_ring_size),
   _cvlock("DatagramQueue::_cvlock"),
-  _cv(_cvlock)
+  _cv(_cvlock),
+  _num_waiting(0)
 {
   _shutdown = false;
   _max_queue_size = get_net_max_write_queue();
@@ -64,20 +66,34 @@ shutdown() {
  */
 bool DatagramQueue::
 insert(const NetDatagram &data, bool block) {
-  MutexHolder holder(_cvlock);
+  return insert(NetDatagram(data), block);
+}
 
-  bool enqueue_ok = ((int)_queue.size() < _max_queue_size);
+/**
+ * Moves the indicated datagram onto the end of the queue.  See the above
+ * method.
+ */
+bool DatagramQueue::
+insert(NetDatagram &&data, bool block) {
+  bool enqueue_ok = (_queue.size() < _max_queue_size);
   if (block) {
     while (!enqueue_ok && !_shutdown) {
-      _cv.wait();
-      enqueue_ok = ((int)_queue.size() < _max_queue_size);
+      MutexHolder holder(_cvlock);
+      AtomicAdjust::inc(_num_waiting);
+      // Check again, now that we are counted as waiting, so that we can't
+      // miss the wakeup.
+      if (_queue.size() >= _max_queue_size && !_shutdown) {
+        _cv.wait();
+      }
+      AtomicAdjust::dec(_num_waiting);
+      enqueue_ok = (_queue.size() < _max_queue_size);
     }
   }
 
   if (enqueue_ok) {
-    _queue.push_back(data);
+    _queue.push(std::move(data));
   }
-  _cv.notify();  // Only need to wake up one thread.
+  notify_waiting();
 
   return enqueue_ok;
 }
@@ -101,24 +117,51 @@ extract(NetDatagram &result) {
   // connection pointer--we're about to go to sleep for a while.
   result.clear();
 
-  MutexHolder holder(_cvlock);
+  while (!_shutdown) {
+    if (_queue.pop(result)) {
+      // Wake up any threads waiting to stuff things into the queue.
+      notify_waiting();
+      return true;
+    }
 
-  while (_queue.empty() && !_shutdown) {
-    _cv.wait();
+    MutexHolder holder(_cvlock);
+    AtomicAdjust::inc(_num_waiting);
+    if (_queue.empty() && !_shutdown) {
+      _cv.wait();
+    }
+    AtomicAdjust::dec(_num_waiting);
   }
 
-  if (_shutdown) {
-    return false;
-  }
+  return false;
+}
 
-  nassertr(!_queue.empty(), false);
-  result = _queue.front();
-  _queue.pop_front();
+/**
+ * Like extract(), but extracts all of the datagrams at the head of the queue,
+ * up to max_count, into the result vector.  This blocks until at least one
+ * datagram is available.
+ *
+ * The return value is true if at least one datagram is extracted, or false if
+ * the queue was destroyed while waiting.
+ */
+bool DatagramQueue::
+extract_batch(pvector<NetDatagram> &result, int max_count) {
+  result.clear();
 
-  // Wake up any threads waiting to stuff things into the queue.
-  _cv.notify_all();
+  while (!_shutdown) {
+    if (_queue.pop_batch(result, max_count) > 0) {
+      notify_waiting();
+      return true;
+    }
+
+    MutexHolder holder(_cvlock);
+    AtomicAdjust::inc(_num_waiting);
+    if (_queue.empty() && !_shutdown) {
+      _cv.wait();
+    }
+    AtomicAdjust::dec(_num_waiting);
+  }
 
-  return true;
+  return false;
 }
 
 /**
@@ -131,7 +174,6 @@ extract(NetDatagram &result) {
  */
 void DatagramQueue::
 set_max_queue_size(int max_size) {
-  MutexHolder holder(_cvlock);
   _max_queue_size = max_size;
 }
 
@@ -149,7 +191,17 @@ get_max_queue_size() const {
  */
 int DatagramQueue::
 get_current_queue_size() const {
-  MutexHolder holder(_cvlock);
-  int size = _queue.size();
-  return size;
+  return _queue.size();
+}
+
+/**
+ * Wakes up the threads that are sleeping in insert() or extract(), if there
+ * are any.  This must be called after changing the contents of the queue.
+ */
+void DatagramQueue::
+notify_waiting() {
+  if (AtomicAdjust::get(_num_waiting) != 0) {
+    MutexHolder holder(_cvlock);
+    _cv.notify_all();
+  }
 }
@@ -17,14 +17,20 @@
 #include "pandabase.h"
 
 #include "netDatagram.h"
+#include "ringQueue.h"
 #include "pmutex.h"
 #include "conditionVar.h"
-#include "pdeque.h"
+#include "atomicAdjust.h"
+#include "pvector.h"
 
 /**
  * A thread-safe, FIFO queue of NetDatagrams.  This is used by
  * ConnectionWriter for queuing up datagrams for its various threads to write
  * to sockets.
+ *
+ * The datagrams are kept on a RingQueue; the mutex is only taken by threads
+ * that have to go to sleep because the queue is empty (or full, for a
+ * blocking insert), and by the threads that wake them up.
  */
 class EXPCL_PANDA_NET DatagramQueue {
 public:
@@ -33,18 +39,23 @@ public:
   void shutdown();
 
   bool insert(const NetDatagram &data, bool block = false);
+  bool insert(NetDatagram &&data, bool block = false);
   bool extract(NetDatagram &result);
+  bool extract_batch(pvector<NetDatagram> &result, int max_count);
 
   void set_max_queue_size(int max_size);
   int get_max_queue_size() const;
   int get_current_queue_size() const;
 
 private:
+  void notify_waiting();
+
+  RingQueue<NetDatagram> _queue;
+
   Mutex _cvlock;
   ConditionVar _cv;  // signaled when queue contents change.
+  AtomicAdjust::Integer _num_waiting;
 
-  typedef pdeque<NetDatagram> QueueType;
-  QueueType _queue;
   bool _shutdown;
   int _max_queue_size;
 };
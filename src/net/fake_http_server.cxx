@@ -22,32 +22,105 @@
 #include "netDatagram.h"
 #include "pmap.h"
 
+#ifdef HAVE_OPENSSL
+#include "openSSLWrapper.h"
+#endif
+
 #include <ctype.h>
+#include <sstream>
 
 using std::string;
 
 QueuedConnectionManager cm;
 QueuedConnectionReader reader(&cm, 10);
-ConnectionWriter writer(&cm, 10);
+
+// The writer sends immediately, so that the SSL records for a client go out
+// in the order they were made.
+ConnectionWriter writer(&cm, 0);
+
+#ifdef HAVE_OPENSSL
+// If a certificate and key are given on the command line, this is the context
+// for the secure connections; the server then speaks https instead of http.
+SSL_CTX *ssl_ctx = nullptr;
+#endif
 
 class ClientState {
 public:
   ClientState(Connection *client);
+  void close();
   void receive_data(const Datagram &data);
   void receive_line(string line);
+  void send_data(const string &data);
 
   Connection *_client;
   string _received;
+
+#ifdef HAVE_OPENSSL
+  // The SSL state for a secure connection.  The encrypted side is kept in
+  // memory BIOs, since the reader and writer do the actual socket I/O.
+  void flush_ssl();
+
+  SSL *_ssl;
+  BIO *_rbio;
+  BIO *_wbio;
+#endif
 };
 
 ClientState::
 ClientState(Connection *client) {
   _client = client;
+
+#ifdef HAVE_OPENSSL
+  _ssl = nullptr;
+  if (ssl_ctx != nullptr) {
+    _ssl = SSL_new(ssl_ctx);
+    _rbio = BIO_new(BIO_s_mem());
+    _wbio = BIO_new(BIO_s_mem());
+    BIO_set_mem_eof_return(_rbio, -1);
+    SSL_set_bio(_ssl, _rbio, _wbio);
+    SSL_set_accept_state(_ssl);
+  }
+#endif
+}
+
+void ClientState::
+close() {
+#ifdef HAVE_OPENSSL
+  if (_ssl != nullptr) {
+    SSL_free(_ssl);
+    _ssl = nullptr;
+  }
+#endif
 }
 
 void ClientState::
 receive_data(const Datagram &data) {
-  _received += data.get_message();
+#ifdef HAVE_OPENSSL
+  if (_ssl != nullptr) {
+    BIO_write(_rbio, data.get_data(), (int)data.get_length());
+    if (!SSL_is_init_finished(_ssl)) {
+      int result = SSL_do_handshake(_ssl);
+      if (result <= 0) {
+        int error = SSL_get_error(_ssl, result);
+        if (error != SSL_ERROR_WANT_READ && error != SSL_ERROR_WANT_WRITE) {
+          nout << "SSL handshake failed.\n";
+          OpenSSLWrapper::get_global_ptr()->notify_ssl_errors();
+        }
+      }
+    }
+    char buffer[4096];
+    int bytes_read = SSL_read(_ssl, buffer, sizeof(buffer));
+    while (bytes_read > 0) {
+      _received += string(buffer, bytes_read);
+      bytes_read = SSL_read(_ssl, buffer, sizeof(buffer));
+    }
+    flush_ssl();
+  } else
+#endif
+  {
+    _received += data.get_message();
+  }
+
   size_t next = 0;
   size_t newline = _received.find('\n', next);
   while (newline != string::npos) {
@@ -77,28 +150,81 @@ receive_line(string line) {
     line = line.substr(0, size);
   }
 
-  /*
   if (line.empty()) {
-    // Start to honor the request, as if we cared.
-    Datagram dg;
-    dg.append_data("HTTP/1.1 200 OK\r\n");
+    // Honor the request, as if we cared.  The connection is kept open for the
+    // next one.
+    string body = "Hello from fake_http_server.\n";
+    std::ostringstream response;
+    response
+      << "HTTP/1.1 200 OK\r\n"
+      << "Content-Type: text/plain\r\n"
+      << "Content-Length: " << body.size() << "\r\n"
+      << "\r\n" << body;
+    send_data(response.str());
+  }
+}
+
+void ClientState::
+send_data(const string &data) {
+#ifdef HAVE_OPENSSL
+  if (_ssl != nullptr) {
+    if (SSL_write(_ssl, data.data(), (int)data.size()) <= 0) {
+      nout << "Could not send to client.\n";
+    }
+    flush_ssl();
+    return;
+  }
+#endif
+
+  Datagram dg;
+  dg.append_data(data);
+  writer.send(dg, _client);
+}
+
+#ifdef HAVE_OPENSSL
+void ClientState::
+flush_ssl() {
+  // Send whatever the SSL protocol has produced: the server's half of the
+  // handshake, or encrypted data.
+  char buffer[4096];
+  int bytes_read = BIO_read(_wbio, buffer, sizeof(buffer));
+  while (bytes_read > 0) {
+    Datagram dg(buffer, bytes_read);
     writer.send(dg, _client);
-    // Close the connection!
-    cm.close_connection(_client);
+    bytes_read = BIO_read(_wbio, buffer, sizeof(buffer));
   }
-  */
 }
+#endif
 
 
 int
 main(int argc, char *argv[]) {
-  if (argc != 2) {
-    nout << "fake_http_server port\n";
+  if (argc != 2 && argc != 4) {
+    nout << "fake_http_server port [cert.pem key.pem]\n";
     exit(1);
   }
 
   int port = atoi(argv[1]);
 
+  if (argc == 4) {
+#ifdef HAVE_OPENSSL
+    // A self-signed certificate for testing may be made with:
+    // openssl req -x509 -newkey rsa:2048 -nodes -keyout key.pem -out cert.pem
+    //   -days 30 -subj /CN=localhost
+    OpenSSLWrapper::get_global_ptr();
+    ssl_ctx = SSL_CTX_new(SSLv23_server_method());
+    if (SSL_CTX_use_certificate_chain_file(ssl_ctx, argv[2]) <= 0 ||
+        SSL_CTX_use_PrivateKey_file(ssl_ctx, argv[3], SSL_FILETYPE_PEM) <= 0) {
+      nout << "Unable to load " << argv[2] << " and " << argv[3] << ".\n";
+      OpenSSLWrapper::get_global_ptr()->notify_ssl_errors();
+      exit(1);
+    }
+#else
+    nout << "OpenSSL is not available; cannot serve https.\n";
+    exit(1);
+#endif
+  }
+
   PT(Connection) rendezvous = cm.open_TCP_server_rendezvous(port, 5);
 
   if (rendezvous.is_null()) {
@@ -106,7 +232,13 @@ main(int argc, char *argv[]) {
     exit(1);
   }
 
-  nout << "Listening for connections on port " << port << "\n";
+  nout << "Listening for connections on port " << port;
+#ifdef HAVE_OPENSSL
+  if (ssl_ctx != nullptr) {
+    nout << " (https)";
+  }
+#endif
+  nout << "\n";
 
   QueuedConnectionListener listener(&cm, 1);
   listener.add_connection(rendezvous);
@@ -137,7 +269,11 @@ main(int argc, char *argv[]) {
       if (cm.get_reset_connection(connection)) {
         nout << "Lost connection from "
              << connection->get_address() << "\n";
-        clients.erase(connection);
+        Clients::iterator ci = clients.find(connection);
+        if (ci != clients.end()) {
+          (*ci).second.close();
+          clients.erase(ci);
+        }
         cm.close_connection(connection);
       }
     }
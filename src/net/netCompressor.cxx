@@ -0,0 +1,240 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file netCompressor.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "netCompressor.h"
+
+// This module is not compiled if zlib is not available.
+#ifdef HAVE_ZLIB
+
+#include "datagram.h"
+#include "datagramBufferPool.h"
+#include "config_net.h"
+
+// Each compressed datagram begins with one of these bytes.  Datagrams too
+// small to be worth compressing are sent as-is, and do not pass through the
+// streams at all.
+enum CompressFlag {
+  CF_stored = 0,
+  CF_deflated = 1,
+};
+
+static const size_t min_compress_size = 32;
+
+/**
+ * Creates the deflate and inflate streams.  level is the zlib compression
+ * level, 1 through 9.
+ */
+NetCompressor::
+NetCompressor(int level, const vector_uchar &dictionary) :
+  _deflate_valid(false),
+  _inflate_valid(false)
+{
+  memset(&_deflate, 0, sizeof(_deflate));
+  memset(&_inflate, 0, sizeof(_inflate));
+
+  // We use raw deflate streams, without the zlib header and checksum; TCP
+  // already protects the data, and there is no end to the stream to put the
+  // checksum after.
+  int result = deflateInit2(&_deflate, level, Z_DEFLATED, -15, 8,
+                            Z_DEFAULT_STRATEGY);
+  if (result != Z_OK) {
+    show_zlib_error("deflateInit2", result, _deflate);
+    return;
+  }
+  _deflate_valid = true;
+
+  result = inflateInit2(&_inflate, -15);
+  if (result != Z_OK) {
+    show_zlib_error("inflateInit2", result, _inflate);
+    return;
+  }
+  _inflate_valid = true;
+
+  if (!dictionary.empty()) {
+    result = deflateSetDictionary(&_deflate, (const Bytef *)dictionary.data(),
+                                  (uInt)dictionary.size());
+    if (result != Z_OK) {
+      show_zlib_error("deflateSetDictionary", result, _deflate);
+      _deflate_valid = false;
+    }
+    result = inflateSetDictionary(&_inflate, (const Bytef *)dictionary.data(),
+                                  (uInt)dictionary.size());
+    if (result != Z_OK) {
+      show_zlib_error("inflateSetDictionary", result, _inflate);
+      _inflate_valid = false;
+    }
+  }
+}
+
+/**
+ *
+ */
+NetCompressor::
+~NetCompressor() {
+  deflateEnd(&_deflate);
+  inflateEnd(&_inflate);
+}
+
+/**
+ * Returns true if the streams were successfully created.
+ */
+bool NetCompressor::
+is_valid() const {
+  return _deflate_valid && _inflate_valid;
+}
+
+/**
+ * Fills dest with the compressed form of source.  Returns true on success,
+ * false if the deflate stream has failed, in which case nothing further can
+ * be sent.
+ */
+bool NetCompressor::
+compress(const Datagram &source, Datagram &dest) {
+  if (!_deflate_valid) {
+    return false;
+  }
+
+  size_t source_size = source.get_length();
+  PTA_uchar buffer = DatagramBufferPool::get_global_ptr()->
+    get_buffer(source_size + 1);
+  vector_uchar &out = buffer.v();
+
+  if (source_size < min_compress_size) {
+    out.push_back(CF_stored);
+    const unsigned char *data = (const unsigned char *)source.get_data();
+    out.insert(out.end(), data, data + source_size);
+    dest.set_array(std::move(buffer));
+    return true;
+  }
+
+  out.push_back(CF_deflated);
+  _deflate.next_in = (Bytef *)source.get_data();
+  _deflate.avail_in = (uInt)source_size;
+
+  // A sync flush writes out everything so far, so that the other end can
+  // decompress this datagram without waiting for the next one.  We keep
+  // calling deflate() until it leaves some of the output space unused.
+  do {
+    size_t pos = out.size();
+    out.resize(pos + std::max(source_size / 2, (size_t)256));
+    _deflate.next_out = (Bytef *)&out[pos];
+    _deflate.avail_out = (uInt)(out.size() - pos);
+
+    int result = deflate(&_deflate, Z_SYNC_FLUSH);
+    out.resize(out.size() - _deflate.avail_out);
+    if (result != Z_OK && result != Z_BUF_ERROR) {
+      show_zlib_error("deflate", result, _deflate);
+      _deflate_valid = false;
+      return false;
+    }
+  } while (_deflate.avail_out == 0);
+
+  dest.set_array(std::move(buffer));
+  return true;
+}
+
+/**
+ * Fills dest with the original form of source, which was produced by
+ * compress() on the other end of the connection.  Returns true on success,
+ * false if the data is corrupt, or would expand to more than max_size bytes,
+ * in which case nothing further can be received, and every later call will
+ * also return false.
+ */
+bool NetCompressor::
+decompress(const Datagram &source, Datagram &dest, size_t max_size) {
+  if (!_inflate_valid) {
+    return false;
+  }
+
+  size_t source_size = source.get_length();
+  if (source_size == 0) {
+    net_cat.error()
+      << "Received empty compressed datagram.\n";
+    return false;
+  }
+
+  const unsigned char *data = (const unsigned char *)source.get_data();
+  if (data[0] == CF_stored) {
+    if (source_size - 1 > max_size) {
+      net_cat.error()
+        << "Received datagram of " << source_size - 1
+        << " bytes, larger than the limit of " << max_size << ".\n";
+      _inflate_valid = false;
+      return false;
+    }
+    PTA_uchar buffer = DatagramBufferPool::get_global_ptr()->
+      get_buffer(source_size - 1);
+    buffer.v().insert(buffer.v().end(), data + 1, data + source_size);
+    dest.set_array(std::move(buffer));
+    return true;
+  }
+
+  if (data[0] != CF_deflated) {
+    net_cat.error()
+      << "Received datagram with unknown compression " << (int)data[0]
+      << ".\n";
+    return false;
+  }
+
+  PTA_uchar buffer = DatagramBufferPool::get_global_ptr()->
+    get_buffer(std::min(source_size * 4, max_size));
+  vector_uchar &out = buffer.v();
+
+  _inflate.next_in = (Bytef *)(data + 1);
+  _inflate.avail_in = (uInt)(source_size - 1);
+
+  do {
+    // We allow one byte more than max_size, so that we can tell when the
+    // datagram has gone over it.
+    size_t pos = out.size();
+    if (pos > max_size) {
+      net_cat.error()
+        << "Received datagram that expands to more than the limit of "
+        << max_size << " bytes.\n";
+      _inflate_valid = false;
+      return false;
+    }
+    out.resize(pos + std::min(std::max(source_size * 4, (size_t)1024),
+                              max_size + 1 - pos));
+    _inflate.next_out = (Bytef *)&out[pos];
+    _inflate.avail_out = (uInt)(out.size() - pos);
+
+    int result = inflate(&_inflate, Z_SYNC_FLUSH);
+    out.resize(out.size() - _inflate.avail_out);
+    if (result != Z_OK && result != Z_BUF_ERROR) {
+      show_zlib_error("inflate", result, _inflate);
+      _inflate_valid = false;
+      return false;
+    }
+  } while (_inflate.avail_in != 0 || _inflate.avail_out == 0);
+
+  dest.set_array(std::move(buffer));
+  return true;
+}
+
+/**
+ * Reports a recent error code returned by zlib.
+ */
+void NetCompressor::
+show_zlib_error(const char *function, int error_code, z_stream &z) {
+  net_cat.error()
+    << "zlib error " << error_code << " in " << function;
+  if (z.msg != nullptr) {
+    net_cat.error(false)
+      << ": " << z.msg;
+  }
+  net_cat.error(false)
+    << "\n";
+}
+
+#endif  // HAVE_ZLIB
@@ -0,0 +1,62 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file netCompressor.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef NETCOMPRESSOR_H
+#define NETCOMPRESSOR_H
+
+#include "pandabase.h"
+
+// This module is not compiled if zlib is not available.
+#ifdef HAVE_ZLIB
+
+#include "vector_uchar.h"
+#include <zlib.h>
+
+class Datagram;
+
+/**
+ * The compression state of one TCP connection.  Outgoing datagrams are
+ * compressed with a single deflate stream that lasts for the life of the
+ * connection, flushed at the end of each datagram, so that each datagram may
+ * be compressed against all of the data sent before it; incoming datagrams
+ * are decompressed with a matching inflate stream.  Both ends must therefore
+ * see every compressed datagram, in order.
+ *
+ * An optional dictionary primes both streams with data that is expected to be
+ * common in the traffic, which helps considerably with the first datagrams
+ * sent.  Both ends must use the same dictionary.
+ *
+ * This is used internally by Connection; see Connection::set_compression().
+ */
+class EXPCL_PANDA_NET NetCompressor {
+public:
+  NetCompressor(int level, const vector_uchar &dictionary);
+  ~NetCompressor();
+
+  bool is_valid() const;
+
+  bool compress(const Datagram &source, Datagram &dest);
+  bool decompress(const Datagram &source, Datagram &dest, size_t max_size);
+
+private:
+  void show_zlib_error(const char *function, int error_code, z_stream &z);
+
+  z_stream _deflate;
+  z_stream _inflate;
+  bool _deflate_valid;
+  bool _inflate_valid;
+};
+
+#endif  // HAVE_ZLIB
+
+#endif
@@ -46,6 +46,11 @@ PUBLISHED:
   void operator = (const Datagram &copy);
   void operator = (const NetDatagram &copy);
 
+public:
+  NetDatagram(NetDatagram &&from) noexcept;
+  void operator = (NetDatagram &&from) noexcept;
+
+PUBLISHED:
   virtual void clear();
 
   void set_connection(const PT(Connection) &connection);
@@ -0,0 +1,94 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file netStats.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "netStats.h"
+#include "lightMutexHolder.h"
+
+#include <algorithm>
+
+NetStats::AllStats NetStats::_all_stats;
+LightMutex NetStats::_all_stats_lock("NetStats::_all_stats_lock");
+
+/**
+ *
+ */
+NetStats::
+NetStats(const std::string &name, Direction direction) :
+  _name(name),
+  _direction(direction),
+  _num_bytes(0),
+  _num_datagrams(0),
+  _wait_usec(0),
+  _queue_high_water_mark(0)
+{
+}
+
+/**
+ *
+ */
+void NetStats::
+output(std::ostream &out) const {
+  out << "NetStats " << _name << ((_direction == D_in) ? " in: " : " out: ")
+      << get_num_datagrams() << " datagrams, " << get_num_bytes()
+      << " bytes";
+}
+
+/**
+ * Records that the queue now holds the indicated number of datagrams, raising
+ * the high-water mark if necessary.
+ */
+void NetStats::
+note_queue_size(int size) {
+  AtomicAdjust::Integer mark = AtomicAdjust::get(_queue_high_water_mark);
+  while (size > mark) {
+    AtomicAdjust::Integer orig =
+      AtomicAdjust::compare_and_exchange(_queue_high_water_mark, mark, size);
+    if (orig == mark) {
+      break;
+    }
+    mark = orig;
+  }
+}
+
+/**
+ * Adds this object to the global list returned by get_all_stats().  This is
+ * called by the reader or writer that owns it.
+ */
+void NetStats::
+register_stats() {
+  LightMutexHolder holder(_all_stats_lock);
+  _all_stats.push_back(this);
+}
+
+/**
+ * Removes this object from the global list.  This is called by the reader or
+ * writer that owns it, when it is destroyed.
+ */
+void NetStats::
+unregister_stats() {
+  LightMutexHolder holder(_all_stats_lock);
+  AllStats::iterator si = std::find(_all_stats.begin(), _all_stats.end(), this);
+  if (si != _all_stats.end()) {
+    _all_stats.erase(si);
+  }
+}
+
+/**
+ * Fills result with the stats of all the readers and writers that currently
+ * exist.
+ */
+void NetStats::
+get_all_stats(pvector<PT(NetStats)> &result) {
+  LightMutexHolder holder(_all_stats_lock);
+  result = _all_stats;
+}
@@ -0,0 +1,94 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file netStats.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef NETSTATS_H
+#define NETSTATS_H
+
+#include "pandabase.h"
+#include "referenceCount.h"
+#include "pointerTo.h"
+#include "atomicAdjust.h"
+#include "lightMutex.h"
+#include "pvector.h"
+
+/**
+ * Counts the traffic that passes through one ConnectionReader or
+ * ConnectionWriter: the datagrams and bytes, the time spent waiting in
+ * select() or epoll_wait(), and the high-water mark of its queue.
+ *
+ * Every ConnectionReader and ConnectionWriter keeps one of these for as long
+ * as it exists, and they are all kept on a global list, from which
+ * PStatClient reports them each frame.  The counts are totals since the
+ * reader or writer was created, except for the queue high-water mark, which
+ * may be reset.
+ */
+class EXPCL_PANDA_NET NetStats : public ReferenceCount {
+PUBLISHED:
+  enum Direction {
+    D_in,
+    D_out,
+  };
+
+  INLINE const std::string &get_name() const;
+  INLINE Direction get_direction() const;
+
+  INLINE uint64_t get_num_bytes() const;
+  INLINE uint64_t get_num_datagrams() const;
+  INLINE double get_wait_time() const;
+
+  INLINE int get_queue_high_water_mark() const;
+  INLINE void reset_queue_high_water_mark();
+
+  void output(std::ostream &out) const;
+
+  MAKE_PROPERTY(name, get_name);
+  MAKE_PROPERTY(direction, get_direction);
+  MAKE_PROPERTY(num_bytes, get_num_bytes);
+  MAKE_PROPERTY(num_datagrams, get_num_datagrams);
+  MAKE_PROPERTY(wait_time, get_wait_time);
+
+public:
+  NetStats(const std::string &name, Direction direction);
+
+  INLINE void add_datagram(size_t num_bytes);
+  INLINE void add_wait_time(double elapsed);
+  void note_queue_size(int size);
+
+  void register_stats();
+  void unregister_stats();
+  static void get_all_stats(pvector<PT(NetStats)> &result);
+
+private:
+  std::string _name;
+  Direction _direction;
+
+  AtomicAdjust::Integer _num_bytes;
+  AtomicAdjust::Integer _num_datagrams;
+  // The wait time is kept in microseconds, so that it may be added to
+  // atomically.
+  AtomicAdjust::Integer _wait_usec;
+  AtomicAdjust::Integer _queue_high_water_mark;
+
+  typedef pvector<PT(NetStats)> AllStats;
+  static AllStats _all_stats;
+  static LightMutex _all_stats_lock;
+};
+
+INLINE std::ostream &operator << (std::ostream &out, const NetStats &stats) {
+  stats.output(out);
+  return out;
+}
+
+#include "netStats.I"
+
+#endif
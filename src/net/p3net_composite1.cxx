@@ -4,6 +4,7 @@
 #include "connectionListener.cxx"
 #include "connectionManager.cxx"
 #include "connectionReader.cxx"
+#include "connectionStats.cxx"
 #include "connectionWriter.cxx"
 #include "datagramGeneratorNet.cxx"
 #include "datagramSinkNet.cxx"
@@ -2,8 +2,12 @@
 #include "datagramTCPHeader.cxx"
 #include "datagramUDPHeader.cxx"
 #include "netAddress.cxx"
+#include "netCompressor.cxx"
 #include "netDatagram.cxx"
+#include "netStats.cxx"
 #include "queuedConnectionListener.cxx"
 #include "queuedConnectionManager.cxx"
 #include "queuedConnectionReader.cxx"
 #include "recentConnectionReader.cxx"
+#include "reliableChannel.cxx"
+#include "stateSnapshot.cxx"
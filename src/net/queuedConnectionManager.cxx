@@ -12,6 +12,7 @@
  */
 
 #include "queuedConnectionManager.h"
+#include "lightMutexHolder.h"
 
 #include <algorithm>
 
@@ -65,7 +66,13 @@ reset_connection_available() const {
  */
 bool QueuedConnectionManager::
 get_reset_connection(PT(Connection) &connection) {
-  return get_thing(connection);
+  if (!get_thing(connection)) {
+    return false;
+  }
+
+  LightMutexHolder holder(_pending_lock);
+  _pending.erase(connection);
+  return true;
 }
 
 
@@ -80,5 +87,10 @@ connection_reset(const PT(Connection) &connection, bool okflag) {
 
   // Largely, we don't care if this particular queue fills up.  If it does, it
   // probably just means the user isn't bothering to track this.
-  enqueue_unique_thing(connection);
+  LightMutexHolder holder(_pending_lock);
+  if (_pending.insert(connection).second) {
+    if (!enqueue_thing(connection)) {
+      _pending.erase(connection);
+    }
+  }
 }
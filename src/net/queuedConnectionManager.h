@@ -19,6 +19,8 @@
 #include "connectionManager.h"
 #include "queuedReturn.h"
 #include "pdeque.h"
+#include "pset.h"
+#include "lightMutex.h"
 
 EXPORT_TEMPLATE_CLASS(EXPCL_PANDA_NET, EXPTP_PANDA_NET, QueuedReturn< PT(Connection) >);
 
@@ -44,6 +46,12 @@ PUBLISHED:
 protected:
   virtual void connection_reset(const PT(Connection) &connection,
                                 bool okflag);
+
+private:
+  // The connections that are currently on the queue, so that each is only
+  // reported once.
+  LightMutex _pending_lock;
+  pset<Connection *> _pending;
 };
 
 #endif
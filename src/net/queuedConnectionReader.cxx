@@ -84,6 +84,24 @@ get_data(Datagram &result) {
   return true;
 }
 
+/**
+ * Retrieves up to max_count of the available datagrams at once, appending
+ * them to the result vector in the order they were received, and returns the
+ * number retrieved.  This is cheaper than calling get_data() for each one
+ * when many datagrams arrive per frame.
+ *
+ * Unlike data_available(), this does not poll the sockets of a polling
+ * reader; call data_available() or poll() first in that case.
+ *
+ * The datagrams' storage comes from the global DatagramBufferPool; passing
+ * each one to DatagramBufferPool::release() once it has been processed lets
+ * the reader reuse its buffer.
+ */
+size_t QueuedConnectionReader::
+get_data_batch(pvector<NetDatagram> &result, size_t max_count) {
+  return get_things(result, max_count);
+}
+
 /**
  * An internal function called by ConnectionReader() when a new datagram has
  * become available.  The QueuedConnectionReader simply queues it up for later
@@ -108,6 +126,8 @@ receive_datagram(const NetDatagram &datagram) {
       << "QueuedConnectionReader queue full!\n";
   }
 #endif  // SIMULATE_NETWORK_DELAY
+
+  _stats->note_queue_size(get_current_queue_size());
 }
 
 
@@ -40,6 +40,10 @@ PUBLISHED:
   bool get_data(NetDatagram &result);
   bool get_data(Datagram &result);
 
+public:
+  size_t get_data_batch(pvector<NetDatagram> &result,
+                        size_t max_count = (size_t)-1);
+
 protected:
   virtual void receive_datagram(const NetDatagram &datagram);
 
@@ -19,10 +19,9 @@
 #include "connectionListener.h"
 #include "connection.h"
 #include "netAddress.h"
-#include "lightMutex.h"
-#include "pdeque.h"
+#include "ringQueue.h"
+#include "pvector.h"
 #include "config_net.h"
-#include "lightMutexHolder.h"
 
 #include <algorithm>
 
@@ -30,6 +29,9 @@
  * This is the implementation of a family of things that queue up their return
  * values for later retrieval by client code, like QueuedConnectionReader,
  * QueuedConnectionListener, QueuedConnectionManager.
+ *
+ * The things are kept on a RingQueue, so that the threads that queue them up
+ * do not contend on a lock with the thread that retrieves them.
  */
 template<class Thing>
 class QueuedReturn {
@@ -47,14 +49,13 @@ protected:
 
   INLINE bool thing_available() const;
   bool get_thing(Thing &thing);
+  size_t get_things(pvector<Thing> &result, size_t max_count);
 
   bool enqueue_thing(const Thing &thing);
-  bool enqueue_unique_thing(const Thing &thing);
+  bool enqueue_thing(Thing &&thing);
 
 private:
-  LightMutex _mutex;
-  pdeque<Thing> _things;
-  bool _available;
+  RingQueue<Thing> _things;
   int _max_queue_size;
   bool _overflow_flag;
 };
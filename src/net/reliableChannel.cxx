@@ -0,0 +1,729 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file reliableChannel.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "reliableChannel.h"
+#include "connectionWriter.h"
+#include "netAddress.h"
+#include "config_net.h"
+
+using std::max;
+using std::min;
+
+// The flags, sequence number, ack and ack bits at the start of each packet.
+static const size_t packet_header_size = 9;
+
+enum PacketFlags {
+  // Set once we have received something from the peer, and so have something
+  // to acknowledge.
+  PF_has_ack = 0x01,
+
+  // Set on packets that carry nothing but acknowledgements.  These don't take
+  // up a sequence number, since they are never acknowledged themselves; if
+  // they did, a stream of them would push the packets that are waiting for
+  // an ack out of the range that the peer's acks can cover.
+  PF_ack_only = 0x02,
+};
+
+// The largest per-message header: flags, id, fragment group, index and count,
+// and length.
+static const size_t max_message_header_size = 9;
+
+// Reliable messages may only be sent this far ahead of the oldest one that
+// has not been acknowledged, which is also how far ahead of the next expected
+// message the receiver buffers them.
+static const uint16_t reliable_window_size = 512;
+
+// Unreliable messages beyond this many are discarded, oldest first, rather
+// than sent late.
+static const size_t max_unreliable_queue = 256;
+
+// A packet is given up for lost once this many later packets have been
+// acknowledged.
+static const uint16_t fast_resend_threshold = 3;
+
+static const double initial_rto = 0.5;
+static const double min_rto = 0.05;
+static const double max_rto = 2.0;
+
+// The least time beyond the smoothed round trip to wait for an ack, even if
+// the round trip time has been perfectly steady.
+static const double rto_margin = 0.02;
+
+static const double initial_cwnd = 4.0;
+static const double min_cwnd = 2.0;
+
+// Each packet acknowledges only the last 33 received, so if more than that
+// were in flight, some could never be acknowledged.
+static const double max_cwnd = 32.0;
+
+/**
+ * Creates a channel whose packets will be no larger than max_packet_size
+ * bytes.  The default leaves room for IP and UDP headers on a typical path
+ * without IP fragmentation.
+ */
+ReliableChannel::
+ReliableChannel(size_t max_packet_size) :
+  _max_packet_size(max(max_packet_size, packet_header_size + max_message_header_size + 1)),
+  _local_seq(0),
+  _next_reliable_id(0),
+  _next_group(0),
+  _num_in_flight(0),
+  _have_newest_acked(false),
+  _newest_acked(0),
+  _srtt(0.0),
+  _rttvar(0.0),
+  _rto(initial_rto),
+  _have_rtt(false),
+  _cwnd(initial_cwnd),
+  _ssthresh(max_cwnd),
+  _recovery_time(-1.0),
+  _reliable_first(false),
+  _have_remote_seq(false),
+  _remote_seq(0),
+  _remote_bits(0),
+  _ack_pending(false),
+  _expected_reliable_id(0),
+  _receive_window(reliable_window_size),
+  _reliable_assembly_next(0),
+  _num_packets_sent(0),
+  _num_packets_lost(0),
+  _num_messages_resent(0),
+  _num_unreliable_dropped(0)
+{
+  for (ReceiveSlot &slot : _receive_window) {
+    slot._present = false;
+  }
+}
+
+/**
+ *
+ */
+ReliableChannel::
+~ReliableChannel() {
+}
+
+/**
+ * Queues a message for sending to the peer.  Returns false if the message is
+ * too large to be sent; see get_max_message_size().
+ */
+bool ReliableChannel::
+send(const Datagram &message, bool reliable) {
+  size_t size = message.get_length();
+  if (size > get_max_message_size()) {
+    net_cat.error()
+      << "Attempt to send " << size << "-byte message on ReliableChannel; "
+      << "the limit is " << get_max_message_size() << " bytes.\n";
+    return false;
+  }
+
+  const unsigned char *data = (const unsigned char *)message.get_data();
+  size_t max_payload = _max_packet_size - packet_header_size - max_message_header_size;
+  size_t count = (size + max_payload - 1) / max_payload;
+  uint8_t flags = reliable ? MF_reliable : 0;
+  uint16_t group = 0;
+  if (count > 1) {
+    flags |= MF_fragment;
+    group = _next_group++;
+  } else {
+    count = 1;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    size_t offset = i * max_payload;
+    size_t part_size = min(size - offset, max_payload);
+
+    if (reliable) {
+      OutgoingMessage out;
+      out._id = _next_reliable_id++;
+      out._acked = false;
+      out._needs_send = true;
+      out._last_sent = -1.0;
+      add_message(out._encoded, flags, out._id, group, (uint8_t)i,
+                  (uint8_t)count, data + offset, part_size);
+      _reliable_queue.push_back(std::move(out));
+
+    } else {
+      if (_unreliable_queue.size() >= max_unreliable_queue) {
+        _unreliable_queue.pop_front();
+        ++_num_unreliable_dropped;
+      }
+      Datagram encoded;
+      add_message(encoded, flags, 0, group, (uint8_t)i, (uint8_t)count,
+                  data + offset, part_size);
+      _unreliable_queue.push_back(std::move(encoded));
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Processes a packet that was received from the peer.  Any messages it
+ * completes become available to get_message().  Returns false if the packet
+ * was malformed, or a duplicate or too old to be of use.
+ */
+bool ReliableChannel::
+receive_packet(const Datagram &packet, double now) {
+  DatagramIterator scan(packet);
+  if (scan.get_remaining_size() < packet_header_size) {
+    return false;
+  }
+  uint8_t packet_flags = scan.get_uint8();
+  uint16_t seq = scan.get_uint16();
+  uint16_t ack = scan.get_uint16();
+  uint32_t ack_bits = scan.get_uint32();
+
+  if (packet_flags & PF_ack_only) {
+    // There is nothing else in it, and nothing to acknowledge.  A duplicate
+    // does no harm, since the acks have already been counted.
+    if (scan.get_remaining_size() != 0) {
+      return false;
+    }
+    if (packet_flags & PF_has_ack) {
+      process_acks(ack, ack_bits, now);
+    }
+    return true;
+  }
+
+  // Check the whole packet before acting on any of it.  Otherwise, a
+  // corrupted packet would take the place of the intact one with the same
+  // sequence number, which would then be discarded as a duplicate, and the
+  // messages before the damage would be delivered regardless.
+  if (!check_messages(scan)) {
+    net_cat.warning()
+      << "Received malformed packet on ReliableChannel.\n";
+    return false;
+  }
+
+  // Record that we have received this packet, so that we can acknowledge it,
+  // and ignore it if we have seen it before.
+  if (!_have_remote_seq) {
+    _have_remote_seq = true;
+    _remote_seq = seq;
+    _remote_bits = 0;
+
+  } else if (seq_greater(seq, _remote_seq)) {
+    uint16_t diff = (uint16_t)(seq - _remote_seq);
+    _remote_bits = (diff < 32) ? (_remote_bits << diff) : 0;
+    if (diff <= 32) {
+      _remote_bits |= (uint32_t)1 << (diff - 1);
+    }
+    _remote_seq = seq;
+
+  } else {
+    uint16_t diff = (uint16_t)(_remote_seq - seq);
+    if (diff == 0 || diff > 32) {
+      return false;
+    }
+    uint32_t bit = (uint32_t)1 << (diff - 1);
+    if ((_remote_bits & bit) != 0) {
+      return false;
+    }
+    _remote_bits |= bit;
+  }
+
+  if (packet_flags & PF_has_ack) {
+    process_acks(ack, ack_bits, now);
+  }
+
+  bool any_messages = false;
+  while (scan.get_remaining_size() > 0) {
+    receive_message(scan);
+    any_messages = true;
+  }
+
+  if (any_messages) {
+    _ack_pending = true;
+  }
+  return true;
+}
+
+/**
+ * Fills in the next packet that should be sent to the peer.  Returns false if
+ * there is nothing to send right now, either because there are no messages
+ * waiting, or because the congestion window is full.  This should be called
+ * repeatedly until it returns false, and then again whenever a message is
+ * queued or a packet is received, or a little while later to send any
+ * messages that were lost.
+ */
+bool ReliableChannel::
+get_next_packet(Datagram &packet, double now) {
+  detect_losses(now);
+
+  bool window_open = (_num_in_flight < (int)_cwnd);
+  if (!window_open && !_ack_pending) {
+    return false;
+  }
+
+  packet.clear();
+  packet.add_uint8(_have_remote_seq ? PF_has_ack : 0);
+  packet.add_uint16(_local_seq);
+  packet.add_uint16(_remote_seq);
+  packet.add_uint32(_remote_bits);
+
+  SentPacket sent;
+  sent._seq = _local_seq;
+  sent._time = now;
+  sent._acked = false;
+  sent._lost = false;
+
+  if (window_open) {
+    // When both kinds of message are waiting, alternate which goes first, so
+    // that neither can starve the other.
+    if (_reliable_first) {
+      add_reliable_messages(packet, sent, now);
+      add_unreliable_messages(packet);
+    } else {
+      add_unreliable_messages(packet);
+      add_reliable_messages(packet, sent, now);
+    }
+    _reliable_first = !_reliable_first;
+  }
+
+  bool any_messages = (packet.get_length() > packet_header_size);
+  if (!any_messages) {
+    if (!_ack_pending) {
+      return false;
+    }
+
+    // Packets that carry nothing but acknowledgements aren't tracked, since
+    // there is nothing in them to send again, and so don't use up a sequence
+    // number either.
+    packet.clear();
+    packet.add_uint8(PF_has_ack | PF_ack_only);
+    packet.add_uint16(_local_seq);
+    packet.add_uint16(_remote_seq);
+    packet.add_uint32(_remote_bits);
+    _ack_pending = false;
+    return true;
+  }
+
+  ++_local_seq;
+  _ack_pending = false;
+  _sent_packets.push_back(std::move(sent));
+  ++_num_in_flight;
+  ++_num_packets_sent;
+  return true;
+}
+
+/**
+ * Adds as many of the reliable messages that need to be sent as will fit in
+ * the packet, oldest first, but only as far ahead as the receiver is willing
+ * to buffer.
+ */
+void ReliableChannel::
+add_reliable_messages(Datagram &packet, SentPacket &sent, double now) {
+  uint16_t base_id = _reliable_queue.empty() ? 0 : _reliable_queue.front()._id;
+  for (OutgoingMessage &out : _reliable_queue) {
+    if ((uint16_t)(out._id - base_id) >= reliable_window_size) {
+      break;
+    }
+    if (!out._needs_send) {
+      continue;
+    }
+    if (packet.get_length() + out._encoded.get_length() > _max_packet_size) {
+      break;
+    }
+    packet.append_data(out._encoded.get_data(), out._encoded.get_length());
+    if (out._last_sent >= 0.0) {
+      ++_num_messages_resent;
+    }
+    out._needs_send = false;
+    out._last_sent = now;
+    sent._reliable_ids.push_back(out._id);
+  }
+}
+
+/**
+ * Adds as many of the waiting unreliable messages as will fit in the packet.
+ */
+void ReliableChannel::
+add_unreliable_messages(Datagram &packet) {
+  while (!_unreliable_queue.empty() &&
+         packet.get_length() + _unreliable_queue.front().get_length() <= _max_packet_size) {
+    const Datagram &encoded = _unreliable_queue.front();
+    packet.append_data(encoded.get_data(), encoded.get_length());
+    _unreliable_queue.pop_front();
+  }
+}
+
+/**
+ * Sends all of the packets that are ready to the peer at the indicated
+ * address, via the indicated ConnectionWriter and UDP connection.  Returns
+ * the number of packets that were sent.
+ */
+int ReliableChannel::
+flush(ConnectionWriter *writer, Connection *connection,
+      const NetAddress &address, double now) {
+  nassertr(writer != nullptr && connection != nullptr, 0);
+
+  int num_sent = 0;
+  Datagram packet;
+  while (get_next_packet(packet, now)) {
+    if (!writer->send(packet, connection, address)) {
+      break;
+    }
+    ++num_sent;
+  }
+  return num_sent;
+}
+
+/**
+ * Retrieves the next message that was received from the peer.  Returns false
+ * if there is none.
+ */
+bool ReliableChannel::
+get_message(Datagram &message) {
+  if (_received.empty()) {
+    return false;
+  }
+  message = std::move(_received.front());
+  _received.pop_front();
+  return true;
+}
+
+/**
+ * Marks the packets acknowledged by the peer.  ack is the most recent packet
+ * it has received from us, and each bit of ack_bits stands for one of the 32
+ * packets before that.
+ */
+void ReliableChannel::
+process_acks(uint16_t ack, uint32_t ack_bits, double now) {
+  if (_sent_packets.empty()) {
+    return;
+  }
+
+  if (!_have_newest_acked || seq_greater(ack, _newest_acked)) {
+    // Only take the peer's word for it if we have actually sent that packet.
+    if (!seq_greater(ack, (uint16_t)(_local_seq - 1))) {
+      _have_newest_acked = true;
+      _newest_acked = ack;
+    }
+  }
+
+  for (size_t pi = 0; pi < _sent_packets.size(); ++pi) {
+    const SentPacket &sent = _sent_packets[pi];
+    if (sent._acked) {
+      continue;
+    }
+    uint16_t diff = (uint16_t)(ack - sent._seq);
+    if (diff == 0 || (diff <= 32 && (ack_bits & ((uint32_t)1 << (diff - 1))) != 0)) {
+      on_packet_acked(pi, now);
+    }
+  }
+
+  // Forget the packets at the front that have been dealt with.
+  while (!_sent_packets.empty() &&
+         (_sent_packets.front()._acked || _sent_packets.front()._lost)) {
+    _sent_packets.pop_front();
+  }
+
+  // Likewise the reliable messages.
+  while (!_reliable_queue.empty() && _reliable_queue.front()._acked) {
+    _reliable_queue.pop_front();
+  }
+}
+
+/**
+ * Called when the peer acknowledges the indicated packet for the first time.
+ */
+void ReliableChannel::
+on_packet_acked(size_t pi, double now) {
+  SentPacket &sent = _sent_packets[pi];
+  sent._acked = true;
+
+  if (!sent._lost) {
+    --_num_in_flight;
+
+    // Every packet has its own sequence number, so even if its messages were
+    // resent, this ack is for this particular transmission.
+    double sample = now - sent._time;
+    if (!_have_rtt) {
+      _have_rtt = true;
+      _srtt = sample;
+      _rttvar = sample * 0.5;
+    } else {
+      _rttvar = 0.75 * _rttvar + 0.25 * fabs(_srtt - sample);
+      _srtt = 0.875 * _srtt + 0.125 * sample;
+    }
+    _rto = min(max(_srtt + max(4.0 * _rttvar, rto_margin), min_rto), max_rto);
+
+    if (_cwnd < _ssthresh) {
+      _cwnd += 1.0;
+    } else {
+      _cwnd += 1.0 / _cwnd;
+    }
+    _cwnd = min(_cwnd, max_cwnd);
+  }
+
+  if (!sent._reliable_ids.empty() && !_reliable_queue.empty()) {
+    uint16_t base_id = _reliable_queue.front()._id;
+    for (uint16_t id : sent._reliable_ids) {
+      uint16_t offset = (uint16_t)(id - base_id);
+      if (offset < _reliable_queue.size()) {
+        OutgoingMessage &out = _reliable_queue[offset];
+        nassertd(out._id == id) continue;
+        out._acked = true;
+        out._needs_send = false;
+      }
+    }
+  }
+}
+
+/**
+ * Gives up on the packets that have been in flight too long, or that later
+ * packets have overtaken, and arranges for their reliable messages to be sent
+ * again.
+ */
+void ReliableChannel::
+detect_losses(double now) {
+  bool any_lost = false;
+  double lost_time = -1.0;
+
+  for (SentPacket &sent : _sent_packets) {
+    if (sent._acked || sent._lost) {
+      continue;
+    }
+    // A packet that several later ones have overtaken is probably lost, but
+    // we allow for a little reordering on the way.
+    bool overtaken = _have_newest_acked &&
+      (int16_t)(uint16_t)(_newest_acked - sent._seq) >= (int16_t)fast_resend_threshold &&
+      now - sent._time > _srtt * 1.25;
+    if (!overtaken && now - sent._time < _rto) {
+      continue;
+    }
+
+    sent._lost = true;
+    --_num_in_flight;
+    ++_num_packets_lost;
+    any_lost = true;
+    lost_time = max(lost_time, sent._time);
+
+    if (!_reliable_queue.empty()) {
+      uint16_t base_id = _reliable_queue.front()._id;
+      for (uint16_t id : sent._reliable_ids) {
+        uint16_t offset = (uint16_t)(id - base_id);
+        if (offset < _reliable_queue.size() && !_reliable_queue[offset]._acked) {
+          _reliable_queue[offset]._needs_send = true;
+        }
+      }
+    }
+  }
+
+  // Back off once per round trip, no matter how many packets from that
+  // window were lost.
+  if (any_lost && lost_time > _recovery_time) {
+    _ssthresh = max(_cwnd * 0.5, min_cwnd);
+    _cwnd = _ssthresh;
+    _recovery_time = now;
+  }
+
+  while (!_sent_packets.empty() &&
+         (_sent_packets.front()._acked || _sent_packets.front()._lost)) {
+    _sent_packets.pop_front();
+  }
+}
+
+/**
+ * Reads the header of one message from the packet, leaving the iterator at
+ * the start of the message's data.  Returns false if the header is malformed,
+ * or if the packet ends before the data does.
+ */
+bool ReliableChannel::
+read_message_header(DatagramIterator &scan, MessageHeader &header) {
+  if (scan.get_remaining_size() < 1) {
+    return false;
+  }
+  header._flags = scan.get_uint8();
+  size_t header_size = 2;
+  if (header._flags & MF_reliable) {
+    header_size += 2;
+  }
+  if (header._flags & MF_fragment) {
+    header_size += 4;
+  }
+  if (scan.get_remaining_size() < header_size) {
+    return false;
+  }
+
+  header._id = 0;
+  if (header._flags & MF_reliable) {
+    header._id = scan.get_uint16();
+  }
+  header._group = 0;
+  header._index = 0;
+  header._count = 1;
+  if (header._flags & MF_fragment) {
+    header._group = scan.get_uint16();
+    header._index = scan.get_uint8();
+    header._count = scan.get_uint8();
+    if (header._index >= header._count) {
+      return false;
+    }
+  }
+  header._length = scan.get_uint16();
+  return scan.get_remaining_size() >= header._length;
+}
+
+/**
+ * Returns true if the rest of the packet consists entirely of well-formed
+ * messages.  The iterator is taken by value, so the caller's is not moved.
+ */
+bool ReliableChannel::
+check_messages(DatagramIterator scan) {
+  while (scan.get_remaining_size() > 0) {
+    MessageHeader header;
+    if (!read_message_header(scan, header)) {
+      return false;
+    }
+    scan.skip_bytes(header._length);
+  }
+  return true;
+}
+
+/**
+ * Reads one message from the packet, and buffers or delivers it.  The packet
+ * must already have been checked with check_messages().
+ */
+void ReliableChannel::
+receive_message(DatagramIterator &scan) {
+  MessageHeader header;
+  bool okflag = read_message_header(scan, header);
+  nassertv(okflag);
+  uint8_t flags = header._flags;
+  uint16_t group = header._group;
+  uint8_t index = header._index;
+  uint8_t count = header._count;
+  DatagramView view = scan.extract_bytes_view(header._length);
+  Datagram data(view.data(), view.size());
+
+  if ((flags & MF_reliable) == 0) {
+    deliver(flags, group, index, count, std::move(data));
+    return;
+  }
+
+  // A reliable message is buffered until all the ones before it have
+  // arrived.  Ones we have already delivered are resends whose ack was lost.
+  uint16_t id = header._id;
+  uint16_t offset = (uint16_t)(id - _expected_reliable_id);
+  if (offset >= reliable_window_size) {
+    return;
+  }
+  ReceiveSlot &slot = _receive_window[id % reliable_window_size];
+  if (!slot._present) {
+    slot._present = true;
+    slot._flags = flags;
+    slot._group = group;
+    slot._index = index;
+    slot._count = count;
+    slot._data = std::move(data);
+  }
+
+  while (true) {
+    ReceiveSlot &next = _receive_window[_expected_reliable_id % reliable_window_size];
+    if (!next._present) {
+      break;
+    }
+    next._present = false;
+    deliver(next._flags, next._group, next._index, next._count, std::move(next._data));
+    next._data.clear();
+    ++_expected_reliable_id;
+  }
+}
+
+/**
+ * Hands a message, or one fragment of one, to the application.
+ */
+void ReliableChannel::
+deliver(uint8_t flags, uint16_t group, uint8_t index, uint8_t count,
+        Datagram &&data) {
+  if ((flags & MF_fragment) == 0) {
+    _received.push_back(std::move(data));
+    return;
+  }
+
+  if (flags & MF_reliable) {
+    // Reliable fragments arrive in order, so we only need to append them.
+    if (index == 0) {
+      _reliable_assembly.clear();
+      _reliable_assembly_next = 0;
+    }
+    if (index != _reliable_assembly_next) {
+      return;
+    }
+    _reliable_assembly.append_data(data.get_data(), data.get_length());
+    ++_reliable_assembly_next;
+    if (index + 1 == count) {
+      _received.push_back(std::move(_reliable_assembly));
+      _reliable_assembly.clear();
+      _reliable_assembly_next = 0;
+    }
+    return;
+  }
+
+  // Unreliable fragments may arrive in any order, or not at all.  We only
+  // keep a few partial messages around, dropping the oldest ones.
+  Assembly &assembly = _assemblies[group];
+  if (assembly._parts.empty()) {
+    assembly._num_received = 0;
+    assembly._parts.resize(count);
+    assembly._have.resize(count, false);
+  }
+  if (assembly._parts.size() != count || assembly._have[index]) {
+    return;
+  }
+  assembly._parts[index] = std::move(data);
+  assembly._have[index] = true;
+  ++assembly._num_received;
+
+  if (assembly._num_received == (int)count) {
+    Datagram message;
+    for (const Datagram &part : assembly._parts) {
+      message.append_data(part.get_data(), part.get_length());
+    }
+    _received.push_back(std::move(message));
+    _assemblies.erase(group);
+    return;
+  }
+
+  while (_assemblies.size() > 16) {
+    pmap<uint16_t, Assembly>::iterator oldest = _assemblies.begin();
+    for (pmap<uint16_t, Assembly>::iterator ai = _assemblies.begin();
+         ai != _assemblies.end(); ++ai) {
+      if (seq_greater(oldest->first, ai->first)) {
+        oldest = ai;
+      }
+    }
+    _assemblies.erase(oldest);
+  }
+}
+
+/**
+ * Appends the wire form of one message, or fragment, to the datagram.
+ */
+void ReliableChannel::
+add_message(Datagram &encoded, uint8_t flags, uint16_t id, uint16_t group,
+            uint8_t index, uint8_t count, const unsigned char *data,
+            size_t size) {
+  encoded.add_uint8(flags);
+  if (flags & MF_reliable) {
+    encoded.add_uint16(id);
+  }
+  if (flags & MF_fragment) {
+    encoded.add_uint16(group);
+    encoded.add_uint8(index);
+    encoded.add_uint8(count);
+  }
+  encoded.add_uint16((uint16_t)size);
+  encoded.append_data(data, size);
+}
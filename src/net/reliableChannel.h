@@ -0,0 +1,200 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file reliableChannel.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef RELIABLECHANNEL_H
+#define RELIABLECHANNEL_H
+
+#include "pandabase.h"
+#include "referenceCount.h"
+#include "datagram.h"
+#include "datagramIterator.h"
+#include "pointerTo.h"
+#include "pdeque.h"
+#include "pmap.h"
+#include "pvector.h"
+
+class Connection;
+class ConnectionWriter;
+class NetAddress;
+
+/**
+ * Carries both reliable and unreliable messages between two peers over an
+ * unreliable, unordered packet transport such as UDP.
+ *
+ * Reliable messages are delivered exactly once, in the order they were sent,
+ * while unreliable ones are delivered at most once, as soon as they arrive.
+ * Each packet that carries messages has a sequence number, and every packet
+ * acknowledges the last 33 of these received from the peer; only the
+ * reliable messages of packets that were lost are sent again.  Messages that do not fit in one packet are split into
+ * fragments and reassembled at the other end.  The number of packets in
+ * flight is limited by a congestion window that grows as packets are
+ * acknowledged and is halved when they are lost.
+ *
+ * This class does not own a socket.  Packets received from the peer are
+ * passed to receive_packet(), and the packets to send are retrieved with
+ * get_next_packet(), or handed straight to a ConnectionWriter with flush().
+ * Both take the current time in seconds, which may come from any clock, as
+ * long as it is used consistently.  Neither is thread-safe.
+ */
+class EXPCL_PANDA_NET ReliableChannel : public ReferenceCount {
+PUBLISHED:
+  explicit ReliableChannel(size_t max_packet_size = 1200);
+  ~ReliableChannel();
+
+  bool send(const Datagram &message, bool reliable = true);
+
+  bool receive_packet(const Datagram &packet, double now);
+  bool get_next_packet(Datagram &packet, double now);
+  int flush(ConnectionWriter *writer, Connection *connection,
+            const NetAddress &address, double now);
+
+  INLINE bool has_message() const;
+  bool get_message(Datagram &message);
+
+  INLINE size_t get_max_packet_size() const;
+  INLINE size_t get_max_message_size() const;
+
+  INLINE double get_rtt() const;
+  INLINE double get_rto() const;
+  INLINE double get_congestion_window() const;
+  INLINE int get_num_packets_in_flight() const;
+  INLINE int get_num_pending_reliable() const;
+  INLINE int get_num_pending_unreliable() const;
+
+  INLINE uint64_t get_num_packets_sent() const;
+  INLINE uint64_t get_num_packets_lost() const;
+  INLINE uint64_t get_num_messages_resent() const;
+  INLINE uint64_t get_num_unreliable_dropped() const;
+
+  MAKE_PROPERTY(rtt, get_rtt);
+  MAKE_PROPERTY(congestion_window, get_congestion_window);
+
+private:
+  void process_acks(uint16_t ack, uint32_t ack_bits, double now);
+  void on_packet_acked(size_t pi, double now);
+  void detect_losses(double now);
+  void receive_message(DatagramIterator &scan);
+  void deliver(uint8_t flags, uint16_t group, uint8_t index, uint8_t count,
+               Datagram &&data);
+  void add_message(Datagram &encoded, uint8_t flags, uint16_t id,
+                   uint16_t group, uint8_t index, uint8_t count,
+                   const unsigned char *data, size_t size);
+
+  INLINE static bool seq_greater(uint16_t a, uint16_t b);
+
+  enum MessageFlags {
+    MF_reliable = 0x01,
+    MF_fragment = 0x02,
+  };
+
+  // A reliable message that has not yet been acknowledged.
+  class OutgoingMessage {
+  public:
+    uint16_t _id;
+    Datagram _encoded;
+    bool _acked;
+    bool _needs_send;
+    double _last_sent;
+  };
+
+  // A packet that carried messages, and may not yet have been acknowledged.
+  class SentPacket {
+  public:
+    uint16_t _seq;
+    double _time;
+    bool _acked;
+    bool _lost;
+    pvector<uint16_t> _reliable_ids;
+  };
+
+  // A reliable message that arrived ahead of its predecessors.
+  class ReceiveSlot {
+  public:
+    bool _present;
+    uint8_t _flags;
+    uint16_t _group;
+    uint8_t _index;
+    uint8_t _count;
+    Datagram _data;
+  };
+
+  // The fragments of an unreliable message received so far.
+  class Assembly {
+  public:
+    int _num_received;
+    pvector<Datagram> _parts;
+    pvector<bool> _have;
+  };
+
+  // The header that precedes each message within a packet.
+  class MessageHeader {
+  public:
+    uint8_t _flags;
+    uint16_t _id;
+    uint16_t _group;
+    uint8_t _index;
+    uint8_t _count;
+    uint16_t _length;
+  };
+
+  static bool read_message_header(DatagramIterator &scan,
+                                  MessageHeader &header);
+  static bool check_messages(DatagramIterator scan);
+
+  void add_reliable_messages(Datagram &packet, SentPacket &sent, double now);
+  void add_unreliable_messages(Datagram &packet);
+
+  size_t _max_packet_size;
+
+  // Sending side.
+  uint16_t _local_seq;
+  uint16_t _next_reliable_id;
+  uint16_t _next_group;
+  pdeque<OutgoingMessage> _reliable_queue;
+  pdeque<Datagram> _unreliable_queue;
+  pdeque<SentPacket> _sent_packets;
+  int _num_in_flight;
+  bool _have_newest_acked;
+  uint16_t _newest_acked;
+
+  // Round-trip time estimate and congestion control.
+  double _srtt;
+  double _rttvar;
+  double _rto;
+  bool _have_rtt;
+  double _cwnd;
+  double _ssthresh;
+  double _recovery_time;
+  bool _reliable_first;
+
+  // Receiving side.
+  bool _have_remote_seq;
+  uint16_t _remote_seq;
+  uint32_t _remote_bits;
+  bool _ack_pending;
+  uint16_t _expected_reliable_id;
+  pvector<ReceiveSlot> _receive_window;
+  Datagram _reliable_assembly;
+  int _reliable_assembly_next;
+  pmap<uint16_t, Assembly> _assemblies;
+  pdeque<Datagram> _received;
+
+  uint64_t _num_packets_sent;
+  uint64_t _num_packets_lost;
+  uint64_t _num_messages_resent;
+  uint64_t _num_unreliable_dropped;
+};
+
+#include "reliableChannel.I"
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file ringQueue.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef RINGQUEUE_H
+#define RINGQUEUE_H
+
+#include "pandabase.h"
+#include "atomicAdjust.h"
+#include "lightMutex.h"
+#include "lightMutexHolder.h"
+#include "pdeque.h"
+#include "pvector.h"
+
+/**
+ * A FIFO queue that may be pushed to by any number of threads and popped from
+ * by any number of threads without taking a lock, as long as it holds no
+ * more than ring_size elements.  Each slot of the ring carries a sequence
+ * number that tells producers and consumers whether it is theirs to fill or
+ * to empty.
+ *
+ * Elements pushed while the ring is full are kept on a mutex-protected
+ * overflow list instead, which is drained only once the ring is empty; while
+ * the overflow list is in use, new elements are added to it as well, so that
+ * the elements pushed by any one thread are popped in order.  It is up to the
+ * owner to enforce a limit on the total size.
+ *
+ * Elements are moved in and out of the queue, not copied.
+ */
+template<class Thing>
+class RingQueue {
+public:
+  explicit RingQueue(size_t ring_size);
+  ~RingQueue();
+
+  void push(const Thing &thing);
+  void push(Thing &&thing);
+  bool pop(Thing &result);
+  size_t pop_batch(pvector<Thing> &result, size_t max_count);
+
+  INLINE int size() const;
+  INLINE bool empty() const;
+
+private:
+  bool push_ring(Thing &thing);
+  bool pop_ring(Thing &result);
+
+  class Cell {
+  public:
+    AtomicAdjust::Integer _seq;
+    Thing _data;
+  };
+
+  Cell *_cells;
+  AtomicAdjust::Integer _mask;
+
+  // The producers' and consumers' positions are kept apart so that they
+  // don't share a cache line.
+  AtomicAdjust::Integer _enqueue_pos;
+  char _pad0[64];
+  AtomicAdjust::Integer _dequeue_pos;
+  char _pad1[64];
+
+  // The number of elements in the ring and overflow list together.  This is
+  // only approximate while other threads are pushing or popping.
+  AtomicAdjust::Integer _size;
+
+  AtomicAdjust::Integer _num_overflow;
+  LightMutex _overflow_lock;
+  pdeque<Thing> _overflow;
+};
+
+#include "ringQueue.I"
+
+#endif
@@ -0,0 +1,311 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file stateSnapshot.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "stateSnapshot.h"
+#include "config_net.h"
+#include "datagramBitReader.h"
+#include "datagramBitWriter.h"
+
+#include <string.h>
+
+// The most fields an entity may have.
+static const int max_fields = 255;
+
+/**
+ *
+ */
+StateSnapshot::
+StateSnapshot(uint32_t sequence) :
+  _sequence(sequence)
+{
+}
+
+/**
+ * Sets the indicated field of the indicated entity, adding the entity if it
+ * is not already present.  Any fields before it that have not been set are
+ * zero.
+ */
+void StateSnapshot::
+set_int(uint32_t entity, int field, int32_t value) {
+  set_field(entity, field, (uint32_t)value);
+}
+
+/**
+ * Sets the indicated field of the indicated entity to a floating-point value.
+ */
+void StateSnapshot::
+set_float(uint32_t entity, int field, PN_float32 value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  set_field(entity, field, bits);
+}
+
+/**
+ * Returns the indicated field of the indicated entity, or 0 if it is not
+ * present.
+ */
+int32_t StateSnapshot::
+get_int(uint32_t entity, int field) const {
+  return (int32_t)get_field(entity, field);
+}
+
+/**
+ * Returns the indicated field of the indicated entity as a floating-point
+ * value, or 0 if it is not present.
+ */
+PN_float32 StateSnapshot::
+get_float(uint32_t entity, int field) const {
+  uint32_t bits = get_field(entity, field);
+  PN_float32 value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/**
+ * Returns the number of fields of the indicated entity, or 0 if it is not
+ * present.
+ */
+int StateSnapshot::
+get_num_fields(uint32_t entity) const {
+  Entities::const_iterator ei = _entities.find(entity);
+  if (ei == _entities.end()) {
+    return 0;
+  }
+  return (int)(*ei).second.size();
+}
+
+/**
+ * Removes the indicated entity from the snapshot.
+ */
+void StateSnapshot::
+remove_entity(uint32_t entity) {
+  _entities.erase(entity);
+}
+
+/**
+ * Reads a varint written by Datagram::add_varuint(), checking that it lies
+ * within the datagram, since a delta may come from an untrusted peer.
+ */
+static bool
+read_varuint(DatagramIterator &scan, uint64_t &value) {
+  value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (scan.get_remaining_size() == 0) {
+      return false;
+    }
+    uint8_t byte = scan.get_uint8();
+    value |= (uint64_t)(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * Writes this snapshot to the datagram, as the difference from the indicated
+ * baseline, which must be a snapshot the receiver already has.  If baseline
+ * is nullptr, the whole snapshot is written.
+ *
+ * Each entity that was added or changed is written with a bitmask of its
+ * changed fields, followed by their values; unchanged entities are not
+ * written at all.  Entity ids are written as varints, as the difference from
+ * the previous one.
+ */
+void StateSnapshot::
+write_delta(Datagram &dg, const StateSnapshot *baseline) const {
+  static const Entities empty_entities;
+  const Entities &base = (baseline != nullptr) ? baseline->_entities : empty_entities;
+
+  dg.add_varuint(_sequence);
+  dg.add_bool(baseline != nullptr);
+  if (baseline != nullptr) {
+    dg.add_varuint(baseline->_sequence);
+  }
+
+  // Walk the two sorted maps side by side.
+  Datagram removed, changed;
+  uint32_t num_removed = 0;
+  uint32_t num_changed = 0;
+  uint32_t last_removed = 0;
+  uint32_t last_changed = 0;
+  Entities::const_iterator ci = _entities.begin();
+  Entities::const_iterator bi = base.begin();
+  while (ci != _entities.end() || bi != base.end()) {
+    if (ci == _entities.end() || (bi != base.end() && (*bi).first < (*ci).first)) {
+      removed.add_varuint((*bi).first - last_removed);
+      last_removed = (*bi).first;
+      ++num_removed;
+      ++bi;
+      continue;
+    }
+
+    static const Fields empty_fields;
+    const Fields &fields = (*ci).second;
+    const Fields *base_fields = &empty_fields;
+    bool is_new = true;
+    if (bi != base.end() && (*bi).first == (*ci).first) {
+      base_fields = &(*bi).second;
+      is_new = false;
+      ++bi;
+    }
+
+    if (is_new || fields != *base_fields) {
+      size_t num_fields = fields.size();
+      changed.add_varuint((*ci).first - last_changed);
+      changed.add_varuint(num_fields);
+      last_changed = (*ci).first;
+
+      bool mask[max_fields];
+      {
+        DatagramBitWriter bits(changed);
+        for (size_t fi = 0; fi < num_fields; ++fi) {
+          uint32_t base_value = (fi < base_fields->size()) ? (*base_fields)[fi] : 0;
+          mask[fi] = (fields[fi] != base_value);
+          bits.add_bool(mask[fi]);
+        }
+      }
+      for (size_t fi = 0; fi < num_fields; ++fi) {
+        if (mask[fi]) {
+          changed.add_uint32(fields[fi]);
+        }
+      }
+      ++num_changed;
+    }
+    ++ci;
+  }
+
+  dg.add_varuint(num_removed);
+  dg.append_data(removed.get_data(), removed.get_length());
+  dg.add_varuint(num_changed);
+  dg.append_data(changed.get_data(), changed.get_length());
+}
+
+/**
+ * Reads a snapshot written by write_delta() against the indicated baseline,
+ * which should be nullptr if the delta was written without one.  Returns
+ * nullptr if the delta was encoded against a different baseline, or is
+ * malformed.
+ */
+PT(StateSnapshot) StateSnapshot::
+read_delta(DatagramIterator &scan, const StateSnapshot *baseline) {
+  uint64_t value;
+  if (!read_varuint(scan, value) || scan.get_remaining_size() < 1) {
+    return nullptr;
+  }
+  PT(StateSnapshot) snapshot = new StateSnapshot((uint32_t)value);
+  bool has_baseline = scan.get_bool();
+  if (has_baseline) {
+    if (!read_varuint(scan, value) || baseline == nullptr ||
+        value != baseline->_sequence) {
+      return nullptr;
+    }
+    snapshot->_entities = baseline->_entities;
+  }
+
+  uint64_t num_removed;
+  if (!read_varuint(scan, num_removed)) {
+    return nullptr;
+  }
+  uint32_t entity = 0;
+  for (uint64_t i = 0; i < num_removed; ++i) {
+    if (!read_varuint(scan, value)) {
+      return nullptr;
+    }
+    entity += (uint32_t)value;
+    snapshot->_entities.erase(entity);
+  }
+
+  uint64_t num_changed;
+  if (!read_varuint(scan, num_changed)) {
+    return nullptr;
+  }
+  entity = 0;
+  for (uint64_t i = 0; i < num_changed; ++i) {
+    uint64_t num_fields;
+    if (!read_varuint(scan, value) || !read_varuint(scan, num_fields) ||
+        num_fields > max_fields ||
+        scan.get_remaining_size() < (num_fields + 7) / 8) {
+      return nullptr;
+    }
+    entity += (uint32_t)value;
+
+    bool mask[max_fields];
+    DatagramBitReader bits(scan);
+    for (size_t fi = 0; fi < num_fields; ++fi) {
+      mask[fi] = bits.get_bool();
+    }
+    bits.align();
+
+    // Fields that are not in the mask keep their baseline values.
+    Fields &fields = snapshot->_entities[entity];
+    fields.resize(num_fields, 0);
+    for (size_t fi = 0; fi < num_fields; ++fi) {
+      if (mask[fi]) {
+        if (scan.get_remaining_size() < 4) {
+          return nullptr;
+        }
+        fields[fi] = scan.get_uint32();
+      }
+    }
+  }
+
+  return snapshot;
+}
+
+/**
+ * Returns true if the two snapshots have the same entities and fields.  The
+ * sequence numbers are not compared.
+ */
+bool StateSnapshot::
+operator == (const StateSnapshot &other) const {
+  return _entities == other._entities;
+}
+
+/**
+ *
+ */
+void StateSnapshot::
+output(std::ostream &out) const {
+  out << "StateSnapshot " << _sequence << ", " << _entities.size()
+      << " entities";
+}
+
+/**
+ *
+ */
+void StateSnapshot::
+set_field(uint32_t entity, int field, uint32_t bits) {
+  nassertv(field >= 0 && field < max_fields);
+  Fields &fields = _entities[entity];
+  if ((size_t)field >= fields.size()) {
+    fields.resize(field + 1, 0);
+  }
+  fields[field] = bits;
+}
+
+/**
+ *
+ */
+uint32_t StateSnapshot::
+get_field(uint32_t entity, int field) const {
+  Entities::const_iterator ei = _entities.find(entity);
+  if (ei == _entities.end()) {
+    return 0;
+  }
+  const Fields &fields = (*ei).second;
+  if (field < 0 || (size_t)field >= fields.size()) {
+    return 0;
+  }
+  return fields[field];
+}
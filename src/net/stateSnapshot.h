@@ -0,0 +1,82 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file stateSnapshot.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef STATESNAPSHOT_H
+#define STATESNAPSHOT_H
+
+#include "pandabase.h"
+#include "referenceCount.h"
+#include "datagram.h"
+#include "datagramIterator.h"
+#include "pointerTo.h"
+#include "pmap.h"
+#include "pvector.h"
+
+/**
+ * The state of a set of entities at one moment, each being a short list of
+ * 32-bit integer or floating-point fields, which can be encoded as the
+ * difference from an earlier snapshot.
+ *
+ * This is meant for state that is sent many times a second over an
+ * unreliable channel: the sender encodes each snapshot against the most
+ * recent one the receiver has acknowledged, so that only the entities and
+ * fields that changed since then take up space.  The receiver must keep the
+ * snapshots it has acknowledged until it knows the sender has moved on.
+ */
+class EXPCL_PANDA_NET StateSnapshot : public ReferenceCount {
+PUBLISHED:
+  explicit StateSnapshot(uint32_t sequence = 0);
+  StateSnapshot(const StateSnapshot &copy) = default;
+
+  INLINE void set_sequence(uint32_t sequence);
+  INLINE uint32_t get_sequence() const;
+
+  void set_int(uint32_t entity, int field, int32_t value);
+  void set_float(uint32_t entity, int field, PN_float32 value);
+  int32_t get_int(uint32_t entity, int field) const;
+  PN_float32 get_float(uint32_t entity, int field) const;
+
+  INLINE bool has_entity(uint32_t entity) const;
+  int get_num_fields(uint32_t entity) const;
+  INLINE int get_num_entities() const;
+  void remove_entity(uint32_t entity);
+  INLINE void clear();
+
+  void write_delta(Datagram &dg, const StateSnapshot *baseline) const;
+  static PT(StateSnapshot) read_delta(DatagramIterator &scan,
+                                      const StateSnapshot *baseline);
+
+  bool operator == (const StateSnapshot &other) const;
+  INLINE bool operator != (const StateSnapshot &other) const;
+
+  void output(std::ostream &out) const;
+
+private:
+  void set_field(uint32_t entity, int field, uint32_t bits);
+  uint32_t get_field(uint32_t entity, int field) const;
+
+  typedef pvector<uint32_t> Fields;
+  typedef pmap<uint32_t, Fields> Entities;
+
+  uint32_t _sequence;
+  Entities _entities;
+};
+
+INLINE std::ostream &operator << (std::ostream &out, const StateSnapshot &snapshot) {
+  snapshot.output(out);
+  return out;
+}
+
+#include "stateSnapshot.I"
+
+#endif
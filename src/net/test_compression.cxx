@@ -0,0 +1,228 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_compression.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+
+#include "queuedConnectionManager.h"
+#include "queuedConnectionListener.h"
+#include "queuedConnectionReader.h"
+#include "connectionWriter.h"
+#include "netDatagram.h"
+#include "trueClock.h"
+#include "thread.h"
+#include "panda_getopt.h"
+#include "preprocess_argv.h"
+
+#include <algorithm>
+
+// This opens a compressed TCP connection to itself, and sends a series of
+// datagrams over it, first with an immediate ConnectionWriter, and then with
+// a threaded one, which writes the datagrams it has queued up in batches
+// with writev().  Some of the datagrams are small enough to be sent without
+// compression; the rest are long, repetitive messages that compress well.
+// This is done with and without a dictionary.
+//
+// The test fails unless every datagram arrives intact and in order, and
+// fewer bytes went over the wire than were sent.
+
+static int port = 4998;
+static int num_messages = 500;
+
+static bool
+get_command_line_opts(int &argc, char **&argv) {
+  extern char *optarg;
+  extern int optind;
+  const char *options = "p:m:";
+  int flag = getopt(argc, argv, options);
+  while (flag != EOF) {
+    switch (flag) {
+    case 'p':
+      port = atoi(optarg);
+      break;
+
+    case 'm':
+      num_messages = std::max(atoi(optarg), 1);
+      break;
+
+    case '?':
+      nout
+        << "test_compression [-p port] [-m messages]\n";
+      return false;
+    }
+
+    flag = getopt(argc, argv, options);
+  }
+
+  argv += (optind - 1);
+  argc -= (optind - 1);
+
+  return true;
+}
+
+/**
+ * Returns the nth message to send.  Every fourth one is shorter than the
+ * size at which compression begins.
+ */
+static std::string
+make_message(int n) {
+  if ((n % 4) == 0) {
+    return std::string("hi ") + std::to_string(n);
+  }
+  std::string message;
+  int count = 1 + (n % 40);
+  for (int i = 0; i < count; ++i) {
+    message += "player " + std::to_string((n + i) % 16) +
+      " moved to position " + std::to_string(i * 10) + ", 0, 0; ";
+  }
+  return message;
+}
+
+/**
+ * Sends the messages from first to last with the indicated writer, and
+ * collects them at the other end.  Returns false if any of them did not
+ * arrive intact.
+ */
+static bool
+send_messages(ConnectionWriter &writer, Connection *client,
+              QueuedConnectionReader &reader, int first, int last) {
+  for (int n = first; n < last; ++n) {
+    NetDatagram datagram;
+    datagram.append_data(make_message(n));
+    if (!writer.send(datagram, client)) {
+      nout << "Could not send message " << n << ".\n";
+      return false;
+    }
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double timeout = clock->get_short_time() + 10.0;
+  int n = first;
+  while (n < last && clock->get_short_time() < timeout) {
+    reader.poll();
+    while (reader.data_available()) {
+      NetDatagram datagram;
+      if (reader.get_data(datagram)) {
+        if (datagram.get_message() != make_message(n)) {
+          nout << "Message " << n << " was garbled.\n";
+          return false;
+        }
+        ++n;
+      }
+    }
+    Thread::force_yield();
+  }
+
+  if (n < last) {
+    nout << "Only " << n - first << " of " << last - first
+         << " messages arrived.\n";
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Runs the test over a fresh connection, with the indicated dictionary.
+ */
+static bool
+run_test(const vector_uchar &dictionary) {
+  QueuedConnectionManager cm;
+  PT(Connection) rendezvous = cm.open_TCP_server_rendezvous(port, 5);
+  if (rendezvous == nullptr) {
+    nout << "Cannot grab port " << port << ".\n";
+    return false;
+  }
+
+  QueuedConnectionListener listener(&cm, 0);
+  listener.add_connection(rendezvous);
+
+  PT(Connection) client = cm.open_TCP_client_connection("127.0.0.1", port, 5000);
+  if (client == nullptr) {
+    nout << "Cannot connect to port " << port << ".\n";
+    return false;
+  }
+
+  PT(Connection) server;
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double timeout = clock->get_short_time() + 5.0;
+  while (server == nullptr && clock->get_short_time() < timeout) {
+    listener.poll();
+    if (listener.new_connection_available()) {
+      PT(Connection) rv;
+      NetAddress address;
+      listener.get_new_connection(rv, address, server);
+    }
+  }
+  if (server == nullptr) {
+    nout << "Connection was not accepted.\n";
+    return false;
+  }
+
+  // Both ends must enable compression before anything is sent.
+  if (!client->set_compression(6, dictionary) ||
+      !server->set_compression(6, dictionary)) {
+    nout << "Could not enable compression.\n";
+    return false;
+  }
+
+  QueuedConnectionReader reader(&cm, 1);
+  reader.add_connection(server);
+
+  bool okflag = true;
+  {
+    ConnectionWriter writer(&cm, 0);
+    okflag = send_messages(writer, client, reader, 0, num_messages / 2);
+  }
+  if (okflag) {
+    ConnectionWriter writer(&cm, 1);
+    okflag = send_messages(writer, client, reader, num_messages / 2, num_messages);
+  }
+
+  uint64_t payload = client->get_payload_bytes_sent();
+  uint64_t wire = client->get_wire_bytes_sent();
+  nout << (dictionary.empty() ? "Without" : "With") << " dictionary: "
+       << payload << " payload bytes sent in " << wire << " wire bytes, "
+       << server->get_payload_bytes_received() << " received in "
+       << server->get_wire_bytes_received() << ".\n";
+
+  if (okflag && wire >= payload) {
+    nout << "Compression did not reduce the data sent.\n";
+    okflag = false;
+  }
+  if (okflag && server->get_payload_bytes_received() != payload) {
+    nout << "Received payload does not match.\n";
+    okflag = false;
+  }
+
+  reader.remove_connection(server);
+  cm.close_connection(server);
+  cm.close_connection(client);
+  cm.close_connection(rendezvous);
+  return okflag;
+}
+
+int
+main(int argc, char *argv[]) {
+  preprocess_argv(argc, argv);
+  if (!get_command_line_opts(argc, argv)) {
+    return (1);
+  }
+
+  std::string words = "player  moved to position , 0, 0; ";
+  vector_uchar dictionary(words.begin(), words.end());
+
+  bool okflag = run_test(vector_uchar());
+  if (okflag) {
+    okflag = run_test(dictionary);
+  }
+  return okflag ? 0 : 1;
+}
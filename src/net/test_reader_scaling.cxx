@@ -0,0 +1,221 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_reader_scaling.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+
+#include "queuedConnectionManager.h"
+#include "queuedConnectionListener.h"
+#include "queuedConnectionReader.h"
+#include "connectionWriter.h"
+#include "netDatagram.h"
+#include "datagramIterator.h"
+#include "config_net.h"
+#include "trueClock.h"
+#include "thread.h"
+#include "panda_getopt.h"
+#include "preprocess_argv.h"
+
+#include <algorithm>
+
+// This is a loopback benchmark of the ConnectionReader.  For each of a series
+// of connection counts, it opens that many TCP connections to itself, sends a
+// number of timestamped datagrams over each of them, and reports the rate at
+// which they arrive and the 99th percentile of the time from send() until
+// the datagram is retrieved from the QueuedConnectionReader.
+//
+// Note that each connection takes two file descriptors, so the larger counts
+// may need a higher "ulimit -n".  The select() backend (-s) cannot handle
+// descriptors beyond FD_SETSIZE at all.
+
+static int port = 4999;
+static int num_threads = 4;
+static int num_messages = 100;
+static pvector<int> connection_counts;
+
+static bool
+get_command_line_opts(int &argc, char **&argv) {
+  extern char *optarg;
+  extern int optind;
+  const char *options = "p:t:m:c:s";
+  int flag = getopt(argc, argv, options);
+  while (flag != EOF) {
+    switch (flag) {
+    case 'p':
+      port = atoi(optarg);
+      break;
+
+    case 't':
+      num_threads = std::max(atoi(optarg), 0);
+      break;
+
+    case 'm':
+      num_messages = std::max(atoi(optarg), 1);
+      break;
+
+    case 'c':
+      connection_counts.push_back(std::max(atoi(optarg), 1));
+      break;
+
+    case 's':
+      net_use_epoll.set_value(false);
+      break;
+
+    case '?':
+      nout
+        << "test_reader_scaling [-p port] [-t threads] [-m messages] "
+        << "[-c connections ...] [-s]\n";
+      return false;
+    }
+
+    flag = getopt(argc, argv, options);
+  }
+
+  argv += (optind - 1);
+  argc -= (optind - 1);
+
+  return true;
+}
+
+/**
+ * Runs the benchmark with the indicated number of connections.  Returns false
+ * if the connections could not be established.
+ */
+static bool
+run_test(int num_connections) {
+  QueuedConnectionManager cm;
+  PT(Connection) rendezvous = cm.open_TCP_server_rendezvous(port, 1024);
+  if (rendezvous == nullptr) {
+    nout << "Cannot grab port " << port << ".\n";
+    return false;
+  }
+
+  QueuedConnectionListener listener(&cm, 0);
+  listener.add_connection(rendezvous);
+  QueuedConnectionReader reader(&cm, num_threads);
+  ConnectionWriter writer(&cm, 0);
+
+  // Open all of the client connections, and accept each one as it comes in.
+  pvector<PT(Connection)> clients;
+  pvector<PT(Connection)> servers;
+  clients.reserve(num_connections);
+  servers.reserve(num_connections);
+  while ((int)servers.size() < num_connections) {
+    if ((int)clients.size() < num_connections) {
+      PT(Connection) client = cm.open_TCP_client_connection("127.0.0.1", port, 5000);
+      if (client == nullptr) {
+        nout << "Could only open " << clients.size() << " connections.\n";
+        return false;
+      }
+      clients.push_back(client);
+    }
+
+    listener.poll();
+    while (listener.new_connection_available()) {
+      PT(Connection) rv;
+      NetAddress address;
+      PT(Connection) new_connection;
+      if (listener.get_new_connection(rv, address, new_connection)) {
+        reader.add_connection(new_connection);
+        servers.push_back(new_connection);
+      }
+    }
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  size_t total = (size_t)num_connections * num_messages;
+  pvector<double> latencies;
+  latencies.reserve(total);
+
+  double start = clock->get_short_time();
+  for (int mi = 0; mi < num_messages; ++mi) {
+    for (Connection *client : clients) {
+      NetDatagram datagram;
+      datagram.add_float64(clock->get_short_time());
+      writer.send(datagram, client);
+    }
+
+    // Collect whatever has arrived so far, so that the reader's queue never
+    // fills up.
+    reader.poll();
+    while (reader.data_available()) {
+      NetDatagram datagram;
+      if (reader.get_data(datagram)) {
+        DatagramIterator scan(datagram);
+        latencies.push_back(clock->get_short_time() - scan.get_float64());
+      }
+    }
+  }
+
+  double timeout = clock->get_short_time() + 10.0;
+  while (latencies.size() < total && clock->get_short_time() < timeout) {
+    reader.poll();
+    while (reader.data_available()) {
+      NetDatagram datagram;
+      if (reader.get_data(datagram)) {
+        DatagramIterator scan(datagram);
+        latencies.push_back(clock->get_short_time() - scan.get_float64());
+      }
+    }
+    Thread::force_yield();
+  }
+  double elapsed = clock->get_short_time() - start;
+
+  if (latencies.empty()) {
+    nout << num_connections << " connections: no datagrams received.\n";
+  } else {
+    std::sort(latencies.begin(), latencies.end());
+    double p99 = latencies[std::min(latencies.size() - 1, latencies.size() * 99 / 100)];
+    nout << num_connections << " connections ("
+         << (reader.is_using_epoll() ? "epoll" : "select") << "): "
+         << latencies.size() << " / " << total << " datagrams, "
+         << (int)(latencies.size() / elapsed) << " msgs/s, p99 latency "
+         << p99 * 1000000.0 << " us\n";
+  }
+  nout << "  " << *reader.get_stats() << "\n"
+       << "  " << *writer.get_stats() << "\n";
+
+  for (Connection *connection : servers) {
+    reader.remove_connection(connection);
+    cm.close_connection(connection);
+  }
+  for (Connection *connection : clients) {
+    cm.close_connection(connection);
+  }
+  cm.close_connection(rendezvous);
+  return true;
+}
+
+int
+main(int argc, char *argv[]) {
+  preprocess_argv(argc, argv);
+  if (!get_command_line_opts(argc, argv)) {
+    return (1);
+  }
+
+  if (connection_counts.empty()) {
+    connection_counts.push_back(10);
+    connection_counts.push_back(100);
+    connection_counts.push_back(1000);
+  }
+
+  nout << "Reading with " << num_threads << " threads, "
+       << num_messages << " datagrams per connection.\n";
+
+  for (int num_connections : connection_counts) {
+    if (!run_test(num_connections)) {
+      return (1);
+    }
+  }
+
+  return (0);
+}
@@ -0,0 +1,574 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_reliable_udp.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+
+#include "reliableChannel.h"
+#include "stateSnapshot.h"
+#include "datagramIterator.h"
+#include "panda_getopt.h"
+#include "preprocess_argv.h"
+
+#include <algorithm>
+#include <queue>
+#include <random>
+
+// This runs a ReliableChannel between two simulated peers over a link that
+// loses, delays, reorders and duplicates packets, and may be limited in
+// bandwidth.  Time is simulated, one millisecond per step, so the results
+// are repeatable for a given seed.
+//
+// The server sends a stream of reliable messages of random sizes, many large
+// enough to be fragmented, along with a delta-encoded world snapshot every 50
+// ms, which the client acknowledges so that the server can use it as the
+// next baseline.  The test fails unless every reliable message arrives
+// exactly once, intact and in order, and every snapshot decodes to what was
+// sent, and unless a packet that is held up behind many acknowledgements is
+// still acknowledged once it arrives.  It also fails if a packet that is
+// damaged in transit delivers anything, or keeps the intact copy of the same
+// packet from being accepted afterward.
+
+static double loss_rate = 0.1;
+static double latency = 0.05;
+static double jitter = 0.02;
+static double duplicate_rate = 0.02;
+static double bandwidth = 0.0;
+static int num_messages = 2000;
+static unsigned int seed = 1;
+
+static const int num_entities = 64;
+static const int num_fields = 6;
+static const double snapshot_interval = 0.05;
+static const double step = 0.001;
+
+enum MessageType {
+  MT_data,
+  MT_snapshot,
+  MT_snapshot_ack,
+};
+
+static std::mt19937 rng;
+
+static double
+random_real() {
+  return std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+}
+
+/**
+ * Carries packets in one direction between the two channels.
+ */
+class LossyLink {
+public:
+  LossyLink() : _busy_until(0.0), _order(0), _num_dropped(0), _num_bytes(0) {}
+
+  void send(const Datagram &packet, double now) {
+    _num_bytes += packet.get_length();
+    if (random_real() < loss_rate) {
+      ++_num_dropped;
+      return;
+    }
+
+    double depart = now;
+    if (bandwidth > 0.0) {
+      // Packets queue up behind each other, and are dropped when the queue
+      // is too long, as a router would.
+      depart = std::max(now, _busy_until) + packet.get_length() / bandwidth;
+      if (depart - now > 0.2) {
+        ++_num_dropped;
+        return;
+      }
+      _busy_until = depart;
+    }
+
+    int copies = (random_real() < duplicate_rate) ? 2 : 1;
+    for (int i = 0; i < copies; ++i) {
+      InFlight in_flight;
+      in_flight._arrival = depart + latency + random_real() * jitter;
+      in_flight._order = _order++;
+      in_flight._packet = packet;
+      _queue.push(std::move(in_flight));
+    }
+  }
+
+  bool receive(Datagram &packet, double now) {
+    if (_queue.empty() || _queue.top()._arrival > now) {
+      return false;
+    }
+    packet = _queue.top()._packet;
+    _queue.pop();
+    return true;
+  }
+
+  class InFlight {
+  public:
+    bool operator < (const InFlight &other) const {
+      // The priority queue puts the greatest first, so this is reversed.
+      if (_arrival != other._arrival) {
+        return _arrival > other._arrival;
+      }
+      return _order > other._order;
+    }
+
+    double _arrival;
+    uint64_t _order;
+    Datagram _packet;
+  };
+
+  std::priority_queue<InFlight> _queue;
+  double _busy_until;
+  uint64_t _order;
+  int _num_dropped;
+  uint64_t _num_bytes;
+};
+
+static bool
+get_command_line_opts(int &argc, char **&argv) {
+  extern char *optarg;
+  extern int optind;
+  const char *options = "l:d:j:u:b:n:s:";
+  int flag = getopt(argc, argv, options);
+  while (flag != EOF) {
+    switch (flag) {
+    case 'l':
+      loss_rate = atof(optarg) / 100.0;
+      break;
+
+    case 'd':
+      latency = atof(optarg) / 1000.0;
+      break;
+
+    case 'j':
+      jitter = atof(optarg) / 1000.0;
+      break;
+
+    case 'u':
+      duplicate_rate = atof(optarg) / 100.0;
+      break;
+
+    case 'b':
+      bandwidth = atof(optarg) * 1024.0;
+      break;
+
+    case 'n':
+      num_messages = std::max(atoi(optarg), 1);
+      break;
+
+    case 's':
+      seed = (unsigned int)atoi(optarg);
+      break;
+
+    case '?':
+      nout
+        << "test_reliable_udp [-l loss%] [-d latency ms] [-j jitter ms] "
+        << "[-u duplicate%] [-b KB/s] [-n messages] [-s seed]\n";
+      return false;
+    }
+
+    flag = getopt(argc, argv, options);
+  }
+
+  argv += (optind - 1);
+  argc -= (optind - 1);
+
+  return true;
+}
+
+/**
+ * Sends whatever packets the channel has ready over the link.
+ */
+static void
+pump(ReliableChannel &channel, LossyLink &link, double now) {
+  Datagram packet;
+  while (channel.get_next_packet(packet, now)) {
+    link.send(packet, now);
+  }
+}
+
+/**
+ * Delivers whatever packets have arrived over the link.
+ */
+static void
+deliver(LossyLink &link, ReliableChannel &channel, double now) {
+  Datagram packet;
+  while (link.receive(packet, now)) {
+    channel.receive_packet(packet, now);
+  }
+}
+
+/**
+ * Fills in the message with the given index, whose contents can be checked
+ * on arrival.
+ */
+static void
+make_message(Datagram &dg, uint32_t index) {
+  size_t size = (random_real() < 0.2) ? (size_t)(random_real() * 8000.0)
+                                      : (size_t)(random_real() * 200.0);
+  dg.add_uint8(MT_data);
+  dg.add_uint32(index);
+  dg.add_uint32((uint32_t)size);
+  for (size_t i = 0; i < size; ++i) {
+    dg.add_uint8((uint8_t)(index + i));
+  }
+}
+
+/**
+ * Returns true if the message is intact.
+ */
+static bool
+check_message(DatagramIterator &scan, uint32_t &index) {
+  index = scan.get_uint32();
+  uint32_t size = scan.get_uint32();
+  if (scan.get_remaining_size() != size) {
+    return false;
+  }
+  for (uint32_t i = 0; i < size; ++i) {
+    if (scan.get_uint8() != (uint8_t)(index + i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Moves the simulated world along a bit.
+ */
+static void
+update_world(StateSnapshot &world) {
+  for (int e = 0; e < num_entities; ++e) {
+    // Most entities are at rest most of the time.
+    if (random_real() < 0.3) {
+      int field = (int)(random_real() * num_fields);
+      world.set_float(e, field, world.get_float(e, field) + (PN_float32)random_real());
+    }
+  }
+  if (random_real() < 0.1) {
+    uint32_t entity = num_entities + (uint32_t)(random_real() * 16);
+    if (world.has_entity(entity)) {
+      world.remove_entity(entity);
+    } else {
+      world.set_int(entity, 0, (int32_t)entity);
+    }
+  }
+}
+
+/**
+ * Checks that a reliable message is still acknowledged when the packet that
+ * carried it arrives only after the peer has received many packets that
+ * carry nothing but acknowledgements, as happens when the other side is
+ * sending a steady stream of its own.  Returns true if it was.
+ */
+static bool
+check_late_ack() {
+  PT(ReliableChannel) server = new ReliableChannel;
+  PT(ReliableChannel) client = new ReliableChannel;
+  double now = 0.0;
+
+  // The client sends a reliable message, but the packet is held up.
+  Datagram message;
+  message.add_uint8(MT_data);
+  client->send(message, true);
+  Datagram delayed;
+  if (!client->get_next_packet(delayed, now)) {
+    nout << "Client did not send its message.\n";
+    return false;
+  }
+
+  // Meanwhile, the server sends many packets, and the client acknowledges
+  // each of them.
+  Datagram packet;
+  for (int i = 0; i < 100; ++i) {
+    now += step;
+    Datagram update;
+    update.add_uint8(MT_snapshot);
+    server->send(update, false);
+    while (server->get_next_packet(packet, now)) {
+      client->receive_packet(packet, now);
+    }
+    while (client->get_next_packet(packet, now)) {
+      server->receive_packet(packet, now);
+    }
+  }
+
+  // Now the held-up packet arrives, and the server acknowledges it.
+  now += step;
+  server->receive_packet(delayed, now);
+  while (server->get_next_packet(packet, now)) {
+    client->receive_packet(packet, now);
+  }
+
+  if (client->get_num_pending_reliable() != 0 ||
+      client->get_num_packets_lost() != 0) {
+    nout << "Delayed packet was not acknowledged.\n";
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Checks that a packet whose last message is cut short is rejected as a
+ * whole, and that the same packet is still accepted when it arrives intact.
+ * Returns true if it was.
+ */
+static bool
+check_malformed_packet() {
+  PT(ReliableChannel) server = new ReliableChannel;
+  PT(ReliableChannel) client = new ReliableChannel;
+  double now = 0.0;
+
+  // Two messages that go out in the same packet.
+  Datagram first, second;
+  first.add_uint8(MT_data);
+  first.add_uint32(1);
+  second.add_uint8(MT_data);
+  second.add_uint32(2);
+  client->send(first, true);
+  client->send(second, true);
+  Datagram packet;
+  if (!client->get_next_packet(packet, now)) {
+    nout << "Client did not send its messages.\n";
+    return false;
+  }
+
+  Datagram damaged(packet.get_data(), packet.get_length() - 1);
+  if (server->receive_packet(damaged, now)) {
+    nout << "Damaged packet was accepted.\n";
+    return false;
+  }
+  Datagram message;
+  if (server->get_message(message)) {
+    nout << "Damaged packet delivered a message.\n";
+    return false;
+  }
+
+  // Nothing of the damaged packet was recorded, so the intact one is not
+  // taken for a duplicate.
+  if (!server->receive_packet(packet, now)) {
+    nout << "Intact packet was rejected after the damaged one.\n";
+    return false;
+  }
+  int num_received = 0;
+  while (server->get_message(message)) {
+    DatagramIterator scan(message);
+    if (scan.get_uint8() != MT_data ||
+        scan.get_uint32() != (uint32_t)(num_received + 1)) {
+      nout << "Intact packet delivered the wrong message.\n";
+      return false;
+    }
+    ++num_received;
+  }
+  if (num_received != 2) {
+    nout << "Intact packet delivered " << num_received
+         << " messages, expected 2.\n";
+    return false;
+  }
+  return true;
+}
+
+int
+main(int argc, char *argv[]) {
+  preprocess_argv(argc, argv);
+  if (!get_command_line_opts(argc, argv)) {
+    return (1);
+  }
+  rng.seed(seed);
+
+  nout << "Loss " << loss_rate * 100.0 << "%, latency " << latency * 1000.0
+       << " ms, jitter " << jitter * 1000.0 << " ms, duplicates "
+       << duplicate_rate * 100.0 << "%, bandwidth ";
+  if (bandwidth > 0.0) {
+    nout << bandwidth / 1024.0 << " KB/s\n";
+  } else {
+    nout << "unlimited\n";
+  }
+
+  PT(ReliableChannel) server = new ReliableChannel;
+  PT(ReliableChannel) client = new ReliableChannel;
+  LossyLink to_client, to_server;
+
+  StateSnapshot world;
+  for (int e = 0; e < num_entities; ++e) {
+    for (int f = 0; f < num_fields; ++f) {
+      world.set_float(e, f, 0.0f);
+    }
+  }
+
+  // The snapshots the server has sent and the client may still use as a
+  // baseline, and the ones the client has received.
+  pmap<uint32_t, PT(StateSnapshot)> sent_snapshots;
+  pmap<uint32_t, PT(StateSnapshot)> received_snapshots;
+  bool have_acked_snapshot = false;
+  uint32_t acked_snapshot = 0;
+  uint32_t next_snapshot = 1;
+  double next_snapshot_time = 0.0;
+  int num_snapshots_received = 0;
+  int num_snapshots_bad = 0;
+  int num_snapshots_stale = 0;
+  size_t delta_bytes = 0;
+  size_t full_bytes = 0;
+
+  int num_sent = 0;
+  uint32_t next_expected = 0;
+  bool failed = false;
+
+  double now = 0.0;
+  double timeout = 600.0;
+  while (now < timeout) {
+    // The server queues a few reliable messages each step until it has sent
+    // them all, so that the congestion window governs how fast they go.
+    while (num_sent < num_messages && server->get_num_pending_reliable() < 64) {
+      Datagram dg;
+      make_message(dg, (uint32_t)num_sent);
+      server->send(dg, true);
+      ++num_sent;
+    }
+
+    // Like a real server, this skips a snapshot if the previous one hasn't
+    // gone out yet, rather than let them pile up.
+    if (now >= next_snapshot_time) {
+      next_snapshot_time += snapshot_interval;
+      update_world(world);
+    }
+    if (now + step >= next_snapshot_time &&
+        server->get_num_pending_unreliable() == 0) {
+      PT(StateSnapshot) snapshot = new StateSnapshot(world);
+      snapshot->set_sequence(next_snapshot++);
+      const StateSnapshot *baseline = nullptr;
+      if (have_acked_snapshot) {
+        baseline = sent_snapshots[acked_snapshot];
+      }
+
+      Datagram dg;
+      dg.add_uint8(MT_snapshot);
+      snapshot->write_delta(dg, baseline);
+      server->send(dg, false);
+      sent_snapshots[snapshot->get_sequence()] = snapshot;
+
+      Datagram full;
+      snapshot->write_delta(full, nullptr);
+      delta_bytes += dg.get_length();
+      full_bytes += full.get_length() + 1;
+    }
+
+    pump(*server, to_client, now);
+    pump(*client, to_server, now);
+    deliver(to_client, *client, now);
+    deliver(to_server, *server, now);
+
+    Datagram message;
+    while (client->get_message(message)) {
+      DatagramIterator scan(message);
+      uint8_t type = scan.get_uint8();
+      if (type == MT_data) {
+        uint32_t index;
+        if (!check_message(scan, index)) {
+          nout << "Message " << index << " was corrupted.\n";
+          failed = true;
+        } else if (index != next_expected) {
+          nout << "Received message " << index << ", expected "
+               << next_expected << ".\n";
+          failed = true;
+        }
+        next_expected = index + 1;
+
+      } else if (type == MT_snapshot) {
+        // Peek at the header to find the baseline it was encoded against.  If
+        // we no longer have it, this snapshot is older than one we have
+        // already seen, and can be ignored.
+        DatagramIterator header(scan);
+        uint32_t sequence = (uint32_t)header.get_varuint();
+        const StateSnapshot *baseline = nullptr;
+        bool has_baseline = header.get_bool();
+        uint32_t baseline_sequence = has_baseline ? (uint32_t)header.get_varuint() : 0;
+        if (has_baseline) {
+          pmap<uint32_t, PT(StateSnapshot)>::const_iterator si =
+            received_snapshots.find(baseline_sequence);
+          if (si == received_snapshots.end()) {
+            ++num_snapshots_stale;
+            continue;
+          }
+          baseline = (*si).second;
+        }
+
+        PT(StateSnapshot) snapshot = StateSnapshot::read_delta(scan, baseline);
+        ++num_snapshots_received;
+        pmap<uint32_t, PT(StateSnapshot)>::const_iterator si =
+          sent_snapshots.find(sequence);
+        if (snapshot == nullptr ||
+            (si != sent_snapshots.end() && *snapshot != *(*si).second)) {
+          nout << "Snapshot " << sequence << " did not decode correctly.\n";
+          ++num_snapshots_bad;
+          continue;
+        }
+        received_snapshots[sequence] = snapshot;
+
+        // The server will never use anything older than this baseline again.
+        if (has_baseline) {
+          received_snapshots.erase(received_snapshots.begin(),
+                                   received_snapshots.lower_bound(baseline_sequence));
+        }
+
+        Datagram ack;
+        ack.add_uint8(MT_snapshot_ack);
+        ack.add_uint32(sequence);
+        client->send(ack, false);
+      }
+    }
+
+    while (server->get_message(message)) {
+      DatagramIterator scan(message);
+      if (scan.get_uint8() == MT_snapshot_ack) {
+        uint32_t sequence = scan.get_uint32();
+        if (!have_acked_snapshot || sequence > acked_snapshot) {
+          have_acked_snapshot = true;
+          acked_snapshot = sequence;
+          sent_snapshots.erase(sent_snapshots.begin(), sent_snapshots.lower_bound(sequence));
+        }
+      }
+    }
+
+    if ((int)next_expected == num_messages && server->get_num_pending_reliable() == 0) {
+      break;
+    }
+    now += step;
+  }
+
+  nout << next_expected << " / " << num_messages << " reliable messages in "
+       << now << " s; "
+       << server->get_num_packets_sent() << " packets sent, "
+       << server->get_num_packets_lost() << " lost, "
+       << server->get_num_messages_resent() << " messages resent, "
+       << to_client._num_dropped << " dropped by the link\n"
+       << "rtt " << server->get_rtt() * 1000.0 << " ms, rto "
+       << server->get_rto() * 1000.0 << " ms, window "
+       << server->get_congestion_window() << " packets, "
+       << (int)(to_client._num_bytes / std::max(now, step) / 1024.0) << " KB/s\n"
+       << num_snapshots_received << " snapshots received, "
+       << num_snapshots_stale << " stale, " << num_snapshots_bad
+       << " bad; deltas were "
+       << (full_bytes > 0 ? delta_bytes * 100 / full_bytes : 0)
+       << "% of the size of full snapshots\n";
+
+  if (!check_late_ack()) {
+    failed = true;
+  }
+  if (!check_malformed_packet()) {
+    failed = true;
+  }
+
+  if (failed || (int)next_expected != num_messages || num_snapshots_bad != 0 ||
+      num_snapshots_received == 0) {
+    nout << "FAILED\n";
+    return (1);
+  }
+  return (0);
+}
@@ -23,14 +23,21 @@
 
 int
 main(int argc, char *argv[]) {
-  if (argc != 3) {
-    nout << "test_spam_client host port\n";
+  if (argc != 3 && argc != 4) {
+    nout << "test_spam_client host port [burst]\n";
     exit(1);
   }
 
   std::string hostname = argv[1];
   int port = atoi(argv[2]);
 
+  // The number of datagrams to send each time around the loop.  Raising this
+  // lets the writer threads batch them together.
+  int burst = 1;
+  if (argc == 4) {
+    burst = std::max(atoi(argv[3]), 1);
+  }
+
   NetAddress host;
   if (!host.set_host(hostname, port)) {
     nout << "Unknown host: " << hostname << "\n";
@@ -63,6 +70,8 @@ main(int argc, char *argv[]) {
 
   int num_sent = 0;
   int num_received = 0;
+  int last_sent = 0;
+  int last_received = 0;
 
   ClockObject *global_clock = ClockObject::get_global_clock();
   double last_reported_time = global_clock->get_real_time();
@@ -70,8 +79,10 @@ main(int argc, char *argv[]) {
 
   while (!lost_connection) {
     // Send the datagram.
-    if (writer.send(datagram, c)) {
-      num_sent++;
+    for (int i = 0; i < burst; ++i) {
+      if (writer.send(datagram, c)) {
+        num_sent++;
+      }
     }
 
     // Check for a lost connection.
@@ -88,7 +99,7 @@ main(int argc, char *argv[]) {
     }
 
     // Now poll for new datagrams on the socket.
-    if (reader.data_available()) {
+    while (reader.data_available()) {
       NetDatagram new_datagram;
       if (reader.get_data(new_datagram)) {
         num_received++;
@@ -97,9 +108,15 @@ main(int argc, char *argv[]) {
 
     double now = global_clock->get_real_time();
     if ((now - last_reported_time) > report_interval) {
+      double elapsed = now - last_reported_time;
       nout << "Sent " << num_sent << ", received "
-           << num_received << " datagrams.\n";
+           << num_received << " datagrams ("
+           << (int)((num_sent - last_sent) / elapsed) << " sent/s, "
+           << (int)((num_received - last_received) / elapsed)
+           << " received/s).\n";
       last_reported_time = now;
+      last_sent = num_sent;
+      last_received = num_received;
     }
 
     // Yield the timeslice before we poll again.
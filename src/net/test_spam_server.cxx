@@ -60,6 +60,8 @@ main(int argc, char *argv[]) {
 
   int num_sent = 0;
   int num_received = 0;
+  int last_sent = 0;
+  int last_received = 0;
 
   ClockObject *global_clock = ClockObject::get_global_clock();
   double last_reported_time = global_clock->get_real_time();
@@ -106,9 +108,15 @@ main(int argc, char *argv[]) {
 
     double now = global_clock->get_real_time();
     if ((now - last_reported_time) > report_interval) {
+      double elapsed = now - last_reported_time;
       nout << "Sent " << num_sent << ", received "
-           << num_received << " datagrams.\n";
+           << num_received << " datagrams ("
+           << (int)((num_sent - last_sent) / elapsed) << " sent/s, "
+           << (int)((num_received - last_received) / elapsed)
+           << " received/s).\n";
       last_reported_time = now;
+      last_sent = num_sent;
+      last_received = num_received;
     }
 
     // Yield the timeslice before we poll again.
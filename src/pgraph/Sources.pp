@@ -25,12 +25,14 @@
     cacheStats.I cacheStats.h \
     camera.I camera.h \
     clipPlaneAttrib.I clipPlaneAttrib.h \
+    clusteredGeomNode.I clusteredGeomNode.h \
     colorAttrib.I colorAttrib.h \
     colorBlendAttrib.I colorBlendAttrib.h \
     colorScaleAttrib.I colorScaleAttrib.h \
     colorWriteAttrib.I colorWriteAttrib.h \
     compassEffect.I compassEffect.h \
     config_pgraph.h \
+    cullArena.I cullArena.h \
     cullBin.I cullBin.h \
     cullBinEnums.h \
     cullBinAttrib.I cullBinAttrib.h \
@@ -68,6 +70,7 @@
     materialCollection.I materialCollection.h \
     modelFlattenRequest.I modelFlattenRequest.h \
     modelLoadRequest.I modelLoadRequest.h \
+    modelPremungeRequest.I modelPremungeRequest.h \
     modelSaveRequest.I modelSaveRequest.h \
     modelNode.I modelNode.h \
     modelPool.I modelPool.h \
@@ -85,6 +88,7 @@
     polylightNode.I polylightNode.h \
     portalNode.I portalNode.h \
     portalClipper.I portalClipper.h \
+    pvsNode.I pvsNode.h \
     renderAttrib.I renderAttrib.h \
     renderAttribRegistry.I renderAttribRegistry.h \
     renderEffect.I renderEffect.h \
@@ -125,12 +129,14 @@
     cacheStats.cxx \
     camera.cxx \
     clipPlaneAttrib.cxx \
+    clusteredGeomNode.cxx \
     colorAttrib.cxx \
     colorBlendAttrib.cxx \
     colorScaleAttrib.cxx \
     colorWriteAttrib.cxx \
     compassEffect.cxx \
     config_pgraph.cxx \
+    cullArena.cxx \
     cullBin.cxx \
     cullBinAttrib.cxx \
     cullBinManager.cxx \
@@ -167,6 +173,7 @@
     materialCollection.cxx \
     modelFlattenRequest.cxx \
     modelLoadRequest.cxx \
+    modelPremungeRequest.cxx \
     modelSaveRequest.cxx \
     modelNode.cxx \
     modelPool.cxx \
@@ -183,6 +190,7 @@
     polylightNode.cxx \
     portalNode.cxx \
     portalClipper.cxx \
+    pvsNode.cxx \
     renderAttrib.cxx \
     renderAttribRegistry.cxx \
     renderEffect.cxx \
@@ -223,12 +231,14 @@
     cacheStats.I cacheStats.h \
     camera.I camera.h \
     clipPlaneAttrib.I clipPlaneAttrib.h \
+    clusteredGeomNode.I clusteredGeomNode.h \
     colorAttrib.I colorAttrib.h \
     colorBlendAttrib.I colorBlendAttrib.h \
     colorScaleAttrib.I colorScaleAttrib.h \
     colorWriteAttrib.I colorWriteAttrib.h \
     compassEffect.I compassEffect.h \
     config_pgraph.h \
+    cullArena.I cullArena.h \
     cullBin.I cullBin.h \
     cullBinEnums.h \
     cullBinAttrib.I cullBinAttrib.h \
@@ -264,6 +274,7 @@
     materialCollection.I materialCollection.h \
     modelFlattenRequest.I modelFlattenRequest.h \
     modelLoadRequest.I modelLoadRequest.h \
+    modelPremungeRequest.I modelPremungeRequest.h \
     modelSaveRequest.I modelSaveRequest.h \
     modelNode.I modelNode.h \
     modelPool.I modelPool.h \
@@ -281,6 +292,7 @@
     polylightNode.I polylightNode.h \
     portalNode.I portalNode.h \
     portalClipper.I portalClipper.h \
+    pvsNode.I pvsNode.h \
     renderAttrib.I renderAttrib.h \
     renderAttribRegistry.I renderAttribRegistry.h \
     renderEffect.I renderEffect.h \
@@ -354,3 +366,33 @@
   #define LOCAL_LIBS $[LOCAL_LIBS] p3pgraph
 
 #end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_vertex_cache
+
+  #define SOURCES \
+    test_vertex_cache.cxx
+
+  #define LOCAL_LIBS $[LOCAL_LIBS] p3pgraph
+
+#end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_cull_arena
+
+  #define SOURCES \
+    test_cull_arena.cxx
+
+  #define LOCAL_LIBS $[LOCAL_LIBS] p3pgraph
+
+#end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_pvs_node
+
+  #define SOURCES \
+    test_pvs_node.cxx
+
+  #define LOCAL_LIBS $[LOCAL_LIBS] p3pgraph
+
+#end test_bin_target
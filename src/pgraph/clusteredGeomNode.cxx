@@ -0,0 +1,618 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file clusteredGeomNode.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "clusteredGeomNode.h"
+#include "cullTraverser.h"
+#include "cullTraverserData.h"
+#include "cullHandler.h"
+#include "cullableObject.h"
+#include "cullFaceAttrib.h"
+#include "cullPlanes.h"
+#include "geomTriangles.h"
+#include "geomVertexReader.h"
+#include "geomVertexWriter.h"
+#include "boundingSphere.h"
+#include "config_pgraph.h"
+#include "bamReader.h"
+#include "bamWriter.h"
+#include "datagram.h"
+#include "datagramIterator.h"
+#include "vector_int.h"
+
+TypeHandle ClusteredGeomNode::_type_handle;
+
+// The number of traversers for which each Geom remembers its partial Geom.
+static const size_t max_partials_per_geom = 4;
+
+/**
+ *
+ */
+ClusteredGeomNode::
+ClusteredGeomNode(const std::string &name) :
+  GeomNode(name),
+  _max_cluster_triangles(max_cluster_triangles)
+{
+}
+
+/**
+ *
+ */
+ClusteredGeomNode::
+ClusteredGeomNode(const ClusteredGeomNode &copy) :
+  GeomNode(copy),
+  _max_cluster_triangles(copy._max_cluster_triangles)
+{
+}
+
+/**
+ *
+ */
+ClusteredGeomNode::
+~ClusteredGeomNode() {
+}
+
+/**
+ * Returns a new ClusteredGeomNode with the same name, Geoms and properties
+ * as the indicated GeomNode (but none of its children).  Use
+ * PandaNode::replace_node() to put it in place of the original in the scene
+ * graph.
+ */
+PT(ClusteredGeomNode) ClusteredGeomNode::
+make_from(GeomNode *node) {
+  nassertr(node != nullptr, nullptr);
+  PT(ClusteredGeomNode) result = new ClusteredGeomNode(node->get_name());
+  result->copy_all_properties(node);
+  result->add_geoms_from(node);
+  return result;
+}
+
+/**
+ * Returns a newly-allocated Node that is a shallow copy of this one.  It will
+ * be a different Node pointer, but its internal data may or may not be shared
+ * with that of the original Node.
+ */
+PandaNode *ClusteredGeomNode::
+make_copy() const {
+  return new ClusteredGeomNode(*this);
+}
+
+/**
+ * Adds the node's contents to the CullResult we are building up during the
+ * cull traversal, so that it will be drawn at render time.  Each Geom is
+ * replaced with just the clusters that survive the view-frustum and back-face
+ * tests.
+ */
+void ClusteredGeomNode::
+add_for_draw(CullTraverser *trav, CullTraverserData &data) {
+  trav->_geom_nodes_pcollector.add_level(1);
+
+  Thread *current_thread = trav->get_current_thread();
+
+  Geoms geoms = get_geoms(current_thread);
+  int num_geoms = geoms.get_num_geoms();
+  trav->_geoms_pcollector.add_level(num_geoms);
+  CPT(TransformState) internal_transform = data.get_internal_transform(trav);
+
+  // Find the camera position in the coordinate space of this node, for the
+  // back-face test.  If the transform mirrors the geometry, the sense of
+  // the winding order is reversed, so we skip that test.
+  const TransformState *net_transform = data.get_net_transform(trav);
+  const LMatrix4 &net_mat = net_transform->get_mat();
+  bool cone_test = (net_mat.get_upper_3().determinant() > 0.0f);
+  LPoint3 camera_pos(0.0f, 0.0f, 0.0f);
+  if (cone_test) {
+    CPT(TransformState) rel_transform =
+      net_transform->invert_compose(trav->get_camera_transform());
+    camera_pos = rel_transform->get_mat().get_row3(3);
+  }
+
+  for (int i = 0; i < num_geoms; i++) {
+    CPT(Geom) geom = geoms.get_geom(i);
+    if (geom->is_empty()) {
+      continue;
+    }
+
+    CPT(RenderState) state = data._state->compose(geoms.get_geom_state(i));
+    if (state->has_cull_callback() && !state->cull_callback(trav, data)) {
+      // Cull.
+      continue;
+    }
+
+    if (num_geoms > 1) {
+      // Cull the individual Geom against the view frustum.
+      if (data._view_frustum != nullptr &&
+          !geom->is_in_view(data._view_frustum, current_thread)) {
+        continue;
+      }
+      if (data._cull_planes != nullptr) {
+        CPT(BoundingVolume) geom_volume = geom->get_bounds(current_thread);
+        const GeometricBoundingVolume *geom_gbv = geom_volume->as_geometric_bounding_volume();
+        int result;
+        data._cull_planes->do_cull(result, state, geom_gbv);
+        if (result == BoundingVolume::IF_no_intersection) {
+          continue;
+        }
+      }
+    }
+
+    PT(ClusteredGeom) cgeom = get_clustered_geom(i, geom, current_thread);
+    int num_clusters = (int)cgeom->_clusters.size();
+
+    const CullFaceAttrib *cfa;
+    state->get_attrib_def(cfa);
+    bool cull_back = cone_test &&
+      (cfa->get_effective_mode() == CullFaceAttrib::M_cull_clockwise);
+
+    if (num_clusters < 2 || (data._view_frustum == nullptr && !cull_back)) {
+      // Nothing to test; draw the whole thing.
+      CullableObject *object =
+        new CullableObject(cgeom->_geom, std::move(state), internal_transform);
+      trav->get_cull_handler()->record_object(object, trav);
+      continue;
+    }
+
+    BitArray visible;
+    int num_visible = 0;
+    for (int ci = 0; ci < num_clusters; ++ci) {
+      const Cluster &cluster = cgeom->_clusters[ci];
+
+      if (data._view_frustum != nullptr) {
+        BoundingSphere sphere(cluster._center, cluster._radius);
+        if (data._view_frustum->contains(&sphere) == BoundingVolume::IF_no_intersection) {
+          continue;
+        }
+      }
+
+      if (cull_back && cluster._cone_cos > 0.0f) {
+        // The cluster is entirely back-facing if the angle between the view
+        // direction and the cone axis, widened by the cone and by the angle
+        // subtended by the bounding sphere, is still under 90 degrees.
+        LVector3 to_center = cluster._center - camera_pos;
+        PN_stdfloat dist = to_center.length();
+        if (dist > cluster._radius) {
+          PN_stdfloat sin_m = cluster._radius / dist;
+          PN_stdfloat cos_m = csqrt(1.0f - sin_m * sin_m);
+          PN_stdfloat cos_sum = cluster._cone_cos * cos_m - cluster._cone_sin * sin_m;
+          if (cos_sum > 0.0f) {
+            PN_stdfloat sin_sum = cluster._cone_sin * cos_m + cluster._cone_cos * sin_m;
+            if (to_center.dot(cluster._cone_axis) >= sin_sum * dist) {
+              continue;
+            }
+          }
+        }
+      }
+
+      visible.set_bit(ci);
+      ++num_visible;
+    }
+
+    CullTraverser::_clusters_pcollector.add_level(num_visible);
+    CullTraverser::_clusters_culled_pcollector.add_level(num_clusters - num_visible);
+
+    if (num_visible == 0) {
+      continue;
+    }
+
+    CPT(Geom) draw_geom;
+    if (num_visible == num_clusters) {
+      draw_geom = cgeom->_geom;
+    } else {
+      {
+        LightMutexHolder holder(_lock);
+        draw_geom = cgeom->find_partial(trav, visible);
+      }
+      if (draw_geom == nullptr) {
+        // The clusters themselves never change, so the new index data can be
+        // built without holding the lock.
+        draw_geom = make_partial_geom(cgeom, visible, current_thread);
+        LightMutexHolder holder(_lock);
+        cgeom->store_partial(trav, visible, draw_geom);
+      }
+    }
+
+    CullableObject *object =
+      new CullableObject(std::move(draw_geom), std::move(state), internal_transform);
+    trav->get_cull_handler()->record_object(object, trav);
+  }
+}
+
+/**
+ * Returns the number of clusters the nth Geom has been divided into, or 1 if
+ * it could not be divided.  This computes the clusters if they have not yet
+ * been computed.
+ */
+int ClusteredGeomNode::
+get_num_clusters(int n) {
+  Thread *current_thread = Thread::get_current_thread();
+  Geoms geoms = get_geoms(current_thread);
+  nassertr(n >= 0 && n < geoms.get_num_geoms(), 0);
+
+  PT(ClusteredGeom) cgeom = get_clustered_geom(n, geoms.get_geom(n), current_thread);
+  return std::max((int)cgeom->_clusters.size(), 1);
+}
+
+/**
+ * Returns the clusters for the indicated Geom, which is the nth Geom of the
+ * node, computing them if necessary.
+ */
+PT(ClusteredGeomNode::ClusteredGeom) ClusteredGeomNode::
+get_clustered_geom(int n, const Geom *geom, Thread *current_thread) {
+  UpdateSeq modified = geom->get_modified(current_thread);
+  {
+    LightMutexHolder holder(_lock);
+    if (n < (int)_clustered_geoms.size()) {
+      ClusteredGeom *cgeom = _clustered_geoms[n];
+      if (cgeom != nullptr && cgeom->_source == geom &&
+          cgeom->_source_modified == modified) {
+        return cgeom;
+      }
+    }
+  }
+
+  // We compute the clusters outside of the lock; if another thread beats us
+  // to it, no harm is done.
+  PT(ClusteredGeom) cgeom = make_clustered_geom(geom, current_thread);
+  cgeom->_source_modified = modified;
+
+  LightMutexHolder holder(_lock);
+  if (n >= (int)_clustered_geoms.size()) {
+    _clustered_geoms.resize(n + 1);
+  }
+  _clustered_geoms[n] = cgeom;
+  return cgeom;
+}
+
+/**
+ * Divides the triangles of the indicated Geom into clusters of adjacent
+ * triangles, and returns a ClusteredGeom with a reordered copy of the Geom.
+ * If the Geom consists of anything other than polygons, or is too small to
+ * be worth dividing, the resulting ClusteredGeom has no clusters.
+ */
+PT(ClusteredGeomNode::ClusteredGeom) ClusteredGeomNode::
+make_clustered_geom(const Geom *geom, Thread *current_thread) const {
+  PT(ClusteredGeom) cgeom = new ClusteredGeom;
+  cgeom->_source = geom;
+  cgeom->_geom = geom;
+  cgeom->_next_partial = 0;
+
+  CPT(GeomVertexData) vdata = geom->get_vertex_data(current_thread);
+  if (!vdata->has_column(InternalName::get_vertex()) ||
+      vdata->get_transform_table() != nullptr ||
+      vdata->get_transform_blend_table() != nullptr ||
+      vdata->get_slider_table() != nullptr) {
+    // Animated vertices move around, so we can't precompute bounds.
+    return cgeom;
+  }
+
+  vector_int indices;
+  GeomEnums::UsageHint usage_hint = geom->get_usage_hint();
+  GeomEnums::ShadeModel shade_model = GeomEnums::SM_uniform;
+  int num_primitives = geom->get_num_primitives();
+  for (int i = 0; i < num_primitives; ++i) {
+    CPT(GeomPrimitive) prim = geom->get_primitive(i);
+    if (prim->get_primitive_type() != GeomEnums::PT_polygons) {
+      return cgeom;
+    }
+    CPT(GeomPrimitive) triangles = prim->decompose();
+    if (triangles->get_num_vertices_per_primitive() != 3) {
+      return cgeom;
+    }
+    if (i == 0) {
+      usage_hint = triangles->get_usage_hint();
+      shade_model = triangles->get_shade_model();
+    }
+    int num_vertices = triangles->get_num_vertices();
+    for (int vi = 0; vi < num_vertices; ++vi) {
+      indices.push_back(triangles->get_vertex(vi));
+    }
+  }
+
+  int num_triangles = (int)indices.size() / 3;
+  int max_triangles = _max_cluster_triangles;
+  if (num_triangles <= max_triangles) {
+    return cgeom;
+  }
+
+  int num_rows = vdata->get_num_rows();
+  pvector<LPoint3> positions(num_rows);
+  {
+    GeomVertexReader vertex(vdata, InternalName::get_vertex(), current_thread);
+    for (int ri = 0; ri < num_rows; ++ri) {
+      positions[ri] = vertex.get_data3();
+    }
+  }
+
+  // Build the vertex-to-triangle adjacency.
+  vector_int adj_start(num_rows + 1, 0);
+  for (int vi : indices) {
+    nassertr(vi >= 0 && vi < num_rows, cgeom);
+    ++adj_start[vi + 1];
+  }
+  for (int ri = 0; ri < num_rows; ++ri) {
+    adj_start[ri + 1] += adj_start[ri];
+  }
+  vector_int adjacency(indices.size());
+  {
+    vector_int fill(adj_start.begin(), adj_start.end() - 1);
+    for (size_t i = 0; i < indices.size(); ++i) {
+      adjacency[fill[indices[i]]++] = (int)(i / 3);
+    }
+  }
+
+  // Grow each cluster breadth-first across shared vertices from the first
+  // unassigned triangle, so that the clusters come out compact.
+  pvector<bool> assigned(num_triangles, false);
+  vector_int new_indices;
+  new_indices.reserve(indices.size());
+  vector_int queue;
+
+  for (int seed = 0; seed < num_triangles; ++seed) {
+    if (assigned[seed]) {
+      continue;
+    }
+
+    Cluster cluster;
+    cluster._first_index = (int)new_indices.size();
+    int count = 0;
+
+    queue.clear();
+    queue.push_back(seed);
+    for (size_t qi = 0; qi < queue.size() && count < max_triangles; ++qi) {
+      int ti = queue[qi];
+      if (assigned[ti]) {
+        continue;
+      }
+      assigned[ti] = true;
+      ++count;
+      for (int k = 0; k < 3; ++k) {
+        int vi = indices[ti * 3 + k];
+        new_indices.push_back(vi);
+        for (int ai = adj_start[vi]; ai < adj_start[vi + 1]; ++ai) {
+          if (!assigned[adjacency[ai]]) {
+            queue.push_back(adjacency[ai]);
+          }
+        }
+      }
+    }
+    cluster._num_indices = (int)new_indices.size() - cluster._first_index;
+
+    // Compute the bounding sphere around the center of the bounding box, and
+    // the cone that contains all of the triangle normals.
+    const int *begin = &new_indices[cluster._first_index];
+    const int *end = begin + cluster._num_indices;
+    LPoint3 min_point = positions[*begin];
+    LPoint3 max_point = min_point;
+    for (const int *p = begin; p != end; ++p) {
+      const LPoint3 &point = positions[*p];
+      min_point.set(std::min(min_point[0], point[0]),
+                    std::min(min_point[1], point[1]),
+                    std::min(min_point[2], point[2]));
+      max_point.set(std::max(max_point[0], point[0]),
+                    std::max(max_point[1], point[1]),
+                    std::max(max_point[2], point[2]));
+    }
+    cluster._center = (min_point + max_point) * 0.5f;
+    PN_stdfloat radius2 = 0.0f;
+    for (const int *p = begin; p != end; ++p) {
+      radius2 = std::max(radius2, (positions[*p] - cluster._center).length_squared());
+    }
+    cluster._radius = csqrt(radius2);
+
+    LVector3 axis(0.0f, 0.0f, 0.0f);
+    for (const int *p = begin; p != end; p += 3) {
+      LVector3 normal = (positions[p[1]] - positions[p[0]]).cross(positions[p[2]] - positions[p[0]]);
+      if (normal.normalize()) {
+        axis += normal;
+      }
+    }
+    cluster._cone_cos = 0.0f;
+    cluster._cone_sin = 1.0f;
+    if (axis.normalize()) {
+      PN_stdfloat min_dot = 1.0f;
+      for (const int *p = begin; p != end; p += 3) {
+        LVector3 normal = (positions[p[1]] - positions[p[0]]).cross(positions[p[2]] - positions[p[0]]);
+        if (normal.normalize()) {
+          min_dot = std::min(min_dot, normal.dot(axis));
+        }
+      }
+      if (min_dot > 0.0f) {
+        cluster._cone_cos = min_dot;
+        cluster._cone_sin = csqrt(std::max(1.0f - min_dot * min_dot, 0.0f));
+      }
+    }
+    cluster._cone_axis = axis;
+
+    cgeom->_clusters.push_back(cluster);
+  }
+
+  nassertr(new_indices.size() == indices.size(), cgeom);
+
+  PT(GeomTriangles) triangles = new GeomTriangles(usage_hint);
+  triangles->set_shade_model(shade_model);
+  if (num_rows >= 0xffff) {
+    triangles->set_index_type(GeomEnums::NT_uint32);
+  }
+  PT(GeomVertexArrayData) index_data = triangles->make_index_data();
+  index_data->unclean_set_num_rows((int)new_indices.size());
+  {
+    GeomVertexWriter index(index_data, 0, current_thread);
+    for (int vi : new_indices) {
+      index.set_data1i(vi);
+    }
+  }
+  triangles->set_vertices(index_data);
+
+  PT(Geom) new_geom = geom->make_copy();
+  new_geom->clear_primitives();
+  new_geom->add_primitive(triangles);
+  cgeom->_geom = new_geom;
+
+  if (pgraph_cat.is_debug()) {
+    pgraph_cat.debug()
+      << "Divided " << num_triangles << " triangles of " << *geom << " into "
+      << cgeom->_clusters.size() << " clusters\n";
+  }
+
+  return cgeom;
+}
+
+/**
+ * Returns the partial Geom that was last generated for the indicated
+ * traverser, if it draws exactly the indicated clusters, or NULL otherwise.
+ * Assumes the node's lock is held.
+ */
+CPT(Geom) ClusteredGeomNode::ClusteredGeom::
+find_partial(const CullTraverser *trav, const BitArray &visible) const {
+  Partials::const_iterator pi;
+  for (pi = _partials.begin(); pi != _partials.end(); ++pi) {
+    if ((*pi)._trav == trav) {
+      if ((*pi)._visible == visible) {
+        return (*pi)._geom;
+      }
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * Remembers the indicated partial Geom as the one last generated for the
+ * indicated traverser.  If there is no room for another traverser, the
+ * oldest one is forgotten.  Assumes the node's lock is held.
+ */
+void ClusteredGeomNode::ClusteredGeom::
+store_partial(const CullTraverser *trav, const BitArray &visible,
+              const Geom *geom) {
+  Partials::iterator pi;
+  for (pi = _partials.begin(); pi != _partials.end(); ++pi) {
+    if ((*pi)._trav == trav) {
+      (*pi)._visible = visible;
+      (*pi)._geom = geom;
+      return;
+    }
+  }
+
+  Partial partial;
+  partial._trav = trav;
+  partial._visible = visible;
+  partial._geom = geom;
+  if (_partials.size() < max_partials_per_geom) {
+    _partials.push_back(std::move(partial));
+  } else {
+    _partials[_next_partial] = std::move(partial);
+    _next_partial = (_next_partial + 1) % max_partials_per_geom;
+  }
+}
+
+/**
+ * Returns a new Geom that draws only the indicated clusters of the clustered
+ * Geom.
+ */
+CPT(Geom) ClusteredGeomNode::
+make_partial_geom(const ClusteredGeom *cgeom, const BitArray &visible,
+                  Thread *current_thread) {
+  CPT(GeomPrimitive) prim = cgeom->_geom->get_primitive(0);
+  int num_clusters = (int)cgeom->_clusters.size();
+
+  int num_indices = 0;
+  for (int ci = 0; ci < num_clusters; ++ci) {
+    if (visible.get_bit(ci)) {
+      num_indices += cgeom->_clusters[ci]._num_indices;
+    }
+  }
+
+  // The visible set will change from time to time, so this index buffer is
+  // marked accordingly.
+  PT(GeomPrimitive) new_prim = prim->make_copy();
+  new_prim->set_usage_hint(GeomEnums::UH_stream);
+  PT(GeomVertexArrayData) new_vertices = new_prim->make_index_data();
+  new_vertices->unclean_set_num_rows(num_indices);
+  {
+    CPT(GeomVertexArrayData) vertices = prim->get_vertices();
+    CPT(GeomVertexArrayDataHandle) from = vertices->get_handle(current_thread);
+    PT(GeomVertexArrayDataHandle) to = new_vertices->modify_handle(current_thread);
+    size_t stride = prim->get_index_stride();
+
+    // Copy contiguous runs of visible clusters with one call each.
+    size_t to_start = 0;
+    int ci = 0;
+    while (ci < num_clusters) {
+      if (!visible.get_bit(ci)) {
+        ++ci;
+        continue;
+      }
+      size_t from_start = cgeom->_clusters[ci]._first_index * stride;
+      size_t size = 0;
+      while (ci < num_clusters && visible.get_bit(ci)) {
+        size += cgeom->_clusters[ci]._num_indices * stride;
+        ++ci;
+      }
+      to->copy_subdata_from(to_start, size, from, from_start, size);
+      to_start += size;
+    }
+  }
+  new_prim->set_vertices(new_vertices, num_indices);
+
+  PT(Geom) partial = cgeom->_geom->make_copy();
+  partial->set_primitive(0, new_prim);
+
+  // Keep the bounds of the whole Geom, rather than recomputing them for
+  // every visible subset.
+  partial->set_bounds(cgeom->_geom->get_bounds(current_thread));
+  return partial;
+}
+
+/**
+ * Tells the BamReader how to create objects of type ClusteredGeomNode.
+ */
+void ClusteredGeomNode::
+register_with_read_factory() {
+  BamReader::get_factory()->register_factory(get_class_type(), make_from_bam);
+}
+
+/**
+ * Writes the contents of this object to the datagram for shipping out to a
+ * Bam file.
+ */
+void ClusteredGeomNode::
+write_datagram(BamWriter *manager, Datagram &dg) {
+  GeomNode::write_datagram(manager, dg);
+  dg.add_int32(_max_cluster_triangles);
+}
+
+/**
+ * This function is called by the BamReader's factory when a new object of
+ * type ClusteredGeomNode is encountered in the Bam file.  It should create
+ * the ClusteredGeomNode and extract its information from the file.
+ */
+TypedWritable *ClusteredGeomNode::
+make_from_bam(const FactoryParams &params) {
+  ClusteredGeomNode *node = new ClusteredGeomNode("");
+  DatagramIterator scan;
+  BamReader *manager;
+
+  parse_params(params, scan, manager);
+  node->fillin(scan, manager);
+
+  return node;
+}
+
+/**
+ * This internal function is called by make_from_bam to read in all of the
+ * relevant data from the BamFile for the new ClusteredGeomNode.
+ */
+void ClusteredGeomNode::
+fillin(DatagramIterator &scan, BamReader *manager) {
+  GeomNode::fillin(scan, manager);
+  _max_cluster_triangles = scan.get_int32();
+}
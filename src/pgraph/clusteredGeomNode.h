@@ -0,0 +1,156 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file clusteredGeomNode.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef CLUSTEREDGEOMNODE_H
+#define CLUSTEREDGEOMNODE_H
+
+#include "pandabase.h"
+#include "geomNode.h"
+#include "bitArray.h"
+#include "lightMutex.h"
+#include "lightMutexHolder.h"
+#include "updateSeq.h"
+#include "pvector.h"
+
+/**
+ * A special kind of GeomNode that partitions each of its Geoms into clusters
+ * of a limited number of adjacent triangles, each with its own bounding
+ * sphere and normal cone.  During the cull traversal, the clusters are culled
+ * individually against the view frustum, and clusters that are entirely
+ * back-facing are dropped as well; only the indices of the remaining clusters
+ * are sent on to be drawn.
+ *
+ * This is intended for the large Geoms produced by flatten_strong(), which
+ * batch well but would otherwise be culled only as a whole.  The clusters are
+ * computed on demand from the current Geoms, so that Geoms may be added or
+ * replaced freely; the first frame after such a change pays the cost.
+ *
+ * The Geom generated for a partially visible set of clusters is cached per
+ * Geom and per CullTraverser, so a view that does not change does not
+ * generate new index data every frame, even when the node is seen by several
+ * cameras at once.
+ */
+class EXPCL_PANDA_PGRAPH ClusteredGeomNode : public GeomNode {
+PUBLISHED:
+  explicit ClusteredGeomNode(const std::string &name);
+  static PT(ClusteredGeomNode) make_from(GeomNode *node);
+
+protected:
+  ClusteredGeomNode(const ClusteredGeomNode &copy);
+public:
+  virtual ~ClusteredGeomNode();
+  virtual PandaNode *make_copy() const;
+  virtual void add_for_draw(CullTraverser *trav, CullTraverserData &data);
+
+PUBLISHED:
+  INLINE void set_max_cluster_triangles(int max_cluster_triangles);
+  INLINE int get_max_cluster_triangles() const;
+  MAKE_PROPERTY(max_cluster_triangles, get_max_cluster_triangles,
+                set_max_cluster_triangles);
+
+  int get_num_clusters(int n);
+
+private:
+  class Cluster {
+  public:
+    int _first_index;
+    int _num_indices;
+    LPoint3 _center;
+    PN_stdfloat _radius;
+
+    // The triangle normals all lie within the cone around _cone_axis with
+    // the indicated half-angle.  If _cone_cos is not positive, the cone is
+    // too wide to be useful.
+    LVector3 _cone_axis;
+    PN_stdfloat _cone_cos;
+    PN_stdfloat _cone_sin;
+  };
+  typedef pvector<Cluster> Clusters;
+
+  class ClusteredGeom : public ReferenceCount {
+  public:
+    CPT(Geom) _source;
+    UpdateSeq _source_modified;
+
+    // The source Geom with its triangles reordered so that each cluster
+    // occupies a contiguous range of indices.
+    CPT(Geom) _geom;
+    Clusters _clusters;
+
+    // The Geom most recently generated for a partially visible set of
+    // clusters, for each of the last few traversers that drew this Geom.
+    // The traverser pointer is only used to tell them apart, never
+    // dereferenced, and the visible set is always compared before a Geom is
+    // reused; so it does no harm if a traverser is freed and another one is
+    // allocated at the same address.
+    class Partial {
+    public:
+      const CullTraverser *_trav;
+      BitArray _visible;
+      CPT(Geom) _geom;
+    };
+    typedef pvector<Partial> Partials;
+    Partials _partials;
+    size_t _next_partial;
+
+    CPT(Geom) find_partial(const CullTraverser *trav,
+                           const BitArray &visible) const;
+    void store_partial(const CullTraverser *trav, const BitArray &visible,
+                       const Geom *geom);
+  };
+  typedef pvector<PT(ClusteredGeom)> ClusteredGeoms;
+
+  PT(ClusteredGeom) get_clustered_geom(int n, const Geom *geom,
+                                       Thread *current_thread);
+  PT(ClusteredGeom) make_clustered_geom(const Geom *geom,
+                                        Thread *current_thread) const;
+  static CPT(Geom) make_partial_geom(const ClusteredGeom *cgeom,
+                                     const BitArray &visible,
+                                     Thread *current_thread);
+
+  int _max_cluster_triangles;
+
+  // Protects _clustered_geoms, which may be consulted by several cull
+  // threads at once.
+  LightMutex _lock;
+  ClusteredGeoms _clustered_geoms;
+
+public:
+  static void register_with_read_factory();
+  virtual void write_datagram(BamWriter *manager, Datagram &dg);
+
+protected:
+  static TypedWritable *make_from_bam(const FactoryParams &params);
+  void fillin(DatagramIterator &scan, BamReader *manager);
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    GeomNode::init_type();
+    register_type(_type_handle, "ClusteredGeomNode",
+                  GeomNode::get_class_type());
+  }
+  virtual TypeHandle get_type() const {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
+
+private:
+  static TypeHandle _type_handle;
+};
+
+#include "clusteredGeomNode.I"
+
+#endif
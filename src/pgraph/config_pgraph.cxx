@@ -20,6 +20,7 @@
 #include "billboardEffect.h"
 #include "camera.h"
 #include "clipPlaneAttrib.h"
+#include "clusteredGeomNode.h"
 #include "colorAttrib.h"
 #include "colorBlendAttrib.h"
 #include "colorScaleAttrib.h"
@@ -54,6 +55,7 @@
 #include "materialAttrib.h"
 #include "modelFlattenRequest.h"
 #include "modelLoadRequest.h"
+#include "modelPremungeRequest.h"
 #include "modelSaveRequest.h"
 #include "modelNode.h"
 #include "modelRoot.h"
@@ -68,6 +70,7 @@
 #include "occluderEffect.h"
 #include "occluderNode.h"
 #include "portalClipper.h"
+#include "pvsNode.h"
 #include "renderAttrib.h"
 #include "renderEffect.h"
 #include "renderEffects.h"
@@ -304,6 +307,38 @@ ConfigVariableBool flatten_geoms
           "only the NodePath interfaces; you may still make the lower-level "
           "SceneGraphReducer calls directly."));
 
+ConfigVariableBool flatten_optimize_vertex_cache
+("flatten-optimize-vertex-cache", false,
+ PRC_DESC("Set this true to have NodePath::flatten_strong() also reorder the "
+          "triangles and vertices of the resulting Geoms for better use of "
+          "the post-transform vertex cache and to reduce overdraw.  See "
+          "SceneGraphReducer::optimize_vertex_cache()."));
+
+ConfigVariableInt vertex_cache_size
+("vertex-cache-size", 32,
+ PRC_DESC("Specifies the number of entries of the post-transform vertex "
+          "cache that SceneGraphReducer::optimize_vertex_cache() optimizes "
+          "for by default.  The resulting triangle order also performs well "
+          "on hardware with a cache of a different size."));
+
+ConfigVariableInt max_cluster_triangles
+("max-cluster-triangles", 128,
+ PRC_DESC("Specifies the default maximum number of triangles in each of the "
+          "clusters that a ClusteredGeomNode divides its Geoms into for "
+          "culling."));
+
+ConfigVariableBool cull_arena
+("cull-arena", true,
+ PRC_DESC("Set this true to allocate the objects produced by each frame's "
+          "cull traversal from a per-frame arena that is recycled in bulk "
+          "after the frame has been drawn, or false to allocate each one "
+          "from the heap."));
+
+ConfigVariableInt cull_arena_block_size
+("cull-arena-block-size", 65536,
+ PRC_DESC("The size in bytes of each block of memory that a cull arena "
+          "allocates as it grows.  See cull-arena."));
+
 ConfigVariableInt max_lenses
 ("max-lenses", 100,
  PRC_DESC("Specifies an upper limit on the maximum number of lenses "
@@ -394,6 +429,7 @@ init_libpgraph() {
   BillboardEffect::init_type();
   Camera::init_type();
   ClipPlaneAttrib::init_type();
+  ClusteredGeomNode::init_type();
   ColorAttrib::init_type();
   ColorBlendAttrib::init_type();
   ColorScaleAttrib::init_type();
@@ -427,6 +463,7 @@ init_libpgraph() {
   MaterialAttrib::init_type();
   ModelFlattenRequest::init_type();
   ModelLoadRequest::init_type();
+  ModelPremungeRequest::init_type();
   ModelSaveRequest::init_type();
   ModelNode::init_type();
   ModelRoot::init_type();
@@ -442,6 +479,7 @@ init_libpgraph() {
   OccluderEffect::init_type();
   OccluderNode::init_type();
   PortalClipper::init_type();
+  PVSNode::init_type();
   RenderAttrib::init_type();
   RenderEffect::init_type();
   RenderEffects::init_type();
@@ -469,6 +507,7 @@ init_libpgraph() {
   BillboardEffect::register_with_read_factory();
   Camera::register_with_read_factory();
   ClipPlaneAttrib::register_with_read_factory();
+  ClusteredGeomNode::register_with_read_factory();
   CompassEffect::register_with_read_factory();
   ColorAttrib::register_with_read_factory();
   ColorBlendAttrib::register_with_read_factory();
@@ -495,6 +534,7 @@ init_libpgraph() {
   PlaneNode::register_with_read_factory();
   PolylightNode::register_with_read_factory();
   PortalNode::register_with_read_factory();
+  PVSNode::register_with_read_factory();
   OccluderEffect::register_with_read_factory();
   OccluderNode::register_with_read_factory();
   RenderEffects::register_with_read_factory();
@@ -57,6 +57,11 @@ extern ConfigVariableInt max_collect_indices;
 extern EXPCL_PANDA_PGRAPH ConfigVariableBool premunge_data;
 extern ConfigVariableBool preserve_geom_nodes;
 extern ConfigVariableBool flatten_geoms;
+extern ConfigVariableBool flatten_optimize_vertex_cache;
+extern ConfigVariableInt vertex_cache_size;
+extern ConfigVariableInt max_cluster_triangles;
+extern ConfigVariableBool cull_arena;
+extern ConfigVariableInt cull_arena_block_size;
 extern EXPCL_PANDA_PGRAPH ConfigVariableInt max_lenses;
 
 extern ConfigVariableBool polylight_info;
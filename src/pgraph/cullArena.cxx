@@ -0,0 +1,157 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cullArena.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "cullArena.h"
+#include "lightMutexHolder.h"
+#include "config_pgraph.h"
+
+#ifndef SIMPLE_THREADS
+// This is kept out of the class, since a thread_local may not be a member of
+// an exported class on Windows.
+static thread_local CullArena *current_arena = nullptr;
+#endif
+
+LightMutex CullArena::_pool_lock("CullArena::_pool_lock");
+CullArena::Pool CullArena::_pool;
+
+// Allocations are rounded up to this alignment.
+static const size_t arena_alignment = 16;
+
+/**
+ *
+ */
+CullArena::
+CullArena() :
+  _block_index(0),
+  _next(nullptr),
+  _end(nullptr),
+  _bytes_used(0)
+{
+}
+
+/**
+ *
+ */
+CullArena::
+~CullArena() {
+  Blocks::iterator bi;
+  for (bi = _blocks.begin(); bi != _blocks.end(); ++bi) {
+    PANDA_FREE_ARRAY((*bi)._data);
+  }
+}
+
+/**
+ * Returns an empty arena, reusing one from the pool if possible.  The arena
+ * should be handed back with release() when the objects allocated from it
+ * have all been destroyed.
+ */
+CullArena *CullArena::
+acquire() {
+  {
+    LightMutexHolder holder(_pool_lock);
+    if (!_pool.empty()) {
+      CullArena *arena = _pool.back();
+      _pool.pop_back();
+      return arena;
+    }
+  }
+  return new CullArena;
+}
+
+/**
+ * Discards everything that was allocated from the arena and returns it to
+ * the pool.  Any CullableObjects allocated from it must already have been
+ * destroyed.
+ */
+void CullArena::
+release(CullArena *arena) {
+  nassertv(arena != nullptr && arena != get_current());
+  arena->reset();
+
+  LightMutexHolder holder(_pool_lock);
+  _pool.push_back(arena);
+}
+
+/**
+ * Returns the arena that CullableObjects created by the current thread are
+ * allocated from, or NULL if they should come from the heap.
+ *
+ * With SIMPLE_THREADS, several Panda threads may share one system thread and
+ * switch at any time, so the arena is never used.
+ */
+CullArena *CullArena::
+get_current() {
+#ifdef SIMPLE_THREADS
+  return nullptr;
+#else
+  return current_arena;
+#endif
+}
+
+/**
+ * Makes the indicated arena, which may be NULL, the one that CullableObjects
+ * created by the current thread are allocated from.  Normally, a Scope is
+ * used instead.
+ */
+void CullArena::
+set_current(CullArena *arena) {
+#ifndef SIMPLE_THREADS
+  current_arena = arena;
+#endif
+}
+
+/**
+ * Returns a pointer to size bytes of uninitialized memory, aligned to 16
+ * bytes, which remains valid until the arena is released.
+ */
+void *CullArena::
+allocate(size_t size) {
+  size = (size + arena_alignment - 1) & ~(arena_alignment - 1);
+
+  while ((size_t)(_end - _next) < size) {
+    if (_next != nullptr) {
+      ++_block_index;
+    }
+    if (_block_index >= _blocks.size()) {
+      Block block;
+      block._size = std::max(size, (size_t)cull_arena_block_size);
+      block._data = (unsigned char *)PANDA_MALLOC_ARRAY(block._size);
+      _blocks.push_back(block);
+    }
+    const Block &block = _blocks[_block_index];
+    _next = block._data;
+    _end = block._data + block._size;
+  }
+
+  void *result = _next;
+  _next += size;
+  _bytes_used += size;
+  return result;
+}
+
+/**
+ * Makes all of the memory in the arena available again.  The blocks are kept
+ * for the next frame.
+ */
+void CullArena::
+reset() {
+  _block_index = 0;
+  if (_blocks.empty()) {
+    _next = nullptr;
+    _end = nullptr;
+  } else {
+    _next = _blocks[0]._data;
+    _end = _next + _blocks[0]._size;
+  }
+  _bytes_used = 0;
+}
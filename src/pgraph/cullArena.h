@@ -0,0 +1,83 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file cullArena.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef CULLARENA_H
+#define CULLARENA_H
+
+#include "pandabase.h"
+#include "pvector.h"
+#include "lightMutex.h"
+
+/**
+ * A block of memory from which the CullableObjects of one frame's
+ * CullResult are allocated.  Allocation just advances a pointer, and
+ * releasing a CullableObject only runs its destructor; the memory is
+ * reclaimed all at once when the CullResult is destroyed after it has been
+ * drawn, and the arena is then returned to a pool to be reused by a later
+ * frame, so that a steady state makes no calls to the heap at all.
+ *
+ * Since a CullResult may still be drawing while the next frame is being
+ * culled into another one, there are normally two or three arenas in use,
+ * depending on the threading model.
+ *
+ * An arena is made current for the calling thread with a CullArena::Scope
+ * for the duration of the cull traversal; CullableObjects created outside of
+ * such a scope are allocated from the heap as usual.
+ */
+class EXPCL_PANDA_PGRAPH CullArena {
+private:
+  CullArena();
+  ~CullArena();
+
+public:
+  static CullArena *acquire();
+  static void release(CullArena *arena);
+
+  void *allocate(size_t size);
+  INLINE size_t get_bytes_used() const;
+
+  static CullArena *get_current();
+  static void set_current(CullArena *arena);
+
+  class EXPCL_PANDA_PGRAPH Scope {
+  public:
+    INLINE Scope(CullArena *arena);
+    INLINE ~Scope();
+
+  private:
+    CullArena *_saved;
+  };
+
+private:
+  void reset();
+
+  class Block {
+  public:
+    unsigned char *_data;
+    size_t _size;
+  };
+  typedef pvector<Block> Blocks;
+  Blocks _blocks;
+  size_t _block_index;
+  unsigned char *_next;
+  unsigned char *_end;
+  size_t _bytes_used;
+
+  typedef pvector<CullArena *> Pool;
+  static LightMutex _pool_lock;
+  static Pool _pool;
+};
+
+#include "cullArena.I"
+
+#endif
@@ -86,12 +86,30 @@ ResultGraphBuilder(PandaNode *root_node) :
  */
 void CullBin::ResultGraphBuilder::
 add_object(CullableObject *object) {
-  if (_current_transform != object->_internal_transform ||
+  if (object->_instances == nullptr) {
+    add_instance(object, object->_internal_transform);
+  } else {
+    // An instanced object is shown as the separate copies it stands for.
+    const CullableObject::InstanceTransforms &transforms =
+      object->_instances->_transforms;
+    CullableObject::InstanceTransforms::const_iterator ti;
+    for (ti = transforms.begin(); ti != transforms.end(); ++ti) {
+      add_instance(object, *ti);
+    }
+  }
+}
+
+/**
+ * Adds one copy of the object, with the indicated transform.
+ */
+void CullBin::ResultGraphBuilder::
+add_instance(CullableObject *object, const TransformState *transform) {
+  if (_current_transform != transform ||
       _current_state != object->_state) {
     // Create a new GeomNode to hold the net transform and state.  We choose
     // to create a new GeomNode for each new state, to make it clearer to the
     // observer when the state changes.
-    _current_transform = object->_internal_transform;
+    _current_transform = transform;
     _current_state = object->_state;
     _current_node = new GeomNode("object_" + format_string(_object_index));
     _root_node->add_child(_current_node);
@@ -49,6 +49,9 @@ public:
   INLINE const std::string &get_name() const;
   INLINE BinType get_bin_type() const;
 
+  INLINE void set_instancing(bool instancing);
+  INLINE bool get_instancing() const;
+
   virtual PT(CullBin) make_next() const;
 
   virtual void add_object(CullableObject *object, Thread *current_thread)=0;
@@ -72,6 +75,7 @@ protected:
   std::string _name;
   BinType _bin_type;
   GraphicsStateGuardianBase *_gsg;
+  bool _instancing;
 
   // Used in make_result_graph() and fill_result_graph().
   class EXPCL_PANDA_PGRAPH ResultGraphBuilder {
@@ -80,6 +84,7 @@ protected:
     void add_object(CullableObject *object);
 
   private:
+    void add_instance(CullableObject *object, const TransformState *transform);
     void record_one_object(GeomNode *node, CullableObject *object);
 
   private:
@@ -99,6 +99,7 @@ add_bin(const string &name, BinType type, int sort) {
   def._type = type;
   def._sort = sort;
   def._active = true;
+  def._instancing = false;
 
 #ifndef NDEBUG
   // Check if there was a flash color configured for this bin name.
@@ -195,7 +196,11 @@ make_new_bin(int bin_index, GraphicsStateGuardianBase *gsg,
   BinConstructors::const_iterator ci = _bin_constructors.find(type);
   if (ci != _bin_constructors.end()) {
     BinConstructor *constructor = (*ci).second;
-    return constructor(name, gsg, draw_region_pcollector);
+    PT(CullBin) bin = constructor(name, gsg, draw_region_pcollector);
+    if (bin != nullptr) {
+      bin->set_instancing(_bin_definitions[bin_index]._instancing);
+    }
+    return bin;
   }
 
   // Hmm, unknown (or unregistered) bin type.
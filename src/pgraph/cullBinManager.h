@@ -64,6 +64,11 @@ PUBLISHED:
   INLINE void set_bin_active(int bin_index, bool active);
   INLINE void set_bin_active(const std::string &name, bool active);
 
+  INLINE bool get_bin_instancing(int bin_index) const;
+  INLINE bool get_bin_instancing(const std::string &name) const;
+  INLINE void set_bin_instancing(int bin_index, bool instancing);
+  INLINE void set_bin_instancing(const std::string &name, bool instancing);
+
 #ifndef NDEBUG
   INLINE bool get_bin_flash_active(int bin_index) const;
   INLINE const LColor &get_bin_flash_color(int bin_index) const;
@@ -105,6 +110,7 @@ private:
     BinType _type;
     int _sort;
     bool _active;
+    bool _instancing;
   };
   typedef epvector<BinDefinition> BinDefinitions;
   BinDefinitions _bin_definitions;
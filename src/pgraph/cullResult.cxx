@@ -29,6 +29,8 @@
 #include "depthOffsetAttrib.h"
 #include "colorBlendAttrib.h"
 
+PStatCollector CullResult::_arena_pcollector("Cull arena");
+
 TypeHandle CullResult::_type_handle;
 
 /*
@@ -58,8 +60,13 @@ CullResult::
 CullResult(GraphicsStateGuardianBase *gsg,
            const PStatCollector &draw_region_pcollector) :
   _gsg(gsg),
-  _draw_region_pcollector(draw_region_pcollector)
+  _draw_region_pcollector(draw_region_pcollector),
+  _arena(nullptr)
 {
+  if (cull_arena) {
+    _arena = CullArena::acquire();
+  }
+
 #ifdef DO_MEMORY_USAGE
   MemoryUsage::update_type(this, get_class_type());
 #endif
@@ -87,7 +94,11 @@ make_next() const {
         old_bin->get_bin_type() != bin_manager->get_bin_type(i)) {
       new_result->_bins.push_back(nullptr);
     } else {
-      new_result->_bins.push_back(old_bin->make_next());
+      PT(CullBin) new_bin = old_bin->make_next();
+      if (new_bin != nullptr) {
+        new_bin->set_instancing(bin_manager->get_bin_instancing(i));
+      }
+      new_result->_bins.push_back(std::move(new_bin));
     }
   }
 
@@ -278,6 +289,10 @@ finish_cull(SceneSetup *scene_setup, Thread *current_thread) {
       }
     }
   }
+
+  if (_arena != nullptr) {
+    _arena_pcollector.add_level(_arena->get_bytes_used());
+  }
 }
 
 /**
@@ -26,6 +26,8 @@
 #include "pset.h"
 #include "pmap.h"
 #include "rescaleNormalAttrib.h"
+#include "cullArena.h"
+#include "pStatCollector.h"
 
 class CullTraverser;
 class GraphicsStateGuardianBase;
@@ -59,8 +61,12 @@ PUBLISHED:
   PT(PandaNode) make_result_graph();
 
 public:
+  INLINE CullArena *get_arena() const;
+
   static void bin_removed(int bin_index);
 
+  static PStatCollector _arena_pcollector;
+
 private:
   CullBin *make_new_bin(int bin_index);
 
@@ -82,6 +88,9 @@ private:
   GraphicsStateGuardianBase *_gsg;
   PStatCollector _draw_region_pcollector;
 
+  // The CullableObjects in the bins are allocated from this, if it is set.
+  CullArena *_arena;
+
   typedef pvector< PT(CullBin) > Bins;
   Bins _bins;
 
@@ -39,6 +39,8 @@ PStatCollector CullTraverser::_nodes_pcollector("Nodes");
 PStatCollector CullTraverser::_geom_nodes_pcollector("Nodes:GeomNodes");
 PStatCollector CullTraverser::_geoms_pcollector("Geoms");
 PStatCollector CullTraverser::_geoms_occluded_pcollector("Geoms:Occluded");
+PStatCollector CullTraverser::_clusters_pcollector("Clusters");
+PStatCollector CullTraverser::_clusters_culled_pcollector("Clusters:Culled");
 
 TypeHandle CullTraverser::_type_handle;
 
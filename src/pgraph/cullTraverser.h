@@ -100,6 +100,8 @@ public:
   static PStatCollector _geom_nodes_pcollector;
   static PStatCollector _geoms_pcollector;
   static PStatCollector _geoms_occluded_pcollector;
+  static PStatCollector _clusters_pcollector;
+  static PStatCollector _clusters_culled_pcollector;
 
 private:
   void show_bounds(CullTraverserData &data, bool tight);
@@ -30,6 +30,9 @@
 #include "geomTriangles.h"
 #include "light.h"
 #include "lightMutexHolder.h"
+#include "cullArena.h"
+
+#include <algorithm>
 
 CullableObject::FormatMap CullableObject::_format_map;
 LightMutex CullableObject::_format_lock;
@@ -43,6 +46,41 @@ PStatCollector CullableObject::_sw_sprites_pcollector("SW Sprites");
 
 TypeHandle CullableObject::_type_handle;
 
+// Each CullableObject is preceded by a header recording the CullArena it was
+// allocated from, if any.  This is padded to keep the object aligned.
+static const size_t object_header_size = 16;
+
+/**
+ * CullableObjects created during the cull traversal are allocated from the
+ * CullArena of the CullResult being filled; others come from the heap.
+ */
+void *CullableObject::
+operator new(size_t size) {
+  CullArena *arena = CullArena::get_current();
+  void **header;
+  if (arena != nullptr) {
+    header = (void **)arena->allocate(size + object_header_size);
+  } else {
+    header = (void **)PANDA_MALLOC_SINGLE(size + object_header_size);
+  }
+  header[0] = arena;
+  return (unsigned char *)header + object_header_size;
+}
+
+/**
+ * Frees an object allocated from the heap.  The memory of an object
+ * allocated from a CullArena is reclaimed when the arena is released.
+ */
+void CullableObject::
+operator delete(void *ptr) {
+  if (ptr != nullptr) {
+    void **header = (void **)((unsigned char *)ptr - object_header_size);
+    if (header[0] == nullptr) {
+      PANDA_FREE_SINGLE(header);
+    }
+  }
+}
+
 void CullableObject::
 ensure_generated_shader(GraphicsStateGuardianBase *gsg) {
   gsg->ensure_generated_shader(_state);
@@ -202,6 +240,84 @@ munge_geom(GraphicsStateGuardianBase *gsg, GeomMunger *munger,
   return true;
 }
 
+/**
+ * Draws all of the copies of an instanced object (one that has _instances
+ * set).  If the GSG supports hardware instancing and the state has a shader
+ * that declares the "instance_transforms" array, the copies are drawn with
+ * as few draw calls as that array allows, with the transforms passed to the
+ * shader in that input; otherwise, which includes the software renderer,
+ * each copy is drawn in turn with its own transform.
+ *
+ * If instance_states is given, the state for a hardware-instanced draw is
+ * taken from it, and its matrix array is updated in place, rather than being
+ * made anew.
+ *
+ * This should only be called from the draw thread.
+ */
+void CullableObject::
+draw_instances(GraphicsStateGuardianBase *gsg, bool force,
+               Thread *current_thread, InstanceStates *instance_states) {
+  nassertv(_instances != nullptr && _geom != nullptr);
+  const InstanceTransforms &transforms = _instances->_transforms;
+
+  GeomPipelineReader geom_reader(_geom, current_thread);
+  GeomVertexDataPipelineReader data_reader(_munged_data, current_thread);
+  data_reader.check_array_readers();
+
+  const ShaderAttrib *sa = nullptr;
+  size_t max_instances = 0;
+  if (gsg->get_supports_geometry_instancing() &&
+      _state->get_attrib(sa) && sa->get_shader() != nullptr &&
+      sa->get_instance_count() == 0) {
+    max_instances = get_max_instances(gsg, sa->get_shader());
+  }
+
+  // The shader ignores the matrices beyond the end of its array, so the
+  // copies are drawn in batches that fit.
+  for (size_t first = 0; max_instances != 0 && first < transforms.size();
+       first += max_instances) {
+    size_t num_instances = std::min(max_instances, transforms.size() - first);
+    PTA_LMatrix4 mats;
+    CPT(RenderState) state;
+
+    if (instance_states != nullptr) {
+      InstanceStates::Entry &entry =
+        instance_states->_entries[std::make_pair(_state.p(), num_instances)];
+      if (entry._base_state == nullptr) {
+        entry._base_state = _state;
+      }
+      if (entry._num_used == entry._batches.size()) {
+        InstanceStates::Batch batch;
+        batch._matrices = PTA_LMatrix4(num_instances, LMatrix4::ident_mat());
+        batch._state = make_instanced_state(_state, sa, batch._matrices);
+        entry._batches.push_back(std::move(batch));
+      }
+      const InstanceStates::Batch &batch = entry._batches[entry._num_used++];
+      mats = batch._matrices;
+      state = batch._state;
+
+    } else {
+      mats = PTA_LMatrix4(num_instances, LMatrix4::ident_mat());
+      state = make_instanced_state(_state, sa, mats);
+    }
+
+    for (size_t i = 0; i < num_instances; ++i) {
+      mats[i] = transforms[first + i]->get_mat();
+    }
+
+    gsg->set_state_and_transform(state, TransformState::make_identity());
+    geom_reader.draw(gsg, &data_reader, force);
+  }
+
+  if (max_instances == 0) {
+    InstanceTransforms::const_iterator ti;
+    for (ti = transforms.begin(); ti != transforms.end(); ++ti) {
+      gsg->set_state_and_transform(_state, *ti);
+      geom_reader.draw(gsg, &data_reader, force);
+    }
+  }
+}
+
 /**
  *
  */
@@ -214,6 +330,76 @@ output(std::ostream &out) const {
   }
 }
 
+/**
+ * Returns the name of the shader input that receives the transforms of an
+ * instanced object.
+ */
+CPT(InternalName) CullableObject::
+get_instance_transforms_name() {
+  static CPT(InternalName) name = InternalName::make("instance_transforms");
+  return name;
+}
+
+/**
+ * Returns the number of elements in the "instance_transforms" array declared
+ * by the shader, which is the most copies that can be drawn with one call, or
+ * 0 if it doesn't declare one.  The inputs of a GLSL shader are only known
+ * once it has been linked, so the shader is prepared now if it isn't yet.
+ */
+size_t CullableObject::
+get_max_instances(GraphicsStateGuardianBase *gsg, const Shader *shader) {
+  const InternalName *name = get_instance_transforms_name();
+  PreparedGraphicsObjects *prepared_objects = gsg->get_prepared_objects();
+
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    for (const Shader::ShaderPtrSpec &spec : shader->_ptr_spec) {
+      if (spec._arg == name) {
+        // A size of -1 means that the length of the array is not checked.
+        return (spec._dim[0] < 0) ? (size_t)-1 : (size_t)spec._dim[0];
+      }
+    }
+    if (shader->is_prepared(prepared_objects)) {
+      break;
+    }
+    ((Shader *)shader)->prepare_now(prepared_objects, gsg);
+  }
+  return 0;
+}
+
+/**
+ * Returns the state to draw an instanced batch with, which is the indicated
+ * state with the matrix array added to its ShaderAttrib, sa, as the
+ * "instance_transforms" input, and the instance count set to its size.
+ */
+CPT(RenderState) CullableObject::
+make_instanced_state(const RenderState *state, const ShaderAttrib *sa,
+                     const PTA_LMatrix4 &matrices) {
+  CPT(RenderAttrib) attrib =
+    sa->set_shader_input(get_instance_transforms_name(), matrices);
+  attrib = DCAST(ShaderAttrib, attrib)->set_instance_count((int)matrices.size());
+  return state->set_attrib(attrib);
+}
+
+/**
+ * Prepares for drawing another frame: the states that were not used in the
+ * last one are released, and the rest become available again.
+ */
+void CullableObject::InstanceStates::
+next_frame() {
+  Entries::iterator ei = _entries.begin();
+  while (ei != _entries.end()) {
+    Entry &entry = (*ei).second;
+    if (entry._num_used == 0) {
+      ei = _entries.erase(ei);
+    } else {
+      // Drop any batches beyond what the last frame needed.
+      entry._batches.resize(entry._num_used);
+      entry._num_used = 0;
+      ++ei;
+    }
+  }
+}
+
 /**
  * Converts a table of points to quads for rendering on systems that don't
  * support fancy points.
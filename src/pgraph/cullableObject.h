@@ -30,9 +30,13 @@
 #include "lightMutex.h"
 #include "callbackObject.h"
 #include "geomDrawCallbackData.h"
+#include "pta_LMatrix4.h"
+#include "pmap.h"
 
 class CullTraverser;
 class GeomMunger;
+class ShaderAttrib;
+class Shader;
 
 /**
  * The smallest atom of cull.  This is normally just a Geom and its associated
@@ -53,11 +57,16 @@ public:
                   const CullTraverser *traverser, bool force);
   INLINE void draw(GraphicsStateGuardianBase *gsg,
                    bool force, Thread *current_thread);
+  class InstanceStates;
+  void draw_instances(GraphicsStateGuardianBase *gsg,
+                      bool force, Thread *current_thread,
+                      InstanceStates *instance_states = nullptr);
 
   INLINE bool request_resident() const;
   INLINE static void flush_level();
 
   INLINE void set_draw_callback(CallbackObject *draw_callback);
+  INLINE void set_prev_state(const RenderState *prev_state);
 
   INLINE void draw_inline(GraphicsStateGuardianBase *gsg,
                           bool force, Thread *current_thread);
@@ -67,7 +76,8 @@ public:
   virtual void ensure_generated_shader(GraphicsStateGuardianBase *gsg);
 
 public:
-  ALLOC_DELETED_CHAIN(CullableObject);
+  void *operator new(size_t size);
+  void operator delete(void *ptr);
 
   void output(std::ostream &out) const;
 
@@ -78,7 +88,63 @@ public:
   CPT(TransformState) _internal_transform;
   PT(CallbackObject) _draw_callback;
 
+  // If this is set, the object stands for several copies of the same Geom
+  // with the same state, which differ only in their transform; it is drawn
+  // once with each of these transforms in place of _internal_transform.  See
+  // CullBinManager::set_bin_instancing().
+  typedef pvector<CPT(TransformState)> InstanceTransforms;
+  class Instances : public ReferenceCount {
+  public:
+    InstanceTransforms _transforms;
+  };
+  PT(Instances) _instances;
+
+  // The states that draw_instances() makes for hardware instancing, kept
+  // from one frame to the next by the CullBin, so that a batch can be drawn
+  // without making a new matrix array, ShaderAttrib and RenderState each
+  // time.  Each state has its own matrix array, which is filled in place.
+  // Within a frame, every batch with the same state and count gets a
+  // different one, since the GSG only uploads a matrix array again when the
+  // ShaderAttrib changes or a new frame begins.
+  class InstanceStates : public ReferenceCount {
+  public:
+    void next_frame();
+
+  private:
+    class Batch {
+    public:
+      CPT(RenderState) _state;
+      PTA_LMatrix4 _matrices;
+    };
+    typedef pvector<Batch> Batches;
+
+    class Entry {
+    public:
+      // This keeps the pointer in the key valid.
+      CPT(RenderState) _base_state;
+      Batches _batches;
+      size_t _num_used = 0;
+    };
+    typedef pmap<std::pair<const RenderState *, size_t>, Entry> Entries;
+    Entries _entries;
+
+    friend class CullableObject;
+  };
+
+  // The state of the object that the CullBin will draw just before this one,
+  // and the attributes that differ between the two, as computed by
+  // set_prev_state().  _prev_state is NULL if this is not known.
+  const RenderState *_prev_state;
+  RenderState::SlotMask _changed_slots;
+
 private:
+  static CPT(InternalName) get_instance_transforms_name();
+  static size_t get_max_instances(GraphicsStateGuardianBase *gsg,
+                                  const Shader *shader);
+  static CPT(RenderState) make_instanced_state(const RenderState *state,
+                                               const ShaderAttrib *sa,
+                                               const PTA_LMatrix4 &matrices);
+
   bool munge_points_to_quads(const CullTraverser *traverser, bool force);
 
   static CPT(RenderState) get_flash_cpu_state();
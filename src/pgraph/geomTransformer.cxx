@@ -37,6 +37,7 @@ PStatCollector GeomTransformer::_apply_set_color_collector("*:Flatten:apply:set
 PStatCollector GeomTransformer::_apply_scale_color_collector("*:Flatten:apply:scale color");
 PStatCollector GeomTransformer::_apply_texture_color_collector("*:Flatten:apply:texture color");
 PStatCollector GeomTransformer::_apply_set_format_collector("*:Flatten:apply:set format");
+PStatCollector GeomTransformer::_apply_vertex_cache_collector("*:Flatten:apply:vertex cache");
 
 TypeHandle GeomTransformer::NewCollectedData::_type_handle;
 
@@ -46,7 +47,10 @@ TypeHandle GeomTransformer::NewCollectedData::_type_handle;
 GeomTransformer::
 GeomTransformer() :
   // The default value here comes from the Config file.
-  _max_collect_vertices(max_collect_vertices)
+  _max_collect_vertices(max_collect_vertices),
+  _num_optimized_triangles(0),
+  _vcache_misses_before(0.0),
+  _vcache_misses_after(0.0)
 {
 }
 
@@ -55,7 +59,10 @@ GeomTransformer() :
  */
 GeomTransformer::
 GeomTransformer(const GeomTransformer &copy) :
-  _max_collect_vertices(copy._max_collect_vertices)
+  _max_collect_vertices(copy._max_collect_vertices),
+  _num_optimized_triangles(0),
+  _vcache_misses_before(0.0),
+  _vcache_misses_after(0.0)
 {
 }
 
@@ -902,6 +909,111 @@ reverse(GeomNode *node) {
   return (num_geoms != 0);
 }
 
+/**
+ * Reorders the triangles of the indicated Geom for better use of the
+ * post-transform vertex cache, and then to reduce overdraw; see
+ * GeomPrimitive::optimize_vertex_cache() and
+ * GeomPrimitive::optimize_overdraw().  Triangle strips and fans are
+ * decomposed into independent triangles in the process, but only if that
+ * actually improves the cache efficiency.
+ *
+ * The Geom's vertices are also marked for reordering into the order in which
+ * they are first used, which will happen at the next call to finish_apply().
+ * The Geom is remembered even if it is not changed, so that it is remapped
+ * along with any other Geom passed here that shares its vertex data.  Geoms
+ * that share the vertex data but are never passed here keep the original,
+ * which remains valid for them.
+ *
+ * Returns true if the Geom was changed, false otherwise.
+ */
+bool GeomTransformer::
+optimize_vertex_cache(Geom *geom, int cache_size) {
+  PStatTimer timer(_apply_vertex_cache_collector);
+
+  CPT(GeomVertexData) vdata = geom->get_vertex_data();
+  bool any_changed = false;
+
+  int num_primitives = geom->get_num_primitives();
+  for (int i = 0; i < num_primitives; ++i) {
+    CPT(GeomPrimitive) prim = geom->get_primitive(i);
+    if (prim->get_primitive_type() != GeomEnums::PT_polygons ||
+        !prim->is_indexed()) {
+      // Non-indexed triangles don't share any vertices, so there is nothing
+      // to be gained.
+      continue;
+    }
+
+    CPT(GeomPrimitive) triangles = prim->decompose();
+    if (triangles->get_num_vertices_per_primitive() != 3) {
+      continue;
+    }
+    int num_triangles = triangles->get_num_vertices() / 3;
+    PN_stdfloat acmr_before = triangles->get_acmr(cache_size);
+
+    CPT(GeomPrimitive) optimized = triangles->optimize_vertex_cache(cache_size);
+    optimized = optimized->optimize_overdraw(vdata, cache_size);
+    PN_stdfloat acmr_after = optimized->get_acmr(cache_size);
+
+    _num_optimized_triangles += num_triangles;
+    _vcache_misses_before += acmr_before * num_triangles;
+    if (acmr_after < acmr_before) {
+      _vcache_misses_after += acmr_after * num_triangles;
+      geom->set_primitive(i, optimized);
+      any_changed = true;
+    } else {
+      _vcache_misses_after += acmr_before * num_triangles;
+    }
+  }
+
+  VertexDataAssoc &assoc = _vdata_assoc[vdata];
+  assoc._geoms.push_back(geom);
+  if (any_changed) {
+    assoc._reorder_vertices = true;
+  }
+
+  return any_changed;
+}
+
+/**
+ * Calls optimize_vertex_cache() on each Geom of the indicated GeomNode.
+ * Returns true if any Geoms were changed, false otherwise.
+ *
+ * Every Geom is replaced with a copy, even if it was not changed, since its
+ * vertex data may yet be reordered for the sake of another Geom.  A Geom
+ * that appears in more than one pipeline stage is only optimized once.
+ */
+bool GeomTransformer::
+optimize_vertex_cache(GeomNode *node, int cache_size) {
+  bool any_changed = false;
+
+  typedef pmap<CPT(Geom), PT(Geom) > NewGeoms;
+  NewGeoms new_geoms;
+
+  Thread *current_thread = Thread::get_current_thread();
+  OPEN_ITERATE_CURRENT_AND_UPSTREAM(node->_cycler, current_thread) {
+    GeomNode::CDStageWriter cdata(node->_cycler, pipeline_stage, current_thread);
+    GeomNode::GeomList::iterator gi;
+    PT(GeomNode::GeomList) geoms = cdata->modify_geoms();
+    for (gi = geoms->begin(); gi != geoms->end(); ++gi) {
+      GeomNode::GeomEntry &entry = (*gi);
+      CPT(Geom) orig_geom = entry._geom.get_read_pointer();
+      std::pair<NewGeoms::iterator, bool> result =
+        new_geoms.insert(NewGeoms::value_type(orig_geom, nullptr));
+      if (result.second) {
+        PT(Geom) new_geom = orig_geom->make_copy();
+        if (optimize_vertex_cache(new_geom, cache_size)) {
+          any_changed = true;
+        }
+        (*result.first).second = std::move(new_geom);
+      }
+      entry._geom = (*result.first).second;
+    }
+  }
+  CLOSE_ITERATE_CURRENT_AND_UPSTREAM(node->_cycler);
+
+  return any_changed;
+}
+
 /**
  * Should be called after performing any operations--particularly
  * PandaNode::apply_attribs_to_vertices()--that might result in new
@@ -915,7 +1027,9 @@ finish_apply() {
   for (vi = _vdata_assoc.begin(); vi != _vdata_assoc.end(); ++vi) {
     const GeomVertexData *vdata = (*vi).first;
     VertexDataAssoc &assoc = (*vi).second;
-    if (assoc._might_have_unused) {
+    if (assoc._reorder_vertices) {
+      assoc.reorder_vertices(vdata);
+    } else if (assoc._might_have_unused) {
       assoc.remove_unused_vertices(vdata);
     }
   }
@@ -1549,3 +1663,152 @@ remove_unused_vertices(const GeomVertexData *vdata) {
     geom->set_vertex_data(new_vdata);
   }
 }
+
+/**
+ * Rearranges the vertices in the indicated GeomVertexData into the order in
+ * which they are first referenced by the associated Geoms, so that the
+ * vertex fetches made while drawing them proceed linearly through memory.
+ * Vertices that are not referenced at all are removed in the process.
+ *
+ * Every associated Geom that uses this vertex data is given the new vertex
+ * data and has all of its primitives remapped, whether or not its own
+ * triangles were reordered.
+ */
+void GeomTransformer::VertexDataAssoc::
+reorder_vertices(const GeomVertexData *vdata) {
+  if (_geoms.empty()) {
+    // Trivial case.
+    return;
+  }
+
+  if (vdata->get_transform_blend_table() != nullptr ||
+      vdata->get_slider_table() != nullptr) {
+    // These tables refer to particular ranges of rows, which we would have to
+    // break up.  It's not worth it; just remove the unused vertices.
+    if (_might_have_unused) {
+      remove_unused_vertices(vdata);
+    }
+    return;
+  }
+
+  PT(Thread) current_thread = Thread::get_current_thread();
+
+  int num_vertices = vdata->get_num_rows();
+  vector_int remap_array(num_vertices, -1);
+  vector_int order;
+  order.reserve(num_vertices);
+
+  bool any_referenced = false;
+  GeomList::iterator gi;
+  for (gi = _geoms.begin(); gi != _geoms.end(); ++gi) {
+    Geom *geom = (*gi);
+    if (geom->get_vertex_data() != vdata) {
+      continue;
+    }
+
+    any_referenced = true;
+    int num_primitives = geom->get_num_primitives();
+    for (int i = 0; i < num_primitives; ++i) {
+      CPT(GeomPrimitive) prim = geom->get_primitive(i);
+      if (!prim->is_indexed()) {
+        int first_vertex = prim->get_first_vertex();
+        int end_vertex = first_vertex + prim->get_num_vertices();
+        nassertv(end_vertex <= num_vertices);
+        for (int index = first_vertex; index < end_vertex; ++index) {
+          if (remap_array[index] < 0) {
+            remap_array[index] = (int)order.size();
+            order.push_back(index);
+          }
+        }
+        continue;
+      }
+
+      int strip_cut_index = prim->get_strip_cut_index();
+      GeomVertexReader reader(prim->get_vertices(), 0, current_thread);
+      while (!reader.is_at_end()) {
+        int index = reader.get_data1i();
+        if (index == strip_cut_index) {
+          continue;
+        }
+        nassertv(index >= 0 && index < num_vertices);
+        if (remap_array[index] < 0) {
+          remap_array[index] = (int)order.size();
+          order.push_back(index);
+        }
+      }
+    }
+  }
+
+  if (!any_referenced) {
+    return;
+  }
+
+  int new_num_vertices = (int)order.size();
+  if (new_num_vertices == num_vertices) {
+    bool is_identity = true;
+    for (int index = 0; index < num_vertices && is_identity; ++index) {
+      is_identity = (order[index] == index);
+    }
+    if (is_identity) {
+      // The vertices are already in order.
+      return;
+    }
+  }
+
+  // Now recopy the actual vertex data, one array at a time.
+  PT(GeomVertexData) new_vdata = new GeomVertexData(*vdata);
+  new_vdata->unclean_set_num_rows(new_num_vertices);
+
+  size_t num_arrays = vdata->get_num_arrays();
+  nassertv(num_arrays == new_vdata->get_num_arrays());
+
+  GeomVertexDataPipelineReader reader(vdata, current_thread);
+  reader.check_array_readers();
+  GeomVertexDataPipelineWriter writer(new_vdata, true, current_thread);
+  writer.check_array_writers();
+
+  for (size_t a = 0; a < num_arrays; ++a) {
+    const GeomVertexArrayDataHandle *array_reader = reader.get_array_reader(a);
+    GeomVertexArrayDataHandle *array_writer = writer.get_array_writer(a);
+
+    int stride = array_reader->get_array_format()->get_stride();
+    nassertv(stride == array_writer->get_array_format()->get_stride());
+
+    for (int new_index = 0; new_index < new_num_vertices; ++new_index) {
+      array_writer->copy_subdata_from(new_index * stride, stride,
+                                      array_reader,
+                                      order[new_index] * stride, stride);
+    }
+  }
+
+  // Finally, reindex the Geoms.
+  for (gi = _geoms.begin(); gi != _geoms.end(); ++gi) {
+    Geom *geom = (*gi);
+    if (geom->get_vertex_data() != vdata) {
+      continue;
+    }
+
+    int num_primitives = geom->get_num_primitives();
+    for (int i = 0; i < num_primitives; ++i) {
+      PT(GeomPrimitive) prim = geom->modify_primitive(i);
+      prim->make_indexed();
+      int strip_cut_index = prim->get_strip_cut_index();
+      PT(GeomVertexArrayData) vertices = prim->modify_vertices();
+      GeomVertexRewriter rewriter(vertices, 0, current_thread);
+
+      while (!rewriter.is_at_end()) {
+        int index = rewriter.get_data1i();
+        if (index == strip_cut_index) {
+          rewriter.set_data1i(index);
+          continue;
+        }
+        nassertv(index >= 0 && index < num_vertices);
+        int new_index = remap_array[index];
+        nassertv(new_index >= 0 && new_index < new_num_vertices);
+        rewriter.set_data1i(new_index);
+      }
+    }
+
+    geom->set_vertex_data(new_vdata);
+  }
+}
@@ -82,6 +82,12 @@ public:
   bool doubleside(GeomNode *node);
   bool reverse(GeomNode *node);
 
+  bool optimize_vertex_cache(Geom *geom, int cache_size);
+  bool optimize_vertex_cache(GeomNode *node, int cache_size);
+  INLINE int get_num_optimized_triangles() const;
+  INLINE PN_stdfloat get_acmr_before() const;
+  INLINE PN_stdfloat get_acmr_after() const;
+
   void finish_apply();
 
   int collect_vertex_data(Geom *geom, int collect_bits, bool format_only);
@@ -93,6 +99,11 @@ public:
 private:
   int _max_collect_vertices;
 
+  // Accumulated statistics for optimize_vertex_cache().
+  int _num_optimized_triangles;
+  double _vcache_misses_before;
+  double _vcache_misses_after;
+
   typedef pvector<PT(Geom) > GeomList;
 
   // Keeps track of the Geoms that are associated with a particular
@@ -102,8 +113,10 @@ private:
   public:
     INLINE VertexDataAssoc();
     bool _might_have_unused;
+    bool _reorder_vertices;
     GeomList _geoms;
     void remove_unused_vertices(const GeomVertexData *vdata);
+    void reorder_vertices(const GeomVertexData *vdata);
   };
   typedef pmap<CPT(GeomVertexData), VertexDataAssoc> VertexDataAssocMap;
   VertexDataAssocMap _vdata_assoc;
@@ -270,6 +283,7 @@ private:
   static PStatCollector _apply_scale_color_collector;
   static PStatCollector _apply_texture_color_collector;
   static PStatCollector _apply_set_format_collector;
+  static PStatCollector _apply_vertex_cache_collector;
 
 public:
   static void init_type() {
@@ -18,6 +18,8 @@
 #include "modelPool.h"
 #include "modelLoadRequest.h"
 #include "modelSaveRequest.h"
+#include "modelPremungeRequest.h"
+#include "graphicsStateGuardianBase.h"
 #include "config_express.h"
 #include "config_putil.h"
 #include "virtualFileSystem.h"
@@ -317,6 +319,7 @@ try_load_file(const Filename &pathname, const LoaderOptions &options,
           SceneGraphReducer sgr;
           sgr.premunge(result, RenderState::make_empty());
         }
+        start_premunge_request(result);
 
         if (result->is_of_type(ModelRoot::get_class_type())) {
           ModelRoot *model_root = DCAST(ModelRoot, result.p());
@@ -391,6 +394,7 @@ try_load_file(const Filename &pathname, const LoaderOptions &options,
     SceneGraphReducer sgr;
     sgr.premunge(result, RenderState::make_empty());
   }
+  start_premunge_request(result);
 
   if (allow_ram_cache && result->is_of_type(ModelRoot::get_class_type())) {
     // Store the loaded model in the RAM cache, and make sure we return a
@@ -405,6 +409,28 @@ try_load_file(const Filename &pathname, const LoaderOptions &options,
   return result;
 }
 
+/**
+ * If munged vertex data is being stored in the model cache, starts a
+ * background task to munge the newly-loaded model for the default GSG, so
+ * that the munging cache is warm by the time the model is first drawn.
+ */
+void Loader::
+start_premunge_request(PandaNode *model) const {
+  if (!BamCache::get_global_ptr()->get_cache_munged_data()) {
+    return;
+  }
+
+  GraphicsStateGuardianBase *gsg = GraphicsStateGuardianBase::get_default_gsg();
+  if (gsg == nullptr) {
+    // We don't know what to munge it for yet.
+    return;
+  }
+
+  PT(ModelPremungeRequest) request = new ModelPremungeRequest(model, gsg);
+  request->set_task_chain(_task_chain);
+  _task_manager->add(request);
+}
+
 /**
  * Saves a scene graph to a single file, if possible.  The file type written
  * is implicit in the filename extension.
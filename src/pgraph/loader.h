@@ -104,6 +104,7 @@ private:
   PT(PandaNode) load_file(const Filename &filename, const LoaderOptions &options) const;
   PT(PandaNode) try_load_file(const Filename &pathname, const LoaderOptions &options,
                               LoaderFileType *requested_type) const;
+  void start_premunge_request(PandaNode *model) const;
 
   bool save_file(const Filename &filename, const LoaderOptions &options,
                  PandaNode *node) const;
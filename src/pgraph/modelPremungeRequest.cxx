@@ -0,0 +1,89 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file modelPremungeRequest.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "modelPremungeRequest.h"
+#include "geomNode.h"
+#include "geomMunger.h"
+#include "config_pgraph.h"
+
+TypeHandle ModelPremungeRequest::_type_handle;
+
+/**
+ * Create a new ModelPremungeRequest, and add it to a task manager to begin
+ * munging the model in the background.
+ */
+ModelPremungeRequest::
+ModelPremungeRequest(PandaNode *model, GraphicsStateGuardianBase *gsg) :
+  AsyncTask(model->get_name()),
+  _model(model),
+  _gsg(gsg),
+  _num_geoms_munged(0)
+{
+}
+
+/**
+ * Performs the task: that is, munges each Geom in the model.
+ */
+AsyncTask::DoneStatus ModelPremungeRequest::
+do_task() {
+  Thread *current_thread = Thread::get_current_thread();
+  r_premunge(_model, RenderState::make_empty(), current_thread);
+
+  if (loader_cat.is_debug()) {
+    loader_cat.debug()
+      << "Premunged " << _num_geoms_munged << " Geoms of " << *_model << "\n";
+  }
+
+  // Don't continue the task; we're done.
+  return DS_done;
+}
+
+/**
+ * The recursive implementation of do_task().
+ */
+void ModelPremungeRequest::
+r_premunge(PandaNode *node, const RenderState *state,
+           Thread *current_thread) {
+  CPT(RenderState) next_state = state->compose(node->get_state());
+
+  if (node->is_geom_node()) {
+    GeomNode *geom_node = DCAST(GeomNode, node);
+    int num_geoms = geom_node->get_num_geoms();
+    for (int i = 0; i < num_geoms; ++i) {
+      CPT(RenderState) geom_state = next_state->compose(geom_node->get_geom_state(i));
+
+      // This may well run while the cull threads are asking the GSG for
+      // mungers for the same states; the state's munger cache is protected
+      // by its own lock for that reason.
+      PT(GeomMunger) munger = _gsg->get_geom_munger(geom_state, current_thread);
+      if (munger == nullptr) {
+        continue;
+      }
+
+      // The result is discarded; we are only interested in the side-effect
+      // of filling the munging caches.
+      CPT(Geom) geom = geom_node->get_geom(i);
+      CPT(GeomVertexData) data = geom->get_vertex_data(current_thread);
+      munger->munge_geom(geom, data, true, current_thread);
+      ++_num_geoms_munged;
+
+      Thread::consider_yield();
+    }
+  }
+
+  PandaNode::Children children = node->get_children(current_thread);
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    r_premunge(children.get_child(i), next_state, current_thread);
+  }
+}
@@ -0,0 +1,79 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file modelPremungeRequest.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef MODELPREMUNGEREQUEST
+#define MODELPREMUNGEREQUEST
+
+#include "pandabase.h"
+
+#include "asyncTask.h"
+#include "pandaNode.h"
+#include "renderState.h"
+#include "pointerTo.h"
+#include "graphicsStateGuardianBase.h"
+
+/**
+ * This class object manages a single asynchronous request to munge all of
+ * the Geoms of a model for a particular GSG, in a sub-thread (if threading is
+ * available).  The model itself is not modified; the munged results are
+ * simply stored in the Geom munging cache, and in the model cache if
+ * BamCache::get_cache_munged_data() is enabled, so that they will not need to
+ * be computed when the model is first drawn.
+ */
+class EXPCL_PANDA_PGRAPH ModelPremungeRequest : public AsyncTask {
+public:
+  ALLOC_DELETED_CHAIN(ModelPremungeRequest);
+
+PUBLISHED:
+  explicit ModelPremungeRequest(PandaNode *model,
+                                GraphicsStateGuardianBase *gsg);
+
+  INLINE PandaNode *get_model() const;
+  INLINE GraphicsStateGuardianBase *get_gsg() const;
+  INLINE int get_num_geoms_munged() const;
+
+  MAKE_PROPERTY(model, get_model);
+  MAKE_PROPERTY(num_geoms_munged, get_num_geoms_munged);
+
+protected:
+  virtual DoneStatus do_task();
+
+private:
+  void r_premunge(PandaNode *node, const RenderState *state,
+                  Thread *current_thread);
+
+  PT(PandaNode) _model;
+  PT(GraphicsStateGuardianBase) _gsg;
+  int _num_geoms_munged;
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    AsyncTask::init_type();
+    register_type(_type_handle, "ModelPremungeRequest",
+                  AsyncTask::get_class_type());
+    }
+  virtual TypeHandle get_type() const {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
+
+private:
+  static TypeHandle _type_handle;
+};
+
+#include "modelPremungeRequest.I"
+
+#endif
@@ -5469,6 +5469,9 @@ flatten_strong() {
     gr.make_compatible_state(node());
     gr.collect_vertex_data(node(), ~(SceneGraphReducer::CVD_format | SceneGraphReducer::CVD_name | SceneGraphReducer::CVD_animation_type));
     gr.unify(node(), false);
+    if (flatten_optimize_vertex_cache) {
+      gr.optimize_vertex_cache(node());
+    }
   }
 
   return num_removed;
@@ -8,6 +8,7 @@
 #include "cacheStats.cxx"
 #include "camera.cxx"
 #include "clipPlaneAttrib.cxx"
+#include "clusteredGeomNode.cxx"
 #include "colorAttrib.cxx"
 #include "colorBlendAttrib.cxx"
 #include "colorScaleAttrib.cxx"
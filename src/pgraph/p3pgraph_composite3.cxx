@@ -12,6 +12,7 @@
 #include "materialCollection.cxx"
 #include "modelFlattenRequest.cxx"
 #include "modelLoadRequest.cxx"
+#include "modelPremungeRequest.cxx"
 #include "modelSaveRequest.cxx"
 #include "modelNode.cxx"
 #include "modelPool.cxx"
@@ -28,3 +29,4 @@
 #include "polylightNode.cxx"
 #include "portalNode.cxx"
 #include "portalClipper.cxx"
+#include "pvsNode.cxx"
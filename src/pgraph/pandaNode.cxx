@@ -1017,6 +1017,7 @@ set_effect(const RenderEffect *effect) {
     cdata->set_fancy_bit(FB_effects, true);
   }
   CLOSE_ITERATE_CURRENT_AND_UPSTREAM(_cycler);
+  mark_bounds_stale(current_thread);
   mark_bam_modified();
 }
 
@@ -1032,6 +1033,7 @@ clear_effect(TypeHandle type) {
     cdata->set_fancy_bit(FB_effects, !cdata->_effects->is_empty());
   }
   CLOSE_ITERATE_CURRENT_AND_UPSTREAM(_cycler);
+  mark_bounds_stale(current_thread);
   mark_bam_modified();
 }
 
@@ -1074,13 +1076,24 @@ void PandaNode::
 set_effects(const RenderEffects *effects, Thread *current_thread) {
   // Apply this operation to the current stage as well as to all upstream
   // stages.
+  bool any_changed = false;
   OPEN_ITERATE_CURRENT_AND_UPSTREAM(_cycler, current_thread) {
     CDStageWriter cdata(_cycler, pipeline_stage, current_thread);
-    cdata->_effects = effects;
-    cdata->set_fancy_bit(FB_effects, !effects->is_empty());
+    if (cdata->_effects != effects) {
+      cdata->_effects = effects;
+      cdata->set_fancy_bit(FB_effects, !effects->is_empty());
+      any_changed = true;
+    }
   }
   CLOSE_ITERATE_CURRENT_AND_UPSTREAM(_cycler);
-  mark_bam_modified();
+
+  // This doesn't change the bounds, but anything that caches the result of a
+  // cull traversal keys off the bounds sequence; see
+  // DisplayRegion::set_retained_cull().
+  if (any_changed) {
+    mark_bounds_stale(current_thread);
+    mark_bam_modified();
+  }
 }
 
 /**
@@ -0,0 +1,561 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file pvsNode.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pvsNode.h"
+#include "portalNode.h"
+#include "cullTraverser.h"
+#include "cullTraverserData.h"
+#include "nodePath.h"
+#include "nodePathCollection.h"
+#include "finiteBoundingVolume.h"
+#include "config_pgraph.h"
+#include "datagram.h"
+#include "datagramIterator.h"
+#include "bamReader.h"
+#include "bamWriter.h"
+
+TypeHandle PVSNode::_type_handle;
+
+// Distances smaller than this are considered to lie on a plane.
+static const PN_stdfloat pvs_epsilon = 1.0e-4f;
+
+/**
+ * Returns the plane through the three points, with a normalized normal.
+ * Returns false if the points are collinear.
+ */
+static bool
+make_plane(const LPoint3 &a, const LPoint3 &b, const LPoint3 &c,
+           LVector3 &normal, PN_stdfloat &d) {
+  normal = (b - a).cross(c - a);
+  PN_stdfloat length = normal.length();
+  if (length < pvs_epsilon) {
+    return false;
+  }
+  normal /= length;
+  d = -normal.dot(a);
+  return true;
+}
+
+/**
+ * Clips the polygon against the plane, keeping the part that lies on the
+ * positive side.
+ */
+static void
+clip_polygon(pvector<LPoint3> &polygon, const LVector3 &normal, PN_stdfloat d) {
+  pvector<LPoint3> result;
+  size_t num_vertices = polygon.size();
+  for (size_t i = 0; i < num_vertices; ++i) {
+    const LPoint3 &cur = polygon[i];
+    const LPoint3 &next = polygon[(i + 1) % num_vertices];
+    PN_stdfloat dc = normal.dot(cur) + d;
+    PN_stdfloat dn = normal.dot(next) + d;
+    if (dc >= 0) {
+      result.push_back(cur);
+    }
+    if ((dc >= 0) != (dn >= 0)) {
+      result.push_back(cur + (next - cur) * (dc / (dc - dn)));
+    }
+  }
+  polygon.swap(result);
+}
+
+/**
+ * Clips the target polygon to the region that can be reached by a straight
+ * line that passes through both the source and the pass polygons, by
+ * intersecting it with each plane that separates the two.  The planes are
+ * formed from an edge of edge_poly and a vertex of vertex_poly, which are
+ * either source and pass or pass and source.  Returns false if nothing of the
+ * target remains.
+ */
+static bool
+clip_to_separators(const pvector<LPoint3> &source,
+                   const pvector<LPoint3> &pass,
+                   bool edges_from_source,
+                   pvector<LPoint3> &target) {
+  const pvector<LPoint3> &edge_poly = edges_from_source ? source : pass;
+  const pvector<LPoint3> &vertex_poly = edges_from_source ? pass : source;
+
+  size_t num_edges = edge_poly.size();
+  for (size_t ei = 0; ei < num_edges; ++ei) {
+    const LPoint3 &a = edge_poly[ei];
+    const LPoint3 &b = edge_poly[(ei + 1) % num_edges];
+
+    for (size_t vi = 0; vi < vertex_poly.size(); ++vi) {
+      LVector3 normal;
+      PN_stdfloat d;
+      if (!make_plane(a, b, vertex_poly[vi], normal, d)) {
+        continue;
+      }
+
+      // The plane separates the two polygons if the source lies entirely on
+      // one side of it and the pass polygon entirely on the other.
+      bool source_front = false, source_back = false;
+      for (size_t i = 0; i < source.size(); ++i) {
+        PN_stdfloat dist = normal.dot(source[i]) + d;
+        source_front |= (dist > pvs_epsilon);
+        source_back |= (dist < -pvs_epsilon);
+      }
+      bool pass_front = false, pass_back = false;
+      for (size_t i = 0; i < pass.size(); ++i) {
+        PN_stdfloat dist = normal.dot(pass[i]) + d;
+        pass_front |= (dist > pvs_epsilon);
+        pass_back |= (dist < -pvs_epsilon);
+      }
+
+      if (!source_front && !pass_back && pass_front) {
+        // The pass polygon is on the positive side already.
+      } else if (!source_back && !pass_front && pass_back) {
+        normal = -normal;
+        d = -d;
+      } else {
+        continue;
+      }
+
+      // Anything seen through both polygons lies on the same side as the
+      // pass polygon.
+      clip_polygon(target, normal, d);
+      if (target.size() < 3) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ *
+ */
+PVSNode::
+PVSNode(const std::string &name) :
+  PandaNode(name)
+{
+  set_cull_callback();
+}
+
+/**
+ *
+ */
+PVSNode::
+PVSNode(const PVSNode &copy) :
+  PandaNode(copy),
+  _cells(copy._cells)
+{
+  set_cull_callback();
+}
+
+/**
+ *
+ */
+PVSNode::
+~PVSNode() {
+}
+
+/**
+ * Returns a newly-allocated Node that is a shallow copy of this one.  It will
+ * be a different Node pointer, but its internal data may or may not be shared
+ * with that of the original Node.
+ */
+PandaNode *PVSNode::
+make_copy() const {
+  return new PVSNode(*this);
+}
+
+/**
+ * Returns true if it is generally safe to combine this particular kind of
+ * PandaNode with other kinds of PandaNodes of compatible type, adding
+ * children or whatever.  For instance, an LODNode should not be combined with
+ * any other PandaNode, because its set of children is meaningful.
+ */
+bool PVSNode::
+safe_to_combine() const {
+  return false;
+}
+
+/**
+ * Returns true if it is generally safe to combine the children of this
+ * PandaNode with each other.  The children of a PVSNode are its cells, so
+ * they may not be combined.
+ */
+bool PVSNode::
+safe_to_combine_children() const {
+  return false;
+}
+
+/**
+ * Transforms the contents of this PandaNode by the indicated matrix, if it
+ * means anything to do so.  For most kinds of PandaNodes, this does nothing.
+ */
+void PVSNode::
+xform(const LMatrix4 &mat) {
+  Cells::iterator ci;
+  for (ci = _cells.begin(); ci != _cells.end(); ++ci) {
+    Cell &cell = (*ci);
+    LPoint3 min_point(1.0e30f, 1.0e30f, 1.0e30f);
+    LPoint3 max_point(-1.0e30f, -1.0e30f, -1.0e30f);
+    for (int i = 0; i < 8; ++i) {
+      LPoint3 corner((i & 1) ? cell._max[0] : cell._min[0],
+                     (i & 2) ? cell._max[1] : cell._min[1],
+                     (i & 4) ? cell._max[2] : cell._min[2]);
+      corner = corner * mat;
+      min_point = min_point.fmin(corner);
+      max_point = max_point.fmax(corner);
+    }
+    cell._min = min_point;
+    cell._max = max_point;
+  }
+}
+
+/**
+ * This function will be called during the cull traversal to perform any
+ * additional operations that should be performed at cull time.  This may
+ * include additional manipulation of render state or additional
+ * visible/invisible decisions, or any other arbitrary operation.
+ *
+ * By the time this function is called, the node has already passed the
+ * bounding-volume test for the viewing frustum, and the node's transform and
+ * state have already been applied to the indicated CullTraverserData object.
+ *
+ * The return value is true if this node should be visible, or false if it
+ * should be culled.
+ */
+bool PVSNode::
+cull_callback(CullTraverser *trav, CullTraverserData &data) {
+  if (_cells.empty()) {
+    return true;
+  }
+
+  // Find the camera's position in the space of this node.
+  CPT(TransformState) rel_transform =
+    data.get_net_transform(trav)->invert_compose(trav->get_camera_transform());
+  int from_cell = find_cell(rel_transform->get_pos());
+  if (from_cell < 0) {
+    // The camera is outside of all of the cells; we can't rule anything out.
+    return true;
+  }
+
+  const BitArray &visible = _cells[from_cell]._visible;
+
+  Children children = get_children();
+  int num_children = children.get_num_children();
+  for (int i = 0; i < num_children; ++i) {
+    // Any children beyond the cells are always traversed.
+    if (i >= (int)_cells.size() || visible.get_bit(i)) {
+      trav->traverse_child(data, children.get_child_connection(i));
+    }
+  }
+
+  // Now return false indicating that we have already taken care of the
+  // traversal from here.
+  return false;
+}
+
+/**
+ *
+ */
+void PVSNode::
+output(std::ostream &out) const {
+  PandaNode::output(out);
+  out << " " << _cells.size() << " cells";
+}
+
+/**
+ * Adds the indicated node as a new child of this node, and as a new cell.
+ * The camera is located within the cell by the current bounding box of the
+ * node.  Returns the index of the new cell.
+ *
+ * The new cell can see only itself until its visible set is filled in.
+ */
+int PVSNode::
+add_cell(PandaNode *cell) {
+  nassertr(cell != nullptr, -1);
+  CPT(BoundingVolume) bounds = cell->get_bounds();
+  const FiniteBoundingVolume *fbv = bounds->as_finite_bounding_volume();
+  if (fbv == nullptr || bounds->is_empty()) {
+    pgraph_cat.warning()
+      << "Cell " << *cell << " does not have a finite bounding volume.\n";
+    return add_cell(cell, LPoint3::zero(), LPoint3::zero());
+  }
+  return add_cell(cell, fbv->get_min(), fbv->get_max());
+}
+
+/**
+ * Adds the indicated node as a new child of this node, and as a new cell,
+ * with the indicated bounding box for locating the camera.  Returns the index
+ * of the new cell.
+ */
+int PVSNode::
+add_cell(PandaNode *cell, const LPoint3 &min_point, const LPoint3 &max_point) {
+  nassertr(cell != nullptr, -1);
+  nassertr(get_num_children() == (int)_cells.size(), -1);
+
+  add_child(cell);
+
+  int n = (int)_cells.size();
+  Cell new_cell;
+  new_cell._min = min_point;
+  new_cell._max = max_point;
+  new_cell._visible.set_bit(n);
+  _cells.push_back(new_cell);
+  return n;
+}
+
+/**
+ * Changes the bounding box that is used to locate the camera within the nth
+ * cell.  The box is in the coordinate space of this node.
+ */
+void PVSNode::
+set_cell_bounds(int n, const LPoint3 &min_point, const LPoint3 &max_point) {
+  nassertv(n >= 0 && n < (int)_cells.size());
+  _cells[n]._min = min_point;
+  _cells[n]._max = max_point;
+}
+
+/**
+ * Returns the index of the cell that contains the indicated point, in the
+ * coordinate space of this node, or -1 if no cell contains it.  If several
+ * cells contain the point, the smallest is returned.
+ */
+int PVSNode::
+find_cell(const LPoint3 &point) const {
+  int best = -1;
+  PN_stdfloat best_volume = 0;
+  for (int i = 0; i < (int)_cells.size(); ++i) {
+    const Cell &cell = _cells[i];
+    if (point[0] >= cell._min[0] && point[0] <= cell._max[0] &&
+        point[1] >= cell._min[1] && point[1] <= cell._max[1] &&
+        point[2] >= cell._min[2] && point[2] <= cell._max[2]) {
+      LVector3 size = cell._max - cell._min;
+      PN_stdfloat volume = size[0] * size[1] * size[2];
+      if (best < 0 || volume < best_volume) {
+        best = i;
+        best_volume = volume;
+      }
+    }
+  }
+  return best;
+}
+
+/**
+ * Adds or removes to_cell from the potentially visible set of from_cell.
+ */
+void PVSNode::
+set_cell_visible(int from_cell, int to_cell, bool visible) {
+  nassertv(from_cell >= 0 && from_cell < (int)_cells.size());
+  nassertv(to_cell >= 0 && to_cell < (int)_cells.size());
+  _cells[from_cell]._visible.set_bit_to(to_cell, visible);
+}
+
+/**
+ * Resets the potentially visible set of every cell to contain only the cell
+ * itself.
+ */
+void PVSNode::
+clear_visibility() {
+  for (int i = 0; i < (int)_cells.size(); ++i) {
+    _cells[i]._visible.clear();
+    _cells[i]._visible.set_bit(i);
+  }
+}
+
+/**
+ * Computes the potentially visible set of every cell from the open
+ * PortalNodes found anywhere below this node.  Each portal must have both
+ * its cell_in and its cell_out set to cells of this node.  Portals are
+ * treated as one-way, as they are by the cull traversal.
+ *
+ * A cell is considered visible from another if there is some straight line
+ * that passes through every portal of some sequence leading from the one to
+ * the other; this is a conservative answer.  Sequences longer than max_depth
+ * portals are not followed.
+ *
+ * This is intended to be run offline, after which the node may be written
+ * to a bam file.  Returns the number of portals that were used.
+ */
+int PVSNode::
+compute_from_portals(int max_depth) {
+  NodePath this_np(this);
+  Portals portals;
+
+  NodePathCollection portal_paths = this_np.find_all_matches("**/+PortalNode");
+  for (int pi = 0; pi < portal_paths.get_num_paths(); ++pi) {
+    NodePath portal_path = portal_paths.get_path(pi);
+    PortalNode *pnode = DCAST(PortalNode, portal_path.node());
+    if (!pnode->is_open() || pnode->get_num_vertices() < 3) {
+      continue;
+    }
+
+    NodePath cell_in = pnode->get_cell_in();
+    NodePath cell_out = pnode->get_cell_out();
+    int in_index = cell_in.is_empty() ? -1 : find_child(cell_in.node());
+    int out_index = cell_out.is_empty() ? -1 : find_child(cell_out.node());
+    if (in_index < 0 || in_index >= (int)_cells.size() ||
+        out_index < 0 || out_index >= (int)_cells.size()) {
+      pgraph_cat.warning()
+        << "Ignoring " << portal_path
+        << ", which does not connect two cells of " << *this << "\n";
+      continue;
+    }
+    if (in_index == out_index) {
+      continue;
+    }
+
+    LMatrix4 mat = portal_path.get_transform(this_np)->get_mat();
+    Portal portal;
+    portal._cell_in = in_index;
+    portal._cell_out = out_index;
+    for (int vi = 0; vi < pnode->get_num_vertices(); ++vi) {
+      portal._polygon.push_back(pnode->get_vertex(vi) * mat);
+    }
+    portals.push_back(std::move(portal));
+  }
+
+  clear_visibility();
+
+  int num_cells = (int)_cells.size();
+  for (int from = 0; from < num_cells; ++from) {
+    BitArray &visible = _cells[from]._visible;
+
+    Portals::const_iterator p0;
+    for (p0 = portals.begin(); p0 != portals.end(); ++p0) {
+      if ((*p0)._cell_in != from) {
+        continue;
+      }
+
+      // A neighboring cell is always visible, since the camera may be
+      // anywhere within this cell.
+      visible.set_bit((*p0)._cell_out);
+
+      BitArray on_stack;
+      on_stack.set_bit(from);
+      on_stack.set_bit((*p0)._cell_out);
+
+      // So is any cell beyond a second portal, since there is always some
+      // line through two polygons.
+      Portals::const_iterator p1;
+      for (p1 = portals.begin(); p1 != portals.end(); ++p1) {
+        if ((*p1)._cell_in != (*p0)._cell_out || on_stack.get_bit((*p1)._cell_out)) {
+          continue;
+        }
+        visible.set_bit((*p1)._cell_out);
+        on_stack.set_bit((*p1)._cell_out);
+        flow(from, (*p0)._polygon, (*p1)._polygon, (*p1)._cell_out,
+             portals, on_stack, 2, max_depth);
+        on_stack.clear_bit((*p1)._cell_out);
+      }
+    }
+  }
+
+  if (pgraph_cat.is_debug()) {
+    pgraph_cat.debug()
+      << "Computed visibility for " << num_cells << " cells of " << *this
+      << " from " << portals.size() << " portals.\n";
+  }
+
+  return (int)portals.size();
+}
+
+/**
+ * Recursively follows the portals leading out of the indicated cell, which
+ * has been reached by looking from the source portal through the pass
+ * portal, marking every cell that can still be seen in the visible set of
+ * from_cell.
+ */
+void PVSNode::
+flow(int from_cell, const Polygon &source, const Polygon &pass, int cell,
+     const Portals &portals, BitArray &on_stack, int depth, int max_depth) {
+  if (depth >= max_depth) {
+    return;
+  }
+
+  BitArray &visible = _cells[from_cell]._visible;
+
+  Portals::const_iterator pi;
+  for (pi = portals.begin(); pi != portals.end(); ++pi) {
+    const Portal &portal = (*pi);
+    if (portal._cell_in != cell || on_stack.get_bit(portal._cell_out)) {
+      continue;
+    }
+
+    Polygon target = portal._polygon;
+    if (!clip_to_separators(source, pass, true, target) ||
+        !clip_to_separators(source, pass, false, target)) {
+      continue;
+    }
+
+    visible.set_bit(portal._cell_out);
+    on_stack.set_bit(portal._cell_out);
+    flow(from_cell, source, target, portal._cell_out, portals, on_stack,
+         depth + 1, max_depth);
+    on_stack.clear_bit(portal._cell_out);
+  }
+}
+
+/**
+ * Tells the BamReader how to create objects of type PVSNode.
+ */
+void PVSNode::
+register_with_read_factory() {
+  BamReader::get_factory()->register_factory(get_class_type(), make_from_bam);
+}
+
+/**
+ * Writes the contents of this object to the datagram for shipping out to a
+ * Bam file.
+ */
+void PVSNode::
+write_datagram(BamWriter *manager, Datagram &dg) {
+  PandaNode::write_datagram(manager, dg);
+
+  dg.add_uint32(_cells.size());
+  Cells::const_iterator ci;
+  for (ci = _cells.begin(); ci != _cells.end(); ++ci) {
+    (*ci)._min.write_datagram(dg);
+    (*ci)._max.write_datagram(dg);
+    (*ci)._visible.write_datagram(manager, dg);
+  }
+}
+
+/**
+ * This function is called by the BamReader's factory when a new object of
+ * type PVSNode is encountered in the Bam file.  It should create the PVSNode
+ * and extract its information from the file.
+ */
+TypedWritable *PVSNode::
+make_from_bam(const FactoryParams &params) {
+  PVSNode *node = new PVSNode("");
+  DatagramIterator scan;
+  BamReader *manager;
+
+  parse_params(params, scan, manager);
+  node->fillin(scan, manager);
+
+  return node;
+}
+
+/**
+ * This internal function is called by make_from_bam to read in all of the
+ * relevant data from the BamFile for the new PVSNode.
+ */
+void PVSNode::
+fillin(DatagramIterator &scan, BamReader *manager) {
+  PandaNode::fillin(scan, manager);
+
+  size_t num_cells = scan.get_uint32();
+  _cells.resize(num_cells);
+  for (size_t i = 0; i < num_cells; ++i) {
+    _cells[i]._min.read_datagram(scan);
+    _cells[i]._max.read_datagram(scan);
+    _cells[i]._visible.read_datagram(scan, manager);
+  }
+}
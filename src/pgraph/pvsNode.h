@@ -0,0 +1,129 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file pvsNode.h
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#ifndef PVSNODE_H
+#define PVSNODE_H
+
+#include "pandabase.h"
+#include "pandaNode.h"
+#include "bitArray.h"
+#include "pvector.h"
+
+/**
+ * A node that divides a static scene into cells, and stores a precomputed
+ * potentially visible set for each of them: the set of cells that can
+ * possibly be seen from anywhere within that cell.  Each child of this node
+ * is one cell.
+ *
+ * During the cull traversal, the cell that contains the camera is located by
+ * its bounding box, and only the cells in its visible set are traversed; the
+ * rest are skipped outright.  If the camera is not within any cell, all of
+ * the cells are traversed.
+ *
+ * The visible sets may be filled in by hand, or computed offline from the
+ * PortalNodes that connect the cells with compute_from_portals(), and are
+ * then written to the bam file along with the node.  Runtime portal
+ * clipping (allow-portal-cull) should not be enabled at the same time.
+ */
+class EXPCL_PANDA_PGRAPH PVSNode : public PandaNode {
+PUBLISHED:
+  explicit PVSNode(const std::string &name);
+
+protected:
+  PVSNode(const PVSNode &copy);
+
+public:
+  virtual ~PVSNode();
+  virtual PandaNode *make_copy() const;
+  virtual bool safe_to_combine() const;
+  virtual bool safe_to_combine_children() const;
+  virtual void xform(const LMatrix4 &mat);
+
+  virtual bool cull_callback(CullTraverser *trav, CullTraverserData &data);
+  virtual void output(std::ostream &out) const;
+
+PUBLISHED:
+  int add_cell(PandaNode *cell);
+  int add_cell(PandaNode *cell, const LPoint3 &min_point,
+               const LPoint3 &max_point);
+  INLINE int get_num_cells() const;
+  void set_cell_bounds(int n, const LPoint3 &min_point,
+                       const LPoint3 &max_point);
+  INLINE const LPoint3 &get_cell_min(int n) const;
+  INLINE const LPoint3 &get_cell_max(int n) const;
+
+  int find_cell(const LPoint3 &point) const;
+
+  void set_cell_visible(int from_cell, int to_cell, bool visible = true);
+  INLINE bool is_cell_visible(int from_cell, int to_cell) const;
+  INLINE const BitArray &get_visible_cells(int from_cell) const;
+  void clear_visibility();
+
+  int compute_from_portals(int max_depth = 64);
+
+private:
+  typedef pvector<LPoint3> Polygon;
+
+  class Portal {
+  public:
+    Polygon _polygon;
+    int _cell_in;
+    int _cell_out;
+  };
+  typedef pvector<Portal> Portals;
+
+  void flow(int from_cell, const Polygon &source, const Polygon &pass,
+            int cell, const Portals &portals, BitArray &on_stack,
+            int depth, int max_depth);
+
+  class Cell {
+  public:
+    LPoint3 _min;
+    LPoint3 _max;
+    BitArray _visible;
+  };
+  typedef pvector<Cell> Cells;
+
+  // This data is not cycled; the cells are not expected to change once the
+  // scene is loaded.
+  Cells _cells;
+
+public:
+  static void register_with_read_factory();
+  virtual void write_datagram(BamWriter *manager, Datagram &dg);
+
+protected:
+  static TypedWritable *make_from_bam(const FactoryParams &params);
+  void fillin(DatagramIterator &scan, BamReader *manager);
+
+public:
+  static TypeHandle get_class_type() {
+    return _type_handle;
+  }
+  static void init_type() {
+    PandaNode::init_type();
+    register_type(_type_handle, "PVSNode",
+                  PandaNode::get_class_type());
+  }
+  virtual TypeHandle get_type() const {
+    return get_class_type();
+  }
+  virtual TypeHandle force_init_type() {init_type(); return get_class_type();}
+
+private:
+  static TypeHandle _type_handle;
+};
+
+#include "pvsNode.I"
+
+#endif
@@ -65,6 +65,7 @@ TypeHandle RenderState::_type_handle;
  */
 RenderState::
 RenderState() :
+  _munger_lock("RenderState::_munger_lock"),
   _flags(0),
   _lock("RenderState")
 {
@@ -87,6 +88,7 @@ RenderState() :
  */
 RenderState::
 RenderState(const RenderState &copy) :
+  _munger_lock("RenderState::_munger_lock"),
   _filled_slots(copy._filled_slots),
   _flags(0),
   _lock("RenderState")
@@ -207,6 +209,27 @@ compare_mask(const RenderState &other, SlotMask compare_mask) const {
   return 0;
 }
 
+/**
+ * Returns the set of slots whose attributes differ, by pointer, between this
+ * state and the other one.  This is the set of attributes that a GSG must
+ * reissue when it switches from one state to the other.
+ */
+RenderState::SlotMask RenderState::
+get_changed_slots(const RenderState *other) const {
+  SlotMask changed;
+  SlotMask mask = _filled_slots | other->_filled_slots;
+  int slot = mask.get_lowest_on_bit();
+  while (slot >= 0) {
+    if (_attributes[slot]._attrib != other->_attributes[slot]._attrib) {
+      changed.set_bit(slot);
+    }
+    mask.clear_bit(slot);
+    slot = mask.get_lowest_on_bit();
+  }
+
+  return changed;
+}
+
 /**
  * Calls cull_callback() on each attrib.  If any attrib returns false,
  * interrupts the list and returns false immediately; otherwise, completes the
@@ -978,6 +1001,7 @@ clear_munger_cache() {
   size_t size = _states.get_num_entries();
   for (size_t si = 0; si < size; ++si) {
     RenderState *state = (RenderState *)(_states.get_key(si));
+    LightMutexHolder holder(state->_munger_lock);
     state->_mungers.clear();
     state->_munged_states.clear();
     state->_last_mi = -1;
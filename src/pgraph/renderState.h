@@ -154,6 +154,8 @@ PUBLISHED:
   int get_geom_rendering(int geom_rendering) const;
 
 public:
+  SlotMask get_changed_slots(const RenderState *other) const;
+
   static void bin_removed(int bin_index);
 
   INLINE static void flush_level();
@@ -282,6 +284,12 @@ private:
   typedef SimpleHashMap<size_t, WCPT(RenderState), size_t_hash> MungedStates;
   mutable MungedStates _munged_states;
 
+  // This protects _mungers, _last_mi and _munged_states, which are filled in
+  // by whichever thread happens to be culling with the state.  It is never
+  // held while a munger or munged state is being made.  If _states_lock is
+  // also needed, it must be acquired first.
+  mutable LightMutex _munger_lock;
+
   // This is used to mark nodes as we visit them to detect cycles.
   UpdateSeq _cycle_detect;
   static UpdateSeq _last_cycle_detect;
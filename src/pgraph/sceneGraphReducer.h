@@ -137,6 +137,7 @@ PUBLISHED:
   INLINE int make_nonindexed(PandaNode *root, int nonindexed_bits = ~0);
   void unify(PandaNode *root, bool preserve_order);
   void remove_unused_vertices(PandaNode *root);
+  int optimize_vertex_cache(PandaNode *root, int cache_size = -1);
 
   INLINE void premunge(PandaNode *root, const RenderState *initial_state);
   bool check_live_flatten(PandaNode *node);
@@ -177,6 +178,8 @@ protected:
   void r_unify(PandaNode *node, int max_indices, bool preserve_order);
   void r_register_vertices(PandaNode *node, GeomTransformer &transformer);
   void r_decompose(PandaNode *node);
+  int r_optimize_vertex_cache(PandaNode *node, int cache_size,
+                              GeomTransformer &transformer);
 
   void r_premunge(PandaNode *node, const RenderState *state);
 
@@ -193,6 +196,7 @@ private:
   static PStatCollector _make_nonindexed_collector;
   static PStatCollector _unify_collector;
   static PStatCollector _remove_unused_collector;
+  static PStatCollector _optimize_vertex_cache_collector;
   static PStatCollector _premunge_collector;
 };
 
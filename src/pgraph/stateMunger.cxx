@@ -12,6 +12,7 @@
  */
 
 #include "stateMunger.h"
+#include "lightMutexHolder.h"
 
 TypeHandle StateMunger::_type_handle;
 
@@ -30,16 +31,24 @@ munge_state(const RenderState *state) {
   RenderState::MungedStates &munged_states = state->_munged_states;
 
   int id = get_gsg()->_id;
-  int mi = munged_states.find(id);
-  if (mi != -1) {
-    if (auto munged_state = munged_states.get_data(mi).lock()) {
-      return munged_state;
-    } else {
-      munged_states.remove_element(mi);
+  {
+    LightMutexHolder holder(state->_munger_lock);
+    int mi = munged_states.find(id);
+    if (mi != -1) {
+      if (auto munged_state = munged_states.get_data(mi).lock()) {
+        return munged_state;
+      } else {
+        munged_states.remove_element(mi);
+      }
     }
   }
 
+  // The lock is not held while munging, since that may well compose new
+  // states.  Two threads may race to munge the same state, but they will
+  // both arrive at the same unique result.
   CPT(RenderState) result = munge_state_impl(state);
+
+  LightMutexHolder holder(state->_munger_lock);
   munged_states.store(id, result);
 
   return result;
@@ -0,0 +1,145 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_cull_arena.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "cullArena.h"
+#include "cullResult.h"
+#include "cullableObject.h"
+#include "load_prc_file.h"
+#include "pnotify.h"
+
+#include <string.h>
+
+// This checks that a CullArena hands out aligned memory, grows past its
+// block size, and comes back empty, with the same memory, after it has been
+// released to the pool.  CullableObjects made within a CullArena::Scope must
+// come from the arena, and those made outside one from the heap.
+//
+// It then makes a chain of CullResults with make_next(), as the
+// GraphicsEngine does each frame, and checks that two that are alive at the
+// same time, as they are while one frame is drawn and the next culled, have
+// different arenas, and that the arena of one that has been destroyed is
+// reused by the next one made.
+
+static int num_failures = 0;
+
+static void
+check(bool condition, const char *message) {
+  if (!condition) {
+    nout << "FAILED: " << message << "\n";
+    ++num_failures;
+  }
+}
+
+static void
+test_allocate() {
+  CullArena *arena = CullArena::acquire();
+  check(arena->get_bytes_used() == 0, "new arena is empty");
+
+  void *first = arena->allocate(10);
+  void *second = arena->allocate(1);
+  check(((uintptr_t)first & 15) == 0 && ((uintptr_t)second & 15) == 0,
+        "allocations are aligned");
+  check((unsigned char *)second - (unsigned char *)first == 16,
+        "allocations are packed together");
+  check(arena->get_bytes_used() == 32, "bytes used are counted");
+
+  // More than a block's worth still fits.
+  void *large = arena->allocate(200000);
+  check(large != nullptr && arena->get_bytes_used() == 200032,
+        "oversized allocation gets its own block");
+  memset(large, 0, 200000);
+
+  CullArena::release(arena);
+  CullArena *again = CullArena::acquire();
+  check(again == arena, "released arena is reused");
+  check(again->get_bytes_used() == 0, "reused arena is empty");
+  check(again->allocate(10) == first, "reused arena reuses its memory");
+  CullArena::release(again);
+}
+
+static void
+test_objects() {
+  CullArena *arena = CullArena::acquire();
+  {
+    CullArena::Scope scope(arena);
+    if (CullArena::get_current() == arena) {
+      CullableObject *object = new CullableObject;
+      check(arena->get_bytes_used() >= sizeof(CullableObject),
+            "object made in scope is in the arena");
+      delete object;
+    } else {
+      // With SIMPLE_THREADS, arenas are never made current.
+      check(CullArena::get_current() == nullptr, "no arena is current");
+    }
+  }
+  check(CullArena::get_current() == nullptr, "scope restores the arena");
+
+  size_t bytes_used = arena->get_bytes_used();
+  CullableObject *object = new CullableObject;
+  check(arena->get_bytes_used() == bytes_used,
+        "object made outside the scope is not in the arena");
+  delete object;
+  CullArena::release(arena);
+}
+
+static void
+test_results() {
+  PT(CullResult) first = new CullResult(nullptr, PStatCollector("test"));
+  CullArena *first_arena = first->get_arena();
+  check(first_arena != nullptr, "cull result has an arena");
+
+  {
+    CullArena::Scope scope(first_arena);
+    CullableObject *object = new CullableObject;
+    delete object;
+  }
+
+  // While the first frame is drawn, the second is culled into its own arena.
+  PT(CullResult) second = first->make_next();
+  CullArena *second_arena = second->get_arena();
+  check(second_arena != nullptr && second_arena != first_arena,
+        "overlapping cull results have their own arenas");
+
+  // Once the first frame has been drawn, its arena goes to the third.
+  first = nullptr;
+  PT(CullResult) third = second->make_next();
+  check(third->get_arena() == first_arena,
+        "arena of a finished cull result is reused");
+  check(first_arena->get_bytes_used() == 0, "reused arena starts empty");
+
+  second = nullptr;
+  third = nullptr;
+  CullArena *arena = CullArena::acquire();
+  check(arena == first_arena || arena == second_arena,
+        "arenas are returned when the cull results are destroyed");
+  CullArena::release(arena);
+}
+
+int
+main(int argc, char *argv[]) {
+  load_prc_file_data("test_cull_arena",
+                     "cull-arena true\n"
+                     "cull-arena-block-size 65536\n");
+
+  test_allocate();
+  test_objects();
+  test_results();
+
+  if (num_failures != 0) {
+    nout << num_failures << " checks failed.\n";
+    return 1;
+  }
+  nout << "All checks passed.\n";
+  return 0;
+}
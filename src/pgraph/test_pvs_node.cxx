@@ -0,0 +1,138 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_pvs_node.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "pvsNode.h"
+#include "portalNode.h"
+#include "nodePath.h"
+#include "pnotify.h"
+
+// This computes the visible sets of a PVSNode from its PortalNodes.
+//
+// In the first layout, two cells are joined by a single portal.  Portals are
+// one-way, so the second cell must be visible from the first but not the
+// other way around, until a portal back is added; a closed portal must not
+// count at all.
+//
+// In the second, four cells are strung along the X axis, each joined to the
+// next by a unit square portal.  If the portals are lined up, every cell can
+// see the ones after it.  If the last portal is moved well off to the side,
+// no line passes through all three, so the last cell can no longer be seen
+// from the first, but still from the second, which is only two portals away.
+
+static int num_failures = 0;
+
+static void
+check(bool condition, const char *message) {
+  if (!condition) {
+    nout << "FAILED: " << message << "\n";
+    ++num_failures;
+  }
+}
+
+/**
+ * Adds a cell to the PVSNode, covering the indicated range along the X axis.
+ */
+static PandaNode *
+add_cell(PVSNode *pvs, const std::string &name, PN_stdfloat min_x,
+         PN_stdfloat max_x) {
+  PT(PandaNode) cell = new PandaNode(name);
+  pvs->add_cell(cell, LPoint3(min_x, -20.0f, -20.0f),
+                LPoint3(max_x, 20.0f, 20.0f));
+  return cell;
+}
+
+/**
+ * Adds a portal leading from one cell to the other, as a unit square in the
+ * plane x = x, starting at y = y.
+ */
+static PortalNode *
+add_portal(PandaNode *from, PandaNode *to, PN_stdfloat x, PN_stdfloat y) {
+  PT(PortalNode) portal = new PortalNode(from->get_name() + "-" + to->get_name());
+  portal->add_vertex(LPoint3(x, y, 0.0f));
+  portal->add_vertex(LPoint3(x, y + 1.0f, 0.0f));
+  portal->add_vertex(LPoint3(x, y + 1.0f, 1.0f));
+  portal->add_vertex(LPoint3(x, y, 1.0f));
+  portal->set_cell_in(NodePath::any_path(from));
+  portal->set_cell_out(NodePath::any_path(to));
+  from->add_child(portal);
+  return portal;
+}
+
+static void
+test_two_cells() {
+  PT(PVSNode) pvs = new PVSNode("pvs");
+  PandaNode *a = add_cell(pvs, "a", 0.0f, 1.0f);
+  PandaNode *b = add_cell(pvs, "b", 1.0f, 2.0f);
+  check(pvs->find_cell(LPoint3(0.5f, 0.0f, 0.0f)) == 0, "point is in a");
+  check(pvs->find_cell(LPoint3(1.5f, 0.0f, 0.0f)) == 1, "point is in b");
+  check(pvs->find_cell(LPoint3(5.0f, 0.0f, 0.0f)) == -1, "point is in neither");
+
+  PortalNode *forward = add_portal(a, b, 1.0f, 0.0f);
+  check(pvs->compute_from_portals() == 1, "one portal is used");
+  check(pvs->is_cell_visible(0, 0) && pvs->is_cell_visible(1, 1),
+        "each cell sees itself");
+  check(pvs->is_cell_visible(0, 1), "a sees b through the portal");
+  check(!pvs->is_cell_visible(1, 0), "b doesn't see a through a one-way portal");
+
+  PortalNode *back = add_portal(b, a, 1.0f, 0.0f);
+  check(pvs->compute_from_portals() == 2, "two portals are used");
+  check(pvs->is_cell_visible(0, 1) && pvs->is_cell_visible(1, 0),
+        "a and b see each other");
+
+  forward->set_open(false);
+  back->set_open(false);
+  check(pvs->compute_from_portals() == 0, "closed portals are not used");
+  check(!pvs->is_cell_visible(0, 1) && !pvs->is_cell_visible(1, 0),
+        "closed portals hide the other cell");
+  check(pvs->is_cell_visible(0, 0) && pvs->is_cell_visible(1, 1),
+        "each cell still sees itself");
+}
+
+static void
+test_corridor(bool offset) {
+  PT(PVSNode) pvs = new PVSNode("pvs");
+  PandaNode *cells[4];
+  static const char *const names[4] = { "a", "b", "c", "d" };
+  for (int i = 0; i < 4; ++i) {
+    cells[i] = add_cell(pvs, names[i], (PN_stdfloat)i, (PN_stdfloat)(i + 1));
+  }
+  add_portal(cells[0], cells[1], 1.0f, 0.0f);
+  add_portal(cells[1], cells[2], 2.0f, 0.0f);
+  add_portal(cells[2], cells[3], 3.0f, offset ? 10.0f : 0.0f);
+  check(pvs->compute_from_portals() == 3, "corridor portals are used");
+
+  check(pvs->is_cell_visible(0, 1) && pvs->is_cell_visible(0, 2),
+        "a sees b and c");
+  check(pvs->is_cell_visible(1, 3), "b sees d");
+  if (offset) {
+    check(!pvs->is_cell_visible(0, 3), "a doesn't see d around the corner");
+  } else {
+    check(pvs->is_cell_visible(0, 3), "a sees d down the corridor");
+  }
+  check(!pvs->is_cell_visible(3, 0), "d doesn't see back through the portals");
+}
+
+int
+main(int argc, char *argv[]) {
+  test_two_cells();
+  test_corridor(false);
+  test_corridor(true);
+
+  if (num_failures != 0) {
+    nout << num_failures << " checks failed.\n";
+    return 1;
+  }
+  nout << "All checks passed.\n";
+  return 0;
+}
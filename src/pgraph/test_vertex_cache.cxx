@@ -0,0 +1,201 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_vertex_cache.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandabase.h"
+#include "geomNode.h"
+#include "geom.h"
+#include "geomTriangles.h"
+#include "geomVertexData.h"
+#include "geomVertexReader.h"
+#include "geomVertexWriter.h"
+#include "sceneGraphReducer.h"
+#include "pnotify.h"
+
+#include <algorithm>
+#include <random>
+
+// This builds a regular grid of triangles, once in row order and once in a
+// random order, and optimizes it for the vertex cache, both on its own with
+// GeomPrimitive::optimize_vertex_cache() and in a GeomNode with
+// SceneGraphReducer::optimize_vertex_cache(), which also renumbers the
+// vertices.
+//
+// Afterward, the grid must have exactly the same triangles, each with the
+// same winding, as it had before, and the average cache miss ratio must be no
+// worse than before; for the shuffled grid, it must be much better.  If the
+// reducer changes the order, it must also renumber the vertices in the order
+// in which they are first used.
+
+static int num_failures = 0;
+
+static void
+check(bool condition, const char *message) {
+  if (!condition) {
+    nout << "FAILED: " << message << "\n";
+    ++num_failures;
+  }
+}
+
+static const int grid_size = 40;
+static const int cache_size = 16;
+
+typedef pvector<uint64_t> Triangles;
+
+/**
+ * Returns a grid of grid_size by grid_size quads, each made of two
+ * triangles, in row order, or shuffled if shuffle is true.
+ */
+static PT(Geom)
+make_grid(bool shuffle) {
+  PT(GeomVertexData) vdata = new GeomVertexData
+    ("grid", GeomVertexFormat::get_v3(), Geom::UH_static);
+  GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+  for (int y = 0; y <= grid_size; ++y) {
+    for (int x = 0; x <= grid_size; ++x) {
+      vertex.add_data3((PN_stdfloat)x, (PN_stdfloat)y, 0.0f);
+    }
+  }
+
+  pvector<int> quads(grid_size * grid_size);
+  for (size_t i = 0; i < quads.size(); ++i) {
+    quads[i] = (int)i;
+  }
+  if (shuffle) {
+    std::mt19937 rng(1);
+    std::shuffle(quads.begin(), quads.end(), rng);
+  }
+
+  PT(GeomTriangles) tris = new GeomTriangles(Geom::UH_static);
+  for (int quad : quads) {
+    int v = (quad / grid_size) * (grid_size + 1) + (quad % grid_size);
+    tris->add_vertices(v, v + 1, v + grid_size + 2);
+    tris->add_vertices(v, v + grid_size + 2, v + grid_size + 1);
+  }
+
+  PT(Geom) geom = new Geom(vdata);
+  geom->add_primitive(tris);
+  return geom;
+}
+
+/**
+ * Returns the triangles of the primitive, identified by the positions of
+ * their vertices rather than by the vertex numbers, which may have changed.
+ * Each is rotated to begin with its lowest vertex, which keeps its winding,
+ * and the list is sorted, so that two lists of the same triangles compare
+ * equal regardless of their order.
+ */
+static Triangles
+get_triangles(const GeomPrimitive *prim, const GeomVertexData *vdata) {
+  GeomVertexReader vertex(vdata, InternalName::get_vertex());
+  Triangles triangles;
+  int num_vertices = prim->get_num_vertices();
+  for (int i = 0; i + 2 < num_vertices; i += 3) {
+    uint64_t ids[3];
+    for (int j = 0; j < 3; ++j) {
+      vertex.set_row(prim->get_vertex(i + j));
+      LPoint3 p = vertex.get_data3();
+      ids[j] = (uint64_t)(p[1] * (grid_size + 1) + p[0]);
+    }
+    int first = (int)(std::min_element(ids, ids + 3) - ids);
+    triangles.push_back((ids[first] << 40) |
+                        (ids[(first + 1) % 3] << 20) |
+                        ids[(first + 2) % 3]);
+  }
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+/**
+ * Optimizes the primitive of the grid directly.
+ */
+static void
+test_primitive(bool shuffle, PN_stdfloat expected_acmr) {
+  PT(Geom) geom = make_grid(shuffle);
+  CPT(GeomPrimitive) before = geom->get_primitive(0);
+  CPT(GeomPrimitive) after = before->optimize_vertex_cache(cache_size);
+
+  check(after->get_num_vertices() == before->get_num_vertices(),
+        "optimized primitive has as many vertices");
+  check(get_triangles(after, geom->get_vertex_data()) ==
+        get_triangles(before, geom->get_vertex_data()),
+        "optimized primitive has the same triangles");
+
+  PN_stdfloat acmr_before = before->get_acmr(cache_size);
+  PN_stdfloat acmr_after = after->get_acmr(cache_size);
+  check(acmr_after <= acmr_before, "optimized primitive has no worse ACMR");
+  check(acmr_after <= expected_acmr, "optimized primitive has a low ACMR");
+}
+
+/**
+ * Optimizes the grid in a GeomNode with the SceneGraphReducer, which also
+ * reorders the vertices.
+ */
+static void
+test_reducer(bool shuffle) {
+  PT(Geom) geom = make_grid(shuffle);
+  Triangles triangles = get_triangles(geom->get_primitive(0),
+                                      geom->get_vertex_data());
+  PN_stdfloat acmr_before = geom->get_primitive(0)->get_acmr(cache_size);
+
+  PT(GeomNode) node = new GeomNode("grid");
+  node->add_geom(geom);
+  SceneGraphReducer reducer;
+  reducer.optimize_vertex_cache(node, cache_size);
+
+  check(node->get_num_geoms() == 1, "reducer keeps the Geom");
+  CPT(Geom) result = node->get_geom(0);
+  check(result->get_num_primitives() == 1, "reducer keeps one primitive");
+  CPT(GeomPrimitive) prim = result->get_primitive(0);
+  check(result->get_vertex_data()->get_num_rows() ==
+        (grid_size + 1) * (grid_size + 1),
+        "reducer keeps every vertex");
+  check(get_triangles(prim, result->get_vertex_data()) == triangles,
+        "reducer keeps the same triangles");
+  PN_stdfloat acmr_after = prim->get_acmr(cache_size);
+  check(acmr_after <= acmr_before, "reducer doesn't worsen the ACMR");
+  if (acmr_after == acmr_before) {
+    // The reducer kept the original order, and so the original numbering.
+    return;
+  }
+
+  // After renumbering, each vertex is first used in order.
+  int next = 0;
+  bool in_order = true;
+  int num_vertices = prim->get_num_vertices();
+  for (int i = 0; i < num_vertices && in_order; ++i) {
+    int v = prim->get_vertex(i);
+    in_order = (v <= next);
+    if (v == next) {
+      ++next;
+    }
+  }
+  check(in_order, "reducer numbers vertices in order of first use");
+}
+
+int
+main(int argc, char *argv[]) {
+  // A row-order grid misses about once per triangle, and a shuffled one
+  // about twice; either way, the optimized order should miss less than once
+  // for every triangle.
+  test_primitive(false, 0.8f);
+  test_primitive(true, 0.8f);
+  test_reducer(false);
+  test_reducer(true);
+
+  if (num_failures != 0) {
+    nout << num_failures << " checks failed.\n";
+    return 1;
+  }
+  nout << "All checks passed.\n";
+  return 0;
+}
@@ -46,6 +46,7 @@
 #include "lvector4.h"
 #include "config_pgraphnodes.h"
 #include "pStatTimer.h"
+#include "lightMutexHolder.h"
 
 using std::string;
 
@@ -595,11 +596,13 @@ rehash_generated_shaders() {
       if (si != _generated_shaders.end()) {
         if (si->second != state->_generated_shader) {
           state->_generated_shader = si->second;
+          LightMutexHolder munger_holder(state->_munger_lock);
           state->_munged_states.clear();
         }
       } else {
         // We have not yet generated a shader for this modified state.
         state->_generated_shader.clear();
+        LightMutexHolder munger_holder(state->_munger_lock);
         state->_munged_states.clear();
       }
     }
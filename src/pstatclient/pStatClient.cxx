@@ -26,6 +26,7 @@
 #include "thread.h"
 #include "clockObject.h"
 #include "neverFreeMemory.h"
+#include "netStats.h"
 
 using std::string;
 
@@ -58,6 +59,85 @@ public:
 typedef pvector<TypeHandleCollector> TypeHandleCols;
 static TypeHandleCols type_handle_cols;
 
+// This class is used to report the traffic of each ConnectionReader and
+// ConnectionWriter.  We create one of these for each NetStats object, and
+// remember the totals we last saw, so that we can report the traffic of each
+// frame.
+class NetStatsCollectors {
+public:
+  PStatCollector _bytes;
+  PStatCollector _datagrams;
+  PStatCollector _wait;
+  PStatCollector _queue;
+  uint64_t _last_bytes = 0;
+  uint64_t _last_datagrams = 0;
+  double _last_wait = 0.0;
+};
+typedef pmap<PT(NetStats), NetStatsCollectors> NetStatsCols;
+static NetStatsCols net_stats_cols;
+
+/**
+ * Reports the traffic of each ConnectionReader and ConnectionWriter since the
+ * last frame.  This is done here, like the memory usage, because the net
+ * package is below PStatClient and can't report to it directly.
+ */
+static void
+report_net_stats() {
+  pvector<PT(NetStats)> all_stats;
+  NetStats::get_all_stats(all_stats);
+
+  // Readers and writers with the same name share their collectors, so we
+  // clear all the levels first, and then add up the traffic.
+  NetStatsCols::iterator ci;
+  for (ci = net_stats_cols.begin(); ci != net_stats_cols.end(); ++ci) {
+    NetStatsCollectors &cols = (*ci).second;
+    cols._bytes.clear_level();
+    cols._datagrams.clear_level();
+    if (cols._wait.is_valid()) {
+      cols._wait.clear_level();
+    }
+    cols._queue.clear_level();
+  }
+
+  NetStatsCols live_cols;
+  for (NetStats *stats : all_stats) {
+    ci = net_stats_cols.find(stats);
+    if (ci == net_stats_cols.end()) {
+      string name = (stats->get_direction() == NetStats::D_in) ? "In:" : "Out:";
+      name += stats->get_name();
+
+      NetStatsCollectors cols;
+      cols._bytes = PStatCollector("Net bytes:" + name);
+      cols._datagrams = PStatCollector("Net datagrams:" + name);
+      cols._queue = PStatCollector("Net queue:" + name);
+      if (stats->get_direction() == NetStats::D_in) {
+        cols._wait = PStatCollector("Net wait:" + stats->get_name());
+      }
+      ci = net_stats_cols.insert(NetStatsCols::value_type(stats, cols)).first;
+    }
+
+    NetStatsCollectors &cols = (*ci).second;
+    uint64_t bytes = stats->get_num_bytes();
+    uint64_t datagrams = stats->get_num_datagrams();
+    double wait = stats->get_wait_time();
+    cols._bytes.add_level_now((double)(bytes - cols._last_bytes));
+    cols._datagrams.add_level_now((double)(datagrams - cols._last_datagrams));
+    if (cols._wait.is_valid()) {
+      cols._wait.add_level_now(wait - cols._last_wait);
+    }
+    cols._queue.add_level_now(stats->get_queue_high_water_mark());
+    stats->reset_queue_high_water_mark();
+    cols._last_bytes = bytes;
+    cols._last_datagrams = datagrams;
+    cols._last_wait = wait;
+
+    live_cols.insert(*ci);
+  }
+
+  // Forget the readers and writers that have gone away.
+  net_stats_cols.swap(live_cols);
+}
+
 
 /**
  *
@@ -378,6 +458,10 @@ main_tick() {
   }
 #endif  // DO_MEMORY_USAGE
 
+  if (is_connected()) {
+    report_net_stats();
+  }
+
   get_global_pstats()->client_main_tick();
 }
 
@@ -104,6 +104,7 @@ static TimeCollectorProperties time_properties[] = {
   { 1, "Wait:Flip",                        { 1.0, 0.6, 0.3 } },
   { 1, "Wait:Flip:Begin",                  { 0.3, 0.3, 0.9 } },
   { 1, "Wait:Flip:End",                    { 0.9, 0.3, 0.6 } },
+  { 1, "Wait:Frame pacing",                { 0.6, 0.9, 0.6 } },
   { 1, "App",                              { 0.0, 0.4, 0.8 },  1.0 / 30.0 },
   { 1, "App:Collisions",                   { 1.0, 0.5, 0.0 } },
   { 1, "App:Collisions:Reset",             { 0.0, 0.0, 0.5 } },
@@ -182,6 +183,9 @@ static LevelCollectorProperties level_properties[] = {
   { 1, "Nodes",                            { 0.4, 0.2, 0.8 },  "", 500.0 },
   { 1, "Nodes:GeomNodes",                  { 0.8, 0.2, 0.0 } },
   { 1, "Geoms",                            { 0.4, 0.8, 0.3 },  "", 500.0 },
+  { 1, "Clusters",                         { 0.2, 0.6, 0.6 },  "", 5000.0 },
+  { 1, "Clusters:Culled",                  { 0.6, 0.3, 0.3 } },
+  { 1, "Cull arena",                       { 0.5, 0.3, 0.8 },  "KB", 256, 1024 },
   { 1, "Cull volumes",                     { 0.7, 0.6, 0.9 },  "", 500.0 },
   { 1, "Cull volumes:Transforms",          { 0.9, 0.6, 0.0 } },
   { 1, "State changes",                    { 1.0, 0.5, 0.2 },  "", 500.0 },
@@ -207,6 +211,10 @@ static LevelCollectorProperties level_properties[] = {
   { 1, "Vertex Data:Disk",                 { 0.6, 0.9, 0.1 } },
   { 1, "Vertex Data:Disk:Unused",          { 0.8, 0.4, 0.5 } },
   { 1, "Vertex Data:Disk:Used",            { 0.2, 0.1, 0.6 } },
+  { 1, "Vertex Paging",                    { 0.7, 0.5, 0.2 },  "KB", 1024, 1024 },
+  { 1, "Vertex Paging:Compress input",     { 0.9, 0.6, 0.3 } },
+  { 1, "Vertex Paging:Compress output",    { 0.5, 0.1, 0.4 } },
+  { 1, "Vertex Paging:Decompress output",  { 0.3, 0.7, 0.9 } },
   { 1, "TransformStates",                  { 1.0, 0.5, 0.5 },  "", 5000 },
   { 1, "TransformStates:On nodes",         { 0.2, 0.8, 1.0 } },
   { 1, "TransformStates:Cached",           { 1.0, 0.0, 0.2 } },
@@ -220,6 +228,16 @@ static LevelCollectorProperties level_properties[] = {
   { 1, "Collision Volumes",                { 1.0, 0.8, 0.5 },  "", 500 },
   { 1, "Collision Tests",                  { 0.5, 0.8, 1.0 },  "", 100 },
   { 1, "Command latency",                  { 0.8, 0.2, 0.0 },  "ms", 10, 1.0 / 1000.0 },
+  { 1, "Frame latency",                    { 0.9, 0.5, 0.1 },  "ms", 100, 1.0 / 1000.0 },
+  { 1, "Pipeline depth",                   { 0.4, 0.6, 0.9 },  "", 4 },
+  { 1, "Net bytes",                        { 0.2, 0.7, 0.4 },  "KB", 64, 1024 },
+  { 1, "Net bytes:In",                     { 0.2, 0.5, 0.9 } },
+  { 1, "Net bytes:Out",                    { 0.9, 0.5, 0.2 } },
+  { 1, "Net datagrams",                    { 0.6, 0.7, 0.2 },  "", 500 },
+  { 1, "Net datagrams:In",                 { 0.2, 0.5, 0.9 } },
+  { 1, "Net datagrams:Out",                { 0.9, 0.5, 0.2 } },
+  { 1, "Net queue",                        { 0.7, 0.3, 0.7 },  "", 100 },
+  { 1, "Net wait",                         { 0.5, 0.5, 0.8 },  "ms", 20, 1.0 / 1000.0 },
   { 0, nullptr }
 };
 
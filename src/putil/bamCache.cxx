@@ -82,6 +82,13 @@ BamCache() :
               "in the model cache, in their binary form as downloaded "
               "by the GSG."));
 
+  ConfigVariableBool model_cache_munged_data
+    ("model-cache-munged-data", false,
+     PRC_DESC("If this is set to true, vertex data that has been converted "
+              "to the native vertex format of the GSG will be cached in "
+              "the model cache, as vdo files, so that it need not be "
+              "converted again the next time the application runs."));
+
   ConfigVariableInt model_cache_max_kbytes
     ("model-cache-max-kbytes", 10485760,
      PRC_DESC("This is the maximum size of the model cache, in kilobytes."));
@@ -90,6 +97,7 @@ BamCache() :
   _cache_textures = model_cache_textures;
   _cache_compressed_textures = model_cache_compressed_textures;
   _cache_compiled_shaders = model_cache_compiled_shaders;
+  _cache_munged_data = model_cache_munged_data;
 
   _flush_time = model_cache_flush;
   _max_kbytes = model_cache_max_kbytes;
@@ -59,6 +59,9 @@ PUBLISHED:
   INLINE void set_cache_compiled_shaders(bool flag);
   INLINE bool get_cache_compiled_shaders() const;
 
+  INLINE void set_cache_munged_data(bool flag);
+  INLINE bool get_cache_munged_data() const;
+
   void set_root(const Filename &root);
   INLINE Filename get_root() const;
 
@@ -92,6 +95,8 @@ PUBLISHED:
                                            set_cache_compressed_textures);
   MAKE_PROPERTY(cache_compiled_shaders, get_cache_compiled_shaders,
                                         set_cache_compiled_shaders);
+  MAKE_PROPERTY(cache_munged_data, get_cache_munged_data,
+                                   set_cache_munged_data);
   MAKE_PROPERTY(root, get_root, set_root);
   MAKE_PROPERTY(flush_time, get_flush_time, set_flush_time);
   MAKE_PROPERTY(cache_max_kbytes, get_cache_max_kbytes, set_cache_max_kbytes);
@@ -131,6 +136,7 @@ private:
   bool _cache_textures;
   bool _cache_compressed_textures;
   bool _cache_compiled_shaders;
+  bool _cache_munged_data;
   bool _read_only;
   Filename _root;
   int _flush_time;
@@ -7,7 +7,7 @@
     p3framework p3putil p3collide p3pgraph p3chan p3text \
     p3pnmimage p3pnmimagetypes p3pnmtext p3event p3gobj p3display \
     p3mathutil p3putil p3express p3dgraph p3device p3tform \
-    p3linmath p3pstatclient panda
+    p3linmath p3pstatclient p3cull panda
 
 #begin bin_target
   #define TARGET pview
@@ -38,3 +38,8 @@
   #define TARGET test_map
   #define SOURCES test_map.cxx
 #end test_bin_target
+
+#begin test_bin_target
+  #define TARGET test_draw_overhead
+  #define SOURCES test_draw_overhead.cxx
+#end test_bin_target
@@ -0,0 +1,174 @@
+/**
+ * PANDA 3D SOFTWARE
+ * Copyright (c) Carnegie Mellon University.  All rights reserved.
+ *
+ * All use of this software is subject to the terms of the revised BSD
+ * license.  You should have received a copy of this license along
+ * with this source code in a file named "LICENSE."
+ *
+ * @file test_draw_overhead.cxx
+ * @author agent
+ * @date 2026-10-18
+ */
+
+#include "pandaFramework.h"
+#include "geomNode.h"
+#include "geomTriangles.h"
+#include "geomVertexWriter.h"
+#include "colorAttrib.h"
+#include "depthOffsetAttrib.h"
+#include "trueClock.h"
+#include "config_cull.h"
+#include "load_prc_file.h"
+#include "panda_getopt.h"
+#include "preprocess_argv.h"
+
+// This is a synthetic benchmark of the CPU cost of each draw call.  It fills
+// the scene with many tiny, separately transformed triangles spread over a
+// handful of states, renders a number of frames with and without the
+// cull-time state deltas, and reports the time per draw call.  It is best
+// run with -t, which uses tinydisplay in a small window, so that the cost of
+// filling pixels doesn't swamp the cost of setting up each draw.
+
+static int num_draws = 50000;
+static int num_states = 16;
+static int num_frames = 200;
+
+static bool
+get_command_line_opts(int &argc, char **&argv) {
+  extern char *optarg;
+  extern int optind;
+  const char *options = "n:s:f:t";
+  int flag = getopt(argc, argv, options);
+  while (flag != EOF) {
+    switch (flag) {
+    case 'n':
+      num_draws = atoi(optarg);
+      break;
+
+    case 's':
+      num_states = std::max(atoi(optarg), 1);
+      break;
+
+    case 'f':
+      num_frames = std::max(atoi(optarg), 1);
+      break;
+
+    case 't':
+      load_prc_file_data("test_draw_overhead",
+                         "load-display p3tinydisplay\n"
+                         "win-size 320 240\n");
+      break;
+
+    case '?':
+      nout << "Invalid parameter.\n";
+      return false;
+    }
+
+    flag = getopt(argc, argv, options);
+  }
+
+  argv += (optind - 1);
+  argc -= (optind - 1);
+
+  return true;
+}
+
+static PT(Geom)
+make_triangle() {
+  PT(GeomVertexData) vdata = new GeomVertexData
+    ("triangle", GeomVertexFormat::get_v3(), Geom::UH_static);
+  vdata->unclean_set_num_rows(3);
+  GeomVertexWriter vertex(vdata, InternalName::get_vertex());
+  vertex.add_data3(-0.05f, 0.0f, -0.05f);
+  vertex.add_data3(0.05f, 0.0f, -0.05f);
+  vertex.add_data3(0.0f, 0.0f, 0.05f);
+
+  PT(GeomTriangles) tris = new GeomTriangles(Geom::UH_static);
+  tris->add_next_vertices(3);
+
+  PT(Geom) geom = new Geom(vdata);
+  geom->add_primitive(tris);
+  return geom;
+}
+
+static void
+make_scene(const NodePath &root) {
+  PT(Geom) geom = make_triangle();
+
+  pvector<CPT(RenderState)> states;
+  states.reserve(num_states);
+  for (int i = 0; i < num_states; ++i) {
+    PN_stdfloat f = (PN_stdfloat)i / (PN_stdfloat)num_states;
+    states.push_back(RenderState::make
+      (ColorAttrib::make_flat(LColor(f, 1.0f - f, 0.5f, 1.0f)),
+       DepthOffsetAttrib::make(i % 2)));
+  }
+
+  // Lay the triangles out in a grid in front of the default camera.
+  int side = (int)ceil(sqrt((double)std::max(num_draws, 1)));
+  for (int i = 0; i < num_draws; ++i) {
+    PT(GeomNode) node = new GeomNode("tri");
+    node->add_geom(geom, states[i % num_states]);
+
+    NodePath np = root.attach_new_node(node);
+    PN_stdfloat x = ((i % side) / (PN_stdfloat)side - 0.5f) * 20.0f;
+    PN_stdfloat z = ((i / side) / (PN_stdfloat)side - 0.5f) * 15.0f;
+    np.set_pos(x, 30.0f, z);
+  }
+}
+
+static double
+time_frames(PandaFramework &framework, Thread *current_thread) {
+  // Let the first few frames settle, to fill the caches.
+  for (int i = 0; i < 10; ++i) {
+    framework.do_frame(current_thread);
+  }
+
+  TrueClock *clock = TrueClock::get_global_ptr();
+  double start = clock->get_short_time();
+  for (int i = 0; i < num_frames; ++i) {
+    framework.do_frame(current_thread);
+  }
+  return (clock->get_short_time() - start) / num_frames;
+}
+
+int
+main(int argc, char **argv) {
+  preprocess_argv(argc, argv);
+  if (!get_command_line_opts(argc, argv)) {
+    return (1);
+  }
+
+  PandaFramework framework;
+  framework.open_framework(argc, argv);
+  framework.set_window_title("Draw Overhead Test");
+
+  WindowFramework *window = framework.open_window();
+  if (window == nullptr) {
+    nout << "Unable to open window.\n";
+    return (1);
+  }
+
+  make_scene(window->get_render());
+
+  nout << "Drawing " << num_draws << " objects with " << num_states
+       << " states for " << num_frames << " frames.\n";
+
+  Thread *current_thread = Thread::get_current_thread();
+  bool save_delta = cull_state_delta;
+  for (int pass = 0; pass < 2; ++pass) {
+    bool delta = (pass == 0);
+    cull_state_delta = delta;
+
+    double frame_time = time_frames(framework, current_thread);
+    nout << (delta ? "with" : "without") << " cull-state-delta: "
+         << frame_time * 1000.0 << " ms per frame, "
+         << frame_time * 1000000.0 / std::max(num_draws, 1)
+         << " us per draw\n";
+  }
+  cull_state_delta = save_delta;
+
+  framework.close_framework();
+  return (0);
+}
@@ -1483,6 +1483,20 @@ framebuffer_copy_to_ram(Texture *tex, int view, int z,
 void TinyGraphicsStateGuardian::
 set_state_and_transform(const RenderState *target,
                         const TransformState *transform) {
+  set_state_delta_and_transform(target, transform, nullptr,
+                                RenderState::SlotMask());
+}
+
+/**
+ * Like set_state_and_transform(), but changed_slots indicates which
+ * attributes differ between prev_state and target.  If the GSG is still in
+ * prev_state, this saves comparing the two states again here.
+ */
+void TinyGraphicsStateGuardian::
+set_state_delta_and_transform(const RenderState *target,
+                              const TransformState *transform,
+                              const RenderState *prev_state,
+                              const RenderState::SlotMask &changed_slots) {
 #ifndef NDEBUG
   if (tinydisplay_cat.is_spam()) {
     tinydisplay_cat.spam()
@@ -1507,10 +1521,19 @@ set_state_and_transform(const RenderState *target,
   }
   _target_rs = target;
 
+  // Find out which attributes differ from the current state.  The cull
+  // thread may already have worked this out for us.
+  RenderState::SlotMask changed;
+  if (prev_state != nullptr && prev_state == _state_rs) {
+    changed = changed_slots;
+  } else {
+    changed = target->get_changed_slots(_state_rs);
+  }
+
   int color_slot = ColorAttrib::get_class_slot();
   int color_scale_slot = ColorScaleAttrib::get_class_slot();
-  if (_target_rs->get_attrib(color_slot) != _state_rs->get_attrib(color_slot) ||
-      _target_rs->get_attrib(color_scale_slot) != _state_rs->get_attrib(color_scale_slot) ||
+  if (changed.get_bit(color_slot) ||
+      changed.get_bit(color_scale_slot) ||
       !_state_mask.get_bit(color_slot) ||
       !_state_mask.get_bit(color_scale_slot)) {
     PStatTimer timer(_draw_set_state_color_pcollector);
@@ -1521,7 +1544,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int cull_face_slot = CullFaceAttrib::get_class_slot();
-  if (_target_rs->get_attrib(cull_face_slot) != _state_rs->get_attrib(cull_face_slot) ||
+  if (changed.get_bit(cull_face_slot) ||
       !_state_mask.get_bit(cull_face_slot)) {
     PStatTimer timer(_draw_set_state_cull_face_pcollector);
     do_issue_cull_face();
@@ -1529,7 +1552,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int depth_offset_slot = DepthOffsetAttrib::get_class_slot();
-  if (_target_rs->get_attrib(depth_offset_slot) != _state_rs->get_attrib(depth_offset_slot) ||
+  if (changed.get_bit(depth_offset_slot) ||
       !_state_mask.get_bit(depth_offset_slot)) {
     // PStatTimer timer(_draw_set_state_depth_offset_pcollector);
     do_issue_depth_offset();
@@ -1537,7 +1560,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int rescale_normal_slot = RescaleNormalAttrib::get_class_slot();
-  if (_target_rs->get_attrib(rescale_normal_slot) != _state_rs->get_attrib(rescale_normal_slot) ||
+  if (changed.get_bit(rescale_normal_slot) ||
       !_state_mask.get_bit(rescale_normal_slot)) {
     PStatTimer timer(_draw_set_state_rescale_normal_pcollector);
     do_issue_rescale_normal();
@@ -1545,7 +1568,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int render_mode_slot = RenderModeAttrib::get_class_slot();
-  if (_target_rs->get_attrib(render_mode_slot) != _state_rs->get_attrib(render_mode_slot) ||
+  if (changed.get_bit(render_mode_slot) ||
       !_state_mask.get_bit(render_mode_slot)) {
     PStatTimer timer(_draw_set_state_render_mode_pcollector);
     do_issue_render_mode();
@@ -1553,7 +1576,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int texture_slot = TextureAttrib::get_class_slot();
-  if (_target_rs->get_attrib(texture_slot) != _state_rs->get_attrib(texture_slot) ||
+  if (changed.get_bit(texture_slot) ||
       !_state_mask.get_bit(texture_slot)) {
     PStatTimer timer(_draw_set_state_texture_pcollector);
     determine_target_texture();
@@ -1562,7 +1585,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int material_slot = MaterialAttrib::get_class_slot();
-  if (_target_rs->get_attrib(material_slot) != _state_rs->get_attrib(material_slot) ||
+  if (changed.get_bit(material_slot) ||
       !_state_mask.get_bit(material_slot)) {
     PStatTimer timer(_draw_set_state_material_pcollector);
     do_issue_material();
@@ -1570,7 +1593,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int light_slot = LightAttrib::get_class_slot();
-  if (_target_rs->get_attrib(light_slot) != _state_rs->get_attrib(light_slot) ||
+  if (changed.get_bit(light_slot) ||
       !_state_mask.get_bit(light_slot)) {
     PStatTimer timer(_draw_set_state_light_pcollector);
     do_issue_light();
@@ -1578,7 +1601,7 @@ set_state_and_transform(const RenderState *target,
   }
 
   int scissor_slot = ScissorAttrib::get_class_slot();
-  if (_target_rs->get_attrib(scissor_slot) != _state_rs->get_attrib(scissor_slot) ||
+  if (changed.get_bit(scissor_slot) ||
       !_state_mask.get_bit(scissor_slot)) {
     PStatTimer timer(_draw_set_state_scissor_pcollector);
     do_issue_scissor();
@@ -82,6 +82,10 @@ public:
 
   virtual void set_state_and_transform(const RenderState *state,
                                        const TransformState *transform);
+  virtual void set_state_delta_and_transform(const RenderState *state,
+                                             const TransformState *transform,
+                                             const RenderState *prev_state,
+                                             const RenderState::SlotMask &changed_slots);
 
   virtual TextureContext *prepare_texture(Texture *tex, int view);
   virtual bool update_texture(TextureContext *tc, bool force);